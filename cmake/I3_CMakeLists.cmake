@@ -8,8 +8,10 @@ set (PROPOSAL_SRC_FILES
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/Constants.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/EnergyCutSettings.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/Output.cxx
+    ${PROJECT_SOURCE_DIR}/private/PROPOSAL/Pipeline.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/Propagator.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/PropagatorService.cxx
+    ${PROJECT_SOURCE_DIR}/private/PROPOSAL/TableAudit.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/crossection/ComptonIntegral.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/crossection/ComptonInterpolant.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/crossection/BremsIntegral.cxx
@@ -64,7 +66,9 @@ set (PROPOSAL_SRC_FILES
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/math/Interpolant.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/math/MathMethods.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/math/InterpolantBuilder.cxx
+    ${PROJECT_SOURCE_DIR}/private/PROPOSAL/math/ParallelFor.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/math/RandomGenerator.cxx
+    ${PROJECT_SOURCE_DIR}/private/PROPOSAL/math/RandomStream.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/math/Vector3D.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/medium/Components.cxx
     ${PROJECT_SOURCE_DIR}/private/PROPOSAL/medium/Medium.cxx
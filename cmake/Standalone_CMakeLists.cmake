@@ -37,6 +37,9 @@ OPTION(ADD_PYTHON "Choose to compile the python wrapper library" ON)
 OPTION(ADD_ROOT "Choose to compile ROOT examples." OFF)
 OPTION(ADD_PERFORMANCE_TEST "Choose to compile the performace test source." OFF)
 OPTION(ADD_CPPEXAMPLE "Choose to compile Cpp example." ON)
+OPTION(ADD_TABLE_AUDIT "Choose to compile the tool comparing the tables with the integrals." ON)
+OPTION(ADD_PACK_TABLES "Choose to compile the tool packing table files into a bundle." ON)
+OPTION(ADD_PROPOSAL_TABLES "Choose to compile the tool building the tables of configurations in advance." ON)
 
 
 #################################################################
@@ -53,6 +56,11 @@ target_include_directories(
     $<INSTALL_INTERFACE:include>
 )
 target_compile_options(PROPOSAL PRIVATE -Wall -Wextra -Wnarrowing -Wpedantic -fdiagnostics-show-option -Wno-format-security)
+
+# std::thread is used for the parallel propagation
+set(THREADS_PREFER_PTHREAD_FLAG ON)
+find_package(Threads REQUIRED)
+target_link_libraries(PROPOSAL PUBLIC Threads::Threads)
 install(
     TARGETS PROPOSAL
     EXPORT PROPOSALTargets
@@ -116,6 +124,25 @@ IF(ADD_PERFORMANCE_TEST)
     target_link_libraries(performance_test PRIVATE PROPOSAL)
 ENDIF(ADD_PERFORMANCE_TEST)
 
+
+IF(ADD_TABLE_AUDIT)
+    add_executable(table_audit private/test/table_audit.cxx)
+    target_compile_options(table_audit PRIVATE -Wall -Wextra -Wnarrowing -Wpedantic -fdiagnostics-show-option)
+    target_link_libraries(table_audit PRIVATE PROPOSAL)
+ENDIF(ADD_TABLE_AUDIT)
+
+IF(ADD_PACK_TABLES)
+    add_executable(pack_tables private/test/pack_tables.cxx)
+    target_compile_options(pack_tables PRIVATE -Wall -Wextra -Wnarrowing -Wpedantic -fdiagnostics-show-option)
+    target_link_libraries(pack_tables PRIVATE PROPOSAL)
+ENDIF(ADD_PACK_TABLES)
+
+IF(ADD_PROPOSAL_TABLES)
+    add_executable(proposal_tables private/test/proposal_tables.cxx)
+    target_compile_options(proposal_tables PRIVATE -Wall -Wextra -Wnarrowing -Wpedantic -fdiagnostics-show-option)
+    target_link_libraries(proposal_tables PRIVATE PROPOSAL)
+ENDIF(ADD_PROPOSAL_TABLES)
+
 #################################################################
 #################           Tests        ########################
 #################################################################
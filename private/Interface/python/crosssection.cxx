@@ -152,8 +152,9 @@ void init_crosssection(py::module& m) {
                      
                 )pbdoc")
         .def("calculate_produced_particles",
-             &CrossSection::CalculateProducedParticles, py::arg("energy"),
-             py::arg("energy_loss"), py::arg("initial_direction"),
+             static_cast<std::pair<std::vector<DynamicData>, bool> (CrossSection::*)(double, double, const Vector3D&)>(
+                 &CrossSection::CalculateProducedParticles),
+             py::arg("energy"), py::arg("energy_loss"), py::arg("initial_direction"),
              R"pbdoc( 
 
             If particles are produced in the interaction of this CrossSection, the methods samples those particles corresponding to the energy of the initial particle as
@@ -167,6 +168,15 @@ void init_crosssection(py::module& m) {
             Returns:
                 List of created particles as well as a boolean with the information whether the initial particle has been destroyed in the interaction
                      
+                )pbdoc")
+        .def("calculate_produced_particles",
+             static_cast<std::pair<std::vector<DynamicData>, bool> (CrossSection::*)(double, double, const Vector3D&, double, double)>(
+                 &CrossSection::CalculateProducedParticles),
+             py::arg("energy"), py::arg("energy_loss"), py::arg("initial_direction"), py::arg("rnd1"), py::arg("rnd2"),
+             R"pbdoc(
+
+            Same as above for the interaction sampled by calculate_stochastic_loss with the random numbers rnd1 and rnd2.
+
                 )pbdoc")
         .def_property_readonly("id", &CrossSection::GetTypeId,
                                R"pbdoc( 
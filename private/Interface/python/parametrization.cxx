@@ -203,7 +203,9 @@ void init_parametrization(py::module& m) {
             PROPOSAL uses this function internally, for example to compare the probabilities of the different possible interactions. 
 
                 )pbdoc")
-        .def("integral_limits", &Parametrization::GetIntegralLimits,
+        .def("integral_limits",
+             static_cast<Parametrization::IntegralLimits (Parametrization::*)(double)>(
+                 &Parametrization::GetIntegralLimits),
              py::arg("energy"),
              R"pbdoc(
             Returns:
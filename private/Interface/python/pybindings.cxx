@@ -155,6 +155,13 @@ PYBIND11_MODULE(proposal, m)
                 Path where tables can be read from disk to avoid to rebuild
                 it.
             )pbdoc")
+        .def_readwrite("path_to_table_bundle",
+            &InterpolationDef::path_to_table_bundle,
+            R"pbdoc(
+                File with the tables of several table files, which is read
+                at once before looking at the table paths. Bundles are packed
+                from table directories with the pack_tables tool.
+            )pbdoc")
         .def_readwrite("max_node_energy", &InterpolationDef::max_node_energy,
             R"pbdoc(
                 maximum energy that will be interpolated. Energies greater
@@ -177,12 +184,76 @@ PYBIND11_MODULE(proposal, m)
                 number of nodes used by evaluation of propagation
                 integrals. Default: xxx
             )pbdoc")
+        .def_readwrite("n_threads", &InterpolationDef::n_threads,
+            R"pbdoc(
+                number of threads used to build the interpolation tables.
+                The tables do not depend on it. Default: 0, which uses all
+                hardware threads
+            )pbdoc")
+        .def_readwrite("do_polynomial_tables", &InterpolationDef::do_polynomial_tables,
+            R"pbdoc(
+                Evaluate the 1d tables and the rows of the 2d tables with
+                precomputed polynomials instead of the Neville scheme. This is
+                faster, but needs more memory. The table files do not depend
+                on it. Default: False
+            )pbdoc")
+        .def_readwrite("do_inverse_tables", &InterpolationDef::do_inverse_tables,
+            R"pbdoc(
+                Sample the stochastic losses from additional tables of the
+                inverted cumulative dNdx instead of searching the dNdx tables.
+                This is faster, but needs additional tables and agrees with
+                the search only up to the interpolation error. Default: False
+            )pbdoc")
+        .def_readwrite("do_fused_rate_tables", &InterpolationDef::do_fused_rate_tables,
+            R"pbdoc(
+                Choose the interacting cross section and component from tables
+                of the cumulative dNdx over all of them instead of summing up
+                the rates of every cross section for each stochastic loss.
+                The tables are derived from the dNdx tables in memory and the
+                choice agrees with the sum up to the interpolation error.
+                Default: False
+            )pbdoc")
+        .def_readwrite("do_lazy_tables", &InterpolationDef::do_lazy_tables,
+            R"pbdoc(
+                Build or read the tables of a sector on its first use instead
+                of when it is created, so the tables of sectors the particles
+                never reach are not built at all. The tables do not depend on
+                it. Default: False
+            )pbdoc")
+        .def_readwrite("target_interpolation_error", &InterpolationDef::target_interpolation_error,
+            R"pbdoc(
+                If larger than zero, the number of nodes of every table is
+                chosen to reach this estimated relative interpolation error
+                and the nodes_* are the upper limits. Default: 0
+            )pbdoc")
+        .def_readwrite("float_table_tolerance", &InterpolationDef::float_table_tolerance,
+            R"pbdoc(
+                If larger than zero, the function values of the 2d tables are
+                stored in single precision, which halves their memory. A table
+                is only converted if its interpolation deviates from the
+                double precision table by less than this relative tolerance.
+                The table files do not depend on it. Default: 0
+            )pbdoc")
+        .def_readwrite("chebyshev_table_tolerance", &InterpolationDef::chebyshev_table_tolerance,
+            R"pbdoc(
+                If larger than zero, the dEdx, dE2dx and dNdx tables of the
+                cross sections are evaluated with Chebyshev series fitted to
+                them, if the series agree with the tables up to this relative
+                tolerance. The table files do not depend on it. Default: 0
+            )pbdoc")
         .def_readwrite("do_binary_tables", &InterpolationDef::do_binary_tables,
             R"pbdoc(
                 Should binary tables be used to store the data.
                 This will increase performance, but are not readable for a
                 crosscheck by human. Default: xxx
             )pbdoc")
+        .def_readwrite("do_mapped_tables", &InterpolationDef::do_mapped_tables,
+            R"pbdoc(
+                Store the tables in the layout used in memory, in files with
+                the suffix .map, and map these files into memory instead of
+                reading them. Processes on the same machine share the tables.
+                Overrides do_binary_tables. Default: False
+            )pbdoc")
         .def_readwrite("just_use_readonly_path",
             &InterpolationDef::just_use_readonly_path,
             R"pbdoc(
@@ -452,8 +523,27 @@ PYBIND11_MODULE(proposal, m)
             py::arg("initial_energy"), py::arg("distance"))
         .def("make_stochastic_loss", &Sector::MakeStochasticLoss,
             py::arg("minimal_energy"))
-        .def("propagate", &Sector::Propagate,
-            py::arg("particle_condition"), py::arg("max_distance"), py::arg("min_energy"));
+        .def("propagate",
+            overload_cast_<const DynamicData&, double, double>()(&Sector::Propagate),
+            py::arg("particle_condition"), py::arg("max_distance"), py::arg("min_energy"))
+        .def("propagate",
+            [](Sector& sector, const DynamicData& particle_condition,
+                double max_distance, double min_energy, uint64_t seed, uint64_t stream) {
+                PhiloxStream random(seed, stream);
+                py::gil_scoped_release release;
+                return sector.Propagate(particle_condition, max_distance, min_energy, random);
+            },
+            py::arg("particle_condition"), py::arg("max_distance"), py::arg("min_energy"),
+            py::arg("seed"), py::arg("stream"),
+            R"pbdoc(
+                    Same as above, but the random numbers are drawn from the
+                    given stream instead of the RandomGenerator, so the GIL
+                    is released during the propagation.
+
+                    Args:
+                        seed (int): seed of the random stream
+                        stream (int): index of the random stream
+                )pbdoc");
 
     // ---------------------------------------------------------------------
     // // Randomgenerator
@@ -469,6 +559,20 @@ PYBIND11_MODULE(proposal, m)
         .def_static(
             "get", &RandomGenerator::Get, py::return_value_policy::reference);
 
+    py::class_<TableAudit>(m, "TableAudit",
+        R"pbdoc(
+            Accuracy and cost of the tables behind one interpolated quantity,
+            see Propagator.audit_tables.
+        )pbdoc")
+        .def_readonly("sector", &TableAudit::sector)
+        .def_readonly("table", &TableAudit::table)
+        .def_readonly("max_error", &TableAudit::max_error)
+        .def_readonly("worst_energy", &TableAudit::worst_energy)
+        .def_readonly("points", &TableAudit::points)
+        .def_readonly("nodes", &TableAudit::nodes)
+        .def_readonly("bytes", &TableAudit::bytes)
+        .def_readonly("ns", &TableAudit::ns);
+
     // --------------------------------------------------------------------- //
     // Propagator
     // --------------------------------------------------------------------- //
@@ -496,7 +600,8 @@ PYBIND11_MODULE(proposal, m)
             py::arg("detector"))
         .def(py::init<const ParticleDef&, const std::string&>(),
             py::arg("particle_def"), py::arg("config_file"))
-        .def("propagate", &Propagator::Propagate,
+        .def("propagate",
+            overload_cast_<const DynamicData&, double, double>()(&Propagator::Propagate),
             py::arg("particle_condition"),
             py::arg("max_distance_cm") = 1e20,
             py::arg("minimal_energy") = 0.,
@@ -504,6 +609,9 @@ PYBIND11_MODULE(proposal, m)
             R"pbdoc(
                     Propagate a particle through sectors and produce stochastic
                     losses, untill propagated distance is reached.
+                    The random numbers are drawn from the RandomGenerator,
+                    which may call a python function, so the GIL is held.
+                    Pass seed and stream to release it.
 
                     Args:
                         max_distance_cm (float): Maximum distance a particle is
@@ -552,6 +660,121 @@ PYBIND11_MODULE(proposal, m)
                     will be calculated and the produced secondary particles
                     returned.
                 )pbdoc")
+        .def("propagate",
+            [](const Propagator& propagator, const DynamicData& particle_condition,
+                uint64_t seed, uint64_t stream, double max_distance, double minimal_energy) {
+                PhiloxStream random(seed, stream);
+                PropagationContext context(&random);
+                py::gil_scoped_release release;
+                return propagator.Propagate(context, particle_condition, max_distance, minimal_energy);
+            },
+            py::arg("particle_condition"), py::arg("seed"), py::arg("stream"),
+            py::arg("max_distance_cm") = 1e20,
+            py::arg("minimal_energy") = 0.,
+            R"pbdoc(
+                    Same as above, but the random numbers are drawn from the
+                    given stream instead of the RandomGenerator. The
+                    propagator is not altered, so the GIL is released and
+                    several python threads can propagate at once. The
+                    result only depends on the seed and the stream.
+
+                    Args:
+                        seed (int): seed of the random stream
+                        stream (int): index of the random stream, e.g. the
+                            number of the event
+
+                    Example:
+                        >>> daughters = prop.propagate(mu, seed=1, stream=event)
+                )pbdoc")
+        .def("propagate_many",
+            [](Propagator& propagator,
+                py::array_t<double, py::array::c_style | py::array::forcecast> energies,
+                py::array_t<double, py::array::c_style | py::array::forcecast> positions,
+                py::array_t<double, py::array::c_style | py::array::forcecast> directions,
+                unsigned int n_threads, uint64_t seed, uint64_t first_stream,
+                double max_distance, double minimal_energy) {
+                if (energies.ndim() != 1)
+                    throw py::value_error("energies must be a one dimensional array");
+                py::ssize_t n_primaries = energies.shape(0);
+                if (positions.ndim() != 2 || positions.shape(0) != n_primaries || positions.shape(1) != 3)
+                    throw py::value_error("positions must have the shape (len(energies), 3)");
+                if (directions.ndim() != 2 || directions.shape(0) != n_primaries || directions.shape(1) != 3)
+                    throw py::value_error("directions must have the shape (len(energies), 3)");
+
+                auto energy = energies.unchecked<1>();
+                auto position = positions.unchecked<2>();
+                auto direction = directions.unchecked<2>();
+
+                std::vector<DynamicData> primaries;
+                primaries.reserve(n_primaries);
+                for (py::ssize_t i = 0; i < n_primaries; ++i) {
+                    DynamicData primary(propagator.GetParticleDef().particle_type);
+                    primary.SetEnergy(energy(i));
+                    primary.SetPosition(Vector3D(position(i, 0), position(i, 1), position(i, 2)));
+                    primary.SetDirection(Vector3D(direction(i, 0), direction(i, 1), direction(i, 2)));
+                    primaries.push_back(primary);
+                }
+
+                BatchOptions options;
+                options.n_threads = n_threads;
+                options.seed = seed;
+                options.first_stream = first_stream;
+                options.max_distance = max_distance;
+                options.minimal_energy = minimal_energy;
+
+                py::gil_scoped_release release;
+                return propagator.PropagateBatch(primaries, options);
+            },
+            py::arg("energies"), py::arg("positions"), py::arg("directions"),
+            py::arg("n_threads") = 0, py::arg("seed") = 0,
+            py::arg("first_stream") = 0, py::arg("max_distance_cm") = 1e20,
+            py::arg("minimal_energy") = 0.,
+            R"pbdoc(
+                    Propagate many particles on native threads.
+
+                    The GIL is released while the particles are propagated.
+                    Every particle draws its random numbers from its own
+                    stream, so the result does not depend on the number
+                    of threads. Sectors created without an InterpolationDef
+                    work as well, but propagate one particle at a time.
+
+                    Args:
+                        energies (numpy.ndarray): initial energies in MeV, shape (n,)
+                        positions (numpy.ndarray): initial positions in cm, shape (n, 3)
+                        directions (numpy.ndarray): initial directions, shape (n, 3)
+                        n_threads (int): number of threads, 0 uses all hardware threads
+                        seed (int): seed of the random streams
+                        first_stream (int): random stream of the first particle,
+                            the i-th particle uses first_stream + i
+                        max_distance_cm (float): Maximum distance a particle is
+                            propagated before it is considered lost.
+                        minimal_energy (float): energy below which a particle
+                            is considered lost.
+
+                    Returns:
+                        list(Secondaries): the secondaries of every particle,
+                        in the order of the given particles
+
+                    Example:
+                        >>> n = 1000
+                        >>> energies = np.full(n, 1e8)
+                        >>> positions = np.zeros((n, 3))
+                        >>> directions = np.tile([0, 0, -1], (n, 1))
+                        >>> secondaries = prop.propagate_many(energies, positions, directions, n_threads=4)
+                )pbdoc")
+        .def("audit_tables", &AuditTables, py::arg("points") = 100, py::arg("seed") = 0,
+            R"pbdoc(
+                    Compare all tables with the integrals they are built from.
+
+                    Args:
+                        points (int): number of random points per quantity
+                        seed (int): seed of the random points
+
+                    Returns:
+                        list(TableAudit): the maximal relative deviation,
+                        nodes, bytes and evaluation time of every
+                        interpolated quantity of every sector
+                )pbdoc")
         .def_property_readonly("particle_def", &Propagator::GetParticleDef,
             R"pbdoc(
                     Get the internal particle definition to use its properties.
@@ -582,9 +805,31 @@ PYBIND11_MODULE(proposal, m)
     py::class_<PropagatorService, std::shared_ptr<PropagatorService>>(
         m, "PropagatorService")
         .def(py::init<>())
-        .def("propagate", &PropagatorService::Propagate,
+        .def("propagate",
+            overload_cast_<const ParticleDef&, DynamicData&, double, double>()(
+                &PropagatorService::Propagate),
             py::arg("particle_definition"), py::arg("particle_condition"),
             py::arg("max_distance") = 1e20, py::arg("min_energy") = 1e20)
+        .def("propagate",
+            [](const PropagatorService& service, const ParticleDef& particle_def,
+                const DynamicData& particle_condition, uint64_t seed,
+                uint64_t stream, double max_distance, double min_energy) {
+                PhiloxStream random(seed, stream);
+                py::gil_scoped_release release;
+                return service.Propagate(particle_def, particle_condition, random, max_distance, min_energy);
+            },
+            py::arg("particle_definition"), py::arg("particle_condition"),
+            py::arg("seed"), py::arg("stream"),
+            py::arg("max_distance") = 1e20, py::arg("min_energy") = 0.,
+            R"pbdoc(
+                    Propagate the particle with random numbers of the given
+                    stream. The GIL is released, so several python threads
+                    can propagate at once.
+
+                    Args:
+                        seed (int): seed of the random stream
+                        stream (int): index of the random stream
+                )pbdoc")
         .def("register_propagator", &PropagatorService::RegisterPropagator,
             py::arg("propagator"));
 }
@@ -0,0 +1,222 @@
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "PROPOSAL/Pipeline.h"
+#include "PROPOSAL/math/BoundedQueue.h"
+#include "PROPOSAL/math/ParallelFor.h"
+#include "PROPOSAL/math/RandomStream.h"
+
+using namespace PROPOSAL;
+
+namespace {
+
+struct Primary
+{
+    Primary()
+        : index(0)
+        , condition()
+    {
+    }
+
+    size_t index;
+    DynamicData condition;
+};
+
+struct Result
+{
+    Result()
+        : index(0)
+        , secondaries()
+    {
+    }
+
+    size_t index;
+    Secondaries secondaries;
+};
+
+// Waiting for a full or an empty queue. Yields a few times and sleeps
+// afterwards, so the threads waiting for a slow stage do not keep spinning.
+class Backoff
+{
+public:
+    Backoff()
+        : n_(0)
+    {
+    }
+
+    void Wait()
+    {
+        if (n_ < 64)
+        {
+            ++n_;
+            std::this_thread::yield();
+        } else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    void Reset() { n_ = 0; }
+
+private:
+    unsigned int n_;
+};
+
+} // namespace
+
+// ------------------------------------------------------------------------- //
+Pipeline::Pipeline(const Propagator& propagator, const PipelineOptions& options)
+    : propagator_(propagator)
+    , options_(options)
+    , particle_type_(propagator.GetParticleDef().particle_type)
+{
+}
+
+// ------------------------------------------------------------------------- //
+size_t Pipeline::Run(const Generator& generator, const Writer& writer)
+{
+    // the generator and the writer take two of the threads, there is at
+    // least one propagation thread
+    unsigned int n_threads = NumberOfWorkers(options_.n_threads, UINT_MAX);
+    unsigned int n_workers = n_threads > 2 ? n_threads - 2 : 1;
+
+    BoundedQueue<Primary> primaries(options_.queue_size);
+    BoundedQueue<Result> results(options_.queue_size);
+
+    std::atomic<bool> abort(false);
+    std::atomic<bool> generator_done(false);
+    std::atomic<unsigned int> n_running(n_workers);
+
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+
+    auto fail = [&]() {
+        std::lock_guard<std::mutex> lock(exception_mutex);
+        if (!exception)
+            exception = std::current_exception();
+
+        abort = true;
+    };
+
+    auto generate = [&]() {
+        Primary primary;
+        Backoff backoff;
+
+        try
+        {
+            for (size_t index = 0; !abort; ++index)
+            {
+                primary.index     = index;
+                primary.condition = DynamicData(particle_type_);
+                if (!generator(primary.condition))
+                    break;
+
+                while (!primaries.TryPush(primary) && !abort)
+                {
+                    backoff.Wait();
+                }
+                backoff.Reset();
+            }
+        } catch (...)
+        {
+            fail();
+        }
+
+        generator_done = true;
+    };
+
+    auto propagate = [&]() {
+        PhiloxStream stream(options_.seed);
+        PropagationContext context(&stream);
+        Primary primary;
+        Result result;
+        Backoff backoff;
+
+        try
+        {
+            while (!abort)
+            {
+                if (!primaries.TryPop(primary))
+                {
+                    // everything pushed before generator_done is visible now,
+                    // so the queue is drained if this pop fails as well
+                    if (!generator_done)
+                    {
+                        backoff.Wait();
+                        continue;
+                    }
+                    if (!primaries.TryPop(primary))
+                        break;
+                }
+                backoff.Reset();
+
+                stream.SetStream(options_.first_stream + primary.index);
+                result.index       = primary.index;
+                result.secondaries = propagator_.Propagate(
+                    context, primary.condition, options_.max_distance, options_.minimal_energy);
+
+                while (!results.TryPush(result) && !abort)
+                {
+                    backoff.Wait();
+                }
+                backoff.Reset();
+            }
+        } catch (...)
+        {
+            fail();
+        }
+
+        --n_running;
+    };
+
+    std::vector<std::thread> threads;
+    threads.emplace_back(generate);
+    for (unsigned int w = 0; w < n_workers; ++w)
+    {
+        threads.emplace_back(propagate);
+    }
+
+    // the writer runs in the calling thread
+    size_t n_written = 0;
+    Result result;
+    Backoff backoff;
+
+    try
+    {
+        while (!abort)
+        {
+            if (!results.TryPop(result))
+            {
+                if (n_running > 0)
+                {
+                    backoff.Wait();
+                    continue;
+                }
+                if (!results.TryPop(result))
+                    break;
+            }
+            backoff.Reset();
+
+            writer(result.index, result.secondaries);
+            ++n_written;
+        }
+    } catch (...)
+    {
+        fail();
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+
+    return n_written;
+}
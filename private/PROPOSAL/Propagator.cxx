@@ -23,7 +23,9 @@
 #include "PROPOSAL/Constants.h"
 #include "PROPOSAL/Logging.h"
 #include "PROPOSAL/math/MathMethods.h"
+#include "PROPOSAL/math/ParallelFor.h"
 #include "PROPOSAL/math/RandomGenerator.h"
+#include "PROPOSAL/math/RandomStream.h"
 
 using namespace PROPOSAL;
 
@@ -51,8 +53,7 @@ const bool Propagator::uniform_ = true;
 // ------------------------------------------------------------------------- //
 Propagator::Propagator(
     const std::vector<Sector*>& sectors, std::shared_ptr<const Geometry> geometry) try
-    : current_sector_(NULL),
-      particle_def_(sectors.at(0)->GetParticleDef()),
+    : particle_def_(sectors.at(0)->GetParticleDef()),
       detector_(geometry)
 {
     // --------------------------------------------------------------------- //
@@ -68,7 +69,7 @@ Propagator::Propagator(
         }
     }
 
-    current_sector_ = sectors_.at(0);
+    context_.current_sector = sectors_.at(0);
 } catch (const std::out_of_range& ex) {
     log_fatal("No Sectors are provided for the Propagator!");
 }
@@ -81,11 +82,11 @@ Propagator::Propagator(const ParticleDef& particle_def,
     , detector_(geometry)
 {
     for (auto def : sector_defs) {
-        sectors_.push_back(new Sector(particle_def, def));
+        sectors_.push_back(CreateSector(def, nullptr));
     }
 
     try {
-        current_sector_ = sectors_.at(0);
+        context_.current_sector = sectors_.at(0);
     } catch (const std::out_of_range& ex) {
         log_fatal("No Sectors are provided for the Propagator!");
     }
@@ -99,11 +100,11 @@ Propagator::Propagator(const ParticleDef& particle_def,
     , detector_(geometry)
 {
     for (auto def : sector_defs) {
-        sectors_.push_back(new Sector(particle_def, def, interpolation_def));
+        sectors_.push_back(CreateSector(def, &interpolation_def));
     }
 
     try {
-        current_sector_ = sectors_.at(0);
+        context_.current_sector = sectors_.at(0);
     } catch (const std::out_of_range& ex) {
         log_fatal("No Sectors are provided for the Propagator!");
     }
@@ -112,15 +113,14 @@ Propagator::Propagator(const ParticleDef& particle_def,
 // ------------------------------------------------------------------------- //
 Propagator::Propagator(const Propagator& propagator)
     : sectors_(propagator.sectors_.size(), NULL)
-    , current_sector_(NULL)
     , particle_def_(propagator.particle_def_)
     , detector_(propagator.detector_)
 {
     for (unsigned int i = 0; i < propagator.sectors_.size(); ++i) {
         sectors_[i] = new Sector(*propagator.sectors_[i]);
 
-        if (propagator.sectors_[i] == propagator.current_sector_) {
-            current_sector_ = sectors_[i];
+        if (propagator.sectors_[i] == propagator.context_.current_sector) {
+            context_.current_sector = sectors_[i];
         }
     }
 }
@@ -128,8 +128,7 @@ Propagator::Propagator(const Propagator& propagator)
 // ------------------------------------------------------------------------- //
 Propagator::Propagator(
     const ParticleDef& particle_def, const std::string& config_file)
-    : current_sector_(NULL)
-    , particle_def_(particle_def)
+    : particle_def_(particle_def)
     , detector_(NULL)
 {
     int global_seed = global_seed_;
@@ -229,9 +228,9 @@ Propagator::Propagator(
                     }
 
                     if (do_interpolation) {
-                        sectors_.push_back(new Sector(particle_def_, sec_def, interpolation_def));
+                        sectors_.push_back(CreateSector(sec_def, &interpolation_def));
                     } else {
-                        sectors_.push_back(new Sector(particle_def_, sec_def));
+                        sectors_.push_back(CreateSector(sec_def, nullptr));
                     }
                 }
             }
@@ -284,13 +283,22 @@ bool Propagator::operator!=(const Propagator& propagator) const
 Secondaries Propagator::Propagate(
     const DynamicData& initial_condition, double max_distance, double minimal_energy)
 {
+    return Propagate(context_, initial_condition, max_distance, minimal_energy);
+}
+
+// ------------------------------------------------------------------------- //
+Secondaries Propagator::Propagate(PropagationContext& context,
+    const DynamicData& initial_condition, double max_distance, double minimal_energy) const
+{
+    RandomGenerator::StreamScope random_scope(context.random_stream);
+
     double distance = 0;
     double distance_to_closest_approach = 0;
 
     Secondaries secondaries_(std::make_shared<ParticleDef>(particle_def_));
-    /* secondaries_.reserve(static_cast<size_t>(produced_particle_moments_.first
+    /* secondaries_.reserve(static_cast<size_t>(context.produced_particle_moments.first
      */
-    /*     + 2 * std::sqrt(produced_particle_moments_.second))); */
+    /*     + 2 * std::sqrt(context.produced_particle_moments.second))); */
 
     // These two variables are needed to calculate the energy loss inside the
     // detector energy_at_entry_point is initialized with the current energy
@@ -327,17 +335,17 @@ Secondaries Propagator::Propagate(
     std::unique_ptr<DynamicData> p_condition(
         new DynamicData(initial_condition));
     while (1) {
-        ChooseCurrentSector(
+        context.current_sector = ChooseCurrentSector(
             p_condition->GetPosition(), p_condition->GetDirection());
 
-        if (current_sector_ == nullptr) {
+        if (context.current_sector == nullptr) {
             log_info("particle reached the border");
             break;
         }
 
         // Check if have to propagate the particle_ through the whole sector
         // or only to the sector border
-        distance = CalculateEffectiveDistance(
+        distance = CalculateEffectiveDistance(context.current_sector,
             p_condition->GetPosition(), p_condition->GetDirection());
 
         if (already_reached_closest_approach == false) {
@@ -388,7 +396,7 @@ Secondaries Propagator::Propagate(
             distance = max_distance - p_condition->GetPropagatedDistance();
         }
 
-        Secondaries sector_secondaries = current_sector_->Propagate(
+        Secondaries sector_secondaries = context.current_sector->Propagate(
             *p_condition, distance, minimal_energy);
         secondaries_.append(sector_secondaries);
 
@@ -414,21 +422,63 @@ Secondaries Propagator::Propagate(
 
     secondaries_.DoDecay();
 
-    n_th_call_ += 1.;
+    context.n_th_call += 1.;
     double produced_particles_
         = static_cast<double>(secondaries_.GetNumberOfParticles());
-    produced_particle_moments_ = welfords_online_algorithm(produced_particles_,
-        n_th_call_, produced_particle_moments_.first,
-        produced_particle_moments_.second);
+    context.produced_particle_moments = welfords_online_algorithm(produced_particles_,
+        context.n_th_call, context.produced_particle_moments.first,
+        context.produced_particle_moments.second);
 
     return secondaries_;
 }
 
 // ------------------------------------------------------------------------- //
-void Propagator::ChooseCurrentSector(
-    const Vector3D& particle_position, const Vector3D& particle_direction)
+std::vector<Secondaries> Propagator::PropagateBatch(
+    const std::vector<DynamicData>& primaries, const BatchOptions& options) const
+{
+    unsigned int n_workers = NumberOfWorkers(options.n_threads, primaries.size());
+
+    std::vector<PhiloxStream> streams(n_workers, PhiloxStream(options.seed));
+    std::vector<PropagationContext> contexts;
+    for (auto& stream : streams)
+    {
+        contexts.emplace_back(&stream);
+    }
+
+    std::vector<Secondaries> secondaries(primaries.size());
+
+    ParallelFor(primaries.size(), n_workers, [&](unsigned int worker, size_t i) {
+        streams[worker].SetStream(options.first_stream + i);
+        secondaries[i] = Propagate(contexts[worker], primaries[i],
+            options.max_distance, options.minimal_energy);
+    });
+
+    return secondaries;
+}
+
+// ------------------------------------------------------------------------- //
+Sector* Propagator::CreateSector(
+    const Sector::Definition& sector_def, const InterpolationDef* interpolation_def) const
+{
+    for (unsigned int i = 0; i < sectors_.size(); ++i) {
+        if (sectors_[i]->GetSectorDef().HasSamePhysics(sector_def)) {
+            log_debug("Sector %u shares the tables of sector %u", static_cast<unsigned int>(sectors_.size()), i);
+            return new Sector(sector_def, *sectors_[i]);
+        }
+    }
+
+    if (interpolation_def) {
+        return new Sector(particle_def_, sector_def, *interpolation_def);
+    }
+    return new Sector(particle_def_, sector_def);
+}
+
+// ------------------------------------------------------------------------- //
+Sector* Propagator::ChooseCurrentSector(
+    const Vector3D& particle_position, const Vector3D& particle_direction) const
 {
     std::vector<int> crossed_sector;
+    Sector* current_sector = nullptr;
 
     // Get Location of the detector (Inside/Infront/Behind)
     Geometry::ParticleLocation::Enum detector_location
@@ -442,12 +492,11 @@ void Propagator::ChooseCurrentSector(
 
     // No sector was found
     if (crossed_sector.size() == 0) {
-        current_sector_ = nullptr;
         log_warn("There is no sector defined at position [%f, %f, %f] !!!",
             particle_position.GetX(), particle_position.GetY(),
             particle_position.GetZ());
     } else {
-        current_sector_ = sectors_[crossed_sector.back()];
+        current_sector = sectors_[crossed_sector.back()];
     }
 
     // Choose current sector when multiple sectors are crossed!
@@ -462,34 +511,36 @@ void Propagator::ChooseCurrentSector(
 
         // Current Hierarchy is equal -> Look at the density!
         //
-        if (current_sector_->GetSectorDef().GetGeometry()->GetHierarchy()
+        if (current_sector->GetSectorDef().GetGeometry()->GetHierarchy()
             == sectors_[*iter]->GetSectorDef().GetGeometry()->GetHierarchy()) {
             // Current Density is smaller -> Set the new sector!
             //
-            if (current_sector_->GetSectorDef().GetMedium()->GetCorrectedMassDensity(
+            if (current_sector->GetSectorDef().GetMedium()->GetCorrectedMassDensity(
                     particle_position)
                 < sectors_[*iter]->GetSectorDef().GetMedium()->GetCorrectedMassDensity(
                       particle_position))
-                current_sector_ = sectors_[*iter];
+                current_sector = sectors_[*iter];
         }
 
         // Current Hierarchy is smaller -> Set the new sector!
         //
-        if (current_sector_->GetSectorDef().GetGeometry()->GetHierarchy()
+        if (current_sector->GetSectorDef().GetGeometry()->GetHierarchy()
             < sectors_[*iter]->GetSectorDef().GetGeometry()->GetHierarchy())
-            current_sector_ = sectors_[*iter];
+            current_sector = sectors_[*iter];
     }
+
+    return current_sector;
 }
 
 // ------------------------------------------------------------------------- //
-double Propagator::CalculateEffectiveDistance(
-    const Vector3D& particle_position, const Vector3D& particle_direction)
+double Propagator::CalculateEffectiveDistance(const Sector* current_sector,
+    const Vector3D& particle_position, const Vector3D& particle_direction) const
 {
     double distance_to_sector_border = 0;
     double distance_to_detector = 0;
 
     distance_to_sector_border
-        = current_sector_->GetSectorDef().GetGeometry()
+        = current_sector->GetSectorDef().GetGeometry()
               ->DistanceToBorder(particle_position, particle_direction)
               .first;
     double tmp_distance_to_border;
@@ -497,13 +548,13 @@ double Propagator::CalculateEffectiveDistance(
     Geometry::ParticleLocation::Enum detector_location
         = detector_->GetLocation(particle_position, particle_direction);
 
-    for (std::vector<Sector*>::iterator iter = sectors_.begin();
+    for (std::vector<Sector*>::const_iterator iter = sectors_.begin();
          iter != sectors_.end(); ++iter) {
 
         if (static_cast<int>((*iter)->GetLocation())
             == static_cast<int>(detector_location)) {
             if ((*iter)->GetSectorDef().GetGeometry()->GetHierarchy()
-                >= current_sector_->GetSectorDef().GetGeometry()->GetHierarchy()) {
+                >= current_sector->GetSectorDef().GetGeometry()->GetHierarchy()) {
                 tmp_distance_to_border
                     = (*iter)
                           ->GetSectorDef().GetGeometry()
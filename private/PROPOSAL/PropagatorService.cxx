@@ -5,12 +5,14 @@
 #include "PROPOSAL/Secondaries.h"
 
 #include <memory>
+#include <utility>
 
 using namespace PROPOSAL;
 
 // ------------------------------------------------------------------------- //
 PropagatorService::PropagatorService()
     : propagator_map_()
+    , context_pool_map_()
 {
 }
 
@@ -35,6 +37,7 @@ void PropagatorService::RegisterPropagator(const Propagator& propagator)
     } else
     {
         propagator_map_[particle_def] = new Propagator(propagator);
+        context_pool_map_[particle_def] = std::unique_ptr<ContextPool>(new ContextPool());
     }
 }
 
@@ -90,6 +93,39 @@ Secondaries PropagatorService::Propagate(
     }
 }
 
+// ------------------------------------------------------------------------- //
+Secondaries PropagatorService::Propagate(
+    const ParticleDef& particle_def,
+    const DynamicData& particle_condition,
+    RandomStream& random_stream,
+    double max_distance,
+    double min_energy) const
+{
+    PropagatorMap::const_iterator it = propagator_map_.find(particle_def);
+
+    if (it == propagator_map_.end())
+    {
+        log_warn("Propagator for particle %s not found! Empty secondary vector will be returned!",
+                 particle_def.name.c_str());
+        return Secondaries();
+    }
+
+    ContextPool& pool = *context_pool_map_.at(particle_def);
+
+    // If the propagation throws, the context is dropped and the pool
+    // creates a new one on demand.
+    std::unique_ptr<PropagationContext> context = pool.Acquire();
+    context->random_stream = &random_stream;
+
+    Secondaries secondaries = it->second->Propagate(*context, particle_condition, max_distance, min_energy);
+
+    context->random_stream = nullptr;
+    pool.Release(std::move(context));
+
+    return secondaries;
+}
+
+// ------------------------------------------------------------------------- //
 Propagator* PropagatorService::GetPropagatorToParticleDef(const ParticleDef& particle_def)
 {
     PropagatorMap::iterator it = propagator_map_.find(particle_def);
@@ -105,3 +141,37 @@ Propagator* PropagatorService::GetPropagatorToParticleDef(const ParticleDef& par
         return default_propagator;
     }
 }
+
+// ------------------------------------------------------------------------- //
+// ContextPool
+// ------------------------------------------------------------------------- //
+
+PropagatorService::ContextPool::ContextPool()
+    : mutex_()
+    , contexts_()
+{
+}
+
+PropagatorService::ContextPool::~ContextPool() {}
+
+// ------------------------------------------------------------------------- //
+std::unique_ptr<PropagationContext> PropagatorService::ContextPool::Acquire()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (contexts_.empty())
+    {
+        return std::unique_ptr<PropagationContext>(new PropagationContext());
+    }
+
+    std::unique_ptr<PropagationContext> context = std::move(contexts_.back());
+    contexts_.pop_back();
+    return context;
+}
+
+// ------------------------------------------------------------------------- //
+void PropagatorService::ContextPool::Release(std::unique_ptr<PropagationContext> context)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    contexts_.push_back(std::move(context));
+}
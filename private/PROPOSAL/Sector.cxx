@@ -28,10 +28,22 @@
 #include <algorithm>
 #include <array>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 using namespace PROPOSAL;
 
+namespace {
+
+// Held while sectors without interpolation tables propagate
+std::mutex& IntegralMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+} // namespace
+
 namespace PROPOSAL {
 
 std::ostream& operator<<(std::ostream& os, Sector::Definition const& sec_definition)
@@ -196,6 +208,23 @@ bool Sector::Definition::operator!=(const Definition& sector_def) const
     return !(*this == sector_def);
 }
 
+bool Sector::Definition::HasSamePhysics(const Definition& sector_def) const
+{
+    if (do_continuous_randomization != sector_def.do_continuous_randomization)
+        return false;
+    else if (do_exact_time_calculation != sector_def.do_exact_time_calculation)
+        return false;
+    else if (scattering_model != sector_def.scattering_model)
+        return false;
+    else if (utility_def != sector_def.utility_def)
+        return false;
+    else if (cut_settings != sector_def.cut_settings)
+        return false;
+    else if (medium_ != sector_def.medium_ && *medium_ != *sector_def.medium_)
+        return false;
+    return true;
+}
+
 
 Sector::Definition::~Definition()
 {
@@ -225,8 +254,17 @@ std::ostream& operator<<(std::ostream& os, Sector const& sector)
 
     os << "Sector Definition:\n" << sector.sector_def_ << std::endl;
     os << "Particle Definition:\n" << sector.particle_def_ << std::endl;
-    os << "Propagation Utility:\n" << sector.utility_ << std::endl;
-    os << "Scattering:\n" << *sector.scattering_ << std::endl;
+    if (sector.interpolated_) {
+        os << "Interpolation Definition:\n" << sector.interpolation_def_ << std::endl;
+    }
+
+    // lazy tables are not built for printing
+    if (sector.initialized_parts_ & Sector::UtilityPart) {
+        os << "Propagation Utility:\n" << *sector.utility_ << std::endl;
+    }
+    if (sector.initialized_parts_ & Sector::ScatteringPart) {
+        os << "Scattering:\n" << *sector.scattering_ << std::endl;
+    }
 
     os << Helper::Centered(60, "");
     return os;
@@ -238,73 +276,236 @@ std::ostream& operator<<(std::ostream& os, Sector const& sector)
 // Constructors
 // ------------------------------------------------------------------------- //
 
+// The physics of sectors with lazy tables. Each part of it is built for the
+// first of the sectors sharing it using the part and copied from there to
+// the others.
+struct Sector::LazyPhysics
+{
+    LazyPhysics(const ParticleDef& particle_def, const Definition& sector_def,
+        const InterpolationDef& interpolation_def)
+        : particle_def(particle_def)
+        , sector_def(sector_def)
+        , interpolation_def(interpolation_def)
+    {
+        this->interpolation_def.do_lazy_tables = false;
+    }
+
+    // builds the missing of the given parts, the mutex has to be locked
+    void Build(unsigned int parts)
+    {
+        if (!sector) {
+            log_debug("Build the lazy tables of the sector in %s",
+                sector_def.GetMedium()->GetName().c_str());
+            sector.reset(new Sector(particle_def, sector_def, interpolation_def, parts | UtilityPart));
+        } else {
+            sector->BuildParts(parts & ~sector->initialized_parts_, interpolation_def);
+        }
+    }
+
+    ParticleDef particle_def;
+    Definition sector_def;
+    InterpolationDef interpolation_def;
+
+    std::mutex mutex;
+    std::unique_ptr<Sector> sector;
+};
+
 Sector::Sector(const ParticleDef& particle_def, const Definition& sector_def)
     : sector_def_(sector_def)
     , particle_def_(particle_def)
-    , utility_(particle_def, sector_def.GetMedium(), sector_def.cut_settings,
-          sector_def.utility_def)
-    , displacement_calculator_(new UtilityIntegralDisplacement(utility_))
-    , interaction_calculator_(new UtilityIntegralInteraction(utility_))
-    , decay_calculator_(new UtilityIntegralDecay(utility_))
+    , interpolated_(false)
+    , interpolation_def_()
+    , lazy_physics_(nullptr)
+    , utility_(new Utility(particle_def, sector_def.GetMedium(),
+          sector_def.cut_settings, sector_def.utility_def))
+    , displacement_calculator_(new UtilityIntegralDisplacement(*utility_))
+    , interaction_calculator_(new UtilityIntegralInteraction(*utility_))
+    , decay_calculator_(new UtilityIntegralDecay(*utility_))
     , exact_time_calculator_(NULL)
     , cont_rand_(NULL)
     , scattering_(ScatteringFactory::Get().CreateScattering(
-          sector_def_.scattering_model, particle_def, utility_))
+          sector_def_.scattering_model, particle_def, *utility_))
+    , initialized_parts_(AllParts)
 {
     // These are optional, therfore check NULL
     if (sector_def_.do_exact_time_calculation) {
-        exact_time_calculator_ = std::make_shared<UtilityIntegralTime>(utility_);
+        exact_time_calculator_ = std::make_shared<UtilityIntegralTime>(*utility_);
     }
 
     if (sector_def_.do_continuous_randomization) {
-        cont_rand_ = std::make_shared<ContinuousRandomizer>(utility_);
+        cont_rand_ = std::make_shared<ContinuousRandomizer>(*utility_);
     }
 }
 
 Sector::Sector(const ParticleDef& particle_def, const Definition& sector_def,
     const InterpolationDef& interpolation_def)
+    : Sector(particle_def, sector_def, interpolation_def,
+          interpolation_def.do_lazy_tables ? 0u : static_cast<unsigned int>(AllParts))
+{
+    if (interpolation_def.do_lazy_tables) {
+        lazy_physics_ = std::make_shared<LazyPhysics>(
+            particle_def, sector_def, interpolation_def);
+    }
+}
+
+Sector::Sector(const ParticleDef& particle_def, const Definition& sector_def,
+    const InterpolationDef& interpolation_def, unsigned int parts)
     : sector_def_(sector_def)
     , particle_def_(particle_def)
-    , utility_(particle_def, sector_def.GetMedium(), sector_def.cut_settings,
-          sector_def.utility_def, interpolation_def)
-    , displacement_calculator_(
-          new UtilityInterpolantDisplacement(utility_, interpolation_def))
-    , interaction_calculator_(
-          new UtilityInterpolantInteraction(utility_, interpolation_def))
-    , decay_calculator_(
-          new UtilityInterpolantDecay(utility_, interpolation_def))
+    , interpolated_(true)
+    , interpolation_def_(interpolation_def)
+    , lazy_physics_(nullptr)
+    , utility_(nullptr)
+    , displacement_calculator_(NULL)
+    , interaction_calculator_(NULL)
+    , decay_calculator_(NULL)
     , exact_time_calculator_(NULL)
     , cont_rand_(NULL)
-    , scattering_(ScatteringFactory::Get().CreateScattering(
-          sector_def_.scattering_model, particle_def, utility_,
-          interpolation_def))
+    , scattering_(NULL)
+    , initialized_parts_(0)
+{
+    if (parts == 0) {
+        return;
+    }
+
+    utility_.reset(new Utility(particle_def, sector_def.GetMedium(),
+        sector_def.cut_settings, sector_def.utility_def, interpolation_def));
+    initialized_parts_ = UtilityPart;
+
+    BuildParts(parts & ~UtilityPart, interpolation_def);
+}
+
+void Sector::BuildParts(unsigned int parts, const InterpolationDef& interpolation_def) const
 {
+    // The tables of the calculators only depend on the cross sections, so
+    // they are built at the same time
+    std::vector<Helper::TableTask> tasks;
+    if (parts & DisplacementPart) {
+        tasks.push_back([this](const InterpolationDef& share) {
+            displacement_calculator_ = std::make_shared<UtilityInterpolantDisplacement>(*utility_, share);
+        });
+    }
+    if (parts & InteractionPart) {
+        tasks.push_back([this](const InterpolationDef& share) {
+            interaction_calculator_ = std::make_shared<UtilityInterpolantInteraction>(*utility_, share);
+        });
+    }
+    if (parts & DecayPart) {
+        tasks.push_back([this](const InterpolationDef& share) {
+            decay_calculator_ = std::make_shared<UtilityInterpolantDecay>(*utility_, share);
+        });
+    }
+    if (parts & ScatteringPart) {
+        tasks.push_back([this](const InterpolationDef& share) {
+            scattering_.reset(ScatteringFactory::Get().CreateScattering(
+                sector_def_.scattering_model, particle_def_, *utility_, share));
+        });
+    }
+
     // These are optional, therfore check NULL
-    if (sector_def_.do_exact_time_calculation) {
-        exact_time_calculator_ = std::make_shared<UtilityInterpolantTime>(utility_, interpolation_def);
+    if ((parts & ExactTimePart) && sector_def_.do_exact_time_calculation) {
+        tasks.push_back([this](const InterpolationDef& share) {
+            exact_time_calculator_ = std::make_shared<UtilityInterpolantTime>(*utility_, share);
+        });
     }
 
-    if (sector_def_.do_continuous_randomization) {
-        cont_rand_ = std::make_shared<ContinuousRandomizer>(utility_, interpolation_def);
+    if ((parts & ContRandPart) && sector_def_.do_continuous_randomization) {
+        tasks.push_back([this](const InterpolationDef& share) {
+            cont_rand_ = std::make_shared<ContinuousRandomizer>(*utility_, share);
+        });
     }
+
+    Helper::InitializeInParallel(tasks, interpolation_def);
+
+    initialized_parts_ |= parts;
 }
 
 Sector::Sector(const Sector& sector)
     : sector_def_(sector.sector_def_)
     , particle_def_(sector.particle_def_)
-    , utility_(sector.utility_)
-    , displacement_calculator_(sector.displacement_calculator_->clone(utility_))
-    , interaction_calculator_(sector.interaction_calculator_->clone(utility_))
-    , decay_calculator_(sector.decay_calculator_->clone(utility_))
-    , exact_time_calculator_(NULL)
-    , cont_rand_(sector.cont_rand_)
-    , scattering_(sector.scattering_)
+    , interpolated_(sector.interpolated_)
+    , interpolation_def_(sector.interpolation_def_)
+    , lazy_physics_(sector.lazy_physics_)
+    , initialized_parts_(0)
 {
-    // These are optional, therfore check NULL
-    if (sector.exact_time_calculator_ != NULL) {
+    // The copy of a lazy sector stays lazy
+    if (!lazy_physics_) {
+        CopyPhysics(sector);
+    }
+}
+
+Sector::Sector(const Definition& sector_def, const Sector& sector)
+    : sector_def_(sector_def)
+    , particle_def_(sector.particle_def_)
+    , interpolated_(sector.interpolated_)
+    , interpolation_def_(sector.interpolation_def_)
+    , lazy_physics_(sector.lazy_physics_)
+    , initialized_parts_(0)
+{
+    if (!sector_def.HasSamePhysics(sector.sector_def_)) {
+        log_fatal("The sector definition does not match the physics of the "
+                  "sector to share!");
+    }
+
+    if (!lazy_physics_) {
+        CopyPhysics(sector);
+    }
+}
+
+void Sector::CopyPhysics(const Sector& sector, unsigned int parts) const
+{
+    if (parts & UtilityPart) {
+        utility_.reset(new Utility(*sector.utility_));
+    }
+    if (parts & DisplacementPart) {
+        displacement_calculator_.reset(sector.displacement_calculator_->clone(*utility_));
+    }
+    if (parts & InteractionPart) {
+        interaction_calculator_.reset(sector.interaction_calculator_->clone(*utility_));
+    }
+    if (parts & DecayPart) {
+        decay_calculator_.reset(sector.decay_calculator_->clone(*utility_));
+    }
+    if (parts & ExactTimePart) {
         exact_time_calculator_ = sector.exact_time_calculator_;
     }
+    if (parts & ContRandPart) {
+        cont_rand_ = sector.cont_rand_;
+    }
+    if (parts & ScatteringPart) {
+        scattering_ = sector.scattering_;
+    }
+
+    initialized_parts_ |= parts;
+}
+
+void Sector::Initialize() const
+{
+    InitializeParts(AllParts);
+}
+
+void Sector::InitializeParts(unsigned int parts) const
+{
+    if ((initialized_parts_ & parts) == parts) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(initialize_mutex_);
+    unsigned int missing = parts & ~initialized_parts_;
+    if (missing == 0) {
+        return;
+    }
 
+    // the other parts refer to the utility
+    if (!(initialized_parts_ & UtilityPart)) {
+        missing |= UtilityPart;
+    }
+
+    // Sectors sharing the physics wait for the first one building a part
+    std::lock_guard<std::mutex> physics_lock(lazy_physics_->mutex);
+    lazy_physics_->Build(missing);
+
+    CopyPhysics(*lazy_physics_->sector, missing);
 }
 
 bool Sector::operator==(const Sector& sector) const
@@ -313,11 +514,9 @@ bool Sector::operator==(const Sector& sector) const
         return false;
     else if (particle_def_ != sector.particle_def_)
         return false;
-    else if (utility_ != sector.utility_)
+    else if (interpolated_ != sector.interpolated_)
         return false;
-    else if (*cont_rand_ != *sector.cont_rand_)
-        return false;
-    else if (*scattering_ != *sector.scattering_)
+    else if (interpolated_ && !interpolation_def_.HasSameTables(sector.interpolation_def_))
         return false;
     return true;
 }
@@ -339,13 +538,15 @@ Sector::~Sector()
 double Sector::CalculateTime(const DynamicData& p_condition,
     const double final_energy, const double displacement)
 {
+    InitializeParts(ExactTimePart);
+
     if (exact_time_calculator_) {
         // DensityDistribution Approximation: Use the DensityDistribution at the
         // position of initial energy
         return p_condition.GetTime()
             + exact_time_calculator_->Calculate(
                   p_condition.GetEnergy(), final_energy, 0.0)
-            / utility_.GetMedium()->GetDensityDistribution().Evaluate(
+            / utility_->GetMedium()->GetDensityDistribution().Evaluate(
                   p_condition.GetPosition());
     }
 
@@ -355,6 +556,8 @@ double Sector::CalculateTime(const DynamicData& p_condition,
 void Sector::Scatter(const double displacement, const double initial_energy,
     const double final_energy, Vector3D& position, Vector3D& direction)
 {
+    InitializeParts(ScatteringPart);
+
     if (sector_def_.scattering_model != ScatteringFactory::Enum::NoScattering) {
         Directions directions = scattering_->Scatter(
             displacement, initial_energy, final_energy, position, direction);
@@ -368,6 +571,8 @@ void Sector::Scatter(const double displacement, const double initial_energy,
 double Sector::ContinuousRandomize(
     const double initial_energy, const double final_energy)
 {
+    InitializeParts(ContRandPart);
+
     if (cont_rand_) {
         if (final_energy != particle_def_.low) {
             double rnd = RandomGenerator::Get().RandomDouble();
@@ -379,6 +584,8 @@ double Sector::ContinuousRandomize(
 
 std::pair<double, int> Sector::MakeStochasticLoss(double particle_energy)
 {
+    InitializeParts(UtilityPart);
+
     double rnd1 = RandomGenerator::Get().RandomDouble();
     double rnd2 = RandomGenerator::Get().RandomDouble();
     double rnd3 = RandomGenerator::Get().RandomDouble();
@@ -396,7 +603,7 @@ std::pair<double, int> Sector::MakeStochasticLoss(double particle_energy)
         }
     }
 
-    energy_loss = utility_.StochasticLoss(particle_energy, rnd1, rnd2, rnd3);
+    energy_loss = utility_->StochasticLoss(particle_energy, rnd1, rnd2, rnd3);
 
     return energy_loss;
 }
@@ -404,6 +611,8 @@ std::pair<double, int> Sector::MakeStochasticLoss(double particle_energy)
 double Sector::Displacement(const DynamicData& p_condition,
     const double final_energy, const double border_length)
 {
+    InitializeParts(DisplacementPart);
+
     try{
         return displacement_calculator_->Calculate(p_condition.GetEnergy(),
         final_energy, border_length, p_condition.GetPosition(),
@@ -437,6 +646,8 @@ double Sector::EnergyDecay(const double initial_energy, const double rnd)
         return particle_def_.low;
     }
 
+    InitializeParts(DecayPart);
+
     rnddMin
         = decay_calculator_->Calculate(initial_energy, particle_def_.low, rndd);
 
@@ -450,6 +661,8 @@ double Sector::EnergyDecay(const double initial_energy, const double rnd)
 
 double Sector::EnergyInteraction(const double initial_energy, const double rnd)
 {
+    InitializeParts(InteractionPart);
+
     double rndi = -std::log(rnd);
     double rndiMin = 0;
 
@@ -472,6 +685,8 @@ double Sector::EnergyMinimal(const double current_energy, const double cut)
 double Sector::EnergyDistance(
     const double initial_energy, const double distance)
 {
+    InitializeParts(DisplacementPart);
+
     return displacement_calculator_->GetUpperLimit(initial_energy, distance);
 }
 
@@ -494,11 +709,13 @@ int Sector::maximizeEnergy(const std::array<double, 4>& LossEnergies)
 std::shared_ptr<DynamicData> Sector::DoInteraction(
     const DynamicData& p_condition)
 {
+    InitializeParts(UtilityPart);
+
     std::pair<double, int> stochastic_loss
         = MakeStochasticLoss(p_condition.GetEnergy());
 
     CrossSection* cross_section
-        = utility_.GetCrosssection(stochastic_loss.second);
+        = utility_->GetCrosssection(stochastic_loss.second);
     std::pair<double, double> deflection_angles
         = cross_section->StochasticDeflection(
             p_condition.GetEnergy(), stochastic_loss.first);
@@ -551,6 +768,11 @@ std::shared_ptr<DynamicData> Sector::DoContinuous(
 Secondaries Sector::Propagate(
     const DynamicData& p_initial, double border_distance, const double minimal_energy)
 {
+    std::unique_lock<std::mutex> integral_lock;
+    if (!interpolated_) {
+        integral_lock = std::unique_lock<std::mutex>(IntegralMutex());
+    }
+
     Secondaries secondaries(std::make_shared<ParticleDef>(particle_def_));
 
     auto p_condition = std::make_shared<DynamicData>(p_initial);
@@ -627,3 +849,11 @@ Secondaries Sector::Propagate(
 
     return secondaries;
 }
+
+Secondaries Sector::Propagate(const DynamicData& p_initial,
+    double border_distance, const double minimal_energy, RandomStream& random_stream)
+{
+    RandomGenerator::StreamScope random_scope(&random_stream);
+
+    return Propagate(p_initial, border_distance, minimal_energy);
+}
@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+
+#include "PROPOSAL/Propagator.h"
+#include "PROPOSAL/TableAudit.h"
+#include "PROPOSAL/crossection/CrossSectionInterpolant.h"
+#include "PROPOSAL/crossection/parametrization/Parametrization.h"
+#include "PROPOSAL/math/Interpolant.h"
+#include "PROPOSAL/math/RandomStream.h"
+#include "PROPOSAL/medium/Medium.h"
+#include "PROPOSAL/propagation_utility/PropagationUtilityIntegral.h"
+#include "PROPOSAL/propagation_utility/PropagationUtilityInterpolant.h"
+
+using namespace PROPOSAL;
+
+namespace {
+
+struct Point
+{
+    double energy;
+    double final_energy;
+    double v;
+    int component;
+};
+
+typedef std::function<double(const Point&)> Quantity;
+typedef std::vector<std::shared_ptr<const Interpolant> > Tables;
+
+// Energy range of a table, the energies are drawn logarithmically from it.
+// The energy of a 2d table is the x of its rows.
+void EnergyRange(const Interpolant& table, double& low, double& high)
+{
+    std::vector<Interpolant*> rows = table.GetInterpolant();
+
+    if (!rows.empty())
+    {
+        EnergyRange(*rows.front(), low, high);
+        return;
+    }
+
+    low  = table.GetXmin();
+    high = table.GetXmax();
+
+    if (table.GetIsLog())
+    {
+        low  = std::exp(low);
+        high = std::exp(high);
+    }
+}
+
+// A quantity is only audited if there is a table for every component
+bool Complete(const Tables& tables)
+{
+    return !tables.empty() && std::find(tables.begin(), tables.end(), nullptr) == tables.end();
+}
+
+double LogUniform(double low, double high, RandomStream& random)
+{
+    return low * std::exp(random.RandomDouble() * std::log(high / low));
+}
+
+std::vector<Point> EnergyPoints(const Interpolant& table, int points, RandomStream& random)
+{
+    double low, high;
+    EnergyRange(table, low, high);
+
+    std::vector<Point> result(points);
+
+    for (int i = 0; i < points; ++i)
+    {
+        result[i].energy       = LogUniform(low, high, random);
+        result[i].final_energy = LogUniform(low, result[i].energy, random);
+        result[i].v            = 0;
+        result[i].component    = 0;
+    }
+
+    return result;
+}
+
+TableAudit Compare(const std::string& sector,
+                   const std::string& table,
+                   const Tables& tables,
+                   const std::vector<Point>& points,
+                   const Quantity& interpolated,
+                   const Quantity& integrated)
+{
+    TableAudit audit;
+
+    audit.sector = sector;
+    audit.table  = table;
+    audit.points = points.size();
+
+    for (Tables::const_iterator it = tables.begin(); it != tables.end(); ++it)
+    {
+        if (*it)
+        {
+            audit.nodes += (*it)->GetNodes();
+            audit.bytes += (*it)->GetMemorySize();
+        }
+    }
+
+    if (points.empty())
+    {
+        return audit;
+    }
+
+    // The evaluations are repeated until they can be timed
+    std::vector<double> values(points.size());
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed;
+    long evaluations = 0;
+
+    do
+    {
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            values[i] = interpolated(points[i]);
+        }
+
+        evaluations += points.size();
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 1e-3);
+
+    audit.ns = 1e9 * elapsed.count() / evaluations;
+
+    // Close to a threshold the quantities vanish and only the absolute
+    // accuracy of the tables is meaningful, so values below a thousandth of
+    // the largest reference are compared to that fraction instead
+    std::vector<double> references(points.size());
+    double floor = 0;
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        references[i] = integrated(points[i]);
+        floor         = std::max(floor, 1e-3 * std::abs(references[i]));
+    }
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        double reference = references[i];
+        double scale     = std::max(std::max(std::abs(reference), std::abs(values[i])), floor);
+        double error     = scale > 0 ? std::abs(values[i] - reference) / scale : 0;
+
+        if (!(error <= audit.max_error))
+        {
+            audit.max_error    = error;
+            audit.worst_energy = points[i].energy;
+        }
+    }
+
+    return audit;
+}
+
+void AuditCrossSection(const std::string& sector,
+                       CrossSectionInterpolant& interpolant,
+                       CrossSection& integral,
+                       int points,
+                       RandomStream& random,
+                       std::vector<TableAudit>& audits)
+{
+    Parametrization& parametrization = interpolant.GetParametrization();
+    const std::string& name          = parametrization.GetName();
+
+    // Weak interaction, photo pair production and annihilation have no
+    // continuous losses and therefore neither dEdx nor dE2dx tables
+    if (interpolant.GetdEdxInterpolant())
+    {
+        audits.push_back(Compare(sector,
+                                 name + " dEdx",
+                                 Tables(1, interpolant.GetdEdxInterpolant()),
+                                 EnergyPoints(*interpolant.GetdEdxInterpolant(), points, random),
+                                 [&](const Point& p) { return interpolant.CalculatedEdx(p.energy); },
+                                 [&](const Point& p) { return integral.CalculatedEdx(p.energy); }));
+    }
+
+    if (interpolant.GetdE2dxInterpolant())
+    {
+        audits.push_back(Compare(sector,
+                                 name + " dE2dx",
+                                 Tables(1, interpolant.GetdE2dxInterpolant()),
+                                 EnergyPoints(*interpolant.GetdE2dxInterpolant(), points, random),
+                                 [&](const Point& p) { return interpolant.CalculatedE2dx(p.energy); },
+                                 [&](const Point& p) { return integral.CalculatedE2dx(p.energy); }));
+    }
+
+    const Tables& dndx = interpolant.GetdNdxInterpolants1D();
+    const Tables& cumulative = interpolant.GetdNdxInterpolants2D();
+
+    if (Complete(dndx))
+    {
+        audits.push_back(Compare(sector,
+                                 name + " dNdx",
+                                 dndx,
+                                 EnergyPoints(*dndx.front(), points, random),
+                                 [&](const Point& p) { return interpolant.CalculatedNdx(p.energy); },
+                                 [&](const Point& p) { return integral.CalculatedNdx(p.energy); }));
+    }
+
+    if (!Complete(cumulative))
+    {
+        return;
+    }
+
+    // The cumulative dNdx is compared at a random component and a random
+    // relative energy loss between the limits of the integral. Points
+    // without an allowed energy loss are left out.
+    std::vector<Point> losses;
+
+    for (int i = 0; i < points; ++i)
+    {
+        Point p;
+        double low, high;
+
+        p.component = std::min<int>(random.RandomDouble() * cumulative.size(), cumulative.size() - 1);
+        EnergyRange(*cumulative[p.component], low, high);
+        p.energy       = LogUniform(low, high, random);
+        p.final_energy = p.energy;
+
+        Parametrization::IntegralLimits limits = parametrization.GetIntegralLimits(p.energy, p.component);
+
+        if (limits.vUp > 0 && limits.vUp < limits.vMax)
+        {
+            p.v = LogUniform(limits.vUp, limits.vMax, random);
+            losses.push_back(p);
+        }
+    }
+
+    audits.push_back(Compare(sector,
+                             name + " dNdx cumulative",
+                             cumulative,
+                             losses,
+                             [&](const Point& p) { return interpolant.CalculateCumulativeCrossSection(p.energy, p.component, p.v); },
+                             [&](const Point& p) { return integral.CalculateCumulativeCrossSection(p.energy, p.component, p.v); }));
+}
+
+void AuditUtility(const std::string& sector,
+                  const std::string& name,
+                  UtilityDecorator* decorator,
+                  UtilityDecorator& integral,
+                  bool to_lowest_energy,
+                  int points,
+                  RandomStream& random,
+                  std::vector<TableAudit>& audits)
+{
+    UtilityInterpolant* interpolant = dynamic_cast<UtilityInterpolant*>(decorator);
+
+    if (!interpolant)
+    {
+        return;
+    }
+
+    Tables tables;
+    tables.push_back(interpolant->GetInterpolant());
+    tables.push_back(interpolant->GetInterpolantDiff());
+
+    // The interaction and decay tables hold the integral down to the lowest
+    // energy of the particle, which is the quantity used while propagating
+    double low = integral.GetUtility().GetParticleDef().low;
+
+    std::vector<Point> energies = EnergyPoints(*tables.front(), points, random);
+
+    if (to_lowest_energy)
+    {
+        for (size_t i = 0; i < energies.size(); ++i)
+        {
+            energies[i].final_energy = low;
+        }
+    }
+
+    audits.push_back(Compare(sector,
+                             name,
+                             tables,
+                             energies,
+                             [&](const Point& p) { return interpolant->Calculate(p.energy, p.final_energy, 0); },
+                             [&](const Point& p) { return integral.Calculate(p.energy, p.final_energy, 0); }));
+}
+
+} // namespace
+
+TableAudit::TableAudit()
+    : sector()
+    , table()
+    , max_error(0)
+    , worst_energy(0)
+    , points(0)
+    , nodes(0)
+    , bytes(0)
+    , ns(0)
+{
+}
+
+std::vector<TableAudit> PROPOSAL::AuditTables(const Propagator& propagator, int points, uint64_t seed)
+{
+    std::vector<TableAudit> audits;
+    PhiloxStream random(seed);
+
+    const std::vector<Sector*> sectors = propagator.GetSectors();
+
+    for (size_t s = 0; s < sectors.size(); ++s)
+    {
+        const Sector& sector            = *sectors[s];
+        const Sector::Definition& def   = sector.GetSectorDef();
+        std::string name                = std::to_string(s) + " " + def.GetMedium()->GetName();
+
+        // The same quantities as calculated without an InterpolationDef
+        Utility integral(sector.GetParticleDef(), def.GetMedium(), def.cut_settings, def.utility_def);
+
+        const std::vector<CrossSection*>& crosssections = sector.GetUtility().GetCrosssections();
+        const std::vector<CrossSection*>& references    = integral.GetCrosssections();
+
+        for (size_t i = 0; i < crosssections.size() && i < references.size(); ++i)
+        {
+            CrossSectionInterpolant* interpolant = dynamic_cast<CrossSectionInterpolant*>(crosssections[i]);
+
+            if (interpolant && crosssections[i]->GetTypeId() == references[i]->GetTypeId())
+            {
+                AuditCrossSection(name, *interpolant, *references[i], points, random, audits);
+            }
+        }
+
+        UtilityIntegralDisplacement displacement(integral);
+        UtilityIntegralInteraction interaction(integral);
+        UtilityIntegralDecay decay(integral);
+        UtilityIntegralTime time(integral);
+
+        AuditUtility(name, "displacement", sector.GetDisplacementCalculator().get(), displacement, false, points, random, audits);
+        AuditUtility(name, "interaction", sector.GetInteractionCalculator().get(), interaction, true, points, random, audits);
+        AuditUtility(name, "decay", sector.GetDecayCalculator().get(), decay, true, points, random, audits);
+        AuditUtility(name, "time", sector.GetExactTimeCalculator().get(), time, false, points, random, audits);
+    }
+
+    return audits;
+}
+
+void PROPOSAL::PrintTableAudit(std::ostream& os, const std::vector<TableAudit>& audits)
+{
+    std::ios::fmtflags flags   = os.flags();
+    std::streamsize precision = os.precision();
+
+    os << std::left << std::setw(24) << "sector" << std::setw(44) << "table" << std::right << std::setw(8) << "points"
+       << std::setw(8) << "nodes" << std::setw(10) << "bytes" << std::setw(10) << "ns" << std::setw(12) << "max error"
+       << std::setw(12) << "at energy" << '\n';
+
+    for (std::vector<TableAudit>::const_iterator it = audits.begin(); it != audits.end(); ++it)
+    {
+        os << std::left << std::setw(24) << it->sector << std::setw(44) << it->table << std::right << std::setw(8)
+           << it->points << std::setw(8) << it->nodes << std::setw(10) << it->bytes << std::fixed
+           << std::setprecision(1) << std::setw(10) << it->ns << std::scientific << std::setprecision(2)
+           << std::setw(12) << it->max_error << std::setw(12) << it->worst_energy << '\n';
+
+        os.unsetf(std::ios::floatfield);
+    }
+
+    os.flags(flags);
+    os.precision(precision);
+}
@@ -17,14 +17,15 @@
 using namespace PROPOSAL;
 
 AnnihilationInterpolant::AnnihilationInterpolant(const Annihilation& param, InterpolationDef def)
-        : CrossSectionInterpolant(InteractionType::Particle, param), rndc_(-1.) {
+        : CrossSectionInterpolant(InteractionType::Particle, param) {
     // Use parent CrossSecition dNdx interpolation
     InitdNdxInterpolation(def);
+    InitChebyshevSeries(def);
     gamma_def_ = &GammaDef::Get();
 }
 
 AnnihilationInterpolant::AnnihilationInterpolant(const AnnihilationInterpolant& annihilation)
-        : CrossSectionInterpolant(annihilation), rndc_(annihilation.rndc_), gamma_def_(annihilation.gamma_def_)
+        : CrossSectionInterpolant(annihilation), gamma_def_(annihilation.gamma_def_)
 {
 }
 
@@ -55,43 +56,57 @@ bool AnnihilationInterpolant::compare(const CrossSection& cross_section) const
 }
 
 double AnnihilationInterpolant::CalculateStochasticLoss(double energy, double rnd1, double rnd2) {
-    if(rnd1 != rnd_){
-        CalculatedNdx(energy, rnd1);
-    }
-    rndc_ = rnd2; // save random number for component sampling
+    // The produced particles are sampled from the same random numbers, see
+    // CalculateProducedParticles
+    (void)rnd1;
+    (void)rnd2;
+
     return energy; // losses are always catastrophic
 }
 
 std::pair<std::vector<DynamicData>, bool> AnnihilationInterpolant::CalculateProducedParticles(double energy,
                                                                                             double energy_loss,
                                                                                             const Vector3D& initial_direction) {
+    // Without the random numbers of the interaction, new ones are sampled
+    double rnd1 = RandomGenerator::Get().RandomDouble();
+    double rnd2 = RandomGenerator::Get().RandomDouble();
+
+    return CalculateProducedParticles(energy, energy_loss, initial_direction, rnd1, rnd2);
+}
+
+std::pair<std::vector<DynamicData>, bool> AnnihilationInterpolant::CalculateProducedParticles(double energy,
+                                                                                            double energy_loss,
+                                                                                            const Vector3D& initial_direction,
+                                                                                            double rnd1,
+                                                                                            double rnd2) {
     (void)energy_loss;
     double rnd, rsum, rho;
 
     std::vector<DynamicData> particle_list{};
 
-    if(rndc_<0){
-        //CalculateStochasticLoss has never been called before, return empty list
-        //TODO: find a better way of checking the random numbers
-        log_warn("CalculateProducedParticles has been called with no call of CalculateStochasticLoss for PhotoPairProduction");
-        return std::make_pair(particle_list, true);
-    }
-
     particle_list.push_back(DynamicData(gamma_def_->particle_type));
     particle_list.push_back(DynamicData(gamma_def_->particle_type));
 
-    rnd  = rndc_ * sum_of_rates_;
+    // the component is sampled with rnd2 as in CalculateStochasticLoss
+    std::vector<double> rates(components_.size());
+    double sum_of_rates = 0;
+    for (size_t i = 0; i < components_.size(); ++i)
+    {
+        rates[i] = std::max(dndx_interpolant_1d_[i]->Interpolate(energy), 0.);
+        sum_of_rates += rates[i];
+    }
+
+    rnd  = rnd2 * sum_of_rates;
     rsum = 0;
 
     for (size_t i = 0; i < components_.size(); ++i)
     {
-        rsum += prob_for_component_[i];
+        rsum += rates[i];
 
         if (rsum > rnd)
         {
-            parametrization_->SetCurrentComponent(i);
-            Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy);
-            rho = (limits.vUp * std::exp(dndx_interpolant_2d_.at(i)->FindLimit(energy, rnd_ * prob_for_component_[i]) *
+            Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy, i);
+            rho = (limits.vUp * std::exp(FinddNdxLimit(energy, i, rnd1, rnd1 * rates[i]) *
                                          std::log(limits.vMax / limits.vUp)));
 
             // The available energy is the positron energy plus the mass of the electron
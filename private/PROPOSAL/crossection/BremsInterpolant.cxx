@@ -16,9 +16,6 @@ using namespace PROPOSAL;
 BremsInterpolant::BremsInterpolant(const Bremsstrahlung& param, InterpolationDef def)
     : CrossSectionInterpolant(InteractionType::Brems, param)
 {
-    // Use parent CrossSecition dNdx interpolation
-    InitdNdxInterpolation(def);
-
     // --------------------------------------------------------------------- //
     // Builder for DEdx
     // --------------------------------------------------------------------- //
@@ -51,6 +48,8 @@ BremsInterpolant::BremsInterpolant(const Bremsstrahlung& param, InterpolationDef
     Interpolant1DBuilder builder_de2dx;
     Helper::InterpolantBuilderContainer builder_container_de2dx;
 
+    BremsIntegral brems_de2dx(param);
+
     builder_de2dx.SetMax(def.nodes_continous_randomization)
         .SetXMin(param.GetParticleDef().mass)
         .SetXMax(def.max_node_energy)
@@ -62,13 +61,11 @@ BremsInterpolant::BremsInterpolant(const Bremsstrahlung& param, InterpolationDef
         .SetRationalY(false)
         .SetRelativeY(false)
         .SetLogSubst(false)
-        .SetFunction1D(std::bind(&CrossSectionIntegral::CalculatedE2dxWithoutMultiplier, &brems, std::placeholders::_1));
+        .SetFunction1D(std::bind(&CrossSectionIntegral::CalculatedE2dxWithoutMultiplier, &brems_de2dx, std::placeholders::_1));
 
     builder_container_de2dx.push_back(std::make_pair(&builder_de2dx, &de2dx_interpolant_));
 
-    Helper::InitializeInterpolation("dEdx", builder_container, std::vector<Parametrization*>(1, parametrization_), def);
-    Helper::InitializeInterpolation(
-        "dE2dx", builder_container_de2dx, std::vector<Parametrization*>(1, parametrization_), def);
+    InitTables(def, builder_container, builder_container_de2dx);
 }
 
 BremsInterpolant::BremsInterpolant(const BremsInterpolant& brems)
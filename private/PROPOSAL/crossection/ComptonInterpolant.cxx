@@ -19,9 +19,6 @@ using namespace PROPOSAL;
 ComptonInterpolant::ComptonInterpolant(const Compton& param, InterpolationDef def)
         : CrossSectionInterpolant(InteractionType::Compton, param)
 {
-    // Use own CrossSecition dNdx interpolation
-    ComptonInterpolant::InitdNdxInterpolation(def);
-
     // --------------------------------------------------------------------- //
     // Builder for DEdx
     // --------------------------------------------------------------------- //
@@ -54,6 +51,8 @@ ComptonInterpolant::ComptonInterpolant(const Compton& param, InterpolationDef de
     Interpolant1DBuilder builder_de2dx;
     Helper::InterpolantBuilderContainer builder_container_de2dx;
 
+    ComptonIntegral compton_de2dx(param);
+
     builder_de2dx.SetMax(def.nodes_continous_randomization)
             .SetXMin(param.GetParticleDef().low)
             .SetXMax(def.max_node_energy)
@@ -65,13 +64,11 @@ ComptonInterpolant::ComptonInterpolant(const Compton& param, InterpolationDef de
             .SetRationalY(false)
             .SetRelativeY(false)
             .SetLogSubst(false)
-            .SetFunction1D(std::bind(&CrossSectionIntegral::CalculatedE2dxWithoutMultiplier, &compton, std::placeholders::_1));
+            .SetFunction1D(std::bind(&CrossSectionIntegral::CalculatedE2dxWithoutMultiplier, &compton_de2dx, std::placeholders::_1));
 
     builder_container_de2dx.push_back(std::make_pair(&builder_de2dx, &de2dx_interpolant_));
 
-    Helper::InitializeInterpolation("dEdx", builder_container, std::vector<Parametrization*>(1, parametrization_), def);
-    Helper::InitializeInterpolation(
-            "dE2dx", builder_container_de2dx, std::vector<Parametrization*>(1, parametrization_), def);
+    InitTables(def, builder_container, builder_container_de2dx);
 }
 
 ComptonInterpolant::ComptonInterpolant(const ComptonInterpolant& compton)
@@ -99,11 +96,12 @@ double ComptonInterpolant::CalculatedEdx(double energy)
 //----------------------------------------------------------------------------//
 double ComptonInterpolant::FunctionToBuildDNdxInterpolant2D(double energy,
                                                                  double v,
+                                                                 Parametrization& parametrization,
                                                                  Integral& integral,
-                                                                 int component)
+                                                                 int component) const
 {
-    parametrization_->SetCurrentComponent(component);
-    Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy);
+    parametrization.SetCurrentComponent(component);
+    Parametrization::IntegralLimits limits = parametrization.GetIntegralLimits(energy);
 
     if (limits.vUp == limits.vMax)
     {
@@ -114,7 +112,7 @@ double ComptonInterpolant::FunctionToBuildDNdxInterpolant2D(double energy,
 
     // Integrate with the substitution t = ln(1-v) to avoid numerical problems
     auto integrand_substitution = [&](double energy, double t){
-        return std::exp(t) * parametrization_->FunctionToDNdxIntegral(energy, 1 - std::exp(t));
+        return std::exp(t) * parametrization.FunctionToDNdxIntegral(energy, 1 - std::exp(t));
     };
 
     double t_min = std::log(1. - v);
@@ -130,8 +128,7 @@ double ComptonInterpolant::FunctionToBuildDNdxInterpolant2D(double energy,
 
 double ComptonInterpolant::CalculateCumulativeCrossSection(double energy, int component, double v)
 {
-    parametrization_->SetCurrentComponent(component);
-    Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy);
+    Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy, component);
 
     v = (v - limits.vUp) / (limits.vMax - limits.vUp);
 
@@ -150,50 +147,17 @@ std::pair<double, double> ComptonInterpolant::StochasticDeflection(double energy
 // ------------------------------------------------------------------------- //
 
 // ------------------------------------------------------------------------- //
-double ComptonInterpolant::CalculateStochasticLoss(double energy, double rnd1)
+double ComptonInterpolant::CalculateStochasticLossOfComponent(double energy, int component, double rnd, double rate)
 {
+    Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy, component);
 
-    double rnd;
-    double rsum;
-
-    rnd  = rnd1 * sum_of_rates_;
-    rsum = 0;
-
-    for (size_t i = 0; i < components_.size(); ++i)
-    {
-        rsum += prob_for_component_[i];
-
-        if (rsum > rnd)
-        {
-            parametrization_->SetCurrentComponent(i);
-            Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy);
-
-            if (limits.vUp == limits.vMax)
-            {
-                return energy * limits.vUp;
-            }
-
-            // Linear interpolation in v
-            return energy * ( limits.vUp + (limits.vMax - limits.vMin) * dndx_interpolant_2d_.at(i)->FindLimit(energy, rnd_ * prob_for_component_[i]) );
-        }
-    }
-
-    // sometime everything is fine, just the probability for interaction is zero
-    bool prob_for_all_comp_is_zero = true;
-    for (size_t i = 0; i < components_.size(); ++i)
+    if (limits.vUp == limits.vMax)
     {
-        parametrization_->SetCurrentComponent(i);
-        Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy);
-
-        if (limits.vUp != limits.vMax)
-            prob_for_all_comp_is_zero = false;
+        return energy * limits.vUp;
     }
 
-    if (prob_for_all_comp_is_zero)
-        return 0;
-
-    log_fatal("sum was not initialized correctly");
-    return 0; // just to prevent warnings
+    // Linear interpolation in v
+    return energy * ( limits.vUp + (limits.vMax - limits.vMin) * FinddNdxLimit(energy, component, rnd, rate) );
 }
 
 // ------------------------------------------------------------------------- //
@@ -210,8 +174,6 @@ void ComptonInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
     Helper::InterpolantBuilderContainer builder_container2d(components_.size());
     Helper::InterpolantBuilderContainer builder_return;
 
-    Integral integral(IROMB, IMAXS, IPREC);
-
     for (unsigned int i = 0; i < components_.size(); ++i)
     {
         // !!! IMPORTANT !!!
@@ -236,13 +198,7 @@ void ComptonInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
                 .SetRationalY(true)
                 .SetRelativeY(false)
                 .SetLogSubst(false)
-                .SetFunction2D(std::bind(
-                        &CrossSectionInterpolant::FunctionToBuildDNdxInterpolant2D,
-                        this,
-                        std::placeholders::_1,
-                        std::placeholders::_2,
-                        std::ref(integral),
-                        i));
+                .SetFunction2DFactory(DNdxInterpolant2DFactory(i));
 
         builder_container2d[i].first  = &builder2d[i];
         builder_container2d[i].second = &dndx_interpolant_2d_[i];
@@ -270,4 +226,6 @@ void ComptonInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
     // builder2d.insert(builder2d.end(), builder1d.begin(), builder1d.end());
 
     Helper::InitializeInterpolation("dNdx", builder_return, std::vector<Parametrization*>(1, parametrization_), def);
+
+    InitdNdxInverseInterpolation(def, parametrization_->GetParticleDef().low);
 }
@@ -14,20 +14,14 @@ using namespace PROPOSAL;
 CrossSection::CrossSection(const InteractionType& type, const Parametrization& param)
     : type_id_(type)
     , parametrization_(param.clone())
-    , prob_for_component_(param.GetMedium()->GetNumComponents(), 0)
-    , sum_of_rates_(0)
     , components_(parametrization_->GetMedium()->GetComponents())
-    , rnd_(0)
 {
 }
 
 CrossSection::CrossSection(const CrossSection& cross_section)
     : type_id_(cross_section.type_id_)
     , parametrization_(cross_section.parametrization_->clone())
-    , prob_for_component_(cross_section.prob_for_component_)
-    , sum_of_rates_(cross_section.sum_of_rates_)
     , components_(parametrization_->GetMedium()->GetComponents())
-    , rnd_(cross_section.rnd_)
 {
 }
 
@@ -45,12 +39,6 @@ bool CrossSection::operator==(const CrossSection& cross_section) const
         return false;
     else if (*parametrization_ != *cross_section.parametrization_)
         return false;
-    else if (prob_for_component_ != cross_section.prob_for_component_)
-        return false;
-    else if (sum_of_rates_ != cross_section.sum_of_rates_)
-        return false;
-    else if (rnd_ != cross_section.rnd_)
-        return false;
     else
         return this->compare(cross_section);
 }
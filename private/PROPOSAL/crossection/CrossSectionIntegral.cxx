@@ -19,6 +19,9 @@ CrossSectionIntegral::CrossSectionIntegral(const InteractionType& type, const Pa
     , dedx_integral_(IROMB, IMAXS, IPREC)
     , de2dx_integral_(IROMB, IMAXS, IPREC)
     , dndx_integral_(param.GetMedium()->GetNumComponents(), Integral(IROMB, IMAXS, IPREC))
+    , prob_for_component_(param.GetMedium()->GetNumComponents(), 0)
+    , sum_of_rates_(0)
+    , rnd_(0)
 {
 }
 
@@ -27,6 +30,9 @@ CrossSectionIntegral::CrossSectionIntegral(const CrossSectionIntegral& cross_sec
     , dedx_integral_(cross_section.dedx_integral_)
     , de2dx_integral_(cross_section.de2dx_integral_)
     , dndx_integral_(cross_section.dndx_integral_)
+    , prob_for_component_(cross_section.prob_for_component_)
+    , sum_of_rates_(cross_section.sum_of_rates_)
+    , rnd_(cross_section.rnd_)
 {
 }
 
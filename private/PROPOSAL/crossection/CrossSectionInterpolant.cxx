@@ -15,16 +15,26 @@
 
 using namespace PROPOSAL;
 
+namespace {
+
+// Number of components whose rates are kept on the stack while sampling
+const size_t max_stack_rates = 16;
+
+} // namespace
+
 // ------------------------------------------------------------------------- //
 // Constructor & Destructor
 // ------------------------------------------------------------------------- //
 
 CrossSectionInterpolant::CrossSectionInterpolant(const InteractionType& type, const Parametrization& param)
     : CrossSection(type, param)
-    , dedx_interpolant_(NULL)
-    , de2dx_interpolant_(NULL)
-    , dndx_interpolant_1d_(param.GetMedium()->GetNumComponents(), NULL)
-    , dndx_interpolant_2d_(param.GetMedium()->GetNumComponents(), NULL)
+    , dedx_interpolant_(nullptr)
+    , de2dx_interpolant_(nullptr)
+    , dndx_interpolant_1d_(param.GetMedium()->GetNumComponents(), nullptr)
+    , dndx_interpolant_2d_(param.GetMedium()->GetNumComponents(), nullptr)
+    , dndx_inverse_interpolant_2d_()
+    , dndx_inverse_rnd_min_(0)
+    , dndx_inverse_rnd_max_(1)
 {
 }
 
@@ -70,8 +80,6 @@ void CrossSectionInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
     Helper::InterpolantBuilderContainer builder_container2d(components_.size());
     Helper::InterpolantBuilderContainer builder_return;
 
-    Integral integral(IROMB, IMAXS, IPREC);
-
     for (unsigned int i = 0; i < components_.size(); ++i)
     {
         // !!! IMPORTANT !!!
@@ -96,13 +104,7 @@ void CrossSectionInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
             .SetRationalY(true)
             .SetRelativeY(false)
             .SetLogSubst(false)
-            .SetFunction2D(std::bind(
-                &CrossSectionInterpolant::FunctionToBuildDNdxInterpolant2D,
-                this,
-                std::placeholders::_1,
-                std::placeholders::_2,
-                std::ref(integral),
-                i));
+            .SetFunction2DFactory(DNdxInterpolant2DFactory(i));
 
         builder_container2d[i].first  = &builder2d[i];
         builder_container2d[i].second = &dndx_interpolant_2d_[i];
@@ -130,64 +132,168 @@ void CrossSectionInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
     // builder2d.insert(builder2d.end(), builder1d.begin(), builder1d.end());
 
     Helper::InitializeInterpolation("dNdx", builder_return, std::vector<Parametrization*>(1, parametrization_), def);
+
+    InitdNdxInverseInterpolation(def, parametrization_->GetParticleDef().mass);
 }
 
-CrossSectionInterpolant::CrossSectionInterpolant(const CrossSectionInterpolant& cross_section)
-    : CrossSection(cross_section)
+// ------------------------------------------------------------------------- //
+void CrossSectionInterpolant::InitdNdxInverseInterpolation(const InterpolationDef& def, double energy_min)
 {
-    if (cross_section.dedx_interpolant_ != NULL)
+    if (!def.do_inverse_tables)
     {
-        dedx_interpolant_ = new Interpolant(*cross_section.dedx_interpolant_);
-    }
-    else{
-        dedx_interpolant_ = NULL;
+        return;
     }
 
-    if (cross_section.de2dx_interpolant_ != NULL)
-    {
-        de2dx_interpolant_ = new Interpolant(*cross_section.de2dx_interpolant_);
-    }
-    else{
-        de2dx_interpolant_ = NULL;
-    }
+    // --------------------------------------------------------------------- //
+    // Builder for the inverse of dNdx
+    // --------------------------------------------------------------------- //
 
-    int num_components = cross_section.parametrization_->GetMedium()->GetNumComponents();
+    std::vector<Interpolant2DBuilder> builder2d(dndx_interpolant_2d_.size());
+    Helper::InterpolantBuilderContainer builder_container;
 
-    dndx_interpolant_1d_.reserve(num_components);
-    for (auto interpolant: cross_section.dndx_interpolant_1d_)
+    dndx_inverse_interpolant_2d_.assign(dndx_interpolant_2d_.size(), nullptr);
+
+    // Inside the first and the last interval of x2 of the dNdx table, the
+    // cumulative dNdx can be flat, e.g. if the low energy losses are
+    // suppressed by the LPM effect. There, the inverse is too steep to be
+    // interpolated in rnd. The fractions of the rate below the first and
+    // above the last interval bound the rnd using the inverse tables. They
+    // are taken at the energy nodes and over all components, where they are
+    // largest, so they do not depend on the energy.
+    dndx_inverse_rnd_min_ = 0;
+    dndx_inverse_rnd_max_ = 1;
+
+    for (unsigned int i = 0; i < dndx_interpolant_2d_.size(); ++i)
     {
-        if (interpolant != NULL)
+        const Interpolant& dndx_2d = *dndx_interpolant_2d_[i];
+
+        for (int j = 0; j < def.nodes_cross_section; ++j)
         {
-            dndx_interpolant_1d_.push_back(new Interpolant(*interpolant));
+            double energy = energy_min * std::pow(def.max_node_energy / energy_min,
+                                                  static_cast<double>(j) / (def.nodes_cross_section - 1));
+            double rate = dndx_interpolant_1d_[i]->Interpolate(energy);
+
+            if (!(rate > 0))
+            {
+                continue;
+            }
+
+            double rate_min = dndx_2d.Interpolate(energy, dndx_2d.GetXmin() + dndx_2d.GetStep());
+            double rate_max = dndx_2d.Interpolate(energy, dndx_2d.GetXmax() - dndx_2d.GetStep());
+
+            dndx_inverse_rnd_min_ = std::max(dndx_inverse_rnd_min_, rate_min / rate);
+            dndx_inverse_rnd_max_ = std::min(dndx_inverse_rnd_max_, rate_max / rate);
         }
     }
 
-    dndx_interpolant_2d_.reserve(num_components);
-    for (auto interpolant: cross_section.dndx_interpolant_2d_)
+    log_debug("The inverse dNdx tables are used for %f < rnd < %f", dndx_inverse_rnd_min_, dndx_inverse_rnd_max_);
+
+    for (unsigned int i = 0; i < dndx_interpolant_2d_.size(); ++i)
     {
-        if (interpolant != NULL)
-        {
-            dndx_interpolant_2d_.push_back(new Interpolant(*interpolant));
-        }
+        // The inverse is tabulated with the same search as used without it,
+        // so both sample the same distribution. The tables are not altered
+        // by evaluating them, so the function can be used by all threads.
+        std::shared_ptr<const Interpolant> dndx_1d = dndx_interpolant_1d_[i];
+        std::shared_ptr<const Interpolant> dndx_2d = dndx_interpolant_2d_[i];
+
+        Interpolant2DBuilder::Function2D function = [dndx_1d, dndx_2d](double energy, double rnd) {
+            return dndx_2d->FindLimit(energy, rnd * std::max(dndx_1d->Interpolate(energy), 0.));
+        };
+
+        builder2d[i]
+            .SetMax1(def.nodes_cross_section)
+            .SetX1Min(energy_min)
+            .SetX1Max(def.max_node_energy)
+            .SetMax2(def.nodes_cross_section)
+            .SetX2Min(0.0)
+            .SetX2Max(1.0)
+            .SetRomberg1(def.order_of_interpolation)
+            .SetRational1(false)
+            .SetRelative1(false)
+            .SetIsLog1(true)
+            .SetRomberg2(def.order_of_interpolation)
+            .SetRational2(false)
+            .SetRelative2(false)
+            .SetIsLog2(false)
+            .SetRombergY(def.order_of_interpolation)
+            .SetRationalY(false)
+            .SetRelativeY(false)
+            .SetLogSubst(false)
+            .SetFunction2DFactory([function]() { return function; });
+
+        builder_container.push_back(std::make_pair(&builder2d[i], &dndx_inverse_interpolant_2d_[i]));
     }
+
+    Helper::InitializeInterpolation(
+        "dNdx_inverse", builder_container, std::vector<Parametrization*>(1, parametrization_), def);
 }
 
-CrossSectionInterpolant::~CrossSectionInterpolant()
+// ------------------------------------------------------------------------- //
+void CrossSectionInterpolant::InitTables(const InterpolationDef& def,
+                                         Helper::InterpolantBuilderContainer& dedx_builders,
+                                         Helper::InterpolantBuilderContainer& de2dx_builders)
 {
-    delete dedx_interpolant_;
-    delete de2dx_interpolant_;
+    std::vector<Parametrization*> parametrizations(1, parametrization_);
+
+    std::vector<Helper::TableTask> tasks;
+    tasks.push_back([this](const InterpolationDef& share) { InitdNdxInterpolation(share); });
+    tasks.push_back([&](const InterpolationDef& share) {
+        Helper::InitializeInterpolation("dEdx", dedx_builders, parametrizations, share);
+    });
+    tasks.push_back([&](const InterpolationDef& share) {
+        Helper::InitializeInterpolation("dE2dx", de2dx_builders, parametrizations, share);
+    });
 
-    for (auto interpolant: dndx_interpolant_1d_)
+    Helper::InitializeInParallel(tasks, def);
+
+    InitChebyshevSeries(def);
+}
+
+// ------------------------------------------------------------------------- //
+void CrossSectionInterpolant::InitChebyshevSeries(const InterpolationDef& def)
+{
+    if (!(def.chebyshev_table_tolerance > 0))
     {
-        delete interpolant;
+        return;
     }
 
-    for (auto interpolant: dndx_interpolant_2d_)
+    InterpolantVec tables(dndx_interpolant_1d_);
+    tables.push_back(dedx_interpolant_);
+    tables.push_back(de2dx_interpolant_);
+
+    for (unsigned int i = 0; i < tables.size(); ++i)
     {
-        delete interpolant;
+        if (!tables[i])
+        {
+            continue;
+        }
+
+        // the tables have just been created and are not shared yet
+        Interpolant& interpolant = const_cast<Interpolant&>(*tables[i]);
+
+        if (interpolant.FitChebyshev(def.chebyshev_table_tolerance))
+        {
+            log_debug("A %s table is evaluated with %i Chebyshev terms.",
+                      parametrization_->GetName().c_str(),
+                      interpolant.GetChebyshevTerms());
+        }
     }
 }
 
+CrossSectionInterpolant::CrossSectionInterpolant(const CrossSectionInterpolant& cross_section)
+    : CrossSection(cross_section)
+    , dedx_interpolant_(cross_section.dedx_interpolant_)
+    , de2dx_interpolant_(cross_section.de2dx_interpolant_)
+    , dndx_interpolant_1d_(cross_section.dndx_interpolant_1d_)
+    , dndx_interpolant_2d_(cross_section.dndx_interpolant_2d_)
+    , dndx_inverse_interpolant_2d_(cross_section.dndx_inverse_interpolant_2d_)
+    , dndx_inverse_rnd_min_(cross_section.dndx_inverse_rnd_min_)
+    , dndx_inverse_rnd_max_(cross_section.dndx_inverse_rnd_max_)
+{
+}
+
+CrossSectionInterpolant::~CrossSectionInterpolant() {}
+
 // ------------------------------------------------------------------------- //
 // Pulblic methods
 // ------------------------------------------------------------------------- //
@@ -206,84 +312,61 @@ double CrossSectionInterpolant::CalculatedNdx(double energy)
         return 0;
     }
 
-    sum_of_rates_ = 0;
+    double sum_of_rates = 0;
 
-    const auto& components = parametrization_->GetMedium()->GetComponents();
-    for (size_t i = 0; i < components.size(); ++i)
+    for (size_t i = 0; i < components_.size(); ++i)
     {
-        prob_for_component_[i] = std::max(dndx_interpolant_1d_[i]->Interpolate(energy), 0.);
-        sum_of_rates_ += prob_for_component_[i];
+        sum_of_rates += std::max(dndx_interpolant_1d_[i]->Interpolate(energy), 0.);
     }
-    return parametrization_->GetMultiplier() * sum_of_rates_;
+
+    return parametrization_->GetMultiplier() * sum_of_rates;
 }
 
 // ------------------------------------------------------------------------- //
 double CrossSectionInterpolant::CalculatedNdx(double energy, double rnd)
 {
-    if (parametrization_->GetMultiplier() <= 0)
-    {
-        return 0;
-    }
-
-    // The random number will be stored to be able
-    // to check if dNdx is already calculated for this random number.
-    // This avoids a second calculation in CalculateStochaticLoss
-    rnd_ = rnd;
+    // The interpolation tables are not altered by evaluating them,
+    // so the random number is not needed to cache anything here.
+    (void)rnd;
 
-    sum_of_rates_ = 0;
-
-    const auto& components = parametrization_->GetMedium()->GetComponents();
-    for (size_t i = 0; i < components.size(); ++i)
-    {
-        prob_for_component_[i] = std::max(dndx_interpolant_1d_[i]->Interpolate(energy), 0.);
-        sum_of_rates_ += prob_for_component_[i];
-    }
-
-    return parametrization_->GetMultiplier() * sum_of_rates_;
+    return CalculatedNdx(energy);
 }
 
 // ------------------------------------------------------------------------- //
 double CrossSectionInterpolant::CalculateStochasticLoss(double energy, double rnd1, double rnd2)
 {
-    if (rnd1 != rnd_)
+    // The rates of the components are recalculated for every call instead of
+    // being stored in the cross section. This way the cross section can be
+    // used from several threads at once. They are kept on the stack for
+    // the usual number of components.
+    double stack_rates[max_stack_rates];
+    std::vector<double> heap_rates;
+    double* rates = stack_rates;
+
+    if (components_.size() > max_stack_rates)
     {
-        CalculatedNdx(energy, rnd1);
+        heap_rates.resize(components_.size());
+        rates = heap_rates.data();
     }
 
-    return CalculateStochasticLoss(energy, rnd2);
-}
-
-// ------------------------------------------------------------------------- //
-// Private methods
-// ------------------------------------------------------------------------- //
+    double sum_of_rates = 0;
 
-// ------------------------------------------------------------------------- //
-double CrossSectionInterpolant::CalculateStochasticLoss(double energy, double rnd1)
-{
-
-    double rnd;
-    double rsum;
+    for (size_t i = 0; i < components_.size(); ++i)
+    {
+        rates[i] = std::max(dndx_interpolant_1d_[i]->Interpolate(energy), 0.);
+        sum_of_rates += rates[i];
+    }
 
-    rnd  = rnd1 * sum_of_rates_;
-    rsum = 0;
+    double rnd  = rnd2 * sum_of_rates;
+    double rsum = 0;
 
     for (size_t i = 0; i < components_.size(); ++i)
     {
-        rsum += prob_for_component_[i];
+        rsum += rates[i];
 
         if (rsum > rnd)
         {
-            parametrization_->SetCurrentComponent(i);
-            Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy);
-
-            if (limits.vUp == limits.vMax)
-            {
-                return energy * limits.vUp;
-            }
-
-            return energy *
-                   (limits.vUp * std::exp(dndx_interpolant_2d_.at(i)->FindLimit(energy, rnd_ * prob_for_component_[i]) *
-                                     std::log(limits.vMax / limits.vUp)));
+            return CalculateStochasticLossOfComponent(energy, i, rnd1, rnd1 * rates[i]);
         }
     }
 
@@ -291,8 +374,7 @@ double CrossSectionInterpolant::CalculateStochasticLoss(double energy, double rn
     bool prob_for_all_comp_is_zero = true;
     for (size_t i = 0; i < components_.size(); ++i)
     {
-        parametrization_->SetCurrentComponent(i);
-        Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy);
+        Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy, i);
 
         if (limits.vUp != limits.vMax)
             prob_for_all_comp_is_zero = false;
@@ -305,6 +387,74 @@ double CrossSectionInterpolant::CalculateStochasticLoss(double energy, double rn
     return 0; // just to prevent warnings
 }
 
+// ------------------------------------------------------------------------- //
+int CrossSectionInterpolant::GetNumberOfRates() const
+{
+    return HasRatePerComponent() ? components_.size() : 1;
+}
+
+// ------------------------------------------------------------------------- //
+double CrossSectionInterpolant::CalculatedNdxOfRate(double energy, int rate)
+{
+    if (!HasRatePerComponent())
+    {
+        return CalculatedNdx(energy);
+    }
+
+    if (parametrization_->GetMultiplier() <= 0)
+    {
+        return 0;
+    }
+
+    return parametrization_->GetMultiplier() * std::max(dndx_interpolant_1d_[rate]->Interpolate(energy), 0.);
+}
+
+// ------------------------------------------------------------------------- //
+double CrossSectionInterpolant::CalculateStochasticLossOfRate(double energy, int rate, double rnd1, double rnd2)
+{
+    if (!HasRatePerComponent())
+    {
+        return CalculateStochasticLoss(energy, rnd1, rnd2);
+    }
+
+    return CalculateStochasticLossOfComponent(
+        energy, rate, rnd1, rnd1 * std::max(dndx_interpolant_1d_[rate]->Interpolate(energy), 0.));
+}
+
+// ------------------------------------------------------------------------- //
+// Private methods
+// ------------------------------------------------------------------------- //
+
+// ------------------------------------------------------------------------- //
+double CrossSectionInterpolant::CalculateStochasticLossOfComponent(double energy, int component, double rnd, double rate)
+{
+    Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy, component);
+
+    if (limits.vUp == limits.vMax)
+    {
+        return energy * limits.vUp;
+    }
+
+    return energy * (limits.vUp * std::exp(FinddNdxLimit(energy, component, rnd, rate) *
+                                           std::log(limits.vMax / limits.vUp)));
+}
+
+// ------------------------------------------------------------------------- //
+double CrossSectionInterpolant::FinddNdxLimit(double energy, int component, double rnd, double rate) const
+{
+    const Interpolant& dndx_2d = *dndx_interpolant_2d_.at(component);
+
+    if (dndx_inverse_interpolant_2d_.empty() || rnd < dndx_inverse_rnd_min_ || rnd > dndx_inverse_rnd_max_)
+    {
+        return dndx_2d.FindLimit(energy, rate);
+    }
+
+    // like FindLimit, stay in the range of the dNdx table
+    double result = dndx_inverse_interpolant_2d_[component]->Interpolate(energy, rnd);
+
+    return std::min(std::max(result, dndx_2d.GetXmin()), dndx_2d.GetXmax());
+}
+
 // ------------------------------------------------------------------------- //
 // Function needed for interpolation intitialization
 // ------------------------------------------------------------------------- //
@@ -317,8 +467,7 @@ double CrossSectionInterpolant::FunctionToBuildDNdxInterpolant(double energy, in
 
 double CrossSectionInterpolant::CalculateCumulativeCrossSection(double energy, int component, double v)
 {
-    parametrization_->SetCurrentComponent(component);
-    Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy);
+    Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy, component);
 
     v = std::log(v / limits.vUp) / std::log(limits.vMax / limits.vUp);
 
@@ -328,11 +477,12 @@ double CrossSectionInterpolant::CalculateCumulativeCrossSection(double energy, i
 //----------------------------------------------------------------------------//
 double CrossSectionInterpolant::FunctionToBuildDNdxInterpolant2D(double energy,
                                                                  double v,
+                                                                 Parametrization& parametrization,
                                                                  Integral& integral,
-                                                                 int component)
+                                                                 int component) const
 {
-    parametrization_->SetCurrentComponent(component);
-    Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy);
+    parametrization.SetCurrentComponent(component);
+    Parametrization::IntegralLimits limits = parametrization.GetIntegralLimits(energy);
 
     if (limits.vUp == limits.vMax)
     {
@@ -342,5 +492,18 @@ double CrossSectionInterpolant::FunctionToBuildDNdxInterpolant2D(double energy,
     v = limits.vUp * std::exp(v * std::log(limits.vMax / limits.vUp));
 
     return integral.Integrate(
-        limits.vUp, v, std::bind(&Parametrization::FunctionToDNdxIntegral, parametrization_, energy, std::placeholders::_1), 4);
+        limits.vUp, v, std::bind(&Parametrization::FunctionToDNdxIntegral, &parametrization, energy, std::placeholders::_1), 4);
+}
+
+//----------------------------------------------------------------------------//
+Interpolant2DBuilder::Function2DFactory CrossSectionInterpolant::DNdxInterpolant2DFactory(int component) const
+{
+    return [this, component]() -> Interpolant2DBuilder::Function2D {
+        std::shared_ptr<Parametrization> parametrization(parametrization_->clone());
+        std::shared_ptr<Integral> integral = std::make_shared<Integral>(IROMB, IMAXS, IPREC);
+
+        return [this, parametrization, integral, component](double energy, double v) {
+            return FunctionToBuildDNdxInterpolant2D(energy, v, *parametrization, *integral, component);
+        };
+    };
 }
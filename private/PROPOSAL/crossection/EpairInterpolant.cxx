@@ -16,9 +16,6 @@ using namespace PROPOSAL;
 EpairInterpolant::EpairInterpolant(const EpairProduction& param, InterpolationDef def)
     : CrossSectionInterpolant(InteractionType::Epair, param)
 {
-    // Use parent CrossSecition dNdx interpolation
-    InitdNdxInterpolation(def);
-
     // --------------------------------------------------------------------- //
     // Builder for DEdx
     // --------------------------------------------------------------------- //
@@ -51,6 +48,8 @@ EpairInterpolant::EpairInterpolant(const EpairProduction& param, InterpolationDe
     Interpolant1DBuilder builder_de2dx;
     Helper::InterpolantBuilderContainer builder_container_de2dx;
 
+    EpairIntegral epair_de2dx(param);
+
     builder_de2dx.SetMax(def.nodes_continous_randomization)
         .SetXMin(param.GetParticleDef().mass)
         .SetXMax(def.max_node_energy)
@@ -62,13 +61,11 @@ EpairInterpolant::EpairInterpolant(const EpairProduction& param, InterpolationDe
         .SetRationalY(false)
         .SetRelativeY(false)
         .SetLogSubst(false)
-        .SetFunction1D(std::bind(&EpairIntegral::CalculatedE2dxWithoutMultiplier, &epair, std::placeholders::_1));
+        .SetFunction1D(std::bind(&EpairIntegral::CalculatedE2dxWithoutMultiplier, &epair_de2dx, std::placeholders::_1));
 
     builder_container_de2dx.push_back(std::make_pair(&builder_de2dx, &de2dx_interpolant_));
 
-    Helper::InitializeInterpolation("dEdx", builder_container, std::vector<Parametrization*>(1, parametrization_), def);
-    Helper::InitializeInterpolation(
-        "dE2dx", builder_container_de2dx, std::vector<Parametrization*>(1, parametrization_), def);
+    InitTables(def, builder_container, builder_container_de2dx);
 }
 
 EpairInterpolant::EpairInterpolant(const EpairInterpolant& epair)
@@ -23,9 +23,6 @@ using namespace PROPOSAL;
 IonizInterpolant::IonizInterpolant(const Ionization& param, InterpolationDef def)
     : CrossSectionInterpolant(InteractionType::DeltaE, param)
 {
-    // Use overwritten dNdx interpolation
-    InitdNdxInterpolation(def);
-
     // --------------------------------------------------------------------- //
     // Builder for DEdx
     // --------------------------------------------------------------------- //
@@ -57,6 +54,8 @@ IonizInterpolant::IonizInterpolant(const Ionization& param, InterpolationDef def
     Interpolant1DBuilder builder_de2dx;
     Helper::InterpolantBuilderContainer builder_container_de2dx;
 
+    IonizIntegral ioniz_de2dx(param);
+
     builder_de2dx.SetMax(def.nodes_continous_randomization)
         .SetXMin(param.GetParticleDef().mass)
         .SetXMax(def.max_node_energy)
@@ -68,13 +67,11 @@ IonizInterpolant::IonizInterpolant(const Ionization& param, InterpolationDef def
         .SetRationalY(false)
         .SetRelativeY(false)
         .SetLogSubst(false)
-        .SetFunction1D(std::bind(&IonizIntegral::CalculatedE2dxWithoutMultiplier, &ioniz, std::placeholders::_1));
+        .SetFunction1D(std::bind(&IonizIntegral::CalculatedE2dxWithoutMultiplier, &ioniz_de2dx, std::placeholders::_1));
 
     builder_container_de2dx.push_back(std::make_pair(&builder_de2dx, &de2dx_interpolant_));
 
-    Helper::InitializeInterpolation("dEdx", builder_container, std::vector<Parametrization*>(1, parametrization_), def);
-    Helper::InitializeInterpolation(
-        "dE2dx", builder_container_de2dx, std::vector<Parametrization*>(1, parametrization_), def);
+    InitTables(def, builder_container, builder_container_de2dx);
 }
 
 IonizInterpolant::IonizInterpolant(const IonizInterpolant& ioniz)
@@ -98,8 +95,6 @@ void IonizInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
     Helper::InterpolantBuilderContainer builder_container2d(components_.size());
     Helper::InterpolantBuilderContainer builder_return;
 
-    Integral integral(IROMB, IMAXS, IPREC);
-
     for (unsigned int i = 0; i < components_.size(); ++i)
     {
         // !!! IMPORTANT !!!
@@ -124,8 +119,7 @@ void IonizInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
             .SetRationalY(true)
             .SetRelativeY(false)
             .SetLogSubst(false)
-            .SetFunction2D(std::bind(
-                &IonizInterpolant::FunctionToBuildDNdxInterpolant2D, this, std::placeholders::_1, std::placeholders::_2, std::ref(integral), i));
+            .SetFunction2DFactory(DNdxInterpolant2DFactory(i));
 
         builder_container2d[i].first  = &builder2d[i];
         builder_container2d[i].second = &dndx_interpolant_2d_[i];
@@ -153,6 +147,8 @@ void IonizInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
     // builder2d.insert(builder2d.end(), builder1d.begin(), builder1d.end());
 
     Helper::InitializeInterpolation("dNdx", builder_return, std::vector<Parametrization*>(1, parametrization_), def);
+
+    InitdNdxInverseInterpolation(def, parametrization_->GetParticleDef().mass);
 }
 
 // ----------------------------------------------------------------- //
@@ -177,9 +173,7 @@ double IonizInterpolant::CalculatedNdx(double energy)
         return 0;
     }
 
-    sum_of_rates_ = std::max(dndx_interpolant_1d_[0]->Interpolate(energy), 0.);
-
-    return parametrization_->GetMultiplier() * sum_of_rates_;
+    return parametrization_->GetMultiplier() * std::max(dndx_interpolant_1d_[0]->Interpolate(energy), 0.);
 }
 
 // ------------------------------------------------------------------------- //
@@ -187,14 +181,7 @@ double IonizInterpolant::CalculatedNdx(double energy, double rnd)
 {
     (void)rnd;
 
-    if (parametrization_->GetMultiplier() <= 0)
-    {
-        return 0;
-    }
-
-    sum_of_rates_ = std::max(dndx_interpolant_1d_[0]->Interpolate(energy), 0.);
-
-    return parametrization_->GetMultiplier() * sum_of_rates_;
+    return CalculatedNdx(energy);
 }
 
 // ------------------------------------------------------------------------- //
@@ -205,11 +192,15 @@ double IonizInterpolant::FunctionToBuildDNdxInterpolant(double energy, int compo
 }
 
 // ------------------------------------------------------------------------- //
-double IonizInterpolant::FunctionToBuildDNdxInterpolant2D(double energy, double v, Integral& integral, int component)
+double IonizInterpolant::FunctionToBuildDNdxInterpolant2D(double energy,
+                                                          double v,
+                                                          Parametrization& parametrization,
+                                                          Integral& integral,
+                                                          int component) const
 {
     (void)component;
 
-    Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy);
+    Parametrization::IntegralLimits limits = parametrization.GetIntegralLimits(energy);
 
 
     if (limits.vUp == limits.vMax)
@@ -220,15 +211,18 @@ double IonizInterpolant::FunctionToBuildDNdxInterpolant2D(double energy, double
     v = limits.vUp * std::exp(v * std::log(limits.vMax / limits.vUp));
 
     return integral.Integrate(
-        limits.vUp, v, std::bind(&Parametrization::FunctionToDNdxIntegral, parametrization_, energy, std::placeholders::_1), 3, 1);
+        limits.vUp, v, std::bind(&Parametrization::FunctionToDNdxIntegral, &parametrization, energy, std::placeholders::_1), 3, 1);
 }
 
 // ------------------------------------------------------------------------- //
-double IonizInterpolant::CalculateStochasticLoss(double energy, double rnd1)
+double IonizInterpolant::CalculateStochasticLoss(double energy, double rnd1, double rnd2)
 {
+    // Only one table is used for all components, so rnd1 is not needed
+    (void)rnd1;
+
     double rnd, rsum;
 
-    rnd  = parametrization_->GetMedium()->GetSumCharge() * rnd1;
+    rnd  = parametrization_->GetMedium()->GetSumCharge() * rnd2;
     rsum = 0;
 
     for (unsigned int i = 0; i < components_.size(); i++)
@@ -243,7 +237,10 @@ double IonizInterpolant::CalculateStochasticLoss(double energy, double rnd1)
             {
                 return energy * limits.vUp;
             }
-            return energy * (limits.vUp * std::exp(dndx_interpolant_2d_[0]->FindLimit(energy, rnd1 * sum_of_rates_) *
+
+            double sum_of_rates = std::max(dndx_interpolant_1d_[0]->Interpolate(energy), 0.);
+
+            return energy * (limits.vUp * std::exp(FinddNdxLimit(energy, 0, rnd2, rnd2 * sum_of_rates) *
                                               std::log(limits.vMax / limits.vUp)));
         }
     }
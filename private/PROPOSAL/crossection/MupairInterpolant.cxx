@@ -19,9 +19,6 @@ using namespace PROPOSAL;
 MupairInterpolant::MupairInterpolant(const MupairProduction& param, InterpolationDef def)
     : CrossSectionInterpolant(GetType(param), param)
 {
-    // Use parent CrossSecition dNdx interpolation
-    InitdNdxInterpolation(def);
-
     // --------------------------------------------------------------------- //
     // Builder for DEdx
     // --------------------------------------------------------------------- //
@@ -54,6 +51,8 @@ MupairInterpolant::MupairInterpolant(const MupairProduction& param, Interpolatio
     Interpolant1DBuilder builder_de2dx;
     Helper::InterpolantBuilderContainer builder_container_de2dx;
 
+    MupairIntegral mupair_de2dx(param);
+
     builder_de2dx.SetMax(def.nodes_continous_randomization)
         .SetXMin(param.GetParticleDef().mass)
         .SetXMax(def.max_node_energy)
@@ -65,13 +64,11 @@ MupairInterpolant::MupairInterpolant(const MupairProduction& param, Interpolatio
         .SetRationalY(false)
         .SetRelativeY(false)
         .SetLogSubst(false)
-        .SetFunction1D(std::bind(&MupairIntegral::CalculatedE2dxWithoutMultiplier, &mupair, std::placeholders::_1));
+        .SetFunction1D(std::bind(&MupairIntegral::CalculatedE2dxWithoutMultiplier, &mupair_de2dx, std::placeholders::_1));
 
     builder_container_de2dx.push_back(std::make_pair(&builder_de2dx, &de2dx_interpolant_));
 
-    Helper::InitializeInterpolation("dEdx", builder_container, std::vector<Parametrization*>(1, parametrization_), def);
-    Helper::InitializeInterpolation(
-        "dE2dx", builder_container_de2dx, std::vector<Parametrization*>(1, parametrization_), def);
+    InitTables(def, builder_container, builder_container_de2dx);
 
     muminus_def_ = &MuMinusDef::Get();
     muplus_def_ = &MuPlusDef::Get();
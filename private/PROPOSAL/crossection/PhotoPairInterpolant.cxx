@@ -8,6 +8,7 @@
 
 #include "PROPOSAL/math/Interpolant.h"
 #include "PROPOSAL/math/InterpolantBuilder.h"
+#include "PROPOSAL/math/RandomGenerator.h"
 
 #include "PROPOSAL/Constants.h"
 #include "PROPOSAL/methods.h"
@@ -17,16 +18,17 @@ using namespace PROPOSAL;
 
 PhotoPairInterpolant::PhotoPairInterpolant(const PhotoPairProduction& param, const PhotoAngleDistribution& photoangle, InterpolationDef def)
         : CrossSectionInterpolant(InteractionType::Particle, param)
-        , photoangle_(photoangle.clone()), rndc_(-1.){
+        , photoangle_(photoangle.clone()){
     // Use own initialization
     PhotoPairInterpolant::InitdNdxInterpolation(def);
+    InitChebyshevSeries(def);
     eminus_def_ = &EMinusDef::Get();
     eplus_def_ = &EPlusDef::Get();
 }
 
 
 PhotoPairInterpolant::PhotoPairInterpolant(const PhotoPairInterpolant& param)
-        : CrossSectionInterpolant(param), photoangle_(param.GetPhotoAngleDistribution().clone()), rndc_(param.rndc_)
+        : CrossSectionInterpolant(param), photoangle_(param.GetPhotoAngleDistribution().clone())
         , eminus_def_(param.eminus_def_), eplus_def_(param.eplus_def_)
 {
 }
@@ -81,17 +83,26 @@ double PhotoPairInterpolant::CalculatedNdx(double energy, double rnd) {
 // ------------------------------------------------------------------------- //
 double PhotoPairInterpolant::CalculateStochasticLoss(double energy, double rnd1, double rnd2)
 {
-    if(rnd1 != rnd_){
-        CalculatedNdx(energy, rnd1);
-    }
-    rndc_ = rnd2; // save random number for component sampling
-    return energy; // losses are always catastrophic
+    // The produced particles are sampled from the same random numbers, see
+    // CalculateProducedParticles
+    (void)rnd1;
+    (void)rnd2;
 
+    return energy; // losses are always catastrophic
 }
 
 
 // ------------------------------------------------------------------------- //
 std::pair<std::vector<DynamicData>, bool> PhotoPairInterpolant::CalculateProducedParticles(double energy, double energy_loss, const Vector3D& initial_direction){
+    // Without the random numbers of the interaction, new ones are sampled
+    double rnd1 = RandomGenerator::Get().RandomDouble();
+    double rnd2 = RandomGenerator::Get().RandomDouble();
+
+    return CalculateProducedParticles(energy, energy_loss, initial_direction, rnd1, rnd2);
+}
+
+// ------------------------------------------------------------------------- //
+std::pair<std::vector<DynamicData>, bool> PhotoPairInterpolant::CalculateProducedParticles(double energy, double energy_loss, const Vector3D& initial_direction, double rnd1, double rnd2){
     (void)energy_loss;
     double rnd;
     double rsum;
@@ -99,28 +110,29 @@ std::pair<std::vector<DynamicData>, bool> PhotoPairInterpolant::CalculateProduce
 
     std::vector<DynamicData> particle_list{};
 
-    if(rndc_<0){
-        //CalculateStochasticLoss has never been called before, return empty list
-        //TODO: find a better way of checking the random numbers
-        log_warn("CalculateProducedParticles has been called with no call of CalculateStochasticLoss for PhotoPairProduction");
-        return std::make_pair(particle_list, true);
-    }
-
     particle_list.push_back(DynamicData(eplus_def_->particle_type));
     particle_list.push_back(DynamicData(eminus_def_->particle_type));
 
-    rnd  = rndc_ * sum_of_rates_;
+    // the component is sampled with rnd2 as in CalculateStochasticLoss
+    std::vector<double> rates(components_.size());
+    double sum_of_rates = 0;
+    for (size_t i = 0; i < components_.size(); ++i)
+    {
+        rates[i] = std::max(dndx_interpolant_1d_[i]->Interpolate(energy), 0.);
+        sum_of_rates += rates[i];
+    }
+
+    rnd  = rnd2 * sum_of_rates;
     rsum = 0;
 
     for (size_t i = 0; i < components_.size(); ++i)
     {
-        rsum += prob_for_component_[i];
+        rsum += rates[i];
 
         if (rsum > rnd)
         {
-            parametrization_->SetCurrentComponent(i);
-            Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy);
-            rho = (limits.vUp * std::exp(dndx_interpolant_2d_.at(i)->FindLimit(energy, rnd_ * prob_for_component_[i]) *
+            Parametrization::IntegralLimits limits = parametrization_->GetIntegralLimits(energy, i);
+            rho = (limits.vUp * std::exp(FinddNdxLimit(energy, i, rnd1, rnd1 * rates[i]) *
                                          std::log(limits.vMax / limits.vUp)));
 
             particle_list[0].SetEnergy(energy * (1-rho));
@@ -155,8 +167,6 @@ void PhotoPairInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
     Helper::InterpolantBuilderContainer builder_container2d(components_.size());
     Helper::InterpolantBuilderContainer builder_return;
 
-    Integral integral(IROMB, IMAXS, IPREC);
-
     for (unsigned int i = 0; i < components_.size(); ++i)
     {
         // !!! IMPORTANT !!!
@@ -181,13 +191,7 @@ void PhotoPairInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
                 .SetRationalY(true)
                 .SetRelativeY(false)
                 .SetLogSubst(false)
-                .SetFunction2D(std::bind(
-                        &CrossSectionInterpolant::FunctionToBuildDNdxInterpolant2D,
-                        this,
-                        std::placeholders::_1,
-                        std::placeholders::_2,
-                        std::ref(integral),
-                        i));
+                .SetFunction2DFactory(DNdxInterpolant2DFactory(i));
 
         builder_container2d[i].first  = &builder2d[i];
         builder_container2d[i].second = &dndx_interpolant_2d_[i];
@@ -215,4 +219,6 @@ void PhotoPairInterpolant::InitdNdxInterpolation(const InterpolationDef& def)
     // builder2d.insert(builder2d.end(), builder1d.begin(), builder1d.end());
 
     Helper::InitializeInterpolation("dNdx", builder_return, std::vector<Parametrization*>(1, parametrization_), def);
+
+    InitdNdxInverseInterpolation(def, ME);
 }
@@ -18,6 +18,7 @@ WeakInterpolant::WeakInterpolant(const WeakInteraction& param, InterpolationDef
         : CrossSectionInterpolant(InteractionType::WeakInt, param) {
     // Use parent CrossSecition dNdx interpolation
     InitdNdxInterpolation(def);
+    InitChebyshevSeries(def);
 }
 
 WeakInterpolant::WeakInterpolant(const WeakInterpolant& param)
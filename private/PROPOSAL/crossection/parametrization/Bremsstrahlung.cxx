@@ -113,6 +113,12 @@ double Bremsstrahlung::DifferentialCrossSection(double energy, double v)
 
 // ------------------------------------------------------------------------- //
 Parametrization::IntegralLimits Bremsstrahlung::GetIntegralLimits(double energy)
+{
+    return GetIntegralLimits(energy, component_index_);
+}
+
+// ------------------------------------------------------------------------- //
+Parametrization::IntegralLimits Bremsstrahlung::GetIntegralLimits(double energy, int component)
 {
     IntegralLimits limits;
 
@@ -120,7 +126,7 @@ Parametrization::IntegralLimits Bremsstrahlung::GetIntegralLimits(double energy)
 
     // The limit is taken from the Petrukhin/Shestakov Parametrization
     limits.vMax =
-        1 - 0.75 * SQRTE * (particle_def_.mass / energy) * std::pow(components_[component_index_].GetNucCharge(), 1. / 3);
+        1 - 0.75 * SQRTE * (particle_def_.mass / energy) * std::pow(components_[component].GetNucCharge(), 1. / 3);
 
     if (limits.vMax < 0)
     {
@@ -582,25 +588,23 @@ BremsElectronScreening::BremsElectronScreening(const ParticleDef& particle_def,
                                const EnergyCutSettings& cuts,
                                double multiplier,
                                bool lpm)
-        : Bremsstrahlung(particle_def, medium, cuts, multiplier, lpm), interpolant_(NULL)
+        : Bremsstrahlung(particle_def, medium, cuts, multiplier, lpm), interpolant_(nullptr)
     {
-        interpolant_ = new Interpolant(A_logZ, A_energies, A_correction, 2, false, false, 2, false, false);
+        interpolant_ = std::make_shared<Interpolant>(A_logZ, A_energies, A_correction, 2, false, false, 2, false, false);
     }
 
 BremsElectronScreening::BremsElectronScreening(const BremsElectronScreening& brems)
-        : Bremsstrahlung(brems), interpolant_(new Interpolant(*brems.interpolant_))
+        : Bremsstrahlung(brems), interpolant_(brems.interpolant_)
     {
     }
 
-BremsElectronScreening::~BremsElectronScreening() {
-    delete interpolant_;
-}
+BremsElectronScreening::~BremsElectronScreening() {}
 
 bool BremsElectronScreening::compare(const Parametrization& parametrization) const
 {
     const BremsElectronScreening* bremsstrahlung = static_cast<const BremsElectronScreening*>(&parametrization);
 
-    if (interpolant_ != bremsstrahlung->interpolant_)
+    if (*interpolant_ != *bremsstrahlung->interpolant_)
         return false;
     else
         return Bremsstrahlung::compare(parametrization);
@@ -80,13 +80,19 @@ bool EpairProduction::compare(const Parametrization& parametrization) const
 
 // ------------------------------------------------------------------------- //
 Parametrization::IntegralLimits EpairProduction::GetIntegralLimits(double energy)
+{
+    return GetIntegralLimits(energy, component_index_);
+}
+
+// ------------------------------------------------------------------------- //
+Parametrization::IntegralLimits EpairProduction::GetIntegralLimits(double energy, int component)
 {
     IntegralLimits limits;
 
     double aux = particle_def_.mass / energy;
 
     limits.vMin = 4 * ME / energy;
-    limits.vMax = 1 - 0.75 * SQRTE * aux * std::pow(components_[component_index_].GetNucCharge(), 1. / 3);
+    limits.vMax = 1 - 0.75 * SQRTE * aux * std::pow(components_[component].GetNucCharge(), 1. / 3);
 
     aux         = 1 - 6 * aux * aux;
     limits.vMax = std::min(limits.vMax, aux);
@@ -239,7 +239,7 @@ PhotoRhode::PhotoRhode(const ParticleDef& particle_def,
                        double multiplier,
                        bool hard_component)
     : PhotoRealPhotonAssumption(particle_def, medium, cuts, multiplier, hard_component)
-    , interpolant_(NULL)
+    , interpolant_(nullptr)
 {
     std::vector<double> x = { 0,           0.1,         0.144544,   0.20893,     0.301995,    0.436516,    0.630957,
                        0.912011,    1.31826,     1.90546,    2.75423,     3.98107,     5.7544,      8.31764,
@@ -257,19 +257,16 @@ PhotoRhode::PhotoRhode(const ParticleDef& particle_def,
                        223.497, 235.876,   248.921,   262.631, 277.006, 292.046, 307.751, 324.121, 341.157,
                        358.857, 377.222,   396.253,   415.948, 436.309, 457.334, 479.025 };
 
-    interpolant_ = new Interpolant(x, y, 4, false, false);
+    interpolant_ = std::make_shared<Interpolant>(x, y, 4, false, false);
 }
 
 PhotoRhode::PhotoRhode(const PhotoRhode& photo)
     : PhotoRealPhotonAssumption(photo)
-    , interpolant_(new Interpolant(*photo.interpolant_))
+    , interpolant_(photo.interpolant_)
 {
 }
 
-PhotoRhode::~PhotoRhode()
-{
-    delete interpolant_;
-}
+PhotoRhode::~PhotoRhode() {}
 
 Photonuclear* PhotoRhode::create(const ParticleDef& particle_def,
                                  std::shared_ptr<const Medium> medium,
@@ -284,7 +281,7 @@ bool PhotoRhode::compare(const Parametrization& parametrization) const
 {
     const PhotoRhode* photo = static_cast<const PhotoRhode*>(&parametrization);
 
-    if (interpolant_ != photo->interpolant_)
+    if (*interpolant_ != *photo->interpolant_)
         return false;
     else
         return PhotoRealPhotonAssumption::compare(parametrization);
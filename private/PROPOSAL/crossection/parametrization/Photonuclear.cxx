@@ -52,7 +52,7 @@ HardComponent::HardComponent(const ParticleDef& particle_def)
     {
         for (unsigned int i = 0; i < y.size(); i++)
         {
-            interpolant_.push_back(new Interpolant(x, y.at(i), 4, false, false));
+            interpolant_.push_back(std::make_shared<Interpolant>(x, y.at(i), 4, false, false));
         }
     } else
     {
@@ -62,23 +62,11 @@ HardComponent::HardComponent(const ParticleDef& particle_def)
 
 HardComponent::HardComponent(const HardComponent& hard_component)
     : RealPhoton(hard_component)
-    , interpolant_()
+    , interpolant_(hard_component.interpolant_)
 {
-    interpolant_.resize(hard_component.interpolant_.size());
-
-    for (unsigned int i = 0; i < hard_component.interpolant_.size(); ++i)
-    {
-        interpolant_[i] = new Interpolant(*hard_component.interpolant_[i]);
-    }
 }
 
-HardComponent::~HardComponent()
-{
-    for (auto interpolant: interpolant_)
-    {
-        delete interpolant;
-    }
-}
+HardComponent::~HardComponent() {}
 
 bool HardComponent::compare(const RealPhoton& photon) const
 {
@@ -297,17 +285,23 @@ bool Photonuclear::compare(const Parametrization& parametrization) const
 
 // ------------------------------------------------------------------------- //
 Parametrization::IntegralLimits Photonuclear::GetIntegralLimits(double energy)
+{
+    return GetIntegralLimits(energy, component_index_);
+}
+
+// ------------------------------------------------------------------------- //
+Parametrization::IntegralLimits Photonuclear::GetIntegralLimits(double energy, int component)
 {
     double aux;
 
     IntegralLimits limits;
 
-    limits.vMin = (MPI + MPI * MPI / (2 * components_[component_index_].GetAverageNucleonWeight())) / energy;
+    limits.vMin = (MPI + MPI * MPI / (2 * components_[component].GetAverageNucleonWeight())) / energy;
 
     if (particle_def_.mass < MPI)
     {
-        aux         = particle_def_.mass / components_[component_index_].GetAverageNucleonWeight();
-        limits.vMax = 1 - components_[component_index_].GetAverageNucleonWeight() * (1 + aux * aux) / (2 * energy);
+        aux         = particle_def_.mass / components_[component].GetAverageNucleonWeight();
+        limits.vMax = 1 - components_[component].GetAverageNucleonWeight() * (1 + aux * aux) / (2 * energy);
     } else
     {
         limits.vMax = 1;
@@ -70,19 +70,19 @@ WeakCooperSarkarMertsch::WeakCooperSarkarMertsch(const ParticleDef& particle_def
                                                  std::shared_ptr<const Medium> medium,
                                                  double multiplier)
         : WeakInteraction(particle_def, medium, multiplier)
-        , interpolant_(2, NULL)
+        , interpolant_(2, nullptr)
 {
 
     if(particle_def.charge < 0.)
     {
         // Initialize interpolant for particles (remember crossing symmetry rules)
-        interpolant_[0] = new Interpolant(energies, y_nubar_p, sigma_nubar_p, IROMB, false, false, IROMB, false, false);
-        interpolant_[1] = new Interpolant(energies, y_nubar_n, sigma_nubar_n, IROMB, false, false, IROMB, false, false);
+        interpolant_[0] = std::make_shared<Interpolant>(energies, y_nubar_p, sigma_nubar_p, IROMB, false, false, IROMB, false, false);
+        interpolant_[1] = std::make_shared<Interpolant>(energies, y_nubar_n, sigma_nubar_n, IROMB, false, false, IROMB, false, false);
     }
     else if(particle_def.charge > 0.){
         // Initialize interpolant for antiparticles (remember crossing symmetry rules)
-        interpolant_[0] = new Interpolant(energies, y_nu_p, sigma_nu_p, IROMB, false, false, IROMB, false, false);
-        interpolant_[1] = new Interpolant(energies, y_nu_n, sigma_nu_n, IROMB, false, false, IROMB, false, false);
+        interpolant_[0] = std::make_shared<Interpolant>(energies, y_nu_p, sigma_nu_p, IROMB, false, false, IROMB, false, false);
+        interpolant_[1] = std::make_shared<Interpolant>(energies, y_nu_n, sigma_nu_n, IROMB, false, false, IROMB, false, false);
     }else{
         log_fatal("Weak interaction: Particle to propagate is not a charged lepton");
     }
@@ -91,25 +91,11 @@ WeakCooperSarkarMertsch::WeakCooperSarkarMertsch(const ParticleDef& particle_def
 
 WeakCooperSarkarMertsch::WeakCooperSarkarMertsch(const WeakCooperSarkarMertsch& param)
         : WeakInteraction(param)
-        , interpolant_()
+        , interpolant_(param.interpolant_)
 {
-    interpolant_.resize(param.interpolant_.size());
-
-    for (unsigned int i = 0; i < param.interpolant_.size(); ++i)
-    {
-        interpolant_[i] = new Interpolant(*param.interpolant_[i]);
-    }
 }
 
-WeakCooperSarkarMertsch::~WeakCooperSarkarMertsch()
-{
-    for (std::vector<Interpolant*>::const_iterator iter = interpolant_.begin(); iter != interpolant_.end(); ++iter)
-    {
-        delete *iter;
-    }
-
-    interpolant_.clear();
-}
+WeakCooperSarkarMertsch::~WeakCooperSarkarMertsch() {}
 
 bool WeakCooperSarkarMertsch::compare(const Parametrization& parametrization) const
 {
@@ -217,6 +217,8 @@ double ManyBodyPhaseSpace::Evaluate(const DynamicData& p_condition, const std::v
 // ------------------------------------------------------------------------- //
 ManyBodyPhaseSpace::PhaseSpaceParameters ManyBodyPhaseSpace::GetPhaseSpaceParams(const ParticleDef& parent_def)
 {
+    std::lock_guard<std::mutex> lock(parameter_map_mutex_);
+
     ParameterMap::iterator it = parameter_map_.find(parent_def);
 
     if (it != parameter_map_.end())
@@ -25,10 +25,13 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 
 #include "PROPOSAL/math/Interpolant.h"
+#include "PROPOSAL/math/ParallelFor.h"
+#include "PROPOSAL/Constants.h"
 #include "PROPOSAL/Logging.h"
 
 using namespace PROPOSAL;
@@ -36,44 +39,351 @@ using namespace PROPOSAL;
 const double Interpolant::bigNumber_  = -300;
 const double Interpolant::aBigNumber_ = -299;
 
+namespace {
+
+// Scratch space of a single evaluation. It lives on the stack for the usual
+// interpolation orders, so concurrent evaluations never share memory.
+class Scratch
+{
+public:
+    explicit Scratch(int size)
+        : heap_()
+        , data_(stack_)
+    {
+        if (size > stack_size)
+        {
+            heap_.resize(size);
+            data_ = heap_.data();
+        }
+    }
+
+    double& operator[](int i) { return data_[i]; }
+    double* data() { return data_; }
+
+private:
+    static const int stack_size = 32;
+
+    double stack_[stack_size];
+    std::vector<double> heap_;
+    double* data_;
+};
+
+// Maximum number of rows of a 2d table evaluated at once on the grid
+const int max_grid_rows = 16;
+
+// Number of values in a grid of rows starting at cache lines, including one
+// more cache line to align the first row
+template <typename T>
+size_t GridSize(int rows, int max)
+{
+    size_t line   = 64 / sizeof(T);
+    size_t stride = (max + line - 1) / line * line;
+
+    return rows * stride + line - 1;
+}
+
+// First value of a row in a grid, which depends on the alignment of the
+// memory of the grid
+template <typename T>
+const T* AlignedRow(const T* grid, int max, int row)
+{
+    size_t line   = 64 / sizeof(T);
+    size_t stride = (max + line - 1) / line * line;
+    size_t offset = (line - reinterpret_cast<std::uintptr_t>(grid) / sizeof(T) % line) % line;
+
+    return grid + offset + row * stride;
+}
+
+// Maximum order of interpolation with kernels specialized at compile time
+const int max_kernel_romberg = 8;
+
+// Maximum number of terms of the Chebyshev series of a 1d table, the series
+// is fitted with 8, 12, 16, 24, ... terms up to this number
+const int max_chebyshev_terms = 128;
+
+// Number of steps in which the start of the Chebyshev series of a 1d table is
+// moved up to the middle of the table, see FitChebyshev
+const int chebyshev_start_steps = 8;
+
+// Polynomial interpolation of several points at once with the Neville scheme
+// of fast tables. The sampling points of every point are stored lane by
+// lane, so the inner loops over the lanes are free of dependencies and can be
+// vectorized by the compiler. Every lane does the same operations in the same
+// order as the scalar version, so the results are identical.
+class NevilleBlock
+{
+public:
+    static const int width       = 8;
+    static const int max_romberg = 16;
+
+    explicit NevilleBlock(int romberg)
+        : romberg_(romberg)
+        , size_(0)
+    {
+        for (int i = 0; i < max_romberg; i++)
+        {
+            for (int l = 0; l < width; l++)
+            {
+                iX_[i][l] = 0;
+                c_[i][l]  = 0;
+                d_[i][l]  = 0;
+            }
+        }
+
+        for (int l = 0; l < width; l++)
+        {
+            x_[l]      = 0;
+            result_[l] = 0;
+            num_[l]    = 0;
+            dd_[l]     = false;
+            out_[l]    = nullptr;
+        }
+    }
+
+    // Orders above max_romberg have to be evaluated one by one.
+    static bool Supports(int romberg) { return romberg <= max_romberg; }
+
+    ~NevilleBlock() { Flush(); }
+
+    // Adds a point, the result is written to out at the latest on Flush.
+    void Add(const double* iX, const double* iY, double x, int start, int starti, double* out)
+    {
+        int num = starti - start;
+
+        if (x == iX[starti])
+        {
+            *out = iY[starti];
+            return;
+        }
+
+        int l = size_;
+
+        for (int i = 0; i < romberg_; i++)
+        {
+            iX_[i][l] = iX[start + i];
+            c_[i][l]  = iY[start + i];
+            d_[i][l]  = iY[start + i];
+        }
+
+        bool dd;
+
+        if (num == 0)
+        {
+            dd = true;
+        } else if (num == romberg_ - 1)
+        {
+            dd = false;
+        } else
+        {
+            double aux  = iX[start + num - 1];
+            double aux2 = iX[start + num + 1];
+
+            dd = ((x - aux) > (aux2 - x)) == (aux2 > aux);
+        }
+
+        x_[l]      = x;
+        num_[l]    = num;
+        dd_[l]     = dd;
+        result_[l] = iY[start + num];
+        out_[l]    = out;
+
+        if (++size_ == width)
+        {
+            Flush();
+        }
+    }
+
+    void Flush()
+    {
+        if (size_ == 0)
+        {
+            return;
+        }
+
+        for (int k = 1; k < romberg_; k++)
+        {
+            for (int i = 0; i < romberg_ - k; i++)
+            {
+                const double* iXi  = iX_[i];
+                const double* iXik = iX_[i + k];
+                const double* ci1  = c_[i + 1];
+                double* ci         = c_[i];
+                double* di         = d_[i];
+
+                // Unused lanes hold finite values of earlier points.
+                for (int l = 0; l < width; l++)
+                {
+                    double dx1  = iXi[l] - x_[l];
+                    double dx2  = iXik[l] - x_[l];
+                    double aux  = ci1[l] - di[l];
+                    double aux2 = dx1 - dx2;
+
+                    // divide in every lane to keep the loop free of branches
+                    double div = aux2 != 0 ? aux2 : 1;
+
+                    aux   = aux2 != 0 ? aux / div : 0;
+                    ci[l] = dx1 * aux;
+                    di[l] = dx2 * aux;
+                }
+            }
+
+            // The path through the tableau differs between the points and
+            // is followed without branches.
+            for (int l = 0; l < size_; l++)
+            {
+                int num = num_[l];
+                bool dd = num != romberg_ - k && (num == 0 || dd_[l]);
+
+                num -= !dd;
+                result_[l] += dd ? c_[num][l] : d_[num][l];
+
+                num_[l] = num;
+                dd_[l]  = !dd;
+            }
+        }
+
+        for (int l = 0; l < size_; l++)
+        {
+            *out_[l] = result_[l];
+        }
+
+        size_ = 0;
+    }
+
+private:
+    int romberg_;
+    int size_;
+
+    double iX_[max_romberg][width];
+    double c_[max_romberg][width];
+    double d_[max_romberg][width];
+
+    double x_[width];
+    double result_[width];
+    int num_[width];
+    bool dd_[width];
+    double* out_[width];
+};
+
+// Every part of a table saved by SaveMapped starts at a cache line
+const size_t mapped_line = 64;
+
+// Settings of a table saved by SaveMapped, followed by the sampling points
+// and the function values. For 2d tables, the settings of the rows, their
+// sampling points and their function values follow. The sampling points of
+// the rows are only stored once if they are the same for all rows.
+struct MappedTable
+{
+    int32_t rows; // 0 for 1d tables
+    int32_t max;
+    double xmin; // as passed to InitInterpolant
+    double xmax;
+    int32_t romberg;
+    int32_t rombergY;
+    uint8_t rational;
+    uint8_t relative;
+    uint8_t isLog;
+    uint8_t rationalY;
+    uint8_t relativeY;
+    uint8_t logSubst;
+    uint8_t shared_x; // 2d tables only
+    uint8_t unused;
+};
+
+static_assert(sizeof(MappedTable) <= mapped_line, "the settings have to fit in a cache line");
+
+size_t MappedSize(size_t bytes)
+{
+    return (bytes + mapped_line - 1) / mapped_line * mapped_line;
+}
+
+// Number of values between the rows of a 2d table in the mapped layout, the
+// same as in grid_
+size_t MappedStride(int max)
+{
+    size_t line = mapped_line / sizeof(double);
+
+    return (max + line - 1) / line * line;
+}
+
+void AppendMapped(std::string& block, const void* data, size_t bytes)
+{
+    block.append(static_cast<const char*>(data), bytes);
+    block.append(MappedSize(block.size()) - block.size(), '\0');
+}
+
+// Returns the part of the block at offset and moves the offset behind it
+const char* TakeMapped(const char* block, size_t size, size_t& offset, size_t bytes)
+{
+    if (offset > size || MappedSize(bytes) > size - offset)
+    {
+        return nullptr;
+    }
+
+    const char* part = block + offset;
+    offset += MappedSize(bytes);
+
+    return part;
+}
+
+// Upper limit of the sampling points of a loaded table, far above the number
+// of nodes ever used. A larger number is read from a broken table.
+const int max_loaded_nodes = 1 << 24;
+
+// Checks the settings read from a table before memory is allocated for it
+bool ValidSettings(int max, double xmin, double xmax, int romberg, int rombergY)
+{
+    return max > 0 && max <= max_loaded_nodes && std::isfinite(xmin) && std::isfinite(xmax) && romberg > 0
+           && rombergY > 0;
+}
+
+} // namespace
+
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 //-------------------------public member functions----------------------------//
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-double Interpolant::Interpolate(double x)
+double Interpolant::Interpolate(double x) const
 {
-    int start;
-    double result, aux;
+    int start, starti;
+    double result;
 
-    if (isLog_)
+    // the series is not extrapolated
+    if (!chebyshev_.empty())
     {
-        x = Slog(x);
-    }
+        result = isLog_ ? Log(x) : x;
 
-    reverse_ = true;
-    aux      = (x - xmin_) / step_;
-    starti_  = (int)aux;
+        if (result >= chebyshev_min_ && result <= xmax_)
+        {
+            return Exp(EvaluateChebyshev(result));
+        }
+    }
 
-    if (starti_ < 0)
+    if (kernel_ != nullptr)
     {
-        starti_ = 0;
-    } else if (starti_ >= max_)
+        return kernel_(*this, x);
+    }
+
+    if (isLog_)
     {
-        starti_ = max_ - 1;
+        x = Log(x);
     }
 
-    start = (int)(aux - 0.5 * (romberg_ - 1));
+    LocateEquidistant(x, start, starti);
 
-    if (start < 0)
+    if (polynomials_.empty())
     {
-        start = 0;
-    } else if (start + romberg_ > max_ || start > max_)
+        result = Interpolate(
+            iX_.data(), iY_.data(), x, start, starti, romberg_, rational_, relative_, true, precision_, worstX_);
+    } else if (x == iX_[starti])
     {
-        start = max_ - romberg_;
+        result = iY_[starti];
+    } else
+    {
+        result = EvaluatePolynomial(x, start);
     }
-    result = Interpolate(x, start);
 
     if (logSubst_)
     {
@@ -89,9 +399,9 @@ double Interpolant::Interpolate(double x)
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-double Interpolant::Interpolate(double x1, double x2)
+double Interpolant::Interpolate(double x1, double x2) const
 {
-    int i, start;
+    int i, start, starti, first, last;
     double aux, aux2 = 0, result;
 
     if (isLog_)
@@ -99,33 +409,14 @@ double Interpolant::Interpolate(double x1, double x2)
         x2 = std::log(x2);
     }
 
-    reverse_ = true;
-
-    aux     = (x2 - xmin_) / step_;
-    starti_ = (int)aux;
+    LocateEquidistant(x2, start, starti);
 
-    if (starti_ < 0)
-    {
-        starti_ = 0;
-    } else if (starti_ >= max_)
-    {
-        starti_ = max_ - 1;
-    }
-
-    start = (int)(aux - 0.5 * (romberg_ - 1));
+    first = std::min(start, starti);
+    last  = std::max(start + romberg_ - 1, starti);
 
-    if (start < 0)
-    {
-        start = 0;
-    } else if (start + romberg_ > max_ || start > max_)
-    {
-        start = max_ - romberg_;
-    }
+    Scratch iY(last - first + 1);
 
-    for (i = start; i < start + romberg_; i++)
-    {
-        iY_.at(i) = Interpolant_.at(i)->Interpolate(x1);
-    }
+    InterpolateRows(x1, first, last, iY.data());
 
     if (!fast_)
     {
@@ -147,7 +438,23 @@ double Interpolant::Interpolate(double x1, double x2)
         }
     }
 
-    result = Interpolate(x2, start);
+    if (neville_ != nullptr)
+    {
+        result = neville_(iX_.data() + first, iY.data(), x2, start - first, starti - first);
+    } else
+    {
+        result = Interpolate(iX_.data() + first,
+                             iY.data(),
+                             x2,
+                             start - first,
+                             starti - first,
+                             romberg_,
+                             rational_,
+                             relative_,
+                             true,
+                             precision_,
+                             worstX_);
+    }
 
     if (logSubst_)
     {
@@ -160,77 +467,183 @@ double Interpolant::Interpolate(double x1, double x2)
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-double Interpolant::InterpolateArray(double x)
+double Interpolant::InterpolateArray(double x) const
 {
-    int i, j, m, start, auxdir;
-    bool dir;
+    int start, starti;
 
-    reverse_ = false;
-    i        = 0;
-    j        = max_ - 1;
-    dir      = iX_.at(max_ - 1) > iX_.at(0);
+    LocateArray(iX_, x, romberg_, start, starti);
 
-    while (j - i > 1)
+    return Interpolate(
+        iX_.data(), iY_.data(), x, start, starti, romberg_, rational_, relative_, false, precision_, worstX_);
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+double Interpolant::InterpolateArray(double x1, double x2) const
+{
+    int i, start, starti, first, last;
+    double aux, aux2;
+
+    LocateArray(iX_, x1, romberg_, start, starti);
+
+    first = std::min(start, starti);
+    last  = std::max(start + romberg_ - 1, starti);
+
+    Scratch iY(last - first + 1);
+
+    for (i = first; i <= last; i++)
     {
-        m = (i + j) / 2;
+        iY[i - first] = Interpolant_[i]->InterpolateArray(x2);
+    }
 
-        if ((x > iX_.at(m)) == dir)
+    if (!fast_)
+    {
+        aux  = 0;
+        aux2 = 0;
+
+        for (i = start; i < start + romberg_; i++)
         {
-            i = m;
-        } else
+            if (Interpolant_.at(i)->precision_ > aux)
+            {
+                aux  = Interpolant_.at(i)->precision_;
+                aux2 = Interpolant_.at(i)->worstX_;
+            }
+        }
+
+        if (aux > precision2_)
         {
-            j = m;
+            precision2_ = aux;
+            worstX2_    = aux2;
         }
     }
 
-    if (i + 1 < max_)
+    return Interpolate(iX_.data() + first,
+                       iY.data(),
+                       x1,
+                       start - first,
+                       starti - first,
+                       romberg_,
+                       rational_,
+                       relative_,
+                       false,
+                       precision_,
+                       worstX_);
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+double Interpolant::FindLimit(double y) const
+{
+    int start, starti;
+    double result;
+
+    if (logSubst_)
     {
-        if (((x - iX_.at(i)) < (iX_.at(i + 1) - x)) == dir)
-        {
-            auxdir = 0;
-        } else
-        {
-            auxdir = 1;
-        }
+        y = Log(y);
+    }
+
+    LocateArray(iY_, y, rombergY_, start, starti);
+
+    // The inverse interpolation runs on the swapped tables. As before, the
+    // rational flag of the inverse is only taken into account if the
+    // precision is tracked.
+    if (inverse_ != nullptr)
+    {
+        result = inverse_(iY_.data(), iX_.data(), y, start, starti);
     } else
     {
-        auxdir = 0;
+        result = Interpolate(iY_.data(),
+                             iX_.data(),
+                             y,
+                             start,
+                             starti,
+                             rombergY_,
+                             fast_ ? rational_ : rationalY_,
+                             relativeY_,
+                             false,
+                             precisionY_,
+                             worstY_);
     }
 
-    starti_ = i + auxdir;
-    start   = i - (int)(0.5 * (romberg_ - 1 - auxdir));
-
-    if (start < 0)
+    if (result < xmin_)
     {
-        start = 0;
+        result = xmin_;
+    } else if (result > xmax_)
+    {
+        result = xmax_;
     }
 
-    if (start + romberg_ > max_ || start > max_)
+    if (isLog_)
     {
-        start = max_ - romberg_;
+        result = Exp(result);
     }
 
-    return Interpolate(x, start);
+    return result;
 }
 
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-double Interpolant::InterpolateArray(double x1, double x2)
+double Interpolant::FindLimit(double x1, double y) const
 {
-    int i, j, m, start, auxdir, aux, aux2;
+    int i, j, m, start, starti, first, last, auxdir;
     bool dir;
+    double result, aux, aux2 = 0;
+
+    if (logSubst_)
+    {
+        y = Log(y);
+    }
+
+    // Without the flag all rows are evaluated once up front, otherwise only
+    // the rows needed by the bisection are evaluated.
+    Scratch rows(flag_ ? 0 : max_);
+
+    if (!flag_)
+    {
+        InterpolateRows(x1, 0, max_ - 1, rows.data());
+    }
+
+    // the rows in the grid are located once for all rows
+    bool grid = HasGrid();
+    double x = 0;
+    int start1 = 0, starti1 = 0;
 
-    reverse_ = false;
-    i        = 0;
-    j        = max_ - 1;
-    dir      = iX_.at(max_ - 1) > iX_.at(0);
+    if (grid && flag_)
+    {
+        LocateGrid(x1, x, start1, starti1);
+    }
+
+    auto interpolate_row = [&](int m) {
+        return grid ? InterpolateGrid(m, x, start1, starti1) : Interpolant_[m]->Interpolate(x1);
+    };
+
+    i = 0;
+    j = max_ - 1;
+
+    if (flag_)
+    {
+        dir = interpolate_row(max_ - 1) > interpolate_row(0);
+    } else
+    {
+        dir = rows[max_ - 1] > rows[0];
+    }
 
     while (j - i > 1)
     {
         m = (i + j) / 2;
 
-        if ((x1 > iX_.at(m)) == dir)
+        if (flag_)
+        {
+            aux = interpolate_row(m);
+        } else
+        {
+            aux = rows[m];
+        }
+
+        if ((y > aux) == dir)
         {
             i = m;
         } else
@@ -239,9 +652,21 @@ double Interpolant::InterpolateArray(double x1, double x2)
         }
     }
 
+    double lower = 0, upper = 0;
+
     if (i + 1 < max_)
     {
-        if (((x1 - iX_.at(i)) < (iX_.at(i + 1) - x1)) == dir)
+        if (flag_)
+        {
+            lower = interpolate_row(i);
+            upper = interpolate_row(i + 1);
+        } else
+        {
+            lower = rows[i];
+            upper = rows[i + 1];
+        }
+
+        if (((y - lower) < (upper - y)) == dir)
         {
             auxdir = 0;
         } else
@@ -253,30 +678,88 @@ double Interpolant::InterpolateArray(double x1, double x2)
         auxdir = 0;
     }
 
-    starti_ = i + auxdir;
-    start   = i - (int)(0.5 * (romberg_ - 1 - auxdir));
+    starti = i + auxdir;
+    start  = i - (int)(0.5 * (rombergY_ - 1 - auxdir));
 
     if (start < 0)
     {
         start = 0;
     }
 
-    if (start + romberg_ > max_ || start > max_)
+    if (start + rombergY_ > max_ || start > max_)
     {
-        start = max_ - romberg_;
+        start = max_ - rombergY_;
     }
 
-    for (i = start; i < start + romberg_; i++)
+    if (flag_)
     {
-        iY_.at(i) = Interpolant_.at(i)->InterpolateArray(x2);
-    }
+        first = std::min(start, starti);
+        last  = std::max(start + rombergY_ - 1, starti);
 
-    if (!fast_)
-    {
-        aux = 0;
-        aux2 = 0;
+        Scratch window(last - first + 1);
 
-        for (i = start; i < start + romberg_; i++)
+        for (m = first; m <= last; m++)
+        {
+            if (m == i && i + 1 < max_)
+            {
+                window[m - first] = lower;
+            } else if (m == i + 1)
+            {
+                window[m - first] = upper;
+            } else
+            {
+                window[m - first] = interpolate_row(m);
+            }
+        }
+
+        if (inverse_ != nullptr)
+        {
+            result = inverse_(window.data(), iX_.data() + first, y, start - first, starti - first);
+        } else
+        {
+            result = Interpolate(window.data(),
+                                 iX_.data() + first,
+                                 y,
+                                 start - first,
+                                 starti - first,
+                                 rombergY_,
+                                 fast_ ? rational_ : rationalY_,
+                                 relativeY_,
+                                 false,
+                                 precisionY_,
+                                 worstY_);
+        }
+    } else if (inverse_ != nullptr)
+    {
+        result = inverse_(rows.data(), iX_.data(), y, start, starti);
+    } else
+    {
+        result = Interpolate(rows.data(),
+                             iX_.data(),
+                             y,
+                             start,
+                             starti,
+                             rombergY_,
+                             fast_ ? rational_ : rationalY_,
+                             relativeY_,
+                             false,
+                             precisionY_,
+                             worstY_);
+    }
+
+    if (result < xmin_)
+    {
+        result = xmin_;
+    } else if (result > xmax_)
+    {
+        result = xmax_;
+    }
+
+    if (!fast_)
+    {
+        aux = 0;
+
+        for (i = start; i < start + rombergY_; i++)
         {
             if (Interpolant_.at(i)->precision_ > aux)
             {
@@ -292,7 +775,10 @@ double Interpolant::InterpolateArray(double x1, double x2)
         }
     }
 
-    double result = Interpolate(x1, start);
+    if (isLog_)
+    {
+        result = std::exp(result);
+    }
 
     return result;
 }
@@ -300,329 +786,572 @@ double Interpolant::InterpolateArray(double x1, double x2)
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-double Interpolant::FindLimit(double y)
+void Interpolant::Interpolate(const double* x, double* out, size_t n) const
 {
-    int i, j, m, start, auxdir;
-    bool dir, rat, rel;
-    double result;
-
-    rat      = false;
-    reverse_ = false;
-
-    if (logSubst_)
+    if (!fast_ || rational_ || !polynomials_.empty() || !NevilleBlock::Supports(romberg_))
     {
-        y = Log(y);
+        for (size_t p = 0; p < n; p++)
+        {
+            out[p] = Interpolate(x[p]);
+        }
+
+        return;
     }
 
-    i   = 0;
-    j   = max_ - 1;
-    dir = iY_.at(max_ - 1) > iY_.at(0);
+    int start, starti;
+    double xp;
 
-    while (j - i > 1)
     {
-        m = (i + j) / 2;
+        NevilleBlock block(romberg_);
 
-        if ((y > iY_.at(m)) == dir)
-        {
-            i = m;
-        } else
+        for (size_t p = 0; p < n; p++)
         {
-            j = m;
-        }
-    }
+            xp = isLog_ ? Log(x[p]) : x[p];
 
-    iX_.swap(iY_);
-    if (!fast_)
-    {
-        std::swap(precision_, precisionY_);
-        std::swap(worstX_, worstY_);
+            LocateEquidistant(xp, start, starti);
 
-        rat       = rational_;
-        rational_ = rationalY_;
+            if (HasLogZero(iY_.data() + start, romberg_))
+            {
+                out[p] = Interpolate(
+                    iX_.data(), iY_.data(), xp, start, starti, romberg_, rational_, relative_, true, precision_, worstX_);
+            } else
+            {
+                block.Add(iX_.data(), iY_.data(), xp, start, starti, out + p);
+            }
+        }
     }
 
-    std::swap(romberg_, rombergY_);
-
-    rel       = relative_;
-    relative_ = relativeY_;
-
-    if (i + 1 < max_)
+    if (logSubst_ && self_)
     {
-        if (((y - iX_.at(i)) < (iX_.at(i + 1) - y)) == dir)
-        {
-            auxdir = 0;
-        } else
+        for (size_t p = 0; p < n; p++)
         {
-            auxdir = 1;
+            out[p] = Exp(out[p]);
         }
-    } else
-    {
-        auxdir = 0;
     }
+}
 
-    starti_ = i + auxdir;
-    start   = i - (int)(0.5 * (romberg_ - 1 - auxdir));
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
 
-    if (start < 0)
+void Interpolant::Interpolate(const double* x1, const double* x2, double* out, size_t n) const
+{
+    if (!fast_ || rational_ || !NevilleBlock::Supports(romberg_))
     {
-        start = 0;
-    }
+        for (size_t p = 0; p < n; p++)
+        {
+            out[p] = Interpolate(x1[p], x2[p]);
+        }
 
-    if (start + romberg_ > max_ || start > max_)
-    {
-        start = max_ - romberg_;
+        return;
     }
 
-    result = Interpolate(y, start);
-
-    iX_.swap(iY_);
+    int start, starti, first, last;
+    double xp;
 
-    if (!fast_)
     {
-        std::swap(precision_, precisionY_);
-        std::swap(worstX_, worstY_);
+        NevilleBlock block(romberg_);
 
-        rational_ = rat;
-    }
+        for (size_t p = 0; p < n; p++)
+        {
+            xp = isLog_ ? std::log(x2[p]) : x2[p];
 
-    std::swap(romberg_, rombergY_);
+            LocateEquidistant(xp, start, starti);
 
-    relative_ = rel;
+            first = std::min(start, starti);
+            last  = std::max(start + romberg_ - 1, starti);
 
-    if (result < xmin_)
-    {
-        result = xmin_;
-    } else if (result > xmax_)
-    {
-        result = xmax_;
+            Scratch iY(last - first + 1);
+
+            InterpolateRows(x1[p], first, last, iY.data());
+
+            if (HasLogZero(iY.data() + start - first, romberg_))
+            {
+                out[p] = Interpolate(iX_.data() + first,
+                                     iY.data(),
+                                     xp,
+                                     start - first,
+                                     starti - first,
+                                     romberg_,
+                                     rational_,
+                                     relative_,
+                                     true,
+                                     precision_,
+                                     worstX_);
+            } else
+            {
+                block.Add(iX_.data() + first, iY.data(), xp, start - first, starti - first, out + p);
+            }
+        }
     }
 
-    if (isLog_)
+    if (logSubst_)
     {
-        result = Exp(result);
+        for (size_t p = 0; p < n; p++)
+        {
+            out[p] = Exp(out[p]);
+        }
     }
-
-    return result;
 }
 
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-double Interpolant::FindLimit(double x1, double y)
+void Interpolant::FindLimit(const double* y, double* out, size_t n) const
 {
-    int i, j, m, start, auxdir;
-    bool dir;
-    double result, aux, aux2 = 0;
-
-    reverse_ = false;
-
-    if (logSubst_)
-    {
-        y = Log(y);
-    }
-
-    if (!flag_)
+    if (!fast_ || rational_ || !NevilleBlock::Supports(rombergY_))
     {
-        for (i = 0; i < max_; i++)
+        for (size_t p = 0; p < n; p++)
         {
-            iY_.at(i) = Interpolant_.at(i)->Interpolate(x1);
+            out[p] = FindLimit(y[p]);
         }
+
+        return;
     }
 
-    i = 0;
-    j = max_ - 1;
+    int start, starti;
+    double yp;
 
-    if (flag_)
-    {
-        dir = Interpolant_.at(max_ - 1)->Interpolate(x1) > Interpolant_.at(0)->Interpolate(x1);
-    } else
     {
-        dir = iY_.at(max_ - 1) > iY_.at(0);
+        NevilleBlock block(rombergY_);
+
+        for (size_t p = 0; p < n; p++)
+        {
+            yp = logSubst_ ? Log(y[p]) : y[p];
+
+            LocateArray(iY_, yp, rombergY_, start, starti);
+
+            block.Add(iY_.data(), iX_.data(), yp, start, starti, out + p);
+        }
     }
 
-    while (j - i > 1)
+    for (size_t p = 0; p < n; p++)
     {
-        m = (i + j) / 2;
-
-        if (flag_)
+        if (out[p] < xmin_)
         {
-            aux = Interpolant_.at(m)->Interpolate(x1);
-        } else
+            out[p] = xmin_;
+        } else if (out[p] > xmax_)
         {
-            aux = iY_.at(m);
+            out[p] = xmax_;
         }
 
-        if ((y > aux) == dir)
-        {
-            i = m;
-        } else
+        if (isLog_)
         {
-            j = m;
+            out[p] = Exp(out[p]);
         }
     }
+}
 
-    iX_.swap(iY_);
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
 
-    if (!fast_)
+void Interpolant::FindLimit(const double* x1, const double* y, double* out, size_t n) const
+{
+    for (size_t p = 0; p < n; p++)
     {
-        std::swap(precision_, precisionY_);
-        std::swap(worstX_, worstY_);
-        std::swap(rational_, rationalY_);
+        out[p] = FindLimit(x1[p], y[p]);
     }
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
 
-    std::swap(romberg_, rombergY_);
-    std::swap(relative_, relativeY_);
+bool Interpolant::PrecomputePolynomials()
+{
+    if (!floats_.empty())
+    {
+        return false;
+    }
 
-    if (i + 1 < max_)
+    if (!Interpolant_.empty())
     {
-        // iX_ is not pre-filled if flag is true. Fill the bits we're about to use.
-        if (flag_)
-        {
-            iX_.at(i) = Interpolant_.at(i)->Interpolate(x1);
-            iX_.at(i+1) = Interpolant_.at(i+1)->Interpolate(x1);
-        }
-        if (((y - iX_.at(i)) < (iX_.at(i + 1) - y)) == dir)
-        {
-            auxdir = 0;
-        } else
+        bool success = true;
+
+        for (unsigned int i = 0; i < Interpolant_.size(); i++)
         {
-            auxdir = 1;
+            success = Interpolant_[i]->PrecomputePolynomials() && success;
         }
-    } else
-    {
-        auxdir = 0;
-    }
 
-    starti_ = i + auxdir;
-    start   = i - (int)(0.5 * (romberg_ - 1 - auxdir));
+        // rows with polynomials are evaluated by their own Interpolate
+        BuildGrid();
 
-    if (start < 0)
-    {
-        start = 0;
+        return success;
     }
 
-    if (start + romberg_ > max_ || start > max_)
+    if (rational_ || !fast_ || romberg_ > max_)
     {
-        start = max_ - romberg_;
+        return false;
     }
 
-    if (flag_)
+    int i, j, k, start;
+    int windows = max_ - romberg_ + 1;
+
+    polynomials_.resize(windows * romberg_);
+    log_zero_windows_.resize(windows);
+
+    // Newton divided differences of the sampling points of every window
+    for (start = 0; start < windows; start++)
     {
-        for (i = start; i < start + romberg_; i++)
-        {
-            iX_.at(i) = Interpolant_.at(i)->Interpolate(x1);
-        }
-    }
+        double* a        = &polynomials_[start * romberg_];
+        const double* iX = &iX_[start];
 
-    result = Interpolate(y, start);
+        log_zero_windows_[start] = HasLogZero(&iY_[start], romberg_);
 
-    iX_.swap(iY_);
+        for (j = 0; j < romberg_; j++)
+        {
+            a[j] = log_zero_windows_[start] ? Exp(iY_[start + j]) : iY_[start + j];
+        }
 
-    if (!fast_)
-    {
-        std::swap(precision_, precisionY_);
-        std::swap(worstX_, worstY_);
-        std::swap(rational_, rationalY_);
+        for (k = 1; k < romberg_; k++)
+        {
+            for (j = romberg_ - 1; j >= k; j--)
+            {
+                a[j] = (a[j] - a[j - 1]) / (iX[j] - iX[j - k]);
+            }
+        }
     }
 
-    std::swap(romberg_, rombergY_);
-    std::swap(relative_, relativeY_);
+    // Compare with the Neville scheme between all sampling points of every
+    // window. Windows with log substituted zeros are compared without the
+    // substitution, like they are interpolated.
+    const double tolerance = 1e-10;
 
-    if (result < xmin_)
-    {
-        result = xmin_;
-    } else if (result > xmax_)
-    {
-        result = xmax_;
-    }
+    double x, polynomial, neville, scale, dummy;
 
-    if (!fast_)
+    for (start = 0; start < windows; start++)
     {
-        aux = 0;
+        scale = 0;
 
-        for (i = start; i < start + romberg_; i++)
+        for (j = 0; j < romberg_; j++)
         {
-            if (Interpolant_.at(i)->precision_ > aux)
+            if (log_zero_windows_[start])
             {
-                aux  = Interpolant_.at(i)->precision_;
-                aux2 = Interpolant_.at(i)->worstX_;
+                scale = std::max(scale, Exp(iY_[start + j]));
+            } else
+            {
+                scale = std::max(scale, std::abs(iY_[start + j]));
             }
         }
 
-        if (aux > precision2_)
+        for (i = start; i < start + romberg_ - 1; i++)
         {
-            precision2_ = aux;
-            worstX2_    = aux2;
+            x          = 0.5 * (iX_[i] + iX_[i + 1]);
+            polynomial = EvaluatePolynomial(x, start);
+            neville    = Interpolate(
+                iX_.data(), iY_.data(), x, start, i, romberg_, rational_, relative_, true, dummy, dummy);
+
+            if (log_zero_windows_[start])
+            {
+                polynomial = Exp(polynomial);
+                neville    = Exp(neville);
+            }
+
+            if (!(std::abs(polynomial - neville) <= tolerance * std::max(scale, std::abs(neville))))
+            {
+                polynomials_.clear();
+                log_zero_windows_.clear();
+                SelectKernels();
+
+                return false;
+            }
         }
     }
 
-    if (isLog_)
-    {
-        result = std::exp(result);
-    }
+    // the kernels do not use the polynomials
+    SelectKernels();
 
-    return result;
+    return true;
 }
 
-//----------------------------------------------------------------------------//
-//----------------------------------------------------------------------------//
-//--------------------------------Save and Load-------------------------------//
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-bool Interpolant::Save(std::string Path, bool binary_tables)
+bool Interpolant::HasPolynomials() const
 {
-    std::ofstream out;
-
-    if (!binary_tables)
+    if (!Interpolant_.empty())
     {
-        std::stringstream ss;
-        ss << Path << ".txt";
-
-        out.open(ss.str().c_str());
-
-        out.precision(16);
-
-        if (!out.good())
+        for (unsigned int i = 0; i < Interpolant_.size(); i++)
         {
-            log_error("Can not open file %s for writing", Path.c_str());
-            return 0;
+            if (!Interpolant_[i]->HasPolynomials())
+            {
+                return false;
+            }
         }
-    } else
-    {
-
-        out.open(Path.c_str(), std::ios::binary);
 
-        if (!out.good())
-        {
-            log_error("Can not open file %s for writing", Path.c_str());
-            return 0;
-        }
+        return true;
     }
 
-    Save(out, binary_tables);
-
-    out.close();
-    return 1;
+    return !polynomials_.empty();
 }
 
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-bool Interpolant::Save(std::ofstream& out, bool binary_tables)
+int Interpolant::GetNodes() const
 {
-    if (!out.good())
+    int nodes = 0;
+
+    for (unsigned int i = 0; i < Interpolant_.size(); i++)
     {
-        log_error("Can not open file for writing");
-        return 0;
+        nodes += Interpolant_[i]->GetNodes();
     }
-    bool D2 = false;
-    if (function2d_ != NULL)
-        D2 = true;
 
-    if (binary_tables)
-    {
-        out.write(reinterpret_cast<char*>(&D2), sizeof D2);
+    return Interpolant_.empty() ? max_ : nodes;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+size_t Interpolant::GetMemorySize() const
+{
+    size_t bytes = sizeof(Interpolant);
+
+    bytes += (iX_.capacity() + iY_.capacity()) * sizeof(double);
+    bytes += (polynomials_.capacity() + grid_.capacity() + chebyshev_.capacity()) * sizeof(double);
+    bytes += log_zero_windows_.capacity() / 8 + floats_.capacity() * sizeof(float);
+
+    for (unsigned int i = 0; i < iY2_.size(); i++)
+    {
+        bytes += iY2_[i].capacity() * sizeof(double);
+    }
+
+    for (unsigned int i = 0; i < Interpolant_.size(); i++)
+    {
+        bytes += sizeof(Interpolant*) + Interpolant_[i]->GetMemorySize();
+    }
+
+    return bytes;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+bool Interpolant::StoreFloats(double tolerance)
+{
+    if (!floats_.empty())
+    {
+        return true;
+    }
+
+    if (grid_.empty() || !fast_)
+    {
+        return false;
+    }
+
+    const Interpolant& rows = *Interpolant_.front();
+
+    int i, j, row, start, starti;
+    int intervals = rows.max_ - 1;
+    double x, scale, single, value;
+
+    std::vector<double> reference(Interpolant_.size() * intervals);
+
+    for (row = 0; row < max_; row++)
+    {
+        for (i = 0; i < intervals; i++)
+        {
+            x = 0.5 * (rows.iX_[i] + rows.iX_[i + 1]);
+
+            rows.LocateEquidistant(x, start, starti);
+            reference[row * intervals + i] = InterpolateGrid(row, x, start, starti);
+        }
+    }
+
+    BuildFloats(*this);
+
+    // Compare with the double precision values between all sampling points
+    // of every row. Log substituted values are compared after the
+    // substitution is undone, relative to the largest value of the window.
+    for (row = 0; row < max_; row++)
+    {
+        for (i = 0; i < intervals; i++)
+        {
+            x = 0.5 * (rows.iX_[i] + rows.iX_[i + 1]);
+
+            rows.LocateEquidistant(x, start, starti);
+
+            single = InterpolateGrid(row, x, start, starti);
+            value  = reference[row * intervals + i];
+            scale  = 0;
+
+            for (j = start; j < start + rows.romberg_; j++)
+            {
+                if (rows.logSubst_)
+                {
+                    scale = std::max(scale, Exp(GridRow(row)[j]));
+                } else
+                {
+                    scale = std::max(scale, std::abs(GridRow(row)[j]));
+                }
+            }
+
+            if (rows.logSubst_)
+            {
+                single = Exp(single);
+                value  = Exp(value);
+            }
+
+            if (!(std::abs(single - value) <= tolerance * std::max(scale, std::abs(value))))
+            {
+                floats_.clear();
+
+                return false;
+            }
+        }
+    }
+
+    // the values in double precision are not needed anymore
+    grid_.clear();
+
+    for (row = 0; row < max_; row++)
+    {
+        Interpolant_[row]->iY_.clear();
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+bool Interpolant::FitChebyshev(double tolerance)
+{
+    chebyshev_.clear();
+
+    if (!Interpolant_.empty() || !self_ || !fast_ || !(xmin_ < xmax_))
+    {
+        return false;
+    }
+
+    int i, first, terms;
+
+    // The series is fitted to the logarithm of the function, so it
+    // approximates the function up to a relative error over its whole range.
+    // Zeros, e.g. below a threshold, are left to the table, together with
+    // the windows of sampling points including them.
+    for (i = max_ - 1; i >= 0; i--)
+    {
+        if (logSubst_ ? iY_[i] == bigNumber_ : !(iY_[i] > 0))
+        {
+            break;
+        }
+    }
+
+    // A function rising steeply above a threshold spoils the series over the
+    // whole range, so the start of the series is moved up until the rest of
+    // the range can be fitted, at most to the middle of the table.
+    for (first = i < 0 ? 0 : i + romberg_; first <= max_ / 2; first += std::max(max_ / chebyshev_start_steps, 1))
+    {
+        chebyshev_min_ = first == 0 ? xmin_ : iX_[first];
+
+        for (terms = 8; terms <= max_chebyshev_terms; terms = terms % 3 == 0 ? terms / 3 * 4 : terms / 2 * 3)
+        {
+            chebyshev_ = ChebyshevCoefficients(terms);
+
+            if (ChebyshevAgrees(tolerance))
+            {
+                return true;
+            }
+        }
+    }
+
+    chebyshev_.clear();
+
+    return false;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+bool Interpolant::ChebyshevAgrees(double tolerance) const
+{
+    int start, starti;
+    double x, series, value, dummy;
+
+    // four points between every two sampling points, including both ends
+    int points = std::ceil(4 * (xmax_ - chebyshev_min_) / step_);
+
+    for (int i = 0; i <= points; i++)
+    {
+        x = chebyshev_min_ + (xmax_ - chebyshev_min_) * i / points;
+
+        LocateEquidistant(x, start, starti);
+
+        value  = Interpolate(iX_.data(), iY_.data(), x, start, starti, romberg_, rational_, relative_, true, dummy, dummy);
+        series = Exp(EvaluateChebyshev(x));
+
+        if (logSubst_)
+        {
+            value = Exp(value);
+        }
+
+        if (!(std::abs(series - value) <= tolerance * std::abs(value)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+//--------------------------------Save and Load-------------------------------//
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+bool Interpolant::Save(std::string Path, bool binary_tables) const
+{
+    std::ofstream out;
+
+    if (!binary_tables)
+    {
+        std::stringstream ss;
+        ss << Path << ".txt";
+
+        out.open(ss.str().c_str());
+
+        out.precision(16);
+
+        if (!out.good())
+        {
+            log_error("Can not open file %s for writing", Path.c_str());
+            return 0;
+        }
+    } else
+    {
+
+        out.open(Path.c_str(), std::ios::binary);
+
+        if (!out.good())
+        {
+            log_error("Can not open file %s for writing", Path.c_str());
+            return 0;
+        }
+    }
+
+    Save(out, binary_tables);
+
+    out.close();
+    return 1;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+bool Interpolant::Save(std::ostream& out, bool binary_tables) const
+{
+    if (!out.good())
+    {
+        log_error("Can not open file for writing");
+        return 0;
+    }
+    bool D2 = false;
+    if (function2d_ != NULL)
+        D2 = true;
+
+    if (binary_tables)
+    {
+        out.write(reinterpret_cast<const char*>(&D2), sizeof D2);
 
         if (D2)
         {
@@ -631,28 +1360,28 @@ bool Interpolant::Save(std::ofstream& out, bool binary_tables)
                 double xmax = std::exp(xmax_);
                 double xmin = std::exp(xmin_);
 
-                out.write(reinterpret_cast<char*>(&max_), sizeof max_);
-                out.write(reinterpret_cast<char*>(&xmin), sizeof xmin);
-                out.write(reinterpret_cast<char*>(&xmax), sizeof xmax);
+                out.write(reinterpret_cast<const char*>(&max_), sizeof max_);
+                out.write(reinterpret_cast<const char*>(&xmin), sizeof xmin);
+                out.write(reinterpret_cast<const char*>(&xmax), sizeof xmax);
             } else
             {
-                out.write(reinterpret_cast<char*>(&max_), sizeof max_);
-                out.write(reinterpret_cast<char*>(&xmin_), sizeof xmin_);
-                out.write(reinterpret_cast<char*>(&xmax_), sizeof xmax_);
+                out.write(reinterpret_cast<const char*>(&max_), sizeof max_);
+                out.write(reinterpret_cast<const char*>(&xmin_), sizeof xmin_);
+                out.write(reinterpret_cast<const char*>(&xmax_), sizeof xmax_);
             }
-            out.write(reinterpret_cast<char*>(&romberg_), sizeof romberg_);
-            out.write(reinterpret_cast<char*>(&rational_), sizeof rational_);
-            out.write(reinterpret_cast<char*>(&relative_), sizeof relative_);
-            out.write(reinterpret_cast<char*>(&isLog_), sizeof isLog_);
-            out.write(reinterpret_cast<char*>(&rombergY_), sizeof rombergY_);
-            out.write(reinterpret_cast<char*>(&rationalY_), sizeof rationalY_);
-            out.write(reinterpret_cast<char*>(&relativeY_), sizeof relativeY_);
-            out.write(reinterpret_cast<char*>(&logSubst_), sizeof logSubst_);
+            out.write(reinterpret_cast<const char*>(&romberg_), sizeof romberg_);
+            out.write(reinterpret_cast<const char*>(&rational_), sizeof rational_);
+            out.write(reinterpret_cast<const char*>(&relative_), sizeof relative_);
+            out.write(reinterpret_cast<const char*>(&isLog_), sizeof isLog_);
+            out.write(reinterpret_cast<const char*>(&rombergY_), sizeof rombergY_);
+            out.write(reinterpret_cast<const char*>(&rationalY_), sizeof rationalY_);
+            out.write(reinterpret_cast<const char*>(&relativeY_), sizeof relativeY_);
+            out.write(reinterpret_cast<const char*>(&logSubst_), sizeof logSubst_);
 
             for (int i = 0; i < max_; i++)
             {
-                out.write(reinterpret_cast<char*>(&iX_.at(i)), sizeof iX_.at(i));
-                Interpolant_.at(i)->Save(out, binary_tables);
+                out.write(reinterpret_cast<const char*>(&iX_.at(i)), sizeof iX_.at(i));
+                SaveRow(i, out, binary_tables);
             }
         } else
         {
@@ -661,29 +1390,29 @@ bool Interpolant::Save(std::ofstream& out, bool binary_tables)
                 double xmax = std::exp(xmax_);
                 double xmin = std::exp(xmin_);
 
-                out.write(reinterpret_cast<char*>(&max_), sizeof max_);
-                out.write(reinterpret_cast<char*>(&xmin), sizeof xmin);
-                out.write(reinterpret_cast<char*>(&xmax), sizeof xmax);
+                out.write(reinterpret_cast<const char*>(&max_), sizeof max_);
+                out.write(reinterpret_cast<const char*>(&xmin), sizeof xmin);
+                out.write(reinterpret_cast<const char*>(&xmax), sizeof xmax);
             } else
             {
-                out.write(reinterpret_cast<char*>(&max_), sizeof max_);
-                out.write(reinterpret_cast<char*>(&xmin_), sizeof xmin_);
-                out.write(reinterpret_cast<char*>(&xmax_), sizeof xmax_);
+                out.write(reinterpret_cast<const char*>(&max_), sizeof max_);
+                out.write(reinterpret_cast<const char*>(&xmin_), sizeof xmin_);
+                out.write(reinterpret_cast<const char*>(&xmax_), sizeof xmax_);
             }
 
-            out.write(reinterpret_cast<char*>(&romberg_), sizeof romberg_);
-            out.write(reinterpret_cast<char*>(&rational_), sizeof rational_);
-            out.write(reinterpret_cast<char*>(&relative_), sizeof relative_);
-            out.write(reinterpret_cast<char*>(&isLog_), sizeof isLog_);
-            out.write(reinterpret_cast<char*>(&rombergY_), sizeof rombergY_);
-            out.write(reinterpret_cast<char*>(&rationalY_), sizeof rationalY_);
-            out.write(reinterpret_cast<char*>(&relativeY_), sizeof relativeY_);
-            out.write(reinterpret_cast<char*>(&logSubst_), sizeof logSubst_);
+            out.write(reinterpret_cast<const char*>(&romberg_), sizeof romberg_);
+            out.write(reinterpret_cast<const char*>(&rational_), sizeof rational_);
+            out.write(reinterpret_cast<const char*>(&relative_), sizeof relative_);
+            out.write(reinterpret_cast<const char*>(&isLog_), sizeof isLog_);
+            out.write(reinterpret_cast<const char*>(&rombergY_), sizeof rombergY_);
+            out.write(reinterpret_cast<const char*>(&rationalY_), sizeof rationalY_);
+            out.write(reinterpret_cast<const char*>(&relativeY_), sizeof relativeY_);
+            out.write(reinterpret_cast<const char*>(&logSubst_), sizeof logSubst_);
 
             for (int i = 0; i < max_; i++)
             {
-                out.write(reinterpret_cast<char*>(&iX_.at(i)), sizeof iX_.at(i));
-                out.write(reinterpret_cast<char*>(&iY_.at(i)), sizeof iY_.at(i));
+                out.write(reinterpret_cast<const char*>(&iX_.at(i)), sizeof iX_.at(i));
+                out.write(reinterpret_cast<const char*>(&iY_.at(i)), sizeof iY_.at(i));
             }
         }
     } else
@@ -705,7 +1434,7 @@ bool Interpolant::Save(std::ofstream& out, bool binary_tables)
             for (int i = 0; i < max_; i++)
             {
                 out << iX_.at(i) << std::endl;
-                Interpolant_.at(i)->Save(out, binary_tables);
+                SaveRow(i, out, binary_tables);
             }
         } else
         {
@@ -732,6 +1461,23 @@ bool Interpolant::Save(std::ofstream& out, bool binary_tables)
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
+bool Interpolant::SaveRow(int row, std::ostream& out, bool binary_tables) const
+{
+    if (floats_.empty())
+    {
+        return Interpolant_.at(row)->Save(out, binary_tables);
+    }
+
+    Interpolant copy(*Interpolant_.at(row));
+
+    copy.iY_.assign(FloatRow(row), FloatRow(row) + copy.max_);
+
+    return copy.Save(out, binary_tables);
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
 bool Interpolant::Load(std::string Path, bool binary_tables)
 {
     bool success;
@@ -757,7 +1503,7 @@ bool Interpolant::Load(std::string Path, bool binary_tables)
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-bool Interpolant::Load(std::ifstream& in, bool binary_tables)
+bool Interpolant::Load(std::istream& in, bool binary_tables)
 {
     bool D2;
 
@@ -787,6 +1533,9 @@ bool Interpolant::Load(std::ifstream& in, bool binary_tables)
             in.read(reinterpret_cast<char*>(&relativeY), sizeof relativeY);
             in.read(reinterpret_cast<char*>(&logSubst), sizeof logSubst);
 
+            if (!in.good() || !ValidSettings(max, xmin, xmax, romberg, rombergY))
+                return 0;
+
             InitInterpolant(
                 max, xmin, xmax, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
 
@@ -794,15 +1543,18 @@ bool Interpolant::Load(std::ifstream& in, bool binary_tables)
 
             for (int i = 0; i < max_; i++)
             {
-                in.read(reinterpret_cast<char*>(&iX_.at(i)), sizeof iX_.at(i));
+                in.read(reinterpret_cast<char*>(iX_.Mutable() + i), sizeof iX_.at(i));
 
                 if (!in.good())
                     return 0;
                 Interpolant_.at(i) = new Interpolant();
-                Interpolant_.at(i)->Load(in, binary_tables);
-                Interpolant_.at(i)->self_ = false;
+                if (!Interpolant_.at(i)->Load(in, binary_tables))
+                    return 0;
+                Interpolant_.at(i)->SetSelf(false);
             }
 
+            BuildGrid();
+
         } else
         {
             if (!in.good())
@@ -819,13 +1571,16 @@ bool Interpolant::Load(std::ifstream& in, bool binary_tables)
             in.read(reinterpret_cast<char*>(&relativeY), sizeof relativeY);
             in.read(reinterpret_cast<char*>(&logSubst), sizeof logSubst);
 
+            if (!in.good() || !ValidSettings(max, xmin, xmax, romberg, rombergY))
+                return 0;
+
             InitInterpolant(
                 max, xmin, xmax, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
 
             for (int i = 0; i < max_; i++)
             {
-                in.read(reinterpret_cast<char*>(&iX_.at(i)), sizeof iX_.at(i));
-                in.read(reinterpret_cast<char*>(&iY_.at(i)), sizeof iY_.at(i));
+                in.read(reinterpret_cast<char*>(iX_.Mutable() + i), sizeof iX_.at(i));
+                in.read(reinterpret_cast<char*>(iY_.Mutable() + i), sizeof iY_.at(i));
                 if (!in.good())
                     return 0;
             }
@@ -842,6 +1597,9 @@ bool Interpolant::Load(std::ifstream& in, bool binary_tables)
             in >> romberg >> rational >> relative >> isLog;
             in >> rombergY >> rationalY >> relativeY >> logSubst;
 
+            if (!in.good() || !ValidSettings(max, xmin, xmax, romberg, rombergY))
+                return 0;
+
             InitInterpolant(
                 max, xmin, xmax, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
 
@@ -849,14 +1607,17 @@ bool Interpolant::Load(std::ifstream& in, bool binary_tables)
 
             for (int i = 0; i < max_; i++)
             {
-                in >> iX_.at(i);
+                in >> iX_.Mutable()[i];
                 if (!in.good())
                     return 0;
                 Interpolant_.at(i) = new Interpolant();
-                Interpolant_.at(i)->Load(in, binary_tables);
-                Interpolant_.at(i)->self_ = false;
+                if (!Interpolant_.at(i)->Load(in, binary_tables))
+                    return 0;
+                Interpolant_.at(i)->SetSelf(false);
             }
 
+            BuildGrid();
+
         } else
         {
             if (!in.good())
@@ -865,12 +1626,15 @@ bool Interpolant::Load(std::ifstream& in, bool binary_tables)
             in >> romberg >> rational >> relative >> isLog;
             in >> rombergY >> rationalY >> relativeY >> logSubst;
 
+            if (!in.good() || !ValidSettings(max, xmin, xmax, romberg, rombergY))
+                return 0;
+
             InitInterpolant(
                 max, xmin, xmax, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
 
             for (int i = 0; i < max_; i++)
             {
-                in >> iX_.at(i) >> iY_.at(i);
+                in >> iX_.Mutable()[i] >> iY_.Mutable()[i];
                 if (!in.good())
                     return 0;
             }
@@ -879,84 +1643,287 @@ bool Interpolant::Load(std::ifstream& in, bool binary_tables)
     return 1;
 }
 
-//----------------------------------------------------------------------------//
-//----------------------------------------------------------------------------//
-//--------------------------------constructors--------------------------------//
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-Interpolant::Interpolant()
-    : romberg_(1.)
-    , rombergY_(1.)
-    , iX_()
-    , iY_()
-    , c_()
-    , d_()
-    , max_(1.)
-    , xmin_(1.)
-    , xmax_(1.)
-    , step_(0)
-    , rational_(false)
-    , relative_(false)
-    , function1d_(NULL)
-    , function2d_(NULL)
-    , Interpolant_()
-    , row_(0)
-    , starti_(0)
-    , rationalY_(false)
-    , relativeY_(false)
-    , reverse_(false)
-    , self_(true)
-    , flag_(false)
-    , isLog_(false)
-    , logSubst_(false)
-    , precision_(0)
-    , worstX_(0)
-    , precision2_(0)
-    , worstX2_(0)
-    , precisionY_(0)
-    , worstY_(0)
-    , fast_(true)
-    , x_save_(0)
-    , y_save_(0)
+bool Interpolant::SaveMapped(std::string& block) const
 {
-}
+    MappedTable table = MappedTable();
+
+    table.rows      = Interpolant_.size();
+    table.max       = max_;
+    table.xmin      = isLog_ ? std::exp(xmin_) : xmin_;
+    table.xmax      = isLog_ ? std::exp(xmax_) : xmax_;
+    table.romberg   = romberg_;
+    table.rombergY  = rombergY_;
+    table.rational  = rational_;
+    table.relative  = relative_;
+    table.isLog     = isLog_;
+    table.rationalY = rationalY_;
+    table.relativeY = relativeY_;
+    table.logSubst  = logSubst_;
+    table.shared_x  = true;
+
+    int max = 0;
 
-//----------------------------------------------------------------------------//
-//----------------------------------------------------------------------------//
+    for (unsigned int i = 0; i < Interpolant_.size(); i++)
+    {
+        if (!Interpolant_[i]->Interpolant_.empty())
+        {
+            return false;
+        }
 
-Interpolant::Interpolant(const Interpolant& interpolant)
-    : romberg_(interpolant.romberg_)
-    , rombergY_(interpolant.rombergY_)
-    , iX_(interpolant.iX_)
-    , iY_(interpolant.iY_)
-    , c_(interpolant.c_)
-    , d_(interpolant.d_)
-    , max_(interpolant.max_)
-    , xmin_(interpolant.xmin_)
-    , xmax_(interpolant.xmax_)
-    , step_(interpolant.step_)
-    , rational_(interpolant.rational_)
-    , relative_(interpolant.relative_)
-    , row_(interpolant.row_)
-    , starti_(interpolant.starti_)
-    , rationalY_(interpolant.rationalY_)
-    , relativeY_(interpolant.relativeY_)
-    , reverse_(interpolant.reverse_)
-    , self_(interpolant.self_)
-    , flag_(interpolant.flag_)
-    , isLog_(interpolant.isLog_)
-    , logSubst_(interpolant.logSubst_)
-    , precision_(interpolant.precision_)
-    , worstX_(interpolant.worstX_)
-    , precision2_(interpolant.precision2_)
-    , worstX2_(interpolant.worstX2_)
-    , precisionY_(interpolant.precisionY_)
-    , worstY_(interpolant.worstY_)
-    , fast_(interpolant.fast_)
-    , x_save_(interpolant.x_save_)
-    , y_save_(interpolant.y_save_)
+        max = std::max(max, Interpolant_[i]->max_);
+        table.shared_x = table.shared_x && Interpolant_[i]->iX_ == Interpolant_.front()->iX_;
+    }
+
+    AppendMapped(block, &table, sizeof table);
+    AppendMapped(block, iX_.data(), max_ * sizeof(double));
+    AppendMapped(block, iY_.data(), max_ * sizeof(double));
+
+    if (Interpolant_.empty())
+    {
+        return true;
+    }
+
+    for (unsigned int i = 0; i < Interpolant_.size(); i++)
+    {
+        const Interpolant& row = *Interpolant_[i];
+        MappedTable settings = MappedTable();
+
+        settings.max       = row.max_;
+        settings.xmin      = row.isLog_ ? std::exp(row.xmin_) : row.xmin_;
+        settings.xmax      = row.isLog_ ? std::exp(row.xmax_) : row.xmax_;
+        settings.romberg   = row.romberg_;
+        settings.rombergY  = row.rombergY_;
+        settings.rational  = row.rational_;
+        settings.relative  = row.relative_;
+        settings.isLog     = row.isLog_;
+        settings.rationalY = row.rationalY_;
+        settings.relativeY = row.relativeY_;
+        settings.logSubst  = row.logSubst_;
+
+        AppendMapped(block, &settings, sizeof settings);
+    }
+
+    size_t stride = MappedStride(max);
+    std::vector<double> values(Interpolant_.size() * stride, 0);
+
+    for (unsigned int i = 0; i < (table.shared_x ? 1 : Interpolant_.size()); i++)
+    {
+        std::copy(Interpolant_[i]->iX_.begin(), Interpolant_[i]->iX_.end(), values.begin() + i * stride);
+    }
+
+    AppendMapped(block, values.data(), (table.shared_x ? 1 : Interpolant_.size()) * stride * sizeof(double));
+
+    for (unsigned int i = 0; i < Interpolant_.size(); i++)
+    {
+        // the rows of tables in single precision have no values of their own
+        if (floats_.empty())
+        {
+            std::copy(Interpolant_[i]->iY_.begin(), Interpolant_[i]->iY_.end(), values.begin() + i * stride);
+        } else
+        {
+            std::copy(FloatRow(i), FloatRow(i) + Interpolant_[i]->max_, values.begin() + i * stride);
+        }
+    }
+
+    AppendMapped(block, values.data(), values.size() * sizeof(double));
+
+    return true;
+}
 
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+bool Interpolant::LoadMapped(const char* block, size_t size, size_t& offset, std::shared_ptr<const void> owner)
+{
+    if (reinterpret_cast<std::uintptr_t>(block) % mapped_line != 0)
+    {
+        return false;
+    }
+
+    const char* part = TakeMapped(block, size, offset, sizeof(MappedTable));
+    if (part == nullptr)
+    {
+        return false;
+    }
+
+    MappedTable table;
+    std::copy(part, part + sizeof table, reinterpret_cast<char*>(&table));
+
+    if (table.rows < 0 || table.rows > max_loaded_nodes ||
+        !ValidSettings(table.max, table.xmin, table.xmax, table.romberg, table.rombergY))
+    {
+        return false;
+    }
+
+    const char* x = TakeMapped(block, size, offset, table.max * sizeof(double));
+    const char* y = TakeMapped(block, size, offset, table.max * sizeof(double));
+    if (x == nullptr || y == nullptr)
+    {
+        return false;
+    }
+
+    // the views have the size InitInterpolant expects, so they are kept
+    iX_.View(reinterpret_cast<const double*>(x), table.max, owner);
+    iY_.View(reinterpret_cast<const double*>(y), table.max, owner);
+
+    InitInterpolant(table.max,
+                    table.xmin,
+                    table.xmax,
+                    table.romberg,
+                    table.rational,
+                    table.relative,
+                    table.isLog,
+                    table.rombergY,
+                    table.rationalY,
+                    table.relativeY,
+                    table.logSubst);
+
+    if (table.rows == 0)
+    {
+        return true;
+    }
+
+    std::vector<MappedTable> rows(table.rows);
+    int max = 0;
+
+    for (int i = 0; i < table.rows; i++)
+    {
+        part = TakeMapped(block, size, offset, sizeof(MappedTable));
+        if (part == nullptr)
+        {
+            return false;
+        }
+
+        std::copy(part, part + sizeof(MappedTable), reinterpret_cast<char*>(&rows[i]));
+        if (!ValidSettings(rows[i].max, rows[i].xmin, rows[i].xmax, rows[i].romberg, rows[i].rombergY))
+        {
+            return false;
+        }
+        max = std::max(max, rows[i].max);
+    }
+
+    size_t stride = MappedStride(max);
+
+    x = TakeMapped(block, size, offset, (table.shared_x ? 1 : table.rows) * stride * sizeof(double));
+    y = TakeMapped(block, size, offset, table.rows * stride * sizeof(double));
+    if (x == nullptr || y == nullptr)
+    {
+        return false;
+    }
+
+    Interpolant_.resize(table.rows);
+
+    for (int i = 0; i < table.rows; i++)
+    {
+        Interpolant_[i] = new Interpolant();
+
+        const double* row_x = reinterpret_cast<const double*>(x) + (table.shared_x ? 0 : i * stride);
+        const double* row_y = reinterpret_cast<const double*>(y) + i * stride;
+
+        Interpolant_[i]->iX_.View(row_x, rows[i].max, owner);
+        Interpolant_[i]->iY_.View(row_y, rows[i].max, owner);
+        Interpolant_[i]->InitInterpolant(rows[i].max,
+                                         rows[i].xmin,
+                                         rows[i].xmax,
+                                         rows[i].romberg,
+                                         rows[i].rational,
+                                         rows[i].relative,
+                                         rows[i].isLog,
+                                         rows[i].rombergY,
+                                         rows[i].rationalY,
+                                         rows[i].relativeY,
+                                         rows[i].logSubst);
+        Interpolant_[i]->SetSelf(false);
+    }
+
+    // the function values are laid out like grid_ already
+    if (HasGridRows())
+    {
+        grid_.View(reinterpret_cast<const double*>(y), table.rows * stride, owner);
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+//--------------------------------constructors--------------------------------//
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+Interpolant::Interpolant()
+    : romberg_(1.)
+    , rombergY_(1.)
+    , iX_()
+    , iY_()
+    , max_(1.)
+    , xmin_(1.)
+    , xmax_(1.)
+    , step_(0)
+    , rational_(false)
+    , relative_(false)
+    , function1d_(NULL)
+    , function2d_(NULL)
+    , Interpolant_()
+    , row_(0)
+    , rationalY_(false)
+    , relativeY_(false)
+    , self_(true)
+    , flag_(false)
+    , isLog_(false)
+    , logSubst_(false)
+    , precision_(0)
+    , worstX_(0)
+    , precision2_(0)
+    , worstX2_(0)
+    , precisionY_(0)
+    , worstY_(0)
+    , fast_(true)
+    , chebyshev_min_(0)
+    , kernel_(nullptr)
+    , neville_(nullptr)
+    , inverse_(nullptr)
+{
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+Interpolant::Interpolant(const Interpolant& interpolant)
+    : romberg_(interpolant.romberg_)
+    , rombergY_(interpolant.rombergY_)
+    , iX_(interpolant.iX_)
+    , iY_(interpolant.iY_)
+    , max_(interpolant.max_)
+    , xmin_(interpolant.xmin_)
+    , xmax_(interpolant.xmax_)
+    , step_(interpolant.step_)
+    , rational_(interpolant.rational_)
+    , relative_(interpolant.relative_)
+    , row_(interpolant.row_)
+    , rationalY_(interpolant.rationalY_)
+    , relativeY_(interpolant.relativeY_)
+    , self_(interpolant.self_)
+    , flag_(interpolant.flag_)
+    , isLog_(interpolant.isLog_)
+    , logSubst_(interpolant.logSubst_)
+    , precision_(interpolant.precision_)
+    , worstX_(interpolant.worstX_)
+    , precision2_(interpolant.precision2_)
+    , worstX2_(interpolant.worstX2_)
+    , precisionY_(interpolant.precisionY_)
+    , worstY_(interpolant.worstY_)
+    , fast_(interpolant.fast_)
+    , polynomials_(interpolant.polynomials_)
+    , log_zero_windows_(interpolant.log_zero_windows_)
+    , chebyshev_(interpolant.chebyshev_)
+    , chebyshev_min_(interpolant.chebyshev_min_)
+    , kernel_(interpolant.kernel_)
+    , neville_(interpolant.neville_)
+    , inverse_(interpolant.inverse_)
 {
     Interpolant_.resize(interpolant.Interpolant_.size());
 
@@ -965,8 +1932,29 @@ Interpolant::Interpolant(const Interpolant& interpolant)
         Interpolant_.at(i) = new Interpolant(*interpolant.Interpolant_.at(i));
     }
 
-    function1d_ = std::ref(interpolant.function1d_);
-    function2d_ = std::ref(interpolant.function2d_);
+    if (!interpolant.floats_.empty())
+    {
+        BuildFloats(interpolant);
+    } else if (interpolant.grid_.IsView())
+    {
+        // the rows are views into the same memory
+        grid_ = interpolant.grid_;
+    } else
+    {
+        BuildGrid();
+    }
+
+    // a reference to an empty function is not empty, Save tells 1d and 2d
+    // tables apart by it
+    if (interpolant.function1d_)
+    {
+        function1d_ = std::ref(interpolant.function1d_);
+    }
+
+    if (interpolant.function2d_)
+    {
+        function2d_ = std::ref(interpolant.function2d_);
+    }
 }
 
 //----------------------------------------------------------------------------//
@@ -988,8 +1976,6 @@ Interpolant::Interpolant(int max,
     , rombergY_(1.)
     , iX_()
     , iY_()
-    , c_()
-    , d_()
     , max_(1.)
     , xmin_(1.)
     , xmax_(1.)
@@ -1000,10 +1986,8 @@ Interpolant::Interpolant(int max,
     , function2d_(NULL)
     , Interpolant_()
     , row_(0)
-    , starti_(0)
     , rationalY_(false)
     , relativeY_(false)
-    , reverse_(false)
     , self_(true)
     , flag_(false)
     , isLog_(false)
@@ -1015,8 +1999,10 @@ Interpolant::Interpolant(int max,
     , precisionY_(0)
     , worstY_(0)
     , fast_(true)
-    , x_save_(1)
-    , y_save_(0)
+    , chebyshev_min_(0)
+    , kernel_(nullptr)
+    , neville_(nullptr)
+    , inverse_(nullptr)
 {
     InitInterpolant(max, xmin, xmax, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
 
@@ -1029,7 +2015,7 @@ Interpolant::Interpolant(int max,
 
     for (i = 0; i < max_; i++)
     {
-        iX_.at(i) = aux;
+        iX_.Mutable()[i] = aux;
 
         if (isLog_)
         {
@@ -1039,11 +2025,11 @@ Interpolant::Interpolant(int max,
             xaux = aux;
         }
 
-        iY_.at(i) = function1d_(xaux);
+        iY_.Mutable()[i] = function1d_(xaux);
 
         if (logSubst_)
         {
-            iY_.at(i) = Log(iY_.at(i));
+            iY_.Mutable()[i] = Log(iY_.at(i));
         }
 
         aux += step_;
@@ -1072,12 +2058,55 @@ Interpolant::Interpolant(int max1,
                          bool rationalY,
                          bool relativeY,
                          bool logSubst)
+    : Interpolant(max1,
+                  x1min,
+                  x1max,
+                  max2,
+                  x2min,
+                  x2max,
+                  [function2d]() { return function2d; },
+                  1,
+                  romberg1,
+                  rational1,
+                  relative1,
+                  isLog1,
+                  romberg2,
+                  rational2,
+                  relative2,
+                  isLog2,
+                  rombergY,
+                  rationalY,
+                  relativeY,
+                  logSubst)
+{
+}
+
+//----------------------------------------------------------------------------//
+
+Interpolant::Interpolant(int max1,
+                         double x1min,
+                         double x1max,
+                         int max2,
+                         double x2min,
+                         double x2max,
+                         std::function<std::function<double(double, double)>()> function2d_factory,
+                         unsigned int n_threads,
+                         int romberg1,
+                         bool rational1,
+                         bool relative1,
+                         bool isLog1,
+                         int romberg2,
+                         bool rational2,
+                         bool relative2,
+                         bool isLog2,
+                         int rombergY,
+                         bool rationalY,
+                         bool relativeY,
+                         bool logSubst)
     : romberg_(1.)
     , rombergY_(1.)
     , iX_()
     , iY_()
-    , c_()
-    , d_()
     , max_(1.)
     , xmin_(1.)
     , xmax_(1.)
@@ -1088,10 +2117,8 @@ Interpolant::Interpolant(int max1,
     , function2d_(NULL)
     , Interpolant_()
     , row_(0)
-    , starti_(0)
     , rationalY_(false)
     , relativeY_(false)
-    , reverse_(false)
     , self_(true)
     , flag_(false)
     , isLog_(false)
@@ -1103,8 +2130,10 @@ Interpolant::Interpolant(int max1,
     , precisionY_(0)
     , worstY_(0)
     , fast_(true)
-    , x_save_(1)
-    , y_save_(0)
+    , chebyshev_min_(0)
+    , kernel_(nullptr)
+    , neville_(nullptr)
+    , inverse_(nullptr)
 {
     InitInterpolant(
         max2, x2min, x2max, romberg2, rational2, relative2, isLog2, rombergY, rationalY, relativeY, logSubst);
@@ -1112,33 +2141,51 @@ Interpolant::Interpolant(int max1,
     int i;
     double aux;
 
-    function2d_ = function2d;
+    unsigned int n_workers = NumberOfWorkers(n_threads, max_);
+
+    // one instance of the function for every worker
+    std::vector<std::function<double(double, double)> > functions;
+    for (unsigned int w = 0; w < n_workers; ++w)
+    {
+        functions.push_back(function2d_factory());
+    }
+
+    function2d_ = functions.front();
     function1d_ = std::bind(&Interpolant::Get2dFunctionFixedY, this, std::placeholders::_1);
 
     Interpolant_.resize(max_);
 
     for (i = 0, aux = xmin_ + step_ / 2; i < max_; i++, aux += step_)
     {
-        iX_.at(i) = aux;
-        row_      = i;
+        iX_.Mutable()[i] = aux;
+    }
 
-        Interpolant_.at(i) = new Interpolant(max1,
-                                             x1min,
-                                             x1max,
-                                             function1d_,
-                                             romberg1,
-                                             rational1,
-                                             relative1,
-                                             isLog1,
-                                             rombergY,
-                                             rationalY,
-                                             relativeY,
-                                             logSubst_);
+    // the rows are independent of each other
+    ParallelFor(max_, n_workers, [&](unsigned int worker, size_t row) {
+        const std::function<double(double, double)>& function = functions[worker];
+        double x2 = isLog_ ? std::exp(iX_[row]) : iX_[row];
 
-        Interpolant_.at(i)->self_ = false;
-    }
+        Interpolant_[row] = new Interpolant(max1,
+                                            x1min,
+                                            x1max,
+                                            [&function, x2](double x1) { return function(x1, x2); },
+                                            romberg1,
+                                            rational1,
+                                            relative1,
+                                            isLog1,
+                                            rombergY,
+                                            rationalY,
+                                            relativeY,
+                                            logSubst_);
 
+        Interpolant_[row]->SetSelf(false);
+        Interpolant_[row]->function1d_ = function1d_;
+    });
+
+    row_        = max_ - 1;
     precision2_ = 0;
+
+    BuildGrid();
 }
 
 //----------------------------------------------------------------------------//
@@ -1149,8 +2196,6 @@ Interpolant::Interpolant(std::vector<double> x, std::vector<double> y, int rombe
     , rombergY_(1.)
     , iX_()
     , iY_()
-    , c_()
-    , d_()
     , max_(1.)
     , xmin_(1.)
     , xmax_(1.)
@@ -1161,10 +2206,8 @@ Interpolant::Interpolant(std::vector<double> x, std::vector<double> y, int rombe
     , function2d_(NULL)
     , Interpolant_()
     , row_(0)
-    , starti_(0)
     , rationalY_(false)
     , relativeY_(false)
-    , reverse_(false)
     , self_(true)
     , flag_(false)
     , isLog_(false)
@@ -1176,8 +2219,10 @@ Interpolant::Interpolant(std::vector<double> x, std::vector<double> y, int rombe
     , precisionY_(0)
     , worstY_(0)
     , fast_(true)
-    , x_save_(1)
-    , y_save_(0)
+    , chebyshev_min_(0)
+    , kernel_(nullptr)
+    , neville_(nullptr)
+    , inverse_(nullptr)
 {
     InitInterpolant(std::min(x.size(), y.size()),
                     x.at(0),
@@ -1198,12 +2243,12 @@ Interpolant::Interpolant(std::vector<double> x, std::vector<double> y, int rombe
 
     for (int i = 0; i < (int)x.size(); i++)
     {
-        iX_.at(i) = x.at(i);
+        iX_.Mutable()[i] = x.at(i);
     }
 
     for (int i = 0; i < (int)y.size(); i++)
     {
-        iY_.at(i) = y.at(i);
+        iY_.Mutable()[i] = y.at(i);
     }
 }
 
@@ -1216,8 +2261,6 @@ Interpolant::Interpolant(std::vector<double> x1, std::vector<double> x2, std::ve
         , iX_()
         , iY_()
         , iY2_()
-        , c_()
-        , d_()
         , max_(1.)
         , xmin_(1.)
         , xmax_(1.)
@@ -1228,10 +2271,8 @@ Interpolant::Interpolant(std::vector<double> x1, std::vector<double> x2, std::ve
         , function2d_(NULL)
         , Interpolant_()
         , row_(0)
-        , starti_(0)
         , rationalY_(false)
         , relativeY_(false)
-        , reverse_(false)
         , self_(true)
         , flag_(false)
         , isLog_(false)
@@ -1243,8 +2284,10 @@ Interpolant::Interpolant(std::vector<double> x1, std::vector<double> x2, std::ve
         , precisionY_(0)
         , worstY_(0)
         , fast_(true)
-        , x_save_(1)
-        , y_save_(0)
+        , chebyshev_min_(0)
+        , kernel_(nullptr)
+        , neville_(nullptr)
+        , inverse_(nullptr)
 {
 
     //TODO: Not sure what is happening in the romberg=0 case
@@ -1296,7 +2339,7 @@ Interpolant::Interpolant(std::vector<double> x1, std::vector<double> x2, std::ve
 
     for (int i = 0; i < (int)x1.size(); i++)
     {
-        iX_.at(i) = x1.at(i);
+        iX_.Mutable()[i] = x1.at(i);
         row_      = i;
 
         Interpolant_.at(i) = new Interpolant(x2,
@@ -1305,7 +2348,7 @@ Interpolant::Interpolant(std::vector<double> x1, std::vector<double> x2, std::ve
                                              rational2,
                                              relative2);
 
-        Interpolant_.at(i)->self_ = false;
+        Interpolant_.at(i)->SetSelf(false);
     }
 
     precision2_ = 0;
@@ -1319,8 +2362,6 @@ Interpolant::Interpolant(std::vector<double> x1, std::vector< std::vector<double
         , rombergY_(1.)
         , iX_()
         , iY_()
-        , c_()
-        , d_()
         , max_(1.)
         , xmin_(1.)
         , xmax_(1.)
@@ -1331,10 +2372,8 @@ Interpolant::Interpolant(std::vector<double> x1, std::vector< std::vector<double
         , function2d_(NULL)
         , Interpolant_()
         , row_(0)
-        , starti_(0)
         , rationalY_(false)
         , relativeY_(false)
-        , reverse_(false)
         , self_(true)
         , flag_(false)
         , isLog_(false)
@@ -1346,8 +2385,10 @@ Interpolant::Interpolant(std::vector<double> x1, std::vector< std::vector<double
         , precisionY_(0)
         , worstY_(0)
         , fast_(true)
-        , x_save_(1)
-        , y_save_(0)
+        , chebyshev_min_(0)
+        , kernel_(nullptr)
+        , neville_(nullptr)
+        , inverse_(nullptr)
 {
 
     //TODO: Not sure what is happening in the romberg=0 case
@@ -1406,7 +2447,7 @@ Interpolant::Interpolant(std::vector<double> x1, std::vector< std::vector<double
 
     for (int i = 0; i < (int)x1.size(); i++)
     {
-        iX_.at(i) = x1.at(i);
+        iX_.Mutable()[i] = x1.at(i);
         row_      = i;
 
         Interpolant_.at(i) = new Interpolant(x2[i],
@@ -1415,7 +2456,7 @@ Interpolant::Interpolant(std::vector<double> x1, std::vector< std::vector<double
                                              rational2,
                                              relative2);
 
-        Interpolant_.at(i)->self_ = false;
+        Interpolant_.at(i)->SetSelf(false);
     }
 
     precision2_ = 0;
@@ -1460,14 +2501,10 @@ bool Interpolant::operator==(const Interpolant& interpolant) const
         return false;
     if (row_ != interpolant.row_)
         return false;
-    if (starti_ != interpolant.starti_)
-        return false;
     if (rationalY_ != interpolant.rationalY_)
         return false;
     if (relativeY_ != interpolant.relativeY_)
         return false;
-    if (reverse_ != interpolant.reverse_)
-        return false;
     if (self_ != interpolant.self_)
         return false;
     if (flag_ != interpolant.flag_)
@@ -1490,19 +2527,11 @@ bool Interpolant::operator==(const Interpolant& interpolant) const
         return false;
     if (fast_ != interpolant.fast_)
         return false;
-    if (x_save_ != interpolant.x_save_)
-        return false;
-    if (y_save_ != interpolant.y_save_)
-        return false;
 
     if (iX_.size() != interpolant.iX_.size())
         return false;
     if (iY_.size() != interpolant.iY_.size())
         return false;
-    if (c_.size() != interpolant.c_.size())
-        return false;
-    if (d_.size() != interpolant.d_.size())
-        return false;
 
     if (Interpolant_.size() != interpolant.Interpolant_.size())
         return false;
@@ -1517,21 +2546,26 @@ bool Interpolant::operator==(const Interpolant& interpolant) const
         if (iY_.at(i) != interpolant.iY_.at(i))
             return false;
     }
-    for (unsigned int i = 0; i < c_.size(); i++)
-    {
-        if (c_.at(i) != interpolant.c_.at(i))
-            return false;
-    }
-    for (unsigned int i = 0; i < d_.size(); i++)
-    {
-        if (d_.at(i) != interpolant.d_.at(i))
-            return false;
-    }
     for (unsigned int i = 0; i < interpolant.Interpolant_.size(); i++)
     {
         if (*Interpolant_.at(i) != *interpolant.Interpolant_.at(i))
             return false;
     }
+
+    // the rows of tables in single precision have their values in floats_
+    if (floats_.empty() != interpolant.floats_.empty())
+        return false;
+
+    if (!floats_.empty())
+    {
+        int max = Interpolant_.front()->max_;
+
+        for (unsigned int i = 0; i < Interpolant_.size(); i++)
+        {
+            if (!std::equal(FloatRow(i), FloatRow(i) + max, interpolant.FloatRow(i)))
+                return false;
+        }
+    }
     // else
     return true;
 }
@@ -1561,10 +2595,8 @@ void Interpolant::swap(Interpolant& interpolant)
     swap(rational_, interpolant.rational_);
     swap(relative_, interpolant.relative_);
     swap(row_, interpolant.row_);
-    swap(starti_, interpolant.starti_);
     swap(rationalY_, interpolant.rationalY_);
     swap(relativeY_, interpolant.relativeY_);
-    swap(reverse_, interpolant.reverse_);
     swap(self_, interpolant.self_);
     swap(flag_, interpolant.flag_);
     swap(isLog_, interpolant.isLog_);
@@ -1576,23 +2608,457 @@ void Interpolant::swap(Interpolant& interpolant)
     swap(precisionY_, interpolant.precisionY_);
     swap(worstY_, interpolant.worstY_);
     swap(fast_, interpolant.fast_);
-    swap(x_save_, interpolant.x_save_);
-    swap(y_save_, interpolant.y_save_);
 
-    iX_.swap(interpolant.iX_);
-    iY_.swap(interpolant.iY_);
+    iX_.swap(interpolant.iX_);
+    iY_.swap(interpolant.iY_);
+    polynomials_.swap(interpolant.polynomials_);
+    log_zero_windows_.swap(interpolant.log_zero_windows_);
+    grid_.swap(interpolant.grid_);
+    floats_.swap(interpolant.floats_);
+    chebyshev_.swap(interpolant.chebyshev_);
+    swap(chebyshev_min_, interpolant.chebyshev_min_);
+    swap(kernel_, interpolant.kernel_);
+    swap(neville_, interpolant.neville_);
+    swap(inverse_, interpolant.inverse_);
+
+    Interpolant_.swap(interpolant.Interpolant_);
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+//------------------------private member functions----------------------------//
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+void Interpolant::LocateEquidistant(double x, int& start, int& starti) const
+{
+    double aux;
+
+    aux    = (x - xmin_) / step_;
+    starti = (int)aux;
+
+    if (starti < 0)
+    {
+        starti = 0;
+    } else if (starti >= max_)
+    {
+        starti = max_ - 1;
+    }
+
+    start = (int)(aux - 0.5 * (romberg_ - 1));
+
+    if (start < 0)
+    {
+        start = 0;
+    } else if (start + romberg_ > max_ || start > max_)
+    {
+        start = max_ - romberg_;
+    }
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+void Interpolant::LocateArray(const TableValues<double>& iX, double x, int romberg, int& start, int& starti) const
+{
+    int i, j, m, auxdir;
+    bool dir;
+
+    i   = 0;
+    j   = max_ - 1;
+    dir = iX.at(max_ - 1) > iX.at(0);
+
+    while (j - i > 1)
+    {
+        m = (i + j) / 2;
+
+        if ((x > iX[m]) == dir)
+        {
+            i = m;
+        } else
+        {
+            j = m;
+        }
+    }
+
+    if (i + 1 < max_)
+    {
+        if (((x - iX[i]) < (iX[i + 1] - x)) == dir)
+        {
+            auxdir = 0;
+        } else
+        {
+            auxdir = 1;
+        }
+    } else
+    {
+        auxdir = 0;
+    }
+
+    starti = i + auxdir;
+    start  = i - (int)(0.5 * (romberg - 1 - auxdir));
+
+    if (start < 0)
+    {
+        start = 0;
+    }
+
+    if (start + romberg > max_ || start > max_)
+    {
+        start = max_ - romberg;
+    }
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+void Interpolant::BuildGrid()
+{
+    grid_.clear();
+
+    if (!HasGridRows())
+    {
+        return;
+    }
+
+    const Interpolant& rows = *Interpolant_.front();
+
+    grid_.assign(GridSize<double>(Interpolant_.size(), rows.max_), 0);
+
+    for (unsigned int i = 0; i < Interpolant_.size(); i++)
+    {
+        std::copy(Interpolant_[i]->iY_.begin(), Interpolant_[i]->iY_.end(), grid_.Mutable() + (GridRow(i) - grid_.data()));
+    }
+
+    // the rows become views into the grid, so the values are only kept once
+    std::shared_ptr<const void> owner = grid_.Share();
+
+    for (unsigned int i = 0; i < Interpolant_.size(); i++)
+    {
+        Interpolant_[i]->iY_.View(GridRow(i), rows.max_, owner);
+    }
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+bool Interpolant::HasGridRows() const
+{
+    if (Interpolant_.empty() || !fast_)
+    {
+        return false;
+    }
+
+    const Interpolant& rows = *Interpolant_.front();
+
+    for (unsigned int i = 0; i < Interpolant_.size(); i++)
+    {
+        const Interpolant& row = *Interpolant_[i];
+
+        if (!row.Interpolant_.empty() || !row.polynomials_.empty() || !row.fast_ || row.self_ ||
+            row.max_ != rows.max_ || row.xmin_ != rows.xmin_ || row.step_ != rows.step_ ||
+            row.romberg_ != rows.romberg_ || row.rational_ != rows.rational_ || row.relative_ != rows.relative_ ||
+            row.isLog_ != rows.isLog_ || row.logSubst_ != rows.logSubst_ || row.iX_ != rows.iX_)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+const double* Interpolant::GridRow(int row) const
+{
+    return AlignedRow(grid_.data(), Interpolant_.front()->max_, row);
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+const float* Interpolant::FloatRow(int row) const
+{
+    return AlignedRow(floats_.data(), Interpolant_.front()->max_, row);
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+void Interpolant::BuildFloats(const Interpolant& table)
+{
+    int max      = table.Interpolant_.front()->max_;
+    bool doubles = table.floats_.empty();
+
+    floats_.assign(GridSize<float>(table.Interpolant_.size(), max), 0);
+
+    for (unsigned int i = 0; i < table.Interpolant_.size(); i++)
+    {
+        std::vector<float>::iterator row = floats_.begin() + (FloatRow(i) - floats_.data());
+
+        if (doubles)
+        {
+            std::copy(table.GridRow(i), table.GridRow(i) + max, row);
+        } else
+        {
+            std::copy(table.FloatRow(i), table.FloatRow(i) + max, row);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+void Interpolant::GridWindow(int row, int start, int romberg, double* values) const
+{
+    if (floats_.empty())
+    {
+        std::copy(GridRow(row) + start, GridRow(row) + start + romberg, values);
+    } else
+    {
+        std::copy(FloatRow(row) + start, FloatRow(row) + start + romberg, values);
+    }
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+bool Interpolant::HasGrid() const
+{
+    // the rows of a table in single precision have no values of their own
+    return !floats_.empty() || (!grid_.empty() && fast_);
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+void Interpolant::LocateGrid(double x1, double& x, int& start, int& starti) const
+{
+    const Interpolant& rows = *Interpolant_.front();
+
+    x = rows.isLog_ ? Log(x1) : x1;
+
+    rows.LocateEquidistant(x, start, starti);
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+double Interpolant::InterpolateGrid(int row, double x, int start, int starti) const
+{
+    const Interpolant& rows = *Interpolant_.front();
+
+    const double* iX = rows.iX_.data();
+    const double* iY = nullptr;
+
+    // single precision values are interpolated in a window of double values
+    Scratch window(floats_.empty() ? 0 : rows.romberg_);
+
+    if (floats_.empty())
+    {
+        iY = GridRow(row);
+    } else
+    {
+        GridWindow(row, start, rows.romberg_, window.data());
+
+        iX += start;
+        iY = window.data();
+        starti -= start;
+        start = 0;
+    }
+
+    if (rows.neville_ != nullptr)
+    {
+        return rows.neville_(iX, iY, x, start, starti);
+    }
+
+    // the precision is not tracked for the rows in the grid
+    double precision = 0, worstX = 0;
+
+    return rows.Interpolate(iX,
+                            iY,
+                            x,
+                            start,
+                            starti,
+                            rows.romberg_,
+                            rows.rational_,
+                            rows.relative_,
+                            true,
+                            precision,
+                            worstX);
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+void Interpolant::InterpolateRows(double x1, int first, int last, double* iY) const
+{
+    if (!HasGrid())
+    {
+        for (int i = first; i <= last; i++)
+        {
+            iY[i - first] = Interpolant_[i]->Interpolate(x1);
+        }
+
+        return;
+    }
+
+    const Interpolant& rows = *Interpolant_.front();
+
+    int i, k, l, num, start, starti;
+    int lanes   = last - first + 1;
+    int romberg = rows.romberg_;
+    bool dd;
+    double x, aux, aux2, dx1, dx2;
+
+    LocateGrid(x1, x, start, starti);
+
+    if (rows.rational_ || lanes > max_grid_rows || !NevilleBlock::Supports(romberg))
+    {
+        for (i = first; i <= last; i++)
+        {
+            iY[i - first] = InterpolateGrid(i, x, start, starti);
+        }
+
+        return;
+    }
+
+    const double* iX = rows.iX_.data() + start;
+
+    double values[max_grid_rows][NevilleBlock::max_romberg];
+
+    for (l = 0; l < lanes; l++)
+    {
+        GridWindow(first + l, start, romberg, values[l]);
+    }
+
+    num = starti - start;
+
+    if (x == iX[num])
+    {
+        for (l = 0; l < lanes; l++)
+        {
+            iY[l] = values[l][num];
+        }
+
+        return;
+    }
+
+    // The rows share their sampling points, so the Neville scheme takes the
+    // same path through the tableau for all of them and only the function
+    // values differ. Every row does the same operations in the same order as
+    // the scalar version, so the results are identical.
+    double c[NevilleBlock::max_romberg][max_grid_rows];
+    double d[NevilleBlock::max_romberg][max_grid_rows];
+
+    for (l = 0; l < lanes; l++)
+    {
+        for (i = 0; i < romberg; i++)
+        {
+            c[i][l] = values[l][i];
+            d[i][l] = values[l][i];
+        }
+
+        iY[l] = values[l][num];
+    }
+
+    if (num == 0)
+    {
+        dd = true;
+    } else if (num == romberg - 1)
+    {
+        dd = false;
+    } else
+    {
+        aux  = iX[num - 1];
+        aux2 = iX[num + 1];
+        dd   = ((x - aux) > (aux2 - x)) == (aux2 > aux);
+    }
+
+    for (k = 1; k < romberg; k++)
+    {
+        for (i = 0; i < romberg - k; i++)
+        {
+            dx1  = iX[i] - x;
+            dx2  = iX[i + k] - x;
+            aux2 = dx1 - dx2;
+
+            if (aux2 != 0)
+            {
+                for (l = 0; l < lanes; l++)
+                {
+                    aux     = (c[i + 1][l] - d[i][l]) / aux2;
+                    c[i][l] = dx1 * aux;
+                    d[i][l] = dx2 * aux;
+                }
+            } else
+            {
+                for (l = 0; l < lanes; l++)
+                {
+                    c[i][l] = 0;
+                    d[i][l] = 0;
+                }
+            }
+        }
+
+        if (num == 0)
+        {
+            dd = true;
+        }
+
+        if (num == romberg - k)
+        {
+            dd = false;
+        }
 
-    c_.swap(interpolant.c_);
-    d_.swap(interpolant.d_);
+        if (dd)
+        {
+            for (l = 0; l < lanes; l++)
+            {
+                iY[l] += c[num][l];
+            }
+        } else
+        {
+            num--;
 
-    Interpolant_.swap(interpolant.Interpolant_);
+            for (l = 0; l < lanes; l++)
+            {
+                iY[l] += d[num][l];
+            }
+        }
+
+        dd = !dd;
+    }
+
+    // log substituted zeros are interpolated without the substitution
+    for (l = 0; l < lanes; l++)
+    {
+        if (rows.HasLogZero(values[l], romberg))
+        {
+            iY[l] = InterpolateGrid(first + l, x, start, starti);
+        }
+    }
 }
 
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
-//------------------------private member functions----------------------------//
-//----------------------------------------------------------------------------//
-//----------------------------------------------------------------------------//
+
+bool Interpolant::HasLogZero(const double* iY, int romberg) const
+{
+    if (logSubst_)
+    {
+        for (int i = 0; i < romberg; i++)
+        {
+            if (iY[i] == bigNumber_)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
 
 void Interpolant::InitInterpolant(int max,
                                   double xmin,
@@ -1609,8 +3075,12 @@ void Interpolant::InitInterpolant(int max,
 
     self_   = true;
     fast_   = true;
-    x_save_ = 1;
-    y_save_ = 0;
+
+    polynomials_.clear();
+    log_zero_windows_.clear();
+    grid_.clear();
+    floats_.clear();
+    chebyshev_.clear();
 
     if (max <= 0)
     {
@@ -1693,11 +3163,6 @@ void Interpolant::InitInterpolant(int max,
 
     step_ = (this->xmax_ - this->xmin_) / max;
 
-    int VectorMax_ = std::max(romberg, rombergY);
-
-    c_.resize(VectorMax_);
-    d_.resize(VectorMax_);
-
     precision_       = 0;
     this->isLog_     = isLog;
     this->logSubst_  = logSubst;
@@ -1705,6 +3170,8 @@ void Interpolant::InitInterpolant(int max,
     this->relative_  = relative;
     this->rationalY_ = rationalY;
     this->relativeY_ = relativeY;
+
+    SelectKernels();
 }
 
 //----------------------------------------------------------------------------//
@@ -1724,22 +3191,116 @@ double Interpolant::Get2dFunctionFixedY(double x)
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-double Interpolant::Interpolate(double x, int start)
+double Interpolant::EvaluateChebyshev(double x) const
+{
+    const double* c = chebyshev_.data();
+
+    double u  = (2 * x - chebyshev_min_ - xmax_) / (xmax_ - chebyshev_min_);
+    double b1 = 0, b2 = 0, aux;
+
+    for (int k = chebyshev_.size() - 1; k > 0; k--)
+    {
+        aux = c[k] + 2 * u * b1 - b2;
+        b2  = b1;
+        b1  = aux;
+    }
+
+    return c[0] + u * b1 - b2;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+std::vector<double> Interpolant::ChebyshevCoefficients(int terms) const
+{
+    int j, k, start, starti;
+    double x, dummy;
+
+    std::vector<double> values(terms);
+    std::vector<double> coefficients(terms, 0);
+
+    for (j = 0; j < terms; j++)
+    {
+        x = 0.5 * (xmax_ + chebyshev_min_) + 0.5 * (xmax_ - chebyshev_min_) * std::cos(PI * (j + 0.5) / terms);
+
+        LocateEquidistant(x, start, starti);
+        values[j] = Interpolate(
+            iX_.data(), iY_.data(), x, start, starti, romberg_, rational_, relative_, true, dummy, dummy);
+
+        if (!logSubst_)
+        {
+            values[j] = std::log(values[j]);
+        }
+    }
+
+    for (k = 0; k < terms; k++)
+    {
+        for (j = 0; j < terms; j++)
+        {
+            coefficients[k] += values[j] * std::cos(PI * k * (j + 0.5) / terms);
+        }
+
+        coefficients[k] *= (k == 0 ? 1. : 2.) / terms;
+    }
+
+    return coefficients;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+double Interpolant::EvaluatePolynomial(double x, int start) const
+{
+    const double* a  = &polynomials_[start * romberg_];
+    const double* iX = &iX_[start];
+
+    double result = a[romberg_ - 1];
+
+    for (int i = romberg_ - 2; i >= 0; i--)
+    {
+        result = a[i] + (x - iX[i]) * result;
+    }
+
+    if (log_zero_windows_[start])
+    {
+        result = Log(result);
+    }
+
+    return result;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+double Interpolant::Interpolate(const double* iX,
+                                const double* iY,
+                                double x,
+                                int start,
+                                int starti,
+                                int romberg,
+                                bool rational,
+                                bool relative,
+                                bool reverse,
+                                double& precision,
+                                double& worstX) const
 {
     int num, i, k;
     bool dd, doLog;
     double error = 0, result = 0;
     double aux, aux2, dx1, dx2;
 
+    Scratch c(romberg);
+    Scratch d(romberg);
+
     doLog = false;
 
     if (logSubst_)
     {
-        if (reverse_)
+        if (reverse)
         {
-            for (i = 0; i < romberg_; i++)
+            for (i = 0; i < romberg; i++)
             {
-                if (iY_.at(start + i) == bigNumber_)
+                if (iY[start + i] == bigNumber_)
                 {
                     doLog = true;
                     break;
@@ -1750,40 +3311,40 @@ double Interpolant::Interpolate(double x, int start)
 
     if (fast_)
     {
-        num = starti_ - start;
+        num = starti - start;
 
-        if (x == iX_.at(starti_))
+        if (x == iX[starti])
         {
-            return iY_.at(starti_);
+            return iY[starti];
         }
 
         if (doLog)
         {
-            for (i = 0; i < romberg_; i++)
+            for (i = 0; i < romberg; i++)
             {
-                c_.at(i) = Exp(iY_.at(start + i));
-                d_.at(i) = c_.at(i);
+                c[i] = Exp(iY[start + i]);
+                d[i] = c[i];
             }
         } else
         {
-            for (i = 0; i < romberg_; i++)
+            for (i = 0; i < romberg; i++)
             {
-                c_.at(i) = iY_.at(start + i);
-                d_.at(i) = c_.at(i);
+                c[i] = iY[start + i];
+                d[i] = c[i];
             }
         }
     } else
     {
         num = 0;
-        aux = std::abs(x - iX_.at(start + 0));
+        aux = std::abs(x - iX[start + 0]);
 
-        for (i = 0; i < romberg_; i++)
+        for (i = 0; i < romberg; i++)
         {
-            aux2 = std::abs(x - iX_.at(start + i));
+            aux2 = std::abs(x - iX[start + i]);
 
             if (aux2 == 0)
             {
-                return iY_.at(start + i);
+                return iY[start + i];
             }
 
             if (aux2 < aux)
@@ -1794,12 +3355,12 @@ double Interpolant::Interpolate(double x, int start)
 
             if (doLog)
             {
-                c_.at(i) = Exp(iY_.at(start + i));
-                d_.at(i) = c_.at(i);
+                c[i] = Exp(iY[start + i]);
+                d[i] = c[i];
             } else
             {
-                c_.at(i) = iY_.at(start + i);
-                d_.at(i) = c_.at(i);
+                c[i] = iY[start + i];
+                d[i] = c[i];
             }
         }
     }
@@ -1807,14 +3368,14 @@ double Interpolant::Interpolate(double x, int start)
     if (num == 0)
     {
         dd = true;
-    } else if (num == romberg_ - 1)
+    } else if (num == romberg - 1)
     {
         dd = false;
     } else
     {
         k    = start + num;
-        aux  = iX_.at(k - 1);
-        aux2 = iX_.at(k + 1);
+        aux  = iX[k - 1];
+        aux2 = iX[k + 1];
 
         if (fast_)
         {
@@ -1837,50 +3398,50 @@ double Interpolant::Interpolate(double x, int start)
         }
     }
 
-    result = iY_.at(start + num);
+    result = iY[start + num];
 
     if (doLog)
     {
         result = Exp(result);
     }
 
-    for (k = 1; k < romberg_; k++)
+    for (k = 1; k < romberg; k++)
     {
-        for (i = 0; i < romberg_ - k; i++)
+        for (i = 0; i < romberg - k; i++)
         {
-            if (rational_)
+            if (rational)
             {
-                aux  = c_.at(i + 1) - d_.at(i);
-                dx2  = iX_.at(start + i + k) - x;
-                dx1  = d_.at(i) * (iX_.at(start + i) - x) / dx2;
-                aux2 = dx1 - c_.at(i + 1);
+                aux  = c[i + 1] - d[i];
+                dx2  = iX[start + i + k] - x;
+                dx1  = d[i] * (iX[start + i] - x) / dx2;
+                aux2 = dx1 - c[i + 1];
 
                 if (aux2 != 0)
                 {
-                    aux      = aux / aux2;
-                    d_.at(i) = c_.at(i + 1) * aux;
-                    c_.at(i) = dx1 * aux;
+                    aux  = aux / aux2;
+                    d[i] = c[i + 1] * aux;
+                    c[i] = dx1 * aux;
                 } else
                 {
-                    c_.at(i) = 0;
-                    d_.at(i) = 0;
+                    c[i] = 0;
+                    d[i] = 0;
                 }
             } else
             {
-                dx1  = iX_.at(start + i) - x;
-                dx2  = iX_.at(start + i + k) - x;
-                aux  = c_.at(i + 1) - d_.at(i);
+                dx1  = iX[start + i] - x;
+                dx2  = iX[start + i + k] - x;
+                aux  = c[i + 1] - d[i];
                 aux2 = dx1 - dx2;
 
                 if (aux2 != 0)
                 {
-                    aux      = aux / aux2;
-                    c_.at(i) = dx1 * aux;
-                    d_.at(i) = dx2 * aux;
+                    aux  = aux / aux2;
+                    c[i] = dx1 * aux;
+                    d[i] = dx2 * aux;
                 } else
                 {
-                    c_.at(i) = 0;
-                    d_.at(i) = 0;
+                    c[i] = 0;
+                    d[i] = 0;
                 }
             }
         }
@@ -1890,18 +3451,18 @@ double Interpolant::Interpolate(double x, int start)
             dd = true;
         }
 
-        if (num == romberg_ - k)
+        if (num == romberg - k)
         {
             dd = false;
         }
 
         if (dd)
         {
-            error = c_.at(num);
+            error = c[num];
         } else
         {
             num--;
-            error = d_.at(num);
+            error = d[num];
         }
 
         dd = !dd;
@@ -1910,7 +3471,7 @@ double Interpolant::Interpolate(double x, int start)
 
     if (!fast_)
     {
-        if (relative_)
+        if (relative)
         {
             if (result != 0)
             {
@@ -1924,10 +3485,10 @@ double Interpolant::Interpolate(double x, int start)
             aux = std::abs(error);
         }
 
-        if (aux > precision_)
+        if (aux > precision)
         {
-            precision_ = aux;
-            worstX_    = x;
+            precision = aux;
+            worstX    = x;
         }
     }
 
@@ -1942,48 +3503,263 @@ double Interpolant::Interpolate(double x, int start)
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-double Interpolant::Exp(double x)
+template <int Romberg, bool Rational, bool LogZero>
+double Interpolant::Neville(const double* iX, const double* iY, double x, int start, int starti)
 {
-    if (x <= aBigNumber_)
+    int num, i, k;
+    bool dd, doLog;
+    double error = 0, result = 0;
+    double aux, aux2, dx1, dx2;
+
+    double c[Romberg];
+    double d[Romberg];
+
+    if (x == iX[starti])
     {
-        return 0;
+        return iY[starti];
+    }
+
+    num = starti - start;
+    iX += start;
+    iY += start;
+
+    doLog = false;
+
+    if (LogZero)
+    {
+        for (i = 0; i < Romberg; i++)
+        {
+            if (iY[i] == bigNumber_)
+            {
+                doLog = true;
+                break;
+            }
+        }
+    }
+
+    if (doLog)
+    {
+        for (i = 0; i < Romberg; i++)
+        {
+            c[i] = Exp(iY[i]);
+            d[i] = c[i];
+        }
     } else
     {
-        return std::exp(x);
+        for (i = 0; i < Romberg; i++)
+        {
+            c[i] = iY[i];
+            d[i] = c[i];
+        }
+    }
+
+    if (num == 0)
+    {
+        dd = true;
+    } else if (num == Romberg - 1)
+    {
+        dd = false;
+    } else
+    {
+        aux  = iX[num - 1];
+        aux2 = iX[num + 1];
+        dd   = ((x - aux) > (aux2 - x)) == (aux2 > aux);
+    }
+
+    result = iY[num];
+
+    if (doLog)
+    {
+        result = Exp(result);
+    }
+
+    for (k = 1; k < Romberg; k++)
+    {
+        for (i = 0; i < Romberg - k; i++)
+        {
+            if (Rational)
+            {
+                aux  = c[i + 1] - d[i];
+                dx2  = iX[i + k] - x;
+                dx1  = d[i] * (iX[i] - x) / dx2;
+                aux2 = dx1 - c[i + 1];
+
+                if (aux2 != 0)
+                {
+                    aux  = aux / aux2;
+                    d[i] = c[i + 1] * aux;
+                    c[i] = dx1 * aux;
+                } else
+                {
+                    c[i] = 0;
+                    d[i] = 0;
+                }
+            } else
+            {
+                dx1  = iX[i] - x;
+                dx2  = iX[i + k] - x;
+                aux  = c[i + 1] - d[i];
+                aux2 = dx1 - dx2;
+
+                if (aux2 != 0)
+                {
+                    aux  = aux / aux2;
+                    c[i] = dx1 * aux;
+                    d[i] = dx2 * aux;
+                } else
+                {
+                    c[i] = 0;
+                    d[i] = 0;
+                }
+            }
+        }
+
+        if (num == 0)
+        {
+            dd = true;
+        }
+
+        if (num == Romberg - k)
+        {
+            dd = false;
+        }
+
+        if (dd)
+        {
+            error = c[num];
+        } else
+        {
+            num--;
+            error = d[num];
+        }
+
+        dd = !dd;
+        result += error;
     }
+
+    if (doLog)
+    {
+        result = Log(result);
+    }
+
+    return result;
 }
 
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-double Interpolant::Log(double x)
+template <int Romberg, bool Rational, bool IsLog, bool LogSubst>
+double Interpolant::InterpolateKernel(const Interpolant& interpolant, double x)
 {
-    if (x <= 0)
+    int start, starti;
+    double result;
+
+    if (IsLog)
     {
-        return bigNumber_;
-    } else
+        x = Log(x);
+    }
+
+    interpolant.LocateEquidistant(x, start, starti);
+
+    result = Neville<Romberg, Rational, LogSubst>(interpolant.iX_.data(), interpolant.iY_.data(), x, start, starti);
+
+    if (LogSubst)
     {
-        return std::log(x);
+        result = Exp(result);
+    }
+
+    return result;
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
+
+template <>
+void Interpolant::SelectKernelsOfOrder<0>()
+{
+}
+
+template <int Romberg>
+void Interpolant::SelectKernelsOfOrder()
+{
+    // indexed by rational and log substitution of the sampling points
+    static const NevilleKernel nevilles[] = {&Neville<Romberg, false, false>,
+                                             &Neville<Romberg, false, true>,
+                                             &Neville<Romberg, true, false>,
+                                             &Neville<Romberg, true, true>};
+
+    // indexed by rational, isLog and logSubst
+    static const Kernel kernels[] = {&InterpolateKernel<Romberg, false, false, false>,
+                                     &InterpolateKernel<Romberg, false, false, true>,
+                                     &InterpolateKernel<Romberg, false, true, false>,
+                                     &InterpolateKernel<Romberg, false, true, true>,
+                                     &InterpolateKernel<Romberg, true, false, false>,
+                                     &InterpolateKernel<Romberg, true, false, true>,
+                                     &InterpolateKernel<Romberg, true, true, false>,
+                                     &InterpolateKernel<Romberg, true, true, true>};
+
+    if (romberg_ == Romberg)
+    {
+        neville_ = nevilles[2 * rational_ + logSubst_];
+
+        // the values of rows of 2d tables are not log substituted back
+        if (self_ && polynomials_.empty())
+        {
+            kernel_ = kernels[4 * rational_ + 2 * isLog_ + logSubst_];
+        }
+    }
+
+    // the inverse interpolation does not substitute zeros
+    if (rombergY_ == Romberg)
+    {
+        inverse_ = nevilles[2 * rational_];
+    }
+
+    SelectKernelsOfOrder<Romberg - 1>();
+}
+
+void Interpolant::SelectKernels()
+{
+    kernel_  = nullptr;
+    neville_ = nullptr;
+    inverse_ = nullptr;
+
+    // the precision is only tracked by the general code
+    if (fast_)
+    {
+        SelectKernelsOfOrder<max_kernel_romberg>();
     }
 }
 
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 
-double Interpolant::Slog(double x)
+double Interpolant::Exp(double x)
 {
-    if (x == x_save_)
+    if (x <= aBigNumber_)
     {
-        return y_save_;
+        return 0;
     } else
     {
-        x_save_ = x;
-        y_save_ = Log(x_save_);
+        return std::exp(x);
+    }
+}
+
+//----------------------------------------------------------------------------//
+//----------------------------------------------------------------------------//
 
-        return y_save_;
+double Interpolant::Log(double x)
+{
+    if (x <= 0)
+    {
+        return bigNumber_;
+    } else
+    {
+        return std::log(x);
     }
 }
 
+
 //----------------------------------------------------------------------------//
 //----------------------------------------------------------------------------//
 //---------------------------------Setter-------------------------------------//
@@ -1993,46 +3769,55 @@ double Interpolant::Slog(double x)
 void Interpolant::SetRombergY(int rombergY)
 {
     rombergY_ = rombergY;
+    SelectKernels();
 }
 
 void Interpolant::SetRomberg(int romberg)
 {
     romberg_ = romberg;
+    chebyshev_.clear();
+    polynomials_.clear();
+    log_zero_windows_.clear();
+    SelectKernels();
 }
 
 void Interpolant::SetIX(const std::vector<double>& iX)
 {
     iX_ = iX;
+    chebyshev_.clear();
+    polynomials_.clear();
+    log_zero_windows_.clear();
+    SelectKernels();
 }
 
 void Interpolant::SetIY(const std::vector<double>& iY)
 {
     iY_ = iY;
-}
-
-void Interpolant::SetC(const std::vector<double>& c)
-{
-    c_ = c;
-}
-
-void Interpolant::SetD(const std::vector<double>& d)
-{
-    d_ = d;
+    chebyshev_.clear();
+    polynomials_.clear();
+    log_zero_windows_.clear();
+    SelectKernels();
 }
 
 void Interpolant::SetMax(int max)
 {
     max_ = max;
+    chebyshev_.clear();
+    polynomials_.clear();
+    log_zero_windows_.clear();
+    SelectKernels();
 }
 
 void Interpolant::SetXmin(double xmin)
 {
     xmin_ = xmin;
+    chebyshev_.clear();
 }
 
 void Interpolant::SetXmax(double xmax)
 {
     xmax_ = xmax;
+    chebyshev_.clear();
 }
 
 void Interpolant::SetStep(double step)
@@ -2048,6 +3833,8 @@ void Interpolant::SetRelative(bool relative)
 void Interpolant::SetRational(bool rational)
 {
     rational_ = rational;
+    chebyshev_.clear();
+    SelectKernels();
 }
 
 void Interpolant::SetRow(int row)
@@ -2055,11 +3842,6 @@ void Interpolant::SetRow(int row)
     row_ = row;
 }
 
-void Interpolant::SetStarti(int starti)
-{
-    starti_ = starti;
-}
-
 void Interpolant::SetRationalY(bool rationalY)
 {
     rationalY_ = rationalY;
@@ -2073,6 +3855,8 @@ void Interpolant::SetRelativeY(bool relativeY)
 void Interpolant::SetSelf(bool self)
 {
     self_ = self;
+    chebyshev_.clear();
+    SelectKernels();
 }
 
 void Interpolant::SetFlag(bool flag)
@@ -2080,19 +3864,18 @@ void Interpolant::SetFlag(bool flag)
     flag_ = flag;
 }
 
-void Interpolant::SetReverse(bool reverse)
-{
-    reverse_ = reverse;
-}
-
 void Interpolant::SetIsLog(bool isLog)
 {
     isLog_ = isLog;
+    chebyshev_.clear();
+    SelectKernels();
 }
 
 void Interpolant::SetLogSubst(bool logSubst)
 {
     logSubst_ = logSubst;
+    chebyshev_.clear();
+    SelectKernels();
 }
 
 void Interpolant::SetPrecision(double precision)
@@ -2123,16 +3906,8 @@ void Interpolant::SetPrecisionY(double precisionY)
 void Interpolant::SetFast(bool fast)
 {
     fast_ = fast;
-}
-
-void Interpolant::SetX_save(double x_save)
-{
-    x_save_ = x_save;
-}
-
-void Interpolant::SetY_save(double y_save)
-{
-    y_save_ = y_save;
+    chebyshev_.clear();
+    SelectKernels();
 }
 
 //----------------------------------------------------------------------------//
@@ -2145,8 +3920,6 @@ Interpolant::~Interpolant()
 {
     iX_.clear();
     iY_.clear();
-    c_.clear();
-    d_.clear();
 
     for (unsigned int i = 0; i < Interpolant_.size(); i++)
     {
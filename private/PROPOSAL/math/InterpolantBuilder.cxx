@@ -2,8 +2,230 @@
 #include "PROPOSAL/math/InterpolantBuilder.h"
 #include "PROPOSAL/math/Interpolant.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "PROPOSAL/Logging.h"
+
 using namespace PROPOSAL;
 
+namespace {
+
+// Number of rows and columns of a 2d table the error is estimated on
+const int error_samples = 8;
+
+// Largest number of tables built to find the number of nodes
+const int max_adaptive_builds = 8;
+
+// Creates a table with the given number of nodes in every dimension and
+// estimates its error in every dimension
+typedef std::function<Interpolant*(const std::vector<int>&, std::vector<double>&)> AdaptiveBuild;
+
+double Node(double x, bool isLog)
+{
+    return isLog ? std::exp(x) : x;
+}
+
+// Relative difference of the interpolated and the exact value. Close to
+// zeros of the function, the values at the neighbouring nodes set the scale.
+// Intervals at thresholds, where the function vanishes, are not refined by
+// more nodes and are skipped.
+double RelativeError(double interpolated, double exact, double lower, double upper)
+{
+    if (exact == 0 || lower == 0 || upper == 0)
+    {
+        return 0;
+    }
+
+    double scale = std::max(std::max(std::abs(exact), std::abs(interpolated)),
+                            std::max(std::abs(lower), std::abs(upper)));
+    return std::abs(interpolated - exact) / scale;
+}
+
+// Indices of the nodes the error of a 2d table is estimated on
+std::vector<int> Samples(int nodes)
+{
+    std::vector<int> samples;
+    for (int k = 0; k < error_samples; ++k)
+    {
+        int index = k * (nodes - 1) / (error_samples - 1);
+        if (samples.empty() || samples.back() != index)
+        {
+            samples.push_back(index);
+        }
+    }
+    return samples;
+}
+
+// Largest error in the middle between the nodes x
+double EstimateError(const std::vector<double>& x,
+                     bool isLog,
+                     const std::function<double(double)>& interpolate,
+                     const std::function<double(double)>& function)
+{
+    double error = 0;
+
+    double upper = interpolate(Node(x.front(), isLog));
+    for (size_t i = 0; i + 1 < x.size(); ++i)
+    {
+        double lower = upper;
+        upper        = interpolate(Node(x[i + 1], isLog));
+
+        double middle = Node(0.5 * (x[i] + x[i + 1]), isLog);
+        error         = std::max(error, RelativeError(interpolate(middle), function(middle), lower, upper));
+    }
+    return error;
+}
+
+// Largest error between the nodes of the first dimension on some of the
+// rows and between the rows on some of the nodes of the first dimension
+void EstimateError(Interpolant& table,
+                   const std::function<double(double, double)>& function,
+                   bool isLog1,
+                   bool isLog2,
+                   double& error1,
+                   double& error2)
+{
+    std::vector<double> x1 = table.GetInterpolant().front()->GetIX();
+    std::vector<double> x2 = table.GetIX();
+
+    error1 = 0;
+    error2 = 0;
+
+    std::vector<int> rows = Samples(x2.size());
+    for (std::vector<int>::const_iterator row = rows.begin(); row != rows.end(); ++row)
+    {
+        double y = Node(x2[*row], isLog2);
+        error1   = std::max(error1,
+                          EstimateError(x1,
+                                        isLog1,
+                                        [&table, y](double x) { return table.Interpolate(x, y); },
+                                        [&function, y](double x) { return function(x, y); }));
+    }
+
+    std::vector<int> columns = Samples(x1.size());
+    for (std::vector<int>::const_iterator column = columns.begin(); column != columns.end(); ++column)
+    {
+        double x = Node(x1[*column], isLog1);
+        error2   = std::max(error2,
+                          EstimateError(x2,
+                                        isLog2,
+                                        [&table, x](double y) { return table.Interpolate(x, y); },
+                                        [&function, x](double y) { return function(x, y); }));
+    }
+}
+
+// Builds tables until the estimated error is below target_error in every
+// dimension. The error of an interpolation of order romberg scales with the
+// romberg-th power of the node distance, so the number of nodes for the
+// next table is predicted from the error of the last one. Kinks of the
+// function converge slower, so the order is measured by the tables built
+// before. Tables exceeding the target are refined, tables well below it are
+// coarsened.
+Interpolant* BuildAdaptive(const std::vector<int>& max_nodes,
+                           const std::vector<int>& romberg,
+                           double target_error,
+                           const AdaptiveBuild& build,
+                           double& error)
+{
+    size_t dim = max_nodes.size();
+    std::vector<int> min_nodes(dim), nodes(dim), next(dim), last_nodes(dim, 0);
+    std::vector<double> errors(dim), last_errors(dim, 0);
+    std::vector<double> order(romberg.begin(), romberg.end());
+
+    for (size_t d = 0; d < dim; ++d)
+    {
+        min_nodes[d] = std::min(max_nodes[d], 2 * romberg[d]);
+        nodes[d]     = std::max(min_nodes[d], max_nodes[d] / 4);
+    }
+
+    Interpolant* best = nullptr;
+
+    for (int n_builds = 1; n_builds <= max_adaptive_builds; ++n_builds)
+    {
+        Interpolant* table = build(nodes, errors);
+
+        for (size_t d = 0; d < dim; ++d)
+        {
+            if (last_nodes[d] > 0 && last_nodes[d] != nodes[d] && errors[d] > 0 && last_errors[d] > 0)
+            {
+                double measured = std::log(last_errors[d] / errors[d]) / std::log(double(nodes[d]) / last_nodes[d]);
+                order[d]        = std::min(std::max(measured, 1.), double(romberg[d]));
+            }
+            last_nodes[d]  = nodes[d];
+            last_errors[d] = errors[d];
+        }
+
+        bool passed = true, refinable = true;
+        for (size_t d = 0; d < dim; ++d)
+        {
+            if (errors[d] > target_error)
+            {
+                passed    = false;
+                refinable = refinable && nodes[d] < max_nodes[d];
+            }
+        }
+
+        if (passed)
+        {
+            delete best;
+            best  = table;
+            error = *std::max_element(errors.begin(), errors.end());
+        } else if (best != nullptr)
+        {
+            // a coarser table failed, keep the last one
+            delete table;
+            break;
+        } else if (!refinable || n_builds == max_adaptive_builds)
+        {
+            // the target can not be reached, use the given number of nodes
+            if (nodes != max_nodes)
+            {
+                delete table;
+                table = build(max_nodes, errors);
+            }
+            error = *std::max_element(errors.begin(), errors.end());
+            log_warn("The interpolation error %g is larger than the target %g.", error, target_error);
+            return table;
+        } else
+        {
+            delete table;
+        }
+
+        double size = 1, next_size = 1;
+        for (size_t d = 0; d < dim; ++d)
+        {
+            double factor = std::pow(errors[d] / target_error, 1. / order[d]);
+            int n         = static_cast<int>(std::ceil(1.1 * factor * nodes[d]));
+
+            if (errors[d] > target_error)
+            {
+                // the full table costs less than another try close to it
+                n = n > max_nodes[d] / 2 ? max_nodes[d] : std::max(n, nodes[d] + 1);
+            } else
+            {
+                // coarse tables may miss features of the function
+                n = std::min(std::max(n, nodes[d] / 2), nodes[d]);
+            }
+
+            next[d] = std::min(std::max(n, min_nodes[d]), max_nodes[d]);
+            size *= nodes[d];
+            next_size *= next[d];
+        }
+
+        // not worth another table
+        if (passed && next_size > 0.8 * size)
+        {
+            break;
+        }
+        nodes = next;
+    }
+
+    return best;
+}
+
+} // namespace
+
 // ------------------------------------------------------------------------- //
 // Defaults for InterpolantBuilder
 // ------------------------------------------------------------------------- //
@@ -32,6 +254,8 @@ const Interpolant2DBuilder::Function2D Interpolant2DBuilder::default_function2d
 Interpolant1DBuilder::Interpolant1DBuilder()
     : InterpolantBuilder()
     , function1d(default_function1d)
+    , target_error(0)
+    , error(-1)
     , max(default_max)
     , xmin(default_xmin)
     , xmax(default_xmax)
@@ -48,6 +272,8 @@ Interpolant1DBuilder::Interpolant1DBuilder()
 
 Interpolant1DBuilder::Interpolant1DBuilder(const Interpolant1DBuilder& builder)
     : function1d(builder.function1d)
+    , target_error(builder.target_error)
+    , error(builder.error)
     , max(builder.max)
     , xmin(builder.xmin)
     , xmax(builder.xmax)
@@ -64,8 +290,43 @@ Interpolant1DBuilder::Interpolant1DBuilder(const Interpolant1DBuilder& builder)
 
 Interpolant* Interpolant1DBuilder::build()
 {
-    return new Interpolant(
-        max, xmin, xmax, function1d, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
+    error = -1;
+
+    if (target_error <= 0)
+    {
+        return new Interpolant(
+            max, xmin, xmax, function1d, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
+    }
+
+    Interpolant* interpolant = BuildAdaptive(
+        std::vector<int>(1, max),
+        std::vector<int>(1, romberg),
+        target_error,
+        [this](const std::vector<int>& nodes, std::vector<double>& errors) {
+            Interpolant* table = new Interpolant(nodes[0],
+                                                 xmin,
+                                                 xmax,
+                                                 function1d,
+                                                 romberg,
+                                                 rational,
+                                                 relative,
+                                                 isLog,
+                                                 rombergY,
+                                                 rationalY,
+                                                 relativeY,
+                                                 logSubst);
+            errors[0] = EstimateError(
+                table->GetIX(), isLog, [table](double x) { return table->Interpolate(x); }, function1d);
+            return table;
+        },
+        error);
+
+    log_debug("Interpolation table with %i instead of %i nodes, estimated error %g",
+              interpolant->GetMax(),
+              max,
+              error);
+
+    return interpolant;
 }
 
 // ------------------------------------------------------------------------- //
@@ -75,6 +336,10 @@ Interpolant* Interpolant1DBuilder::build()
 Interpolant2DBuilder::Interpolant2DBuilder()
     : InterpolantBuilder()
     , function2d(default_function2d)
+    , function2d_factory(nullptr)
+    , n_threads(1)
+    , target_error(0)
+    , error(-1)
     , max1(default_max)
     , x1min(default_xmin)
     , x1max(default_xmax)
@@ -98,6 +363,10 @@ Interpolant2DBuilder::Interpolant2DBuilder()
 
 Interpolant2DBuilder::Interpolant2DBuilder(const Interpolant2DBuilder& builder)
     : function2d(builder.function2d)
+    , function2d_factory(builder.function2d_factory)
+    , n_threads(builder.n_threads)
+    , target_error(builder.target_error)
+    , error(builder.error)
     , max1(builder.max1)
     , x1min(builder.x1min)
     , x1max(builder.x1max)
@@ -145,10 +414,73 @@ Interpolant2DBuilder_array_as::Interpolant2DBuilder_array_as(const Interpolant2D
 
 Interpolant* Interpolant2DBuilder::build()
 {
-    return new Interpolant(max1,
+    error = -1;
+
+    if (target_error <= 0)
+    {
+        return build(max1, max2);
+    }
+
+    // only used by this thread
+    Function2D function = function2d_factory != nullptr ? function2d_factory() : function2d;
+
+    std::vector<int> max_nodes, romberg;
+    max_nodes.push_back(max1);
+    max_nodes.push_back(max2);
+    romberg.push_back(romberg1);
+    romberg.push_back(romberg2);
+
+    Interpolant* interpolant = BuildAdaptive(
+        max_nodes,
+        romberg,
+        target_error,
+        [this, &function](const std::vector<int>& nodes, std::vector<double>& errors) {
+            Interpolant* table = build(nodes[0], nodes[1]);
+            EstimateError(*table, function, isLog1, isLog2, errors[0], errors[1]);
+            return table;
+        },
+        error);
+
+    log_debug("Interpolation table with %i x %i instead of %i x %i nodes, estimated error %g",
+              interpolant->GetInterpolant().front()->GetMax(),
+              interpolant->GetMax(),
+              max1,
+              max2,
+              error);
+
+    return interpolant;
+}
+
+Interpolant* Interpolant2DBuilder::build(int nodes1, int nodes2)
+{
+    if (function2d_factory != nullptr)
+    {
+        return new Interpolant(nodes1,
+                               x1min,
+                               x1max,
+                               nodes2,
+                               x2min,
+                               x2max,
+                               function2d_factory,
+                               n_threads,
+                               romberg1,
+                               rational1,
+                               relative1,
+                               isLog1,
+                               romberg2,
+                               rational2,
+                               relative2,
+                               isLog2,
+                               rombergY,
+                               rationalY,
+                               relativeY,
+                               logSubst);
+    }
+
+    return new Interpolant(nodes1,
                            x1min,
                            x1max,
-                           max2,
+                           nodes2,
                            x2min,
                            x2max,
                            function2d,
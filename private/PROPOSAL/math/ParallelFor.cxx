@@ -0,0 +1,156 @@
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "PROPOSAL/math/ParallelFor.h"
+
+namespace PROPOSAL {
+
+namespace {
+
+// Items [begin, end) still to be processed by one worker
+struct WorkRange
+{
+    WorkRange()
+        : begin(0)
+        , end(0)
+    {
+    }
+
+    std::mutex mutex;
+    size_t begin;
+    size_t end;
+};
+
+// Takes the next item of the own range. Returns false if it is empty.
+bool PopFront(WorkRange& range, size_t& item)
+{
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.begin >= range.end)
+        return false;
+
+    item = range.begin++;
+    return true;
+}
+
+// Moves the upper half of the victim's range into the own range.
+// Only one lock is held at a time, so workers can not deadlock.
+bool Steal(WorkRange& victim, WorkRange& own)
+{
+    size_t begin, end;
+    {
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.begin >= victim.end)
+            return false;
+
+        begin = victim.begin + (victim.end - victim.begin) / 2;
+        end = victim.end;
+        victim.end = begin;
+    }
+
+    std::lock_guard<std::mutex> lock(own.mutex);
+    own.begin = begin;
+    own.end = end;
+    return true;
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------- //
+unsigned int NumberOfWorkers(unsigned int n_threads, size_t n_items)
+{
+    if (n_threads == 0)
+        n_threads = std::thread::hardware_concurrency();
+
+    if (n_threads == 0)
+        n_threads = 1;
+
+    if (n_items < n_threads)
+        n_threads = n_items > 0 ? static_cast<unsigned int>(n_items) : 1;
+
+    return n_threads;
+}
+
+// ------------------------------------------------------------------------- //
+void ParallelFor(size_t n_items,
+                 unsigned int n_workers,
+                 const std::function<void(unsigned int, size_t)>& task)
+{
+    if (n_workers <= 1)
+    {
+        for (size_t i = 0; i < n_items; ++i)
+            task(0, i);
+
+        return;
+    }
+
+    std::vector<std::unique_ptr<WorkRange>> ranges;
+    for (unsigned int w = 0; w < n_workers; ++w)
+    {
+        ranges.emplace_back(new WorkRange());
+        ranges[w]->begin = n_items * w / n_workers;
+        ranges[w]->end = n_items * (w + 1) / n_workers;
+    }
+
+    std::atomic<bool> abort(false);
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+
+    auto work = [&](unsigned int worker) {
+        WorkRange& own = *ranges[worker];
+        size_t item;
+
+        while (!abort)
+        {
+            if (!PopFront(own, item))
+            {
+                bool stolen = false;
+                for (unsigned int i = 1; i < n_workers && !stolen; ++i)
+                {
+                    stolen = Steal(*ranges[(worker + i) % n_workers], own);
+                }
+
+                // items are only moved between the ranges, so if all of them
+                // are empty the remaining items are already being processed
+                if (!stolen)
+                    return;
+
+                continue;
+            }
+
+            try
+            {
+                task(worker, item);
+            } catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exception_mutex);
+                if (!exception)
+                    exception = std::current_exception();
+
+                abort = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int w = 1; w < n_workers; ++w)
+    {
+        threads.emplace_back(work, w);
+    }
+
+    work(0);
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+} // namespace PROPOSAL
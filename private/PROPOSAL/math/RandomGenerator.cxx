@@ -13,6 +13,28 @@ using namespace PROPOSAL;
 std::mt19937 RandomGenerator::rng_;
 std::uniform_real_distribution<double> RandomGenerator::uniform_distribution(0.0, 1.0);
 
+namespace {
+thread_local RandomStream* current_stream = nullptr;
+} // namespace
+
+// ------------------------------------------------------------------------- //
+// StreamScope
+// ------------------------------------------------------------------------- //
+
+RandomGenerator::StreamScope::StreamScope(RandomStream* stream)
+    : previous_(current_stream)
+{
+    if (stream)
+    {
+        current_stream = stream;
+    }
+}
+
+RandomGenerator::StreamScope::~StreamScope()
+{
+    current_stream = previous_;
+}
+
 // ------------------------------------------------------------------------- //
 // Constructor & destructor
 // ------------------------------------------------------------------------- //
@@ -34,6 +56,11 @@ RandomGenerator::~RandomGenerator() {}
 // ------------------------------------------------------------------------- //
 double RandomGenerator::RandomDouble()
 {
+    if (current_stream)
+    {
+        return current_stream->RandomDouble();
+    }
+
 #ifdef ICECUBE_PROJECT
     if (i3random_gen_)
     {
@@ -57,13 +84,31 @@ void RandomGenerator::SetSeed(int seed)
 // ------------------------------------------------------------------------- //
 void RandomGenerator::Serialize(std::ostream& os)
 {
-    os << rng_;
+    if (current_stream)
+    {
+        current_stream->Serialize(os);
+    } else
+    {
+        os << rng_;
+    }
 }
 
 // ------------------------------------------------------------------------- //
 void RandomGenerator::Deserialize(std::istream& is)
 {
-    is >> rng_;
+    if (current_stream)
+    {
+        current_stream->Deserialize(is);
+    } else
+    {
+        is >> rng_;
+    }
+}
+
+// ------------------------------------------------------------------------- //
+RandomStream* RandomGenerator::GetStream() const
+{
+    return current_stream;
 }
 
 // ------------------------------------------------------------------------- //
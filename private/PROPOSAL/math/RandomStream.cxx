@@ -0,0 +1,153 @@
+
+#include "PROPOSAL/math/RandomStream.h"
+
+using namespace PROPOSAL;
+
+namespace {
+
+const uint32_t PHILOX_M0 = 0xD2511F53;
+const uint32_t PHILOX_M1 = 0xCD9E8D57;
+const uint32_t PHILOX_W0 = 0x9E3779B9; // golden ratio
+const uint32_t PHILOX_W1 = 0xBB67AE85; // sqrt(3) - 1
+
+inline void MulHiLo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo)
+{
+    uint64_t product = static_cast<uint64_t>(a) * b;
+    hi = static_cast<uint32_t>(product >> 32);
+    lo = static_cast<uint32_t>(product);
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------- //
+// Constructor & destructor
+// ------------------------------------------------------------------------- //
+
+PhiloxStream::PhiloxStream(uint64_t seed, uint64_t stream)
+    : seed_(seed)
+    , stream_(stream)
+    , position_(0)
+    , cached_block_(0)
+    , cache_valid_(false)
+    , cache_()
+{
+}
+
+PhiloxStream::PhiloxStream(const PhiloxStream& stream)
+    : seed_(stream.seed_)
+    , stream_(stream.stream_)
+    , position_(stream.position_)
+    , cached_block_(stream.cached_block_)
+    , cache_valid_(stream.cache_valid_)
+    , cache_(stream.cache_)
+{
+}
+
+PhiloxStream::~PhiloxStream() {}
+
+// ------------------------------------------------------------------------- //
+// Operators
+// ------------------------------------------------------------------------- //
+
+bool PhiloxStream::operator==(const PhiloxStream& stream) const
+{
+    // The cache is not part of the state, it is only there for speed
+    return seed_ == stream.seed_ && stream_ == stream.stream_ && position_ == stream.position_;
+}
+
+bool PhiloxStream::operator!=(const PhiloxStream& stream) const
+{
+    return !(*this == stream);
+}
+
+// ------------------------------------------------------------------------- //
+// Methods
+// ------------------------------------------------------------------------- //
+
+// ------------------------------------------------------------------------- //
+PhiloxStream::Counter PhiloxStream::Philox4x32(Counter counter, Key key)
+{
+    uint32_t hi0, lo0, hi1, lo1;
+
+    for (int round = 0; round < 10; ++round)
+    {
+        MulHiLo(PHILOX_M0, counter[0], hi0, lo0);
+        MulHiLo(PHILOX_M1, counter[2], hi1, lo1);
+
+        counter = {{ hi1 ^ counter[1] ^ key[0], lo1, hi0 ^ counter[3] ^ key[1], lo0 }};
+
+        key[0] += PHILOX_W0;
+        key[1] += PHILOX_W1;
+    }
+
+    return counter;
+}
+
+// ------------------------------------------------------------------------- //
+void PhiloxStream::Generate(uint64_t block)
+{
+    Counter counter = {{ static_cast<uint32_t>(block),
+                         static_cast<uint32_t>(block >> 32),
+                         static_cast<uint32_t>(stream_),
+                         static_cast<uint32_t>(stream_ >> 32) }};
+    Key key = {{ static_cast<uint32_t>(seed_), static_cast<uint32_t>(seed_ >> 32) }};
+
+    cache_        = Philox4x32(counter, key);
+    cached_block_ = block;
+    cache_valid_  = true;
+}
+
+// ------------------------------------------------------------------------- //
+double PhiloxStream::RandomDouble()
+{
+    uint64_t block = position_ / 2;
+
+    if (!cache_valid_ || cached_block_ != block)
+    {
+        Generate(block);
+    }
+
+    unsigned int i = 2 * static_cast<unsigned int>(position_ % 2);
+    ++position_;
+
+    // Use the upper 53 bits of the 64 bit word, shifted by half a step,
+    // so neither 0 nor 1 is returned.
+    uint64_t bits = (static_cast<uint64_t>(cache_[i + 1]) << 32) | cache_[i];
+
+    return (static_cast<double>(bits >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// ------------------------------------------------------------------------- //
+void PhiloxStream::SkipAhead(uint64_t n)
+{
+    position_ += n;
+}
+
+// ------------------------------------------------------------------------- //
+void PhiloxStream::SetStream(uint64_t stream)
+{
+    stream_      = stream;
+    position_    = 0;
+    cache_valid_ = false;
+}
+
+// ------------------------------------------------------------------------- //
+void PhiloxStream::SetSeed(uint64_t seed)
+{
+    seed_        = seed;
+    position_    = 0;
+    cache_valid_ = false;
+}
+
+// ------------------------------------------------------------------------- //
+void PhiloxStream::Serialize(std::ostream& os) const
+{
+    os << seed_ << " " << stream_ << " " << position_;
+}
+
+// ------------------------------------------------------------------------- //
+void PhiloxStream::Deserialize(std::istream& is)
+{
+    is >> seed_ >> stream_ >> position_;
+    cache_valid_ = false;
+}
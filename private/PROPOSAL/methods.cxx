@@ -9,12 +9,27 @@
 
 // #include <stdlib.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <climits> // for PATH_MAX
+#include <cstdint>
+#include <cstdio>  // for rename
+#include <cstdlib> // for mkstemp
+#include <cstring> // for strerror
+#include <deque>
+#include <fcntl.h>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <list>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <sys/file.h> // for flock
+#include <sys/mman.h> // for mmap
 #include <sys/stat.h>
 #include <unistd.h>  // check for write permissions
 #include <wordexp.h> // Used to expand path with environment variables
@@ -23,6 +38,7 @@
 
 #include "PROPOSAL/math/Interpolant.h"
 #include "PROPOSAL/math/InterpolantBuilder.h"
+#include "PROPOSAL/math/ParallelFor.h"
 
 #include "PROPOSAL/Logging.h"
 #include "PROPOSAL/methods.h"
@@ -37,8 +53,17 @@ InterpolationDef::InterpolationDef(const nlohmann::json& config)
     nodes_cross_section = config.value("nodes_cross_section", 100);
     max_node_energy = config.value("max_node_energy", 1e14);
     do_binary_tables = config.value("do_binary_tables", true);
+    do_mapped_tables = config.value("do_mapped_tables", false);
     just_use_readonly_path = config.value("just_use_readonly_path", false);
     order_of_interpolation = config.value("order_of_interpolation", 5);
+    n_threads = config.value("n_threads", 0);
+    do_polynomial_tables = config.value("do_polynomial_tables", false);
+    do_inverse_tables = config.value("do_inverse_tables", false);
+    do_fused_rate_tables = config.value("do_fused_rate_tables", false);
+    do_lazy_tables = config.value("do_lazy_tables", false);
+    target_interpolation_error = config.value("target_interpolation_error", 0.);
+    float_table_tolerance = config.value("float_table_tolerance", 0.);
+    chebyshev_table_tolerance = config.value("chebyshev_table_tolerance", 0.);
 
     if (!(nodes_propagate > 3))
         throw std::invalid_argument(
@@ -55,6 +80,15 @@ InterpolationDef::InterpolationDef(const nlohmann::json& config)
     if (!(order_of_interpolation > 1))
         throw std::invalid_argument(
             "Order of interpolation must be larger than one.");
+    if (!(target_interpolation_error >= 0))
+        throw std::invalid_argument(
+            "The target interpolation error must not be negative.");
+    if (!(float_table_tolerance >= 0))
+        throw std::invalid_argument(
+            "The float table tolerance must not be negative.");
+    if (!(chebyshev_table_tolerance >= 0))
+        throw std::invalid_argument(
+            "The chebyshev table tolerance must not be negative.");
 
     if (not config.contains("path_to_tables")) {
         log_warn("No valid writable path to interpolation tables found. Save "
@@ -100,6 +134,19 @@ InterpolationDef::InterpolationDef(const nlohmann::json& config)
                 "string or a list of strings.");
     };
 
+    if (config.contains("path_to_table_bundle")) {
+        if (!config.at("path_to_table_bundle").is_string())
+            throw std::invalid_argument(
+                "Invalid input for option 'path_to_table_bundle'. Expected a "
+                "string.");
+
+        path_to_table_bundle = Helper::ResolvePath(config.at("path_to_table_bundle"), true);
+        if (path_to_table_bundle == "")
+            log_warn("The table bundle %s can not be read, the table paths "
+                     "are used instead.",
+                config.at("path_to_table_bundle").get<std::string>().c_str());
+    }
+
 }
 
 // ------------------------------------------------------------------------- //
@@ -109,9 +156,577 @@ size_t InterpolationDef::GetHash() const
     hash_combine(seed, order_of_interpolation, max_node_energy,
         nodes_cross_section, nodes_continous_randomization, nodes_propagate);
 
+    // tables with the fixed number of nodes keep their hash
+    if (target_interpolation_error > 0)
+        hash_combine(seed, target_interpolation_error);
+
     return seed;
 }
 
+bool InterpolationDef::HasSameTables(const InterpolationDef& interpolation_def) const
+{
+    if (GetHash() != interpolation_def.GetHash())
+        return false;
+    else if (float_table_tolerance != interpolation_def.float_table_tolerance)
+        return false;
+    else if (chebyshev_table_tolerance != interpolation_def.chebyshev_table_tolerance)
+        return false;
+    else if (do_inverse_tables != interpolation_def.do_inverse_tables)
+        return false;
+    else if (do_fused_rate_tables != interpolation_def.do_fused_rate_tables)
+        return false;
+    return true;
+}
+
+std::ostream& operator<<(std::ostream& os, InterpolationDef const& interpolation_def)
+{
+    std::stringstream ss;
+    ss << " Interpolation Definition (" << &interpolation_def << ") ";
+    os << Helper::Centered(60, ss.str()) << '\n';
+
+    os << "Order of Interpolation: " << interpolation_def.order_of_interpolation << std::endl;
+    os << "Maximal Node Energy: " << interpolation_def.max_node_energy << std::endl;
+    os << "Nodes Cross Section: " << interpolation_def.nodes_cross_section << std::endl;
+    os << "Nodes Continuous Randomization: " << interpolation_def.nodes_continous_randomization << std::endl;
+    os << "Nodes Propagate: " << interpolation_def.nodes_propagate << std::endl;
+    os << "Target Interpolation Error: " << interpolation_def.target_interpolation_error << std::endl;
+    os << "Float Table Tolerance: " << interpolation_def.float_table_tolerance << std::endl;
+    os << "Chebyshev Table Tolerance: " << interpolation_def.chebyshev_table_tolerance << std::endl;
+    os << "Do Inverse Tables: " << interpolation_def.do_inverse_tables << std::endl;
+    os << "Do Fused Rate Tables: " << interpolation_def.do_fused_rate_tables << std::endl;
+    os << "Do Lazy Tables: " << interpolation_def.do_lazy_tables << std::endl;
+    os << "Path to Tables: " << interpolation_def.path_to_tables << std::endl;
+
+    os << Helper::Centered(60, "");
+    return os;
+}
+
+namespace {
+
+// Every table file starts with a line of this word, the version of the file
+// format, the format of the tables, the architecture they were written on,
+// the hash of the tables, their length and checksum and optionally their
+// estimated error. Files of other versions are rebuilt.
+const std::string table_file_header = "PROPOSAL_TABLES";
+const int table_file_version = 2;
+
+// The formats are stored in files of their own, as the hash does not depend
+// on them
+std::string TableSuffix(bool binary_tables, bool mapped_tables)
+{
+    if (mapped_tables) {
+        return ".map";
+    }
+    return binary_tables ? "" : ".txt";
+}
+
+std::string TableFormat(bool binary_tables, bool mapped_tables)
+{
+    if (mapped_tables) {
+        return "mapped";
+    }
+    return binary_tables ? "binary" : "text";
+}
+
+// Byte order and sizes of the types the binary and mapped tables are written
+// with, e.g. 1234-4.1.8 on little endian machines with four byte int, one
+// byte bool and eight byte double. Text tables do not depend on it.
+std::string TableArchitecture()
+{
+    const uint32_t order = 0x04030201;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&order);
+
+    std::ostringstream architecture;
+    for (size_t i = 0; i < sizeof order; ++i) {
+        architecture << static_cast<int>(bytes[i]);
+    }
+    architecture << "-" << sizeof(int) << "." << sizeof(bool) << "."
+                 << sizeof(double);
+
+    return architecture.str();
+}
+
+// 64 bit FNV-1a hash
+uint64_t TableChecksum(const char* data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// The estimated error in the header is optional, the header of mapped
+// tables is padded with spaces
+bool ValidTableError(const std::string& error)
+{
+    std::istringstream stream(error);
+    if ((stream >> std::ws).eof()) {
+        return true;
+    }
+
+    double value;
+    stream >> value;
+    return !stream.fail() && (stream >> std::ws).eof();
+}
+
+// Read only memory mapping of a whole file, which is unmapped when the last
+// table using it is gone. The pages are shared by all processes mapping the
+// same file.
+class MappedFile {
+public:
+    static std::shared_ptr<const MappedFile> Open(const std::string& filename)
+    {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        std::shared_ptr<MappedFile> file;
+        struct stat status;
+        if (fstat(fd, &status) == 0 && status.st_size > 0) {
+            void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (data != MAP_FAILED) {
+                file.reset(new MappedFile(data, status.st_size));
+            }
+        }
+
+        close(fd);
+        return file;
+    }
+
+    ~MappedFile() { munmap(data_, size_); }
+
+    const char* data() const { return static_cast<const char*>(data_); }
+    size_t size() const { return size_; }
+
+private:
+    MappedFile(void* data, size_t size)
+        : data_(data)
+        , size_(size)
+    {
+    }
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    void* data_;
+    size_t size_;
+};
+
+// Reads the tables of a mapped file in place instead of copying them into a
+// string stream. The get area is only read, std::streambuf just does not
+// take a const pointer.
+class MemoryBuffer : public std::streambuf {
+public:
+    MemoryBuffer(const char* data, size_t size)
+    {
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+};
+
+// The tables just read or built, which can still be changed, see
+// InitializeInterpolation. The container only holds them as const.
+typedef std::vector<std::shared_ptr<Interpolant> > NewTables;
+
+// Finds the tables in the content of a table file and checks them against
+// the expected format and hash, an empty format and a hash of 0 accept every
+// table file. Everything but the checksum is checked on the header alone.
+// Returns the reason the tables can not be used or nullptr.
+const char* FindTables(const char* content, size_t size,
+    const std::string& format, size_t hash, size_t& begin, size_t& length,
+    std::string& error)
+{
+    // the header is short, so only its beginning is searched
+    const char* end_of_header = static_cast<const char*>(
+        std::memchr(content, '\n', std::min(size, size_t(1024))));
+    if (end_of_header == nullptr) {
+        return "is not a table file";
+    }
+
+    std::istringstream header_stream(std::string(content, end_of_header));
+    std::string header;
+    int version = 0;
+
+    header_stream >> header;
+    if (header_stream.fail() || header != table_file_header) {
+        return "is not a table file";
+    }
+
+    header_stream >> version;
+    if (header_stream.fail() || version != table_file_version) {
+        return "was written by another version of PROPOSAL";
+    }
+
+    std::string table_format;
+    std::string architecture;
+    size_t table_hash = 0;
+    uint64_t checksum = 0;
+
+    header_stream >> table_format >> architecture >> table_hash >> length
+        >> checksum;
+    if (header_stream.fail()) {
+        return "has a broken header";
+    }
+
+    std::getline(header_stream >> std::ws, error);
+    if (!ValidTableError(error)) {
+        return "has a broken header";
+    }
+    error.erase(error.find_last_not_of(' ') + 1);
+
+    if (!format.empty() && table_format != format) {
+        return "contains tables of another format";
+    }
+    if (table_format != "text" && architecture != TableArchitecture()) {
+        return "was written on another architecture";
+    }
+    if (hash != 0 && table_hash != hash) {
+        return "contains other tables";
+    }
+
+    begin = end_of_header + 1 - content;
+    if (size - begin < length) {
+        return "is truncated";
+    }
+    if (size - begin > length) {
+        return "is longer than its tables";
+    }
+
+    if (TableChecksum(content + begin, length) != checksum) {
+        return "is corrupt";
+    }
+
+    return nullptr;
+}
+
+// Reads the interpolants of the container from the content of a table file.
+// Mapped tables become views into the content, which is kept alive by owner.
+bool ReadTables(const char* content, size_t size,
+    std::shared_ptr<const void> owner, const std::string& source,
+    Helper::InterpolantBuilderContainer& builder_container,
+    NewTables& new_tables, bool binary_tables, bool mapped_tables,
+    size_t hash)
+{
+    size_t begin = 0;
+    size_t length = 0;
+    std::string error;
+
+    const char* problem
+        = FindTables(content, size, TableFormat(binary_tables, mapped_tables),
+            hash, begin, length, error);
+    if (problem != nullptr) {
+        log_warn("%s %s and is not used", source.c_str(), problem);
+        return false;
+    }
+
+    NewTables interpolants;
+    bool success = true;
+
+    if (mapped_tables) {
+        const char* tables = content + begin;
+
+        // the tables are copied if they are not aligned in memory, e.g. in
+        // a file with a header of another length
+        if (reinterpret_cast<std::uintptr_t>(tables) % 64 != 0) {
+            log_debug("The tables of %s are not aligned and are copied",
+                source.c_str());
+
+            auto copy = std::make_shared<std::vector<double> >(length / sizeof(double) + 16);
+            char* aligned = reinterpret_cast<char*>(copy->data());
+            aligned += (64 - reinterpret_cast<std::uintptr_t>(aligned) % 64) % 64;
+            std::copy(tables, tables + length, aligned);
+
+            tables = aligned;
+            owner = copy;
+        }
+
+        size_t offset = 0;
+        for (size_t i = 0; success && i < builder_container.size(); ++i) {
+            interpolants.push_back(std::make_shared<Interpolant>());
+            success = interpolants.back()->LoadMapped(tables, length, offset, owner);
+        }
+    } else {
+        MemoryBuffer buffer(content + begin, length);
+        std::istream tables(&buffer);
+
+        for (size_t i = 0; success && i < builder_container.size(); ++i) {
+            interpolants.push_back(std::make_shared<Interpolant>());
+            success = interpolants.back()->Load(tables, binary_tables);
+        }
+    }
+
+    if (!success) {
+        log_warn("%s can not be read", source.c_str());
+        return false;
+    }
+
+    for (size_t i = 0; i < builder_container.size(); ++i) {
+        (*builder_container[i].second) = interpolants[i];
+    }
+    new_tables.swap(interpolants);
+
+    if (!error.empty()) {
+        log_debug("The tables of %s have an estimated error of %s",
+            source.c_str(), error.c_str());
+    }
+
+    return true;
+}
+
+// Writes to a temporary file in the same directory first, which is renamed
+// when it is complete, so other processes see either the complete file or
+// no file at all
+bool WriteFile(const std::string& filename, const std::string& content)
+{
+    std::vector<char> tmp_name(filename.begin(), filename.end());
+    const std::string suffix = ".tmp.XXXXXX";
+    tmp_name.insert(tmp_name.end(), suffix.begin(), suffix.end());
+    tmp_name.push_back('\0');
+
+    int fd = mkstemp(tmp_name.data());
+    if (fd < 0) {
+        log_warn("Can not create temporary file for %s: %s",
+            filename.c_str(), strerror(errno));
+        return false;
+    }
+    fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    bool success = true;
+    size_t written = 0;
+    while (success && written < content.size()) {
+        ssize_t n = write(
+            fd, content.data() + written, content.size() - written);
+        if (n < 0 && errno != EINTR) {
+            success = false;
+        } else if (n > 0) {
+            written += n;
+        }
+    }
+
+    // the data has to be on the disk before the file becomes visible
+    success = success && fsync(fd) == 0;
+    success = (close(fd) == 0) && success;
+    success = success && std::rename(tmp_name.data(), filename.c_str()) == 0;
+
+    if (!success) {
+        log_warn("Can not write file %s: %s", filename.c_str(),
+            strerror(errno));
+        unlink(tmp_name.data());
+    }
+
+    return success;
+}
+
+// A bundle starts with this word and the number of tables, followed by one
+// line per table with the name of its file, its offset from the beginning of
+// the bundle and its length. The table files follow unchanged, each starting
+// at a cache line, so mapped tables stay aligned.
+const std::string table_bundle_header = "PROPOSAL_TABLE_BUNDLE";
+
+struct TableBundle {
+    std::shared_ptr<const MappedFile> file;
+    std::map<std::string, std::pair<size_t, size_t> > index;
+};
+
+bool ReadBundle(const std::string& filename, TableBundle& bundle)
+{
+    bundle.file = MappedFile::Open(filename);
+    if (!bundle.file) {
+        return false;
+    }
+
+    const char* data = bundle.file->data();
+    size_t size = bundle.file->size();
+    size_t position = 0;
+
+    // the index is read line by line, to not copy the whole bundle
+    auto next_line = [&](std::string& line) {
+        const char* end = static_cast<const char*>(
+            std::memchr(data + position, '\n', size - position));
+        if (end == nullptr) {
+            return false;
+        }
+        line.assign(data + position, end);
+        position = end + 1 - data;
+        return true;
+    };
+
+    std::string line;
+    std::string header;
+    size_t number_of_tables = 0;
+
+    if (!next_line(line)) {
+        return false;
+    }
+    std::istringstream(line) >> header >> number_of_tables;
+    if (header != table_bundle_header) {
+        return false;
+    }
+
+    for (size_t i = 0; i < number_of_tables; ++i) {
+        std::string name;
+        size_t offset = 0;
+        size_t length = 0;
+
+        if (!next_line(line)) {
+            return false;
+        }
+        std::istringstream stream(line);
+        stream >> name >> offset >> length;
+        if (stream.fail() || offset > size || length > size - offset) {
+            return false;
+        }
+        bundle.index[name] = std::make_pair(offset, length);
+    }
+
+    return true;
+}
+
+// The bundles used last stay mapped as long as their file is not changed, as
+// all the sectors of a propagator take their tables from the same bundle one
+// by one. Older ones are only kept by the tables mapping them.
+const size_t max_open_bundles = 4;
+
+struct OpenedBundle {
+    std::string filename;
+    std::string version;
+    std::shared_ptr<const TableBundle> bundle;
+};
+
+std::shared_ptr<const TableBundle> OpenBundle(const std::string& filename)
+{
+    static std::mutex mutex;
+    static std::list<OpenedBundle> bundles; // the last used first
+
+    struct stat status;
+    if (stat(filename.c_str(), &status) != 0) {
+        return nullptr;
+    }
+
+    std::stringstream version;
+    version << status.st_size << " " << status.st_mtime << " "
+            << status.st_ino;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = std::find_if(bundles.begin(), bundles.end(),
+        [&filename](const OpenedBundle& opened) {
+            return opened.filename == filename;
+        });
+    if (it != bundles.end()) {
+        if (it->version == version.str()) {
+            bundles.splice(bundles.begin(), bundles, it);
+            return it->bundle;
+        }
+        bundles.erase(it);
+    }
+
+    auto bundle = std::make_shared<TableBundle>();
+    if (!ReadBundle(filename, *bundle)) {
+        log_warn("%s is not a valid table bundle", filename.c_str());
+        bundle.reset();
+    }
+
+    // invalid bundles are remembered too, to warn only once
+    OpenedBundle opened;
+    opened.filename = filename;
+    opened.version = version.str();
+    opened.bundle = bundle;
+    bundles.push_front(opened);
+    if (bundles.size() > max_open_bundles) {
+        bundles.pop_back();
+    }
+    return bundle;
+}
+
+bool LoadTableFile(const std::string& filename,
+    Helper::InterpolantBuilderContainer& builder_container,
+    NewTables& new_tables, bool binary_tables, bool mapped_tables, size_t hash)
+{
+    std::shared_ptr<const MappedFile> file = MappedFile::Open(filename);
+    if (!file) {
+        return false;
+    }
+
+    return ReadTables(file->data(), file->size(), file, filename,
+        builder_container, new_tables, binary_tables, mapped_tables, hash);
+}
+
+bool LoadBundledTables(const std::string& bundle, const std::string& table,
+    Helper::InterpolantBuilderContainer& builder_container,
+    NewTables& new_tables, bool binary_tables, bool mapped_tables, size_t hash)
+{
+    std::shared_ptr<const TableBundle> tables = OpenBundle(bundle);
+    if (!tables) {
+        return false;
+    }
+
+    auto it = tables->index.find(table);
+    if (it == tables->index.end()) {
+        return false;
+    }
+
+    return ReadTables(tables->file->data() + it->second.first,
+        it->second.second, tables->file, bundle + ":" + table,
+        builder_container, new_tables, binary_tables, mapped_tables, hash);
+}
+
+// Thread safe builders build their tables at the same time, the others one
+// after another, as they may use the tables built before
+void BuildTables(Helper::InterpolantBuilderContainer& builder_container,
+    NewTables& new_tables, unsigned int n_threads)
+{
+    new_tables.assign(builder_container.size(), nullptr);
+
+    auto build = [&](size_t i) {
+        new_tables[i].reset(builder_container[i].first->build());
+        (*builder_container[i].second) = new_tables[i];
+    };
+
+    std::vector<size_t> thread_safe;
+    for (size_t i = 0; i < builder_container.size(); ++i) {
+        if (builder_container[i].first->IsThreadSafe()) {
+            thread_safe.push_back(i);
+        }
+    }
+
+    // the available threads are shared among the tables built at once
+    unsigned int n_total = NumberOfWorkers(n_threads, UINT_MAX);
+    unsigned int n_workers = NumberOfWorkers(n_total, thread_safe.size());
+
+    ParallelFor(thread_safe.size(), n_workers,
+        [&](unsigned int, size_t i) {
+            builder_container[thread_safe[i]].first->SetNumberOfThreads(
+                n_total / n_workers);
+            build(thread_safe[i]);
+        });
+
+    for (size_t i = 0; i < builder_container.size(); ++i) {
+        if (!builder_container[i].first->IsThreadSafe()) {
+            build(i);
+        }
+    }
+}
+
+// Records of InitializeInterpolation, see Helper::TakeTableRecords. Only the
+// last ones are kept, in case nobody takes them.
+const size_t max_table_records = 10000;
+
+struct TableRecords {
+    std::mutex mutex;
+    std::deque<Helper::TableRecord> records;
+};
+
+TableRecords& GetTableRecords()
+{
+    static TableRecords records;
+    return records;
+}
+
+} // namespace
+
 namespace Helper {
 
     // -------------------------------------------------------------------------
@@ -235,15 +850,347 @@ namespace Helper {
         }
     }
 
+    // -------------------------------------------------------------------------
+    // //
+    bool SaveTables(const std::string& filename,
+        const InterpolantBuilderContainer& builder_container,
+        bool binary_tables, bool mapped_tables, size_t hash)
+    {
+        std::string tables;
+
+        if (mapped_tables) {
+            for (InterpolantBuilderContainer::const_iterator builder_it
+                 = builder_container.begin();
+                 builder_it != builder_container.end(); ++builder_it) {
+                if (!(*builder_it->second)->SaveMapped(tables)) {
+                    log_warn("A table of %s can not be mapped",
+                        filename.c_str());
+                    return false;
+                }
+            }
+        } else {
+            std::ostringstream stream;
+            stream.precision(16);
+
+            for (InterpolantBuilderContainer::const_iterator builder_it
+                 = builder_container.begin();
+                 builder_it != builder_container.end(); ++builder_it) {
+                (*builder_it->second)->Save(stream, binary_tables);
+            }
+            tables = stream.str();
+        }
+
+        double error = -1;
+        for (InterpolantBuilderContainer::const_iterator builder_it
+             = builder_container.begin();
+             builder_it != builder_container.end(); ++builder_it) {
+            error = std::max(error, builder_it->first->GetError());
+        }
+
+        std::ostringstream header;
+        header << table_file_header << " " << table_file_version << " "
+               << TableFormat(binary_tables, mapped_tables) << " "
+               << TableArchitecture() << " " << hash << " " << tables.size()
+               << " " << TableChecksum(tables.data(), tables.size());
+        if (error >= 0) {
+            header << " " << error;
+        }
+
+        // mapped tables start at a cache line of the file
+        std::string content = header.str();
+        if (mapped_tables) {
+            content.resize((content.size() + 64) / 64 * 64 - 1, ' ');
+        }
+        content += "\n";
+        content += tables;
+
+        return WriteFile(filename, content);
+    }
+
+    // -------------------------------------------------------------------------
+    // //
+    bool LoadTables(const std::string& filename,
+        InterpolantBuilderContainer& builder_container, bool binary_tables,
+        bool mapped_tables, size_t hash)
+    {
+        NewTables new_tables;
+        return LoadTableFile(filename, builder_container, new_tables,
+            binary_tables, mapped_tables, hash);
+    }
+
+    // -------------------------------------------------------------------------
+    // //
+    bool LoadTablesFromBundle(const std::string& bundle,
+        const std::string& table, InterpolantBuilderContainer& builder_container,
+        bool binary_tables, bool mapped_tables, size_t hash)
+    {
+        NewTables new_tables;
+        return LoadBundledTables(bundle, table, builder_container, new_tables,
+            binary_tables, mapped_tables, hash);
+    }
+
+    // -------------------------------------------------------------------------
+    // //
+    std::vector<std::string> GetBundledTables(const std::string& bundle)
+    {
+        std::vector<std::string> tables;
+
+        std::shared_ptr<const TableBundle> content = OpenBundle(bundle);
+        if (content) {
+            for (auto& table : content->index) {
+                tables.push_back(table.first);
+            }
+        }
+
+        return tables;
+    }
+
+    // -------------------------------------------------------------------------
+    // //
+    bool PackTables(
+        const std::string& bundle, const std::vector<std::string>& files)
+    {
+        std::map<std::string, std::shared_ptr<const MappedFile> > tables;
+
+        for (auto& file : files) {
+            std::shared_ptr<const MappedFile> content = MappedFile::Open(file);
+            size_t begin = 0;
+            size_t length = 0;
+            std::string error;
+
+            if (!content) {
+                log_warn("Can not read the table file %s", file.c_str());
+                return false;
+            }
+
+            const char* problem = FindTables(content->data(), content->size(),
+                std::string(), 0, begin, length, error);
+            if (problem != nullptr) {
+                log_warn("%s %s and is not packed", file.c_str(), problem);
+                return false;
+            }
+
+            std::string name = file.substr(file.find_last_of('/') + 1);
+            if (tables.count(name) > 0) {
+                log_warn("The table file %s is packed twice", name.c_str());
+                return false;
+            }
+            tables[name] = content;
+        }
+
+        // the offsets are written with a fixed width, so the size of the
+        // index is known before the offsets
+        const int width = 20;
+        size_t index_size = table_bundle_header.size() + width + 2;
+        for (auto& table : tables) {
+            index_size += table.first.size() + 2 * width + 3;
+        }
+
+        std::ostringstream index;
+        index << table_bundle_header << " " << std::setw(width)
+              << tables.size() << "\n";
+
+        size_t offset = index_size;
+        for (auto& table : tables) {
+            offset = (offset + 63) / 64 * 64;
+            index << table.first << " " << std::setw(width) << offset << " "
+                  << std::setw(width) << table.second->size() << "\n";
+            offset += table.second->size();
+        }
+
+        std::string content = index.str();
+        content.reserve(offset);
+        for (auto& table : tables) {
+            content.resize((content.size() + 63) / 64 * 64, '\0');
+            content.append(table.second->data(), table.second->size());
+        }
+
+        return WriteFile(bundle, content);
+    }
+
+    // -------------------------------------------------------------------------
+    // //
+    FileLock::FileLock(const std::string& path)
+        : path_(path)
+        , fd_(-1)
+    {
+        // the holder removes the lock file before releasing it, so a lock
+        // taken on a file which is no longer at the path is taken again
+        while (true) {
+            fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (fd_ < 0) {
+                return;
+            }
+
+            int result;
+            do {
+                result = flock(fd_, LOCK_EX);
+            } while (result != 0 && errno == EINTR);
+
+            struct stat locked;
+            struct stat current;
+            if (result == 0 && fstat(fd_, &locked) == 0
+                && stat(path.c_str(), &current) == 0
+                && locked.st_dev == current.st_dev
+                && locked.st_ino == current.st_ino) {
+                return;
+            }
+
+            close(fd_);
+            fd_ = -1;
+            if (result != 0) {
+                return;
+            }
+        }
+    }
+
+    FileLock::~FileLock()
+    {
+        if (fd_ >= 0) {
+            unlink(path_.c_str());
+            flock(fd_, LOCK_UN);
+            close(fd_);
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // //
+    void BuildInterpolants(
+        InterpolantBuilderContainer& builder_container, unsigned int n_threads)
+    {
+        NewTables new_tables;
+        BuildTables(builder_container, new_tables, n_threads);
+    }
+
+    namespace {
+    // LoadOrBuildInterpolants, which also returns the new tables
+    TableRecord LoadOrBuildTables(const std::string& name,
+        InterpolantBuilderContainer& builder_container, NewTables& new_tables,
+        const std::vector<Parametrization*>& parametrizations,
+        const InterpolationDef& interpolation_def);
+    } // namespace
+
     // -------------------------------------------------------------------------
     // //
     void InitializeInterpolation(const std::string name,
         InterpolantBuilderContainer& builder_container,
         const std::vector<Parametrization*>& parametrizations,
         const InterpolationDef interpolation_def)
+    {
+        std::chrono::steady_clock::time_point start
+            = std::chrono::steady_clock::now();
+
+        NewTables new_tables;
+        TableRecord record = LoadOrBuildTables(name, builder_container,
+            new_tables, parametrizations, interpolation_def);
+
+        // the tables are prepared through the handles they were created
+        // with, before anything but this container holds them
+        if (interpolation_def.do_polynomial_tables) {
+            for (auto& interpolant : new_tables) {
+                // rational tables keep the Neville scheme
+                if (!interpolant->PrecomputePolynomials()) {
+                    log_debug("A %s table is evaluated with the Neville "
+                              "scheme.",
+                        name.c_str());
+                }
+            }
+        }
+
+        if (interpolation_def.float_table_tolerance > 0) {
+            for (auto& interpolant : new_tables) {
+                // only 2d tables are stored in single precision
+                if (!interpolant->StoreFloats(
+                        interpolation_def.float_table_tolerance)) {
+                    log_debug("A %s table is stored in double precision.",
+                        name.c_str());
+                }
+            }
+        }
+
+        std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start;
+        record.seconds = elapsed.count();
+
+        for (InterpolantBuilderContainer::iterator builder_it
+             = builder_container.begin();
+             builder_it != builder_container.end(); ++builder_it) {
+            record.memory_size += (*builder_it->second)->GetMemorySize();
+        }
+
+        struct stat status;
+        if (record.source != "bundle" && !record.file.empty()
+            && stat(record.file.c_str(), &status) == 0) {
+            record.file_size = status.st_size;
+        }
+
+        TableRecords& records = GetTableRecords();
+        std::lock_guard<std::mutex> lock(records.mutex);
+        records.records.push_back(record);
+        if (records.records.size() > max_table_records) {
+            records.records.pop_front();
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // //
+    void InitializeInParallel(
+        const std::vector<TableTask>& tasks, const InterpolationDef& def)
+    {
+        // the available threads are shared among the tasks run at once
+        unsigned int n_total = NumberOfWorkers(def.n_threads, UINT_MAX);
+        unsigned int n_workers = NumberOfWorkers(n_total, tasks.size());
+
+        InterpolationDef share = def;
+        share.n_threads = n_total / n_workers;
+
+        ParallelFor(tasks.size(), n_workers,
+            [&](unsigned int, size_t i) { tasks[i](share); });
+    }
+
+    // -------------------------------------------------------------------------
+    // //
+    std::vector<TableRecord> TakeTableRecords()
+    {
+        TableRecords& records = GetTableRecords();
+        std::lock_guard<std::mutex> lock(records.mutex);
+
+        std::vector<TableRecord> taken(
+            records.records.begin(), records.records.end());
+        records.records.clear();
+        return taken;
+    }
+
+    // -------------------------------------------------------------------------
+    // //
+    TableRecord LoadOrBuildInterpolants(const std::string& name,
+        InterpolantBuilderContainer& builder_container,
+        const std::vector<Parametrization*>& parametrizations,
+        const InterpolationDef& interpolation_def)
+    {
+        NewTables new_tables;
+        return LoadOrBuildTables(name, builder_container, new_tables,
+            parametrizations, interpolation_def);
+    }
+
+    namespace {
+    TableRecord LoadOrBuildTables(const std::string& name,
+        InterpolantBuilderContainer& builder_container, NewTables& new_tables,
+        const std::vector<Parametrization*>& parametrizations,
+        const InterpolationDef& interpolation_def)
     {
         log_debug("Initialize %s interpolation.", name.c_str());
 
+        TableRecord record;
+        record.name = name;
+
+        for (InterpolantBuilderContainer::iterator builder_it
+             = builder_container.begin();
+             builder_it != builder_container.end(); ++builder_it) {
+            builder_it->first->SetTargetError(
+                interpolation_def.target_interpolation_error);
+        }
+
         // ---------------------------------------------------------------------
         // // Create hash for the file name
         // ---------------------------------------------------------------------
@@ -266,57 +1213,59 @@ namespace Helper {
         }
         hash_combine(hash_digest, interpolation_def.GetHash());
 
-        bool storing_failed = false;
-        bool reading_worked = false;
         bool binary_tables = interpolation_def.do_binary_tables;
+        bool mapped_tables = interpolation_def.do_mapped_tables;
         bool just_use_readonly_path = interpolation_def.just_use_readonly_path;
         std::string pathname;
         std::stringstream filename;
 
+        // ---------------------------------------------------------------------
+        // // the bundle is read before the paths, it holds the table files
+        // under their names
+        if (!interpolation_def.path_to_table_bundle.empty()) {
+            filename << name << "_" << hash_digest;
+            filename << TableSuffix(binary_tables, mapped_tables);
+            if (LoadBundledTables(interpolation_def.path_to_table_bundle,
+                    filename.str(), builder_container, new_tables,
+                    binary_tables, mapped_tables, hash_digest)) {
+                log_debug("%s tables were read from the bundle %s",
+                    name.c_str(),
+                    interpolation_def.path_to_table_bundle.c_str());
+                log_debug("Initialize %s interpolation done.", name.c_str());
+                record.source = "bundle";
+                record.file = interpolation_def.path_to_table_bundle + ":"
+                    + filename.str();
+                return record;
+            }
+            log_debug("The table %s is not in the bundle %s",
+                filename.str().c_str(),
+                interpolation_def.path_to_table_bundle.c_str());
+
+            filename.str(std::string());
+            filename.clear();
+        }
+
         // ---------------------------------------------------------------------
         // // first check the reading paths if one of the reading paths already
         // has the required tables
         pathname = ResolvePath(interpolation_def.path_to_tables_readonly, true);
         if (!pathname.empty()) {
             filename << pathname << "/" << name << "_" << hash_digest;
-            if (!binary_tables) {
-                filename << ".txt";
-            }
+            filename << TableSuffix(binary_tables, mapped_tables);
             if (FileExist(filename.str())) {
-                std::ifstream input;
-                if (binary_tables) {
-                    input.open(filename.str().c_str(), std::ios::binary);
-                } else {
-                    input.open(filename.str().c_str());
-                }
-
-                // check if file is empty
-                // this happens if multiple instances tries to load/create the
-                // tables in parallel and another process already starts to
-                // write this table now just hand over to writing process where
-                // it might saves them in memory if the other instance is still
-                // writing them down in the same path
-                if (input.peek() == std::ifstream::traits_type::eof()) {
-                    log_info("file %s is empty! Another process is presumably "
-                             "writing. "
-                             "Try another reading path or write in memory!",
-                        filename.str().c_str());
-                } else {
-                    log_debug("%s tables will be read from file: %s",
+                if (LoadTableFile(filename.str(), builder_container,
+                        new_tables, binary_tables, mapped_tables,
+                        hash_digest)) {
+                    log_debug("%s tables were read from file: %s",
                         name.c_str(), filename.str().c_str());
-
-                    for (InterpolantBuilderContainer::iterator builder_it
-                         = builder_container.begin();
-                         builder_it != builder_container.end(); ++builder_it) {
-                        // TODO(mario): read check Tue 2017/09/05
-                        (*builder_it->second) = new Interpolant();
-                        (*builder_it->second)->Load(input, binary_tables);
-                    }
-                    reading_worked = true;
+                    log_debug("Initialize %s interpolation done.", name.c_str());
+                    record.source = "read";
+                    record.file = filename.str();
+                    return record;
                 }
-
-                input.close();
-
+                log_warn("The table file %s in the readonly path can not be "
+                         "used. Try the writing path.",
+                    filename.str().c_str());
             } else {
                 log_debug("In the readonly path to the interpolation tables, "
                           "the file %s "
@@ -329,11 +1278,6 @@ namespace Helper {
                       "the writing path.");
         }
 
-        if (reading_worked) {
-            log_debug("Initialize %s interpolation done.", name.c_str());
-            return;
-        }
-
         if (just_use_readonly_path) {
             log_fatal("The just_use_readonly_path option is enabled and the "
                       "table is not "
@@ -345,93 +1289,75 @@ namespace Helper {
         // the interpolation tables will be written in the path for writing
         pathname = ResolvePath(interpolation_def.path_to_tables);
 
+        if (pathname.empty()) {
+            log_debug("%s tables will be stored in memomy!", name.c_str());
+
+            BuildTables(
+                builder_container, new_tables, interpolation_def.n_threads);
+
+            log_debug("Initialize %s interpolation done.", name.c_str());
+            record.source = "memory";
+            return record;
+        }
+
         // clear the stringstream
         filename.str(std::string());
         filename.clear();
         filename << pathname << "/" << name << "_" << hash_digest;
+        filename << TableSuffix(binary_tables, mapped_tables);
 
-        if (!binary_tables) {
-            filename << ".txt";
+        // complete files are renamed into place, so they can be read
+        // without waiting for the lock
+        if (FileExist(filename.str())
+            && LoadTableFile(filename.str(), builder_container, new_tables,
+                binary_tables, mapped_tables, hash_digest)) {
+            log_debug("%s tables were read from file: %s", name.c_str(),
+                filename.str().c_str());
+            log_debug("Initialize %s interpolation done.", name.c_str());
+            record.source = "read";
+            record.file = filename.str();
+            return record;
         }
 
-        if (!pathname.empty()) {
-            if (FileExist(filename.str())) {
-                std::ifstream input;
-
-                if (binary_tables) {
-                    input.open(filename.str().c_str(), std::ios::binary);
-                } else {
-                    input.open(filename.str().c_str());
-                }
-
-                // check if file is empty
-                // this happens if multiple instances try to write the tables in
-                // parallel now just one is writing them and the other just
-                // saves them in memory
-                if (input.peek() == std::ifstream::traits_type::eof()) {
-                    log_info("file %s is empty! Another process is presumably "
-                             "writing. "
-                             "Save this table in memory!",
-                        filename.str().c_str());
-                    storing_failed = true;
-                } else {
-                    log_debug("%s tables will be read from file: %s",
-                        name.c_str(), filename.str().c_str());
-
-                    for (InterpolantBuilderContainer::iterator builder_it
-                         = builder_container.begin();
-                         builder_it != builder_container.end(); ++builder_it) {
-                        // TODO(mario): read check Tue 2017/09/05
-                        (*builder_it->second) = new Interpolant();
-                        (*builder_it->second)->Load(input, binary_tables);
-                    }
-                }
-
-                input.close();
-            } else {
-                log_debug("%s tables will be saved to file: %s", name.c_str(),
-                    filename.str().c_str());
+        // only one process builds the tables, the others wait for it
+        // and read the tables afterwards
+        FileLock lock(filename.str() + ".lock");
 
-                std::ofstream output;
-
-                if (binary_tables) {
-                    output.open(filename.str().c_str(), std::ios::binary);
-                } else {
-                    output.open(filename.str().c_str());
-                }
-
-                if (output.good()) {
-                    output.precision(16);
-
-                    for (InterpolantBuilderContainer::iterator builder_it
-                         = builder_container.begin();
-                         builder_it != builder_container.end(); ++builder_it) {
-                        (*builder_it->second) = builder_it->first->build();
-                        (*builder_it->second)->Save(output, binary_tables);
-                    }
-                } else {
-                    storing_failed = true;
-                    log_warn(
-                        "Can not open file %s for writing! Table will not be "
-                        "stored!",
-                        filename.str().c_str());
-                }
-                output.close();
+        if (lock.IsLocked()) {
+            if (FileExist(filename.str())
+                && LoadTableFile(filename.str(), builder_container,
+                    new_tables, binary_tables, mapped_tables, hash_digest)) {
+                log_debug("%s tables were built by another process and read "
+                          "from file: %s",
+                    name.c_str(), filename.str().c_str());
+                log_debug("Initialize %s interpolation done.", name.c_str());
+                record.source = "read";
+                record.file = filename.str();
+                return record;
             }
+        } else {
+            log_warn("Can not lock %s.lock, the tables may be built by other "
+                     "processes at the same time.",
+                filename.str().c_str());
         }
 
-        if (pathname.empty() || storing_failed) {
-            log_debug("%s tables will be stored in memomy!", name.c_str());
+        log_debug("%s tables will be saved to file: %s", name.c_str(),
+            filename.str().c_str());
 
-            for (InterpolantBuilderContainer::iterator builder_it
-                 = builder_container.begin();
-                 builder_it != builder_container.end(); ++builder_it) {
-                (*builder_it->second) = builder_it->first->build();
-            }
+        BuildTables(builder_container, new_tables, interpolation_def.n_threads);
+
+        record.source = "built";
+        if (SaveTables(filename.str(), builder_container, binary_tables,
+                mapped_tables, hash_digest)) {
+            record.file = filename.str();
+        } else {
+            log_warn("Table %s will not be stored!", filename.str().c_str());
         }
 
         log_debug("Initialize %s interpolation done.", name.c_str());
+        return record;
     }
+    } // namespace
 
 } // namespace Helper
 
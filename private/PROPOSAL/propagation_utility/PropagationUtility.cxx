@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <functional>
 
 #include <PROPOSAL/crossection/factories/PhotoPairFactory.h>
 #include "PROPOSAL/Logging.h"
@@ -6,7 +8,10 @@
 #include "PROPOSAL/propagation_utility/PropagationUtility.h"
 
 #include "PROPOSAL/crossection/CrossSection.h"
+#include "PROPOSAL/crossection/CrossSectionInterpolant.h"
 #include "PROPOSAL/crossection/parametrization/Parametrization.h"
+#include "PROPOSAL/math/Interpolant.h"
+#include "PROPOSAL/methods.h"
 
 using namespace PROPOSAL;
 
@@ -248,24 +253,34 @@ Utility::Utility(const ParticleDef& particle_def,
     , cut_settings_(cut_settings)
     , crosssections_()
 {
+    std::vector<std::function<CrossSection*(const InterpolationDef&)> > creators;
+
     if(utility_def.brems_def.parametrization!=BremsstrahlungFactory::Enum::None) {
-        crosssections_.push_back(BremsstrahlungFactory::Get().CreateBremsstrahlung(
-                particle_def_, medium_, cut_settings_, utility_def.brems_def, interpolation_def));
+        creators.push_back([&](const InterpolationDef& share) {
+            return BremsstrahlungFactory::Get().CreateBremsstrahlung(
+                particle_def_, medium_, cut_settings_, utility_def.brems_def, share);
+        });
     }
 
     if(utility_def.photo_def.parametrization!=PhotonuclearFactory::Enum::None) {
-        crosssections_.push_back(PhotonuclearFactory::Get().CreatePhotonuclear(
-                particle_def_, medium_, cut_settings_, utility_def.photo_def, interpolation_def));
+        creators.push_back([&](const InterpolationDef& share) {
+            return PhotonuclearFactory::Get().CreatePhotonuclear(
+                particle_def_, medium_, cut_settings_, utility_def.photo_def, share);
+        });
     }
 
     if(utility_def.epair_def.parametrization!=EpairProductionFactory::Enum::None) {
-        crosssections_.push_back(EpairProductionFactory::Get().CreateEpairProduction(
-                particle_def_, medium_, cut_settings_, utility_def.epair_def, interpolation_def));
+        creators.push_back([&](const InterpolationDef& share) {
+            return EpairProductionFactory::Get().CreateEpairProduction(
+                particle_def_, medium_, cut_settings_, utility_def.epair_def, share);
+        });
     }
 
     if(utility_def.ioniz_def.parametrization!=IonizationFactory::Enum::None) {
-        crosssections_.push_back(IonizationFactory::Get().CreateIonization(
-                particle_def_, medium_, cut_settings_, utility_def.ioniz_def, interpolation_def));
+        creators.push_back([&](const InterpolationDef& share) {
+            return IonizationFactory::Get().CreateIonization(
+                particle_def_, medium_, cut_settings_, utility_def.ioniz_def, share);
+        });
     }else{
         log_debug("No Ionization cross section chosen. For lepton propagation,Initialization may fail because no cross"
                   "section for small energies are available. You may have to enable Ionization or set a higher e_low"
@@ -273,36 +288,73 @@ Utility::Utility(const ParticleDef& particle_def,
     }
 
     if(utility_def.annihilation_def.parametrization!=AnnihilationFactory::Enum::None) {
-        crosssections_.push_back(AnnihilationFactory::Get().CreateAnnihilation(
-                particle_def_, medium_, utility_def.annihilation_def, interpolation_def));
+        creators.push_back([&](const InterpolationDef& share) {
+            return AnnihilationFactory::Get().CreateAnnihilation(
+                particle_def_, medium_, utility_def.annihilation_def, share);
+        });
         log_debug("Annihilation enabled");
     }
 
     if(utility_def.mupair_def.parametrization!=MupairProductionFactory::Enum::None) {
-        crosssections_.push_back(MupairProductionFactory::Get().CreateMupairProduction(
-                    particle_def_, medium_, cut_settings_, utility_def.mupair_def, interpolation_def));
+        creators.push_back([&](const InterpolationDef& share) {
+            return MupairProductionFactory::Get().CreateMupairProduction(
+                particle_def_, medium_, cut_settings_, utility_def.mupair_def, share);
+        });
         log_debug("Mupair Production enabled");
     }
 
     if(utility_def.weak_def.parametrization!=WeakInteractionFactory::Enum::None) {
-        crosssections_.push_back(WeakInteractionFactory::Get().CreateWeakInteraction(
-                    particle_def_, medium_, utility_def.weak_def, interpolation_def));
+        creators.push_back([&](const InterpolationDef& share) {
+            return WeakInteractionFactory::Get().CreateWeakInteraction(
+                particle_def_, medium_, utility_def.weak_def, share);
+        });
         log_debug("Weak Interaction enabled");
     }
 
     // Photon interactions
 
     if(utility_def.compton_def.parametrization!=ComptonFactory::Enum::None) {
-        crosssections_.push_back(ComptonFactory::Get().CreateCompton(
-                particle_def_, medium_, cut_settings_, utility_def.compton_def, interpolation_def));
+        creators.push_back([&](const InterpolationDef& share) {
+            return ComptonFactory::Get().CreateCompton(
+                particle_def_, medium_, cut_settings_, utility_def.compton_def, share);
+        });
         log_debug("Compton enabled");
     }
 
     if(utility_def.photopair_def.parametrization!=PhotoPairFactory::Enum::None) {
-        crosssections_.push_back(PhotoPairFactory::Get().CreatePhotoPair(
-                particle_def_, medium_, utility_def.photopair_def, interpolation_def));
+        creators.push_back([&](const InterpolationDef& share) {
+            return PhotoPairFactory::Get().CreatePhotoPair(
+                particle_def_, medium_, utility_def.photopair_def, share);
+        });
         log_debug("PhotoPairProduction enabled");
     }
+
+    // The tables of the cross sections do not depend on each other, so they
+    // are built at the same time. The cross sections keep the order above.
+    crosssections_.assign(creators.size(), nullptr);
+
+    std::vector<Helper::TableTask> tasks;
+    for (size_t i = 0; i < creators.size(); ++i)
+    {
+        tasks.push_back([this, &creators, i](const InterpolationDef& share) {
+            crosssections_[i] = creators[i](share);
+        });
+    }
+
+    try
+    {
+        Helper::InitializeInParallel(tasks, interpolation_def);
+    } catch (...)
+    {
+        // the destructor is not called if the constructor throws
+        for (CrossSection* crosssection : crosssections_)
+        {
+            delete crosssection;
+        }
+        throw;
+    }
+
+    InitFusedRateTables(interpolation_def);
 }
 
 Utility::Utility(const std::vector<CrossSection*>& crosssections) try
@@ -334,7 +386,9 @@ Utility::Utility(const Utility& collection)
     : particle_def_(collection.particle_def_),
       medium_(collection.medium_),
       cut_settings_(collection.cut_settings_),
-      crosssections_(collection.crosssections_.size(), NULL) {
+      crosssections_(collection.crosssections_.size(), NULL),
+      rates_(collection.rates_),
+      cumulative_rates_(collection.cumulative_rates_) {
     for (unsigned int i = 0; i < crosssections_.size(); ++i) {
         crosssections_[i] = collection.crosssections_[i]->clone();
     }
@@ -384,20 +438,118 @@ CrossSection* Utility::GetCrosssection(int typeId) const {
 }
 
 
+void Utility::InitFusedRateTables(const InterpolationDef& interpolation_def)
+{
+    if (!interpolation_def.do_fused_rate_tables)
+        return;
+
+    std::vector<CrossSectionInterpolant*> crosssections;
+    int max = 0;
+
+    for (auto crosssection : crosssections_) {
+        CrossSectionInterpolant* interpolant
+            = dynamic_cast<CrossSectionInterpolant*>(crosssection);
+
+        if (interpolant == nullptr) {
+            log_warn("Fused rate tables need interpolated cross sections, "
+                     "the rates are summed up instead.");
+            rates_.clear();
+            return;
+        }
+
+        for (int i = 0; i < interpolant->GetNumberOfRates(); ++i)
+            rates_.push_back(std::make_pair(crosssections.size(), i));
+
+        for (auto& table : interpolant->GetdNdxInterpolants1D())
+            max = std::max(max, table->GetMax());
+
+        crosssections.push_back(interpolant);
+    }
+
+    // The tables share the nodes of the dNdx tables, so the interpolation of
+    // a sum is the sum of the interpolations up to the clipping at zero.
+    for (size_t k = 0; k < rates_.size(); ++k) {
+        std::function<double(double)> cumulative_rate
+            = [this, crosssections, k](double energy) {
+                  double sum = 0;
+                  for (size_t j = 0; j <= k; ++j)
+                      sum += crosssections[rates_[j].first]->CalculatedNdxOfRate(
+                          energy, rates_[j].second);
+                  return sum;
+              };
+
+        std::shared_ptr<Interpolant> table = std::make_shared<Interpolant>(max,
+            particle_def_.mass, interpolation_def.max_node_energy,
+            cumulative_rate, interpolation_def.order_of_interpolation, false,
+            false, true, interpolation_def.order_of_interpolation, true, false,
+            false);
+
+        if (interpolation_def.do_polynomial_tables)
+            table->PrecomputePolynomials();
+
+        cumulative_rates_.push_back(table);
+    }
+
+    log_debug("%zu fused rate tables for %s built", cumulative_rates_.size(),
+        particle_def_.name.c_str());
+}
+
 std::pair<double, int> Utility::StochasticLoss(
     double particle_energy, double rnd1, double rnd2, double rnd3)
 {
-    double total_rate = 0;
-    double total_rate_weighted = 0;
-    double rates_sum = 0;
-    std::vector<double> rates;
-    rates.resize(crosssections_.size());
-
     // return 0 and unknown, if there is no interaction
     std::pair<double, int> energy_loss;
     energy_loss.first = 0.;
     energy_loss.second = 0;
 
+    if (!cumulative_rates_.empty()) {
+        double total_rate_weighted
+            = rnd1 * cumulative_rates_.back()->Interpolate(particle_energy);
+
+        // first rate whose cumulative rate reaches the weighted total
+        size_t low = 0;
+        size_t high = cumulative_rates_.size() - 1;
+        while (low < high) {
+            size_t mid = (low + high) / 2;
+            if (cumulative_rates_[mid]->Interpolate(particle_energy)
+                >= total_rate_weighted)
+                high = mid;
+            else
+                low = mid + 1;
+        }
+
+        CrossSectionInterpolant* crosssection
+            = static_cast<CrossSectionInterpolant*>(
+                crosssections_[rates_[low].first]);
+        int rate = rates_[low].second;
+
+        // Close to a threshold the interpolated cumulative rate may rise
+        // before the rate itself does, then the rates are summed up below.
+        if (total_rate_weighted > 0
+            && crosssection->CalculatedNdxOfRate(particle_energy, rate) > 0) {
+            energy_loss.first = crosssection->CalculateStochasticLossOfRate(
+                particle_energy, rate, rnd2, rnd3);
+            energy_loss.second = crosssection->GetTypeId();
+
+            return energy_loss;
+        }
+    }
+
+    // The rates are kept on the stack for the usual number of cross sections.
+    const unsigned int max_stack_rates = 16;
+    double stack_rates[max_stack_rates];
+    std::vector<double> heap_rates;
+    double* rates = stack_rates;
+
+    if (crosssections_.size() > max_stack_rates) {
+        heap_rates.resize(crosssections_.size());
+        rates = heap_rates.data();
+    }
+
+    double total_rate = 0;
+    double total_rate_weighted = 0;
+    double rates_sum = 0;
+
     for (unsigned int i = 0; i < crosssections_.size(); i++) {
         rates[i] = crosssections_[i]->CalculatedNdx(particle_energy, rnd2);
         total_rate += rates[i];
@@ -408,7 +560,7 @@ std::pair<double, int> Utility::StochasticLoss(
     log_debug("Total rate = %f, total rate weighted = %f", total_rate,
               total_rate_weighted);
 
-    for (unsigned int i = 0; i < rates.size(); i++) {
+    for (unsigned int i = 0; i < crosssections_.size(); i++) {
         rates_sum += rates[i];
 
         if (rates_sum >= total_rate_weighted) {
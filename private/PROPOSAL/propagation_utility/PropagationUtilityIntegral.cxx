@@ -55,8 +55,9 @@ bool UtilityIntegral::compare(const UtilityDecorator& utility_decorator) const {
 }
 
 double UtilityIntegral::GetUpperLimit(double ei, double rnd) {
-    (void)ei;
-    (void)rnd;
+    // The integral is calculated again, so the upper limit does not depend
+    // on the last call of Calculate, as for the utility interpolants
+    Calculate(ei, utility_.GetParticleDef().low, rnd);
 
     return integral_.GetUpperLimit();
 }
@@ -23,9 +23,8 @@ using namespace PROPOSAL;
 UtilityInterpolant::UtilityInterpolant(
     const Utility& utility, InterpolationDef def)
     : UtilityDecorator(utility)
-    , stored_result_(0)
-    , interpolant_(NULL)
-    , interpolant_diff_(NULL)
+    , interpolant_(nullptr)
+    , interpolant_diff_(nullptr)
     , interpolation_def_(def)
 {
 }
@@ -33,9 +32,8 @@ UtilityInterpolant::UtilityInterpolant(
 UtilityInterpolant::UtilityInterpolant(
     const Utility& utility, const UtilityInterpolant& collection)
     : UtilityDecorator(utility)
-    , stored_result_(collection.stored_result_)
-    , interpolant_(new Interpolant(*collection.interpolant_))
-    , interpolant_diff_(new Interpolant(*collection.interpolant_diff_))
+    , interpolant_(collection.interpolant_)
+    , interpolant_diff_(collection.interpolant_diff_)
     , interpolation_def_(collection.interpolation_def_)
 {
     if (utility != collection.GetUtility()) {
@@ -45,18 +43,13 @@ UtilityInterpolant::UtilityInterpolant(
 
 UtilityInterpolant::UtilityInterpolant(const UtilityInterpolant& collection)
     : UtilityDecorator(collection)
-    , stored_result_(collection.stored_result_)
-    , interpolant_(new Interpolant(*collection.interpolant_))
-    , interpolant_diff_(new Interpolant(*collection.interpolant_diff_))
+    , interpolant_(collection.interpolant_)
+    , interpolant_diff_(collection.interpolant_diff_)
     , interpolation_def_(collection.interpolation_def_)
 {
 }
 
-UtilityInterpolant::~UtilityInterpolant()
-{
-    delete interpolant_;
-    delete interpolant_diff_;
-}
+UtilityInterpolant::~UtilityInterpolant() {}
 
 bool UtilityInterpolant::compare(
     const UtilityDecorator& utility_decorator) const
@@ -64,9 +57,7 @@ bool UtilityInterpolant::compare(
     const UtilityInterpolant* utility_interpolant
         = static_cast<const UtilityInterpolant*>(&utility_decorator);
 
-    if (stored_result_ != utility_interpolant->stored_result_)
-        return false;
-    else if (*interpolant_ != *utility_interpolant->interpolant_)
+    if (*interpolant_ != *utility_interpolant->interpolant_)
         return false;
     else if (*interpolant_diff_ != *utility_interpolant->interpolant_diff_)
         return false;
@@ -93,7 +84,8 @@ void UtilityInterpolant::InitInterpolation(const std::string& name,
     Integral integral(IROMB, IMAXS, IPREC2);
     const ParticleDef& particle_def = utility_.GetParticleDef();
 
-    std::vector<std::pair<Interpolant**, std::function<double(double)>>>
+    std::vector<std::pair<std::shared_ptr<const Interpolant>*,
+        std::function<double(double)>>>
         interpolants;
 
     interpolants.push_back(std::make_pair(&interpolant_,
@@ -174,17 +166,15 @@ double UtilityInterpolantDisplacement::Calculate(
     if (std::abs(ei - ef) > std::abs(ei) * HALF_PRECISION) {
         double aux;
 
-        stored_result_ = interpolant_->Interpolate(ei);
-        aux = stored_result_ - interpolant_->Interpolate(ef);
+        double result = interpolant_->Interpolate(ei);
+        aux = result - interpolant_->Interpolate(ef);
 
-        if (std::abs(aux) > std::abs(stored_result_) * HALF_PRECISION
+        if (std::abs(aux) > std::abs(result) * HALF_PRECISION
             && aux >= 0) {
             return std::max(aux, 0.0);
         }
     }
 
-    stored_result_ = 0;
-
     return std::max(
         (interpolant_diff_->Interpolate((ei + ef) / 2)) * (ef - ei), 0.0);
 }
@@ -198,8 +188,8 @@ double UtilityInterpolantDisplacement::Calculate(double ei, double ef,
         double aux;
         double displacement;
 
-        stored_result_ = interpolant_->Interpolate(ei);
-        aux = stored_result_ - interpolant_->Interpolate(ef);
+        double result = interpolant_->Interpolate(ei);
+        aux = result - interpolant_->Interpolate(ef);
 
         try {
             displacement = utility_.GetMedium()->GetDensityDistribution().Correct(
@@ -208,21 +198,19 @@ double UtilityInterpolantDisplacement::Calculate(double ei, double ef,
             throw;
         }
 
-        if (std::abs(aux) > std::abs(stored_result_) * HALF_PRECISION
+        if (std::abs(aux) > std::abs(result) * HALF_PRECISION
             && aux >= 0) {
             return std::max(displacement, 0.0);
         }
     }
 
-    stored_result_ = 0;
-
     return std::max(
         (interpolant_diff_->Interpolate((ei + ef) / 2)) * (ef - ei), 0.0);
 }
 
 double UtilityInterpolantDisplacement::GetUpperLimit(double ei, double rnd) {
-    f = [&](double ef) { return Calculate(ei, ef, rnd) - rnd; };
-    df = [&](double ef) { return interpolant_diff_->Interpolate(ef); };
+    std::function<double(double)> f = [&](double ef) { return Calculate(ei, ef, rnd) - rnd; };
+    std::function<double(double)> df = [&](double ef) { return interpolant_diff_->Interpolate(ef); };
 
     int MaxSteps = 200;
     try{
@@ -303,24 +291,28 @@ double UtilityInterpolantInteraction::Calculate(
     (void)rnd;
     (void)ef;
 
-    stored_result_ = interpolant_->Interpolate(ei);
+    double result = interpolant_->Interpolate(ei);
 
     if (up_) {
-        return std::max(stored_result_, 0.0);
+        return std::max(result, 0.0);
     } else {
-        return std::max(big_low_ - stored_result_, 0.0);
+        return std::max(big_low_ - result, 0.0);
     }
 }
 
 double UtilityInterpolantInteraction::GetUpperLimit(double ei, double rnd)
 {
-    if (std::abs(rnd) > std::abs(stored_result_) * HALF_PRECISION) {
+    // The integral at ei is evaluated again instead of being stored in
+    // Calculate, so the utility does not change while propagating.
+    double result = interpolant_->Interpolate(ei);
+
+    if (std::abs(rnd) > std::abs(result) * HALF_PRECISION) {
         double aux;
 
         if (up_) {
-            aux = interpolant_->FindLimit(stored_result_ - rnd);
+            aux = interpolant_->FindLimit(result - rnd);
         } else {
-            aux = interpolant_->FindLimit(stored_result_ + rnd);
+            aux = interpolant_->FindLimit(result + rnd);
         }
 
         if (std::abs(ei - aux) > std::abs(ei) * HALF_PRECISION) {
@@ -428,21 +420,23 @@ double UtilityInterpolantDecay::Calculate(double ei, double ef, double rnd)
     (void)rnd;
     (void)ef;
 
-    stored_result_ = interpolant_->Interpolate(ei);
+    double result = interpolant_->Interpolate(ei);
 
     if (up_) {
-        return std::max(stored_result_, 0.0);
+        return std::max(result, 0.0);
     } else {
-        return std::max(big_low_ - stored_result_, 0.0);
+        return std::max(big_low_ - result, 0.0);
     }
 }
 
 double UtilityInterpolantDecay::GetUpperLimit(double ei, double rnd)
 {
-    if (std::abs(rnd) > std::abs(stored_result_) * HALF_PRECISION) {
+    double result = interpolant_->Interpolate(ei);
+
+    if (std::abs(rnd) > std::abs(result) * HALF_PRECISION) {
         double aux;
 
-        aux = interpolant_->FindLimit(stored_result_ + rnd);
+        aux = interpolant_->FindLimit(result + rnd);
 
         if (std::abs(ei - aux) > std::abs(ei) * HALF_PRECISION) {
             return std::min(std::max(aux, utility_.GetParticleDef().low), ei);
@@ -78,6 +78,21 @@ Directions Scattering::Scatter(double dr, double ei, double ef, const Vector3D&
     return Scattering::Scatter(dr, ei, ef, pos, old_direction, rnd1, rnd2, rnd3, rnd4);
 }
 
+Directions Scattering::Scatter(double dr,
+                                double ei,
+                                double ef,
+                                const Vector3D& pos,
+                                const Vector3D& old_direction,
+                                RandomStream& random_stream)
+{
+    double rnd1 = random_stream.RandomDouble();
+    double rnd2 = random_stream.RandomDouble();
+    double rnd3 = random_stream.RandomDouble();
+    double rnd4 = random_stream.RandomDouble();
+
+    return Scattering::Scatter(dr, ei, ef, pos, old_direction, rnd1, rnd2, rnd3, rnd4);
+}
+
 Directions Scattering::Scatter(double dr,
                                 double ei,
                                 double ef,
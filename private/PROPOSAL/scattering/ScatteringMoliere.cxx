@@ -48,7 +48,7 @@ Scattering::RandomAngles ScatteringMoliere::CalculateRandomAngle(double dr,
     }
 
     // Calculate Chi_c^2
-    chiCSq_ =
+    double chiCSq =
         ((4. * PI * NA * ALPHA * ALPHA * HBAR * HBAR * SPEED * SPEED) *
          (medium_->GetMassDensity() *
           medium_->GetDensityDistribution().Evaluate(pos) *
@@ -57,6 +57,7 @@ Scattering::RandomAngles ScatteringMoliere::CalculateRandomAngle(double dr,
 
     // Calculate B
     Scattering::RandomAngles random_angles;
+    std::vector<double> B(numComp_);
 
     for (int i = 0; i < numComp_; i++) {
         // calculate B-ln(B) = ln(chi_c^2/chi_a^2)+1-2*EULER_MASCHERONI via
@@ -64,7 +65,7 @@ Scattering::RandomAngles ScatteringMoliere::CalculateRandomAngle(double dr,
         double xn = 15.;
 
         for (int n = 0; n < 6; n++) {
-            xn = xn * ((1. - std::log(xn) - std::log(chiCSq_ / chi_A_Sq[i]) -
+            xn = xn * ((1. - std::log(xn) - std::log(chiCSq / chi_A_Sq[i]) -
                         1. + 2. * EULER_MASCHERONI) /
                        (1. - xn));
         }
@@ -79,19 +80,19 @@ Scattering::RandomAngles ScatteringMoliere::CalculateRandomAngle(double dr,
             return random_angles;
         }
 
-        B_[i] = xn;
+        B[i] = xn;
     }
 
-    double pre_factor = std::sqrt(chiCSq_ * B_[max_weight_index_]);
+    double pre_factor = std::sqrt(chiCSq * B[max_weight_index_]);
 
-    rnd1 = GetRandom(pre_factor, rnd1);
-    rnd2 = GetRandom(pre_factor, rnd2);
+    rnd1 = GetRandom(pre_factor, chiCSq, B, rnd1);
+    rnd2 = GetRandom(pre_factor, chiCSq, B, rnd2);
 
     random_angles.sx = 0.5 * (rnd1 / SQRT3 + rnd2);
     random_angles.tx = rnd2;
 
-    rnd1 = GetRandom(pre_factor, rnd3);
-    rnd2 = GetRandom(pre_factor, rnd4);
+    rnd1 = GetRandom(pre_factor, chiCSq, B, rnd3);
+    rnd2 = GetRandom(pre_factor, chiCSq, B, rnd4);
 
     random_angles.sy = 0.5 * (rnd1 / SQRT3 + rnd2);
     random_angles.ty = rnd2;
@@ -113,9 +114,7 @@ ScatteringMoliere::ScatteringMoliere(const ParticleDef& particle_def, std::share
       Zi_(numComp_),
       weight_ZZ_(numComp_),
       weight_ZZ_sum_(0.),
-      max_weight_index_(0),
-      chiCSq_(0.0),
-      B_(numComp_) {
+      max_weight_index_(0) {
     std::vector<double> Ai(numComp_,
                            0);  // atomic number of different components
     std::vector<double> ki(
@@ -170,9 +169,7 @@ ScatteringMoliere::ScatteringMoliere(const ScatteringMoliere& scattering)
       Zi_(scattering.Zi_),
       weight_ZZ_(scattering.weight_ZZ_),
       weight_ZZ_sum_(scattering.weight_ZZ_sum_),
-      max_weight_index_(scattering.max_weight_index_),
-      chiCSq_(scattering.chiCSq_),
-      B_(scattering.B_) {}
+      max_weight_index_(scattering.max_weight_index_) {}
 
 ScatteringMoliere::ScatteringMoliere(const ParticleDef& particle_def,
                                      const ScatteringMoliere& scattering)
@@ -183,9 +180,7 @@ ScatteringMoliere::ScatteringMoliere(const ParticleDef& particle_def,
       Zi_(scattering.Zi_),
       weight_ZZ_(scattering.weight_ZZ_),
       weight_ZZ_sum_(scattering.weight_ZZ_sum_),
-      max_weight_index_(scattering.max_weight_index_),
-      chiCSq_(scattering.chiCSq_),
-      B_(scattering.B_) {}
+      max_weight_index_(scattering.max_weight_index_) {}
 
 ScatteringMoliere::~ScatteringMoliere() {
 }
@@ -213,10 +208,6 @@ bool ScatteringMoliere::compare(const Scattering& scattering) const {
         return false;
     else if (max_weight_index_ != scatteringMoliere->max_weight_index_)
         return false;
-    else if (chiCSq_ != scatteringMoliere->chiCSq_)
-        return false;
-    else if (B_ != scatteringMoliere->B_)
-        return false;
     else
         return true;
 }
@@ -236,7 +227,7 @@ void ScatteringMoliere::print(std::ostream& os) const
 //--------------------------calculate distribution----------------------------//
 //----------------------------------------------------------------------------//
 
-double ScatteringMoliere::f1M(double x) {
+double ScatteringMoliere::f1M(double x) const {
     // approximation for large numbers to avoid numerical errors
     if (x > 12.)
         return 0.5 * std::sqrt(PI) /
@@ -273,7 +264,7 @@ double f2Mlarge(double x) {
     return sum;
 }
 
-double ScatteringMoliere::f2M(double x) {
+double ScatteringMoliere::f2M(double x) const {
     // approximation for larger x to avoid numerical errors
     if (x > 4.25 * 4.25)
         return f2Mlarge(x);
@@ -288,14 +279,14 @@ double ScatteringMoliere::f2M(double x) {
 
 //----------------------------------------------------------------------------//
 
-double ScatteringMoliere::f(double theta) {
+double ScatteringMoliere::f(double theta, double chiCSq, const std::vector<double>& B) const {
     double y1 = 0;
 
     for (int i = 0; i < numComp_; i++) {
-        double x = theta * theta / (chiCSq_ * B_[i]);
+        double x = theta * theta / (chiCSq * B[i]);
 
-        y1 += weight_ZZ_[i] / std::sqrt(chiCSq_ * B_[i] * PI) *
-              (std::exp(-x) + f1M(x) / B_[i] + f2M(x) / (B_[i] * B_[i]));
+        y1 += weight_ZZ_[i] / std::sqrt(chiCSq * B[i] * PI) *
+              (std::exp(-x) + f1M(x) / B[i] + f2M(x) / (B[i] * B[i]));
     }
 
     return y1 * weight_ZZ_sum_;
@@ -315,7 +306,7 @@ double F1Mlarge(double x) {
     return sum;
 }
 
-double ScatteringMoliere::F1M(double x) {
+double ScatteringMoliere::F1M(double x) const {
     if (x > 12.)
         return F1Mlarge(x);
 
@@ -350,7 +341,7 @@ double F2Mlarge(double x) {
     return sum;
 }
 
-double ScatteringMoliere::F2M(double x) {
+double ScatteringMoliere::F2M(double x) const {
     if (x > 4.25 * 4.25)
         return F2Mlarge(x);
 
@@ -364,15 +355,15 @@ double ScatteringMoliere::F2M(double x) {
 
 //----------------------------------------------------------------------------//
 
-double ScatteringMoliere::F(double theta) {
+double ScatteringMoliere::F(double theta, double chiCSq, const std::vector<double>& B) const {
     double y1 = 0;
 
     for (int i = 0; i < numComp_; i++) {
-        double x = theta * theta / (chiCSq_ * B_[i]);
+        double x = theta * theta / (chiCSq * B[i]);
 
         y1 += weight_ZZ_[i] * (0.5 * std::erf(std::sqrt(x)) +
                                std::sqrt(1. / PI) *
-                                   (F1M(x) / B_[i] + F2M(x) / (B_[i] * B_[i])));
+                                   (F1M(x) / B[i] + F2M(x) / (B[i] * B[i])));
     }
 
     return (theta < 0.) ? (-1.) * y1 * weight_ZZ_sum_ : y1 * weight_ZZ_sum_;
@@ -382,7 +373,7 @@ double ScatteringMoliere::F(double theta) {
 //-------------------------generate random angle------------------------------//
 //----------------------------------------------------------------------------//
 
-double ScatteringMoliere::GetRandom(double pre_factor, double rnd) {
+double ScatteringMoliere::GetRandom(double pre_factor, double chiCSq, const std::vector<double>& B, double rnd) const {
     //  Generate random angles following Moliere's distribution by comparing a
     //  uniformly distributed random number with the integral of the
     //  distribution. Therefore, determine the angle where the integral is equal
@@ -401,7 +392,7 @@ double ScatteringMoliere::GetRandom(double pre_factor, double rnd) {
     // iterating until the number of correct digits is greater than 4
     do {
         theta_n = theta_np1;
-        theta_np1 = theta_n - (F(theta_n) - rnd) / f(theta_n);
+        theta_np1 = theta_n - (F(theta_n, chiCSq, B) - rnd) / f(theta_n, chiCSq, B);
 
     } while (std::abs((theta_n - theta_np1) / theta_np1) > 1e-4);
 
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cctype>
+#include <dirent.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "PROPOSAL/methods.h"
+
+using namespace PROPOSAL;
+
+// Packs the table files of one or more table directories into one bundle,
+// which is used with the path_to_table_bundle option. Without directories,
+// the tables of the bundle are listed.
+//
+// usage: pack_tables <bundle> [table directory ...]
+
+namespace {
+
+// Table files are named <name>_<hash>, <name>_<hash>.txt or
+// <name>_<hash>.map, lock and temporary files are skipped.
+bool IsTableFile(std::string name)
+{
+    for (const std::string suffix : {".txt", ".map"})
+    {
+        if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+        {
+            name.erase(name.size() - suffix.size());
+        }
+    }
+
+    size_t separator = name.find_last_of('_');
+    if (separator == std::string::npos || separator == 0 || separator + 1 == name.size())
+    {
+        return false;
+    }
+
+    return std::all_of(name.begin() + separator + 1, name.end(), [](char c) { return std::isdigit(c); });
+}
+
+bool ListTableFiles(const std::string& directory, std::vector<std::string>& files)
+{
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr)
+    {
+        return false;
+    }
+
+    std::vector<std::string> names;
+    while (struct dirent* entry = readdir(dir))
+    {
+        if (IsTableFile(entry->d_name))
+        {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+
+    std::sort(names.begin(), names.end());
+    for (auto& name : names)
+    {
+        files.push_back(directory + "/" + name);
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <bundle> [table directory ...]" << std::endl;
+        return 1;
+    }
+
+    std::string bundle = argv[1];
+
+    if (argc == 2)
+    {
+        std::vector<std::string> tables = Helper::GetBundledTables(bundle);
+        if (tables.empty())
+        {
+            std::cerr << bundle << " is not a valid table bundle" << std::endl;
+            return 1;
+        }
+
+        for (auto& table : tables)
+        {
+            std::cout << table << std::endl;
+        }
+        return 0;
+    }
+
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (!ListTableFiles(argv[i], files))
+        {
+            std::cerr << "can not read the table directory " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (!Helper::PackTables(bundle, files))
+    {
+        std::cerr << "can not pack the tables into " << bundle << std::endl;
+        return 1;
+    }
+
+    std::cout << files.size() << " tables packed into " << bundle << std::endl;
+
+    return 0;
+}
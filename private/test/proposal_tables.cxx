@@ -0,0 +1,432 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "PROPOSAL/PROPOSAL.h"
+
+using namespace PROPOSAL;
+
+// Builds the tables of one or more configurations for one or more particles
+// in advance, e.g. on a build node before running many jobs with them. Every
+// configuration and particle is built in a process of its own, the processes
+// share the tables of equal settings through the table files. The time and
+// the size of every table file are reported.
+//
+// usage: proposal_tables [-j jobs] [-t table directory] [-b bundle]
+//                        <config file> [config file ...] <particle> [particle ...]
+//
+// -j: number of processes building at the same time, all hardware threads
+//     by default
+// -t: directory the tables are written to instead of the path_to_tables of
+//     the configurations
+// -b: bundle the tables are packed into afterwards, see pack_tables
+
+namespace {
+
+struct Job
+{
+    std::string config;
+    std::string particle;
+    std::string job_config;
+    FILE* records;
+    pid_t pid;
+};
+
+void PrintUsage(const char* program, const std::map<std::string, ParticleDef>& particles)
+{
+    std::cerr << "usage: " << program
+              << " [-j jobs] [-t table directory] [-b bundle] <config file> [config file ...] <particle> [particle ...]"
+              << std::endl;
+    std::cerr << "particles:";
+    for (auto& particle : particles)
+    {
+        std::cerr << " " << particle.first;
+    }
+    std::cerr << std::endl;
+}
+
+// Copies the configuration with the interpolation settings of the tool, as
+// the propagator reads its settings from a file
+bool WriteJobConfig(const std::string& config,
+                    const std::string& table_directory,
+                    bool bundle,
+                    unsigned int n_threads,
+                    std::string& job_config)
+{
+    nlohmann::json json;
+    try
+    {
+        std::ifstream in(Helper::ResolvePath(config, true));
+        in >> json;
+    } catch (const nlohmann::json::exception&)
+    {
+        std::cerr << "can not read the configuration " << config << std::endl;
+        return false;
+    }
+
+    nlohmann::json& interpolation = json["global"]["interpolation"];
+    if (!table_directory.empty())
+    {
+        interpolation["path_to_tables"] = table_directory;
+    }
+    if (!interpolation.contains("path_to_tables"))
+    {
+        // the tables would only be built in the memory of the job
+        std::cerr << "the configuration " << config << " has no path_to_tables, give a table directory with -t"
+                  << std::endl;
+        return false;
+    }
+    if (bundle)
+    {
+        // the tables are packed from their files
+        interpolation.erase("path_to_table_bundle");
+    }
+    // all tables are built while creating the propagator
+    interpolation["do_lazy_tables"] = false;
+    if (!interpolation.contains("n_threads"))
+    {
+        interpolation["n_threads"] = n_threads;
+    }
+
+    char name[] = "/tmp/proposal_tables_XXXXXX";
+    int fd      = mkstemp(name);
+    if (fd < 0)
+    {
+        std::cerr << "can not create a temporary configuration" << std::endl;
+        return false;
+    }
+    close(fd);
+    job_config = name;
+
+    std::ofstream out(name);
+    out << json.dump(4);
+    out.close();
+
+    if (!out.good())
+    {
+        std::cerr << "can not write the temporary configuration " << name << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Builds the tables in a child process, which writes their records to the
+// file shared with the parent. Returns false if the job could not be started.
+bool StartJob(Job& job, const ParticleDef& particle)
+{
+    job.records = std::tmpfile();
+    if (job.records == nullptr)
+    {
+        std::cerr << job.config << " " << job.particle
+                  << ": can not create the file of the records: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    std::cout << std::flush;
+
+    job.pid = fork();
+    if (job.pid < 0)
+    {
+        std::cerr << job.config << " " << job.particle << ": can not start the job: " << std::strerror(errno)
+                  << std::endl;
+        std::fclose(job.records);
+        job.records = nullptr;
+        return false;
+    }
+    if (job.pid != 0)
+    {
+        return true;
+    }
+
+    int status = 0;
+    try
+    {
+        Propagator propagator(particle, job.job_config);
+
+        for (auto& record : Helper::TakeTableRecords())
+        {
+            std::fprintf(job.records, "%s\t%s\t%s\t%.17g\t%zu\t%zu\n",
+                         record.name.c_str(),
+                         record.source.c_str(),
+                         record.file.c_str(),
+                         record.seconds,
+                         record.file_size,
+                         record.memory_size);
+        }
+    } catch (const std::exception& e)
+    {
+        std::cerr << job.config << " " << job.particle << ": " << e.what() << std::endl;
+        status = 1;
+    }
+
+    std::fflush(job.records);
+    _exit(status);
+}
+
+// Removes the temporary configurations of the jobs on every way out of main,
+// the forked jobs leave with _exit and do not remove them
+struct JobConfigCleanup
+{
+    explicit JobConfigCleanup(const std::vector<Job>& jobs)
+        : jobs(jobs)
+    {
+    }
+
+    ~JobConfigCleanup()
+    {
+        for (auto& job : jobs)
+        {
+            if (!job.job_config.empty())
+            {
+                std::remove(job.job_config.c_str());
+            }
+        }
+    }
+
+    const std::vector<Job>& jobs;
+};
+
+std::vector<Helper::TableRecord> ReadRecords(FILE* file)
+{
+    std::vector<Helper::TableRecord> records;
+    std::rewind(file);
+
+    std::string content;
+    char buffer[4096];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof buffer, file)) > 0)
+    {
+        content.append(buffer, n);
+    }
+
+    std::istringstream lines(content);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        std::istringstream fields(line);
+        std::string seconds, file_size, memory_size;
+        Helper::TableRecord record;
+
+        std::getline(fields, record.name, '\t');
+        std::getline(fields, record.source, '\t');
+        std::getline(fields, record.file, '\t');
+        std::getline(fields, seconds, '\t');
+        std::getline(fields, file_size, '\t');
+        std::getline(fields, memory_size);
+
+        record.seconds     = std::atof(seconds.c_str());
+        record.file_size   = std::strtoull(file_size.c_str(), nullptr, 10);
+        record.memory_size = std::strtoull(memory_size.c_str(), nullptr, 10);
+        records.push_back(record);
+    }
+
+    return records;
+}
+
+std::string FormatSize(size_t bytes)
+{
+    std::stringstream size;
+    size << std::fixed << std::setprecision(1) << bytes / 1024. << " kB";
+    return size.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::map<std::string, ParticleDef> particles;
+    particles.insert(std::make_pair("MuMinus", MuMinusDef::Get()));
+    particles.insert(std::make_pair("MuPlus", MuPlusDef::Get()));
+    particles.insert(std::make_pair("EMinus", EMinusDef::Get()));
+    particles.insert(std::make_pair("EPlus", EPlusDef::Get()));
+    particles.insert(std::make_pair("TauMinus", TauMinusDef::Get()));
+    particles.insert(std::make_pair("TauPlus", TauPlusDef::Get()));
+    particles.insert(std::make_pair("Gamma", GammaDef::Get()));
+
+    unsigned int n_jobs = std::thread::hardware_concurrency();
+    std::string table_directory;
+    std::string bundle;
+
+    int option;
+    while ((option = getopt(argc, argv, "j:t:b:")) != -1)
+    {
+        switch (option)
+        {
+            case 'j':
+                n_jobs = std::atoi(optarg);
+                break;
+            case 't':
+                table_directory = optarg;
+                break;
+            case 'b':
+                bundle = optarg;
+                break;
+            default:
+                PrintUsage(argv[0], particles);
+                return 1;
+        }
+    }
+
+    std::vector<std::string> configs;
+    std::vector<std::string> particle_names;
+    for (int i = optind; i < argc; ++i)
+    {
+        if (particles.find(argv[i]) != particles.end())
+        {
+            particle_names.push_back(argv[i]);
+        } else
+        {
+            configs.push_back(argv[i]);
+        }
+    }
+
+    if (configs.empty() || particle_names.empty())
+    {
+        PrintUsage(argv[0], particles);
+        return 1;
+    }
+
+    if (!table_directory.empty() && mkdir(table_directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        std::cerr << "can not create the table directory " << table_directory << std::endl;
+        return 1;
+    }
+
+    std::vector<Job> jobs;
+    for (auto& config : configs)
+    {
+        for (auto& particle : particle_names)
+        {
+            Job job;
+            job.config   = config;
+            job.particle = particle;
+            job.records  = nullptr;
+            job.pid      = -1;
+            jobs.push_back(job);
+        }
+    }
+
+    JobConfigCleanup cleanup(jobs);
+
+    n_jobs = std::max(1u, std::min<unsigned int>(n_jobs, jobs.size()));
+    unsigned int n_threads = std::max(1u, std::thread::hardware_concurrency() / n_jobs);
+
+    for (auto& job : jobs)
+    {
+        if (!WriteJobConfig(job.config, table_directory, !bundle.empty(), n_threads, job.job_config))
+        {
+            return 1;
+        }
+    }
+
+    // ----[ Build ]----------------------------------------- //
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::set<std::string> files;
+    size_t n_started  = 0;
+    size_t n_running  = 0;
+    bool success      = true;
+    size_t n_built    = 0;
+    size_t built_size = 0;
+    double build_time = 0;
+
+    while (n_started < jobs.size() || n_running > 0)
+    {
+        if (n_started < jobs.size() && n_running < n_jobs)
+        {
+            if (StartJob(jobs[n_started], particles.find(jobs[n_started].particle)->second))
+            {
+                ++n_running;
+            } else
+            {
+                success = false;
+            }
+            ++n_started;
+            continue;
+        }
+
+        int status;
+        pid_t pid = wait(&status);
+        if (pid < 0)
+        {
+            break;
+        }
+        --n_running;
+
+        auto job = std::find_if(jobs.begin(), jobs.end(), [pid](const Job& job) { return job.pid == pid; });
+        if (job == jobs.end())
+        {
+            continue;
+        }
+
+        std::vector<Helper::TableRecord> records = ReadRecords(job->records);
+        std::fclose(job->records);
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            std::cerr << job->config << " " << job->particle << ": the tables could not be built" << std::endl;
+            success = false;
+            continue;
+        }
+
+        std::cout << job->config << " " << job->particle << ": " << records.size() << " tables" << std::endl;
+        for (auto& record : records)
+        {
+            std::cout << "  " << std::left << std::setw(8) << record.source << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(10) << record.seconds << " s" << std::setw(14)
+                      << FormatSize(record.file_size) << std::setw(14) << FormatSize(record.memory_size) << "  "
+                      << (record.file.empty() ? record.name : record.file) << std::endl;
+
+            if (record.source == "built")
+            {
+                ++n_built;
+                build_time += record.seconds;
+                built_size += record.file_size;
+            }
+            if ((record.source == "built" || record.source == "read") && !record.file.empty())
+            {
+                files.insert(record.file);
+            }
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << n_built << " tables with " << FormatSize(built_size) << " built in " << std::fixed
+              << std::setprecision(1) << build_time << " s, " << elapsed.count() << " s with " << n_jobs << " jobs"
+              << std::endl;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    // ----[ Bundle ]---------------------------------------- //
+
+    if (!bundle.empty())
+    {
+        if (!Helper::PackTables(bundle, std::vector<std::string>(files.begin(), files.end())))
+        {
+            std::cerr << "can not pack the tables into " << bundle << std::endl;
+            return 1;
+        }
+        std::cout << files.size() << " tables packed into " << bundle << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "PROPOSAL/PROPOSAL.h"
+
+using namespace PROPOSAL;
+
+// Compares the tables of a propagator with the integrals they are built
+// from, to choose the nodes_* and order_of_interpolation settings.
+//
+// usage: table_audit [config file] [particle] [points]
+
+int main(int argc, const char* argv[])
+{
+    std::string config = "resources/config_ice.json";
+    std::string particle = "MuMinus";
+    int points = 100;
+
+    std::map<std::string, ParticleDef> particles;
+    particles.insert(std::make_pair("MuMinus", MuMinusDef::Get()));
+    particles.insert(std::make_pair("MuPlus", MuPlusDef::Get()));
+    particles.insert(std::make_pair("EMinus", EMinusDef::Get()));
+    particles.insert(std::make_pair("EPlus", EPlusDef::Get()));
+    particles.insert(std::make_pair("TauMinus", TauMinusDef::Get()));
+    particles.insert(std::make_pair("TauPlus", TauPlusDef::Get()));
+    particles.insert(std::make_pair("Gamma", GammaDef::Get()));
+
+    if (argc >= 2)
+    {
+        config = argv[1];
+    }
+    if (argc >= 3)
+    {
+        particle = argv[2];
+    }
+    if (argc >= 4)
+    {
+        points = std::atoi(argv[3]);
+    }
+
+    if (argc > 4 || particles.find(particle) == particles.end() || points <= 0)
+    {
+        std::cerr << "usage: " << argv[0] << " [config file] [particle] [points]" << std::endl;
+        std::cerr << "particles:";
+        for (std::map<std::string, ParticleDef>::const_iterator it = particles.begin(); it != particles.end(); ++it)
+        {
+            std::cerr << " " << it->first;
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+
+    Propagator propagator(particles.find(particle)->second, config);
+
+    PrintTableAudit(std::cout, AuditTables(propagator, points));
+
+    return 0;
+}
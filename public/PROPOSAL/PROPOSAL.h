@@ -98,12 +98,15 @@
 #include "PROPOSAL/medium/density_distr/density_polynomial.h"
 #include "PROPOSAL/medium/density_distr/density_splines.h"
 
+#include "PROPOSAL/math/BoundedQueue.h"
 #include "PROPOSAL/math/Function.h"
 #include "PROPOSAL/math/Integral.h"
 #include "PROPOSAL/math/Interpolant.h"
 #include "PROPOSAL/math/InterpolantBuilder.h"
 #include "PROPOSAL/math/MathMethods.h"
+#include "PROPOSAL/math/ParallelFor.h"
 #include "PROPOSAL/math/RandomGenerator.h"
+#include "PROPOSAL/math/RandomStream.h"
 #include "PROPOSAL/math/Spline.h"
 #include "PROPOSAL/math/TableWriter.h"
 #include "PROPOSAL/math/Vector3D.h"
@@ -126,9 +129,11 @@
 
 #include "PROPOSAL/Constants.h"
 #include "PROPOSAL/EnergyCutSettings.h"
+#include "PROPOSAL/Pipeline.h"
 #include "PROPOSAL/Propagator.h"
 #include "PROPOSAL/PropagatorService.h"
 #include "PROPOSAL/Sector.h"
+#include "PROPOSAL/TableAudit.h"
 #include "PROPOSAL/methods.h"
 #include "PROPOSAL/Secondaries.h"
 
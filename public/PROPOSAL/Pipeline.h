@@ -0,0 +1,109 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "PROPOSAL/Propagator.h"
+
+namespace PROPOSAL {
+
+// ----------------------------------------------------------------------------
+/// @brief Options for Pipeline
+// ----------------------------------------------------------------------------
+struct PipelineOptions : public BatchOptions
+{
+    PipelineOptions()
+        : BatchOptions()
+        , queue_size(1024)
+    {
+    }
+
+    //! capacity of the queue of primaries and of the queue of secondaries,
+    //! generator and propagation threads wait if their queue is full
+    size_t queue_size;
+};
+
+// ----------------------------------------------------------------------------
+/// @brief Overlaps the generation, propagation and writing of events
+///
+/// The primaries are produced by a generator in its own thread and handed
+/// to the propagation threads through a bounded queue. The secondaries are
+/// handed to the writer, which is called in the thread calling Run, through
+/// a second bounded queue. If the writer is slow, the queues fill up and the
+/// generator and the propagation threads wait, so the memory stays bounded.
+/// The generator and the writer count as two of the n_threads of the
+/// options, the remaining ones propagate, but at least one.
+///
+/// Like in Propagator::PropagateBatch every primary draws its random numbers
+/// from its own PhiloxStream, the i-th generated primary uses the stream
+/// first_stream + i. The secondaries only depend on the seed and the index
+/// of the primary, but they reach the writer in the order the propagation
+/// finished.
+// ----------------------------------------------------------------------------
+class Pipeline
+{
+public:
+    //! Sets the next primary, returns false if there are no more primaries.
+    //! The primary is initialized with the particle type of the propagator.
+    typedef std::function<bool(DynamicData&)> Generator;
+
+    //! Gets the index of the primary and its secondaries.
+    typedef std::function<void(size_t, Secondaries&)> Writer;
+
+    // ----------------------------------------------------------------------------
+    /// @brief Create a pipeline for the given propagator
+    ///
+    /// The propagator is not copied and has to outlive the pipeline.
+    /// Sectors built without an InterpolationDef work as well, but propagate
+    /// one particle at a time, see Sector::Propagate.
+    // ----------------------------------------------------------------------------
+    Pipeline(const Propagator&, const PipelineOptions& = PipelineOptions());
+
+    // ----------------------------------------------------------------------------
+    /// @brief Propagate all primaries of the generator
+    ///
+    /// Returns when every generated primary is written. If the generator,
+    /// the writer or a propagation throws, the pipeline is stopped and the
+    /// first exception is rethrown.
+    ///
+    /// @return number of propagated primaries
+    // ----------------------------------------------------------------------------
+    size_t Run(const Generator&, const Writer&);
+
+    const PipelineOptions& GetOptions() const { return options_; }
+
+private:
+    const Propagator& propagator_;
+    PipelineOptions options_;
+    int particle_type_; //!< type of the DynamicData handed to the generator
+};
+
+} // namespace PROPOSAL
@@ -46,12 +46,63 @@
  */
 
 // #include <deque>
+#include <cstdint>
 #include <vector>
 
 #include "PROPOSAL/Sector.h"
 
 namespace PROPOSAL {
 
+class RandomStream;
+
+// ----------------------------------------------------------------------------
+/// @brief State of a propagation that changes from call to call
+///
+/// The Propagator itself only holds the physics model, i.e. the sectors with
+/// their cross sections and interpolation tables, which is not altered by
+/// propagating. Everything that changes while propagating is kept here, so
+/// several threads can share one Propagator by using one context each.
+// ----------------------------------------------------------------------------
+struct PropagationContext
+{
+    PropagationContext(RandomStream* stream = nullptr)
+        : random_stream(stream)
+        , current_sector(nullptr)
+        , produced_particle_moments(100., 10000.)
+        , n_th_call(1)
+    {
+    }
+
+    //! random numbers are drawn from this stream,
+    //! if it is nullptr from the global RandomGenerator
+    RandomStream* random_stream;
+
+    Sector* current_sector; //!< sector of the last propagation step
+    std::pair<double, double> produced_particle_moments;
+    unsigned int n_th_call;
+};
+
+// ----------------------------------------------------------------------------
+/// @brief Options for Propagator::PropagateBatch
+// ----------------------------------------------------------------------------
+struct BatchOptions
+{
+    BatchOptions()
+        : n_threads(0)
+        , seed(0)
+        , first_stream(0)
+        , max_distance(1e20)
+        , minimal_energy(0.)
+    {
+    }
+
+    unsigned int n_threads; //!< number of worker threads, 0 uses all hardware threads
+    uint64_t seed;          //!< seed of the random streams
+    uint64_t first_stream;  //!< random stream of the first primary, the i-th primary uses first_stream + i
+    double max_distance;
+    double minimal_energy;
+};
+
 class Propagator
 {
 public:
@@ -77,15 +128,48 @@ public:
     Secondaries Propagate(const DynamicData& particle_condition,
         double max_distance=1e20, double minimal_energy=0.);
 
+    // ----------------------------------------------------------------------------
+    /// @brief Propagates the particle using the given context
+    ///
+    /// The propagator is not altered, so this method can be called from
+    /// several threads at once as long as every thread uses its own context.
+    /// Sectors built without an InterpolationDef keep intermediate results
+    /// of their integrals, so they propagate one particle at a time, see
+    /// Sector::Propagate.
+    ///
+    /// @return Secondary data
+    // ----------------------------------------------------------------------------
+    Secondaries Propagate(PropagationContext& context, const DynamicData& particle_condition,
+        double max_distance=1e20, double minimal_energy=0.) const;
+
+    // ----------------------------------------------------------------------------
+    /// @brief Propagates all primaries on several threads
+    ///
+    /// The primaries are distributed among the worker threads by work
+    /// stealing. Every primary draws its random numbers from its own
+    /// PhiloxStream, so the result only depends on the seed and the stream
+    /// of the primary, but not on the number of threads.
+    /// Sectors built without an InterpolationDef work as well, but propagate
+    /// one particle at a time, see Sector::Propagate.
+    ///
+    /// @param primaries
+    /// @param options
+    ///
+    /// @return Secondary data of every primary, in the order of the primaries
+    // ----------------------------------------------------------------------------
+    std::vector<Secondaries> PropagateBatch(const std::vector<DynamicData>& primaries,
+        const BatchOptions& options = BatchOptions()) const;
+
     // --------------------------------------------------------------------- //
     // Getter
     // --------------------------------------------------------------------- //
 
-    const Sector* GetCurrentSector() const { return current_sector_; }
+    const Sector* GetCurrentSector() const { return context_.current_sector; }
     const std::vector<Sector*> GetSectors() const { return sectors_; }
 
     std::shared_ptr<const Geometry> GetDetector() const { return detector_; };
     ParticleDef& GetParticleDef() { return particle_def_; };
+    const ParticleDef& GetParticleDef() const { return particle_def_; };
     /* DynamicData& GetEntryCondition() { return entry_condition_; }; */
     /* DynamicData& GetExitCondition() { return exit_condition_; }; */
     /* DynamicData& GetClosestApproachCondition() { return closest_approach_condition_; }; */
@@ -134,13 +218,28 @@ private:
     // ----------------------------------------------------------------------------
     std::shared_ptr<const Geometry> ParseGeometryConfig(const std::string& json_object_str);
 
+    // ----------------------------------------------------------------------------
+    /// @brief Create a sector for the given definition
+    ///
+    /// If a sector with the same physics already exists, the new sector
+    /// shares its cross sections and tables instead of building them again.
+    ///
+    /// @param sector_def
+    /// @param interpolation_def nullptr to use integrals instead of tables
+    ///
+    /// @return new Sector
+    // ----------------------------------------------------------------------------
+    Sector* CreateSector(const Sector::Definition& sector_def, const InterpolationDef* interpolation_def) const;
+
     // ----------------------------------------------------------------------------
     /// @brief Choose the current sector the particle is in.
     ///
     /// @param particle_position
     /// @param particle_direction
+    ///
+    /// @return the current sector, nullptr if there is no sector
     // ----------------------------------------------------------------------------
-    void ChooseCurrentSector(const Vector3D& particle_position, const Vector3D& particle_direction);
+    Sector* ChooseCurrentSector(const Vector3D& particle_position, const Vector3D& particle_direction) const;
 
     // ----------------------------------------------------------------------------
     /// @brief Calculate the distance to propagate
@@ -149,12 +248,15 @@ private:
     /// choose if the particle has to propagate through the whole sector
     /// or only to the sector border
     ///
+    /// @param current_sector
     /// @param particle_position
     /// @param particle_direction
     ///
     /// @return distance
     // ----------------------------------------------------------------------------
-    double CalculateEffectiveDistance(const Vector3D& particle_position, const Vector3D& particle_direction);
+    double CalculateEffectiveDistance(const Sector* current_sector,
+                                      const Vector3D& particle_position,
+                                      const Vector3D& particle_direction) const;
 
     // --------------------------------------------------------------------- //
     // Global default values
@@ -197,13 +299,11 @@ private:
     // --------------------------------------------------------------------- //
 
     std::vector<Sector*> sectors_;
-    Sector* current_sector_;
 
     ParticleDef particle_def_;
     std::shared_ptr<const Geometry> detector_;
 
-    std::pair<double,double> produced_particle_moments_ {100., 10000.};
-    unsigned int n_th_call_ {1};
+    PropagationContext context_; //!< used by Propagate without a context
     /* DynamicData entry_condition_; */
     /* DynamicData exit_condition_; */
     DynamicData closest_approach_condition_;
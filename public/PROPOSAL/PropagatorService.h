@@ -31,12 +31,16 @@
 
 #include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "PROPOSAL/Secondaries.h"
 
 namespace PROPOSAL {
 
 class Propagator;
+class RandomStream;
+struct PropagationContext;
 
 class PropagatorService
 {
@@ -77,6 +81,26 @@ public:
     // ----------------------------------------------------------------------------
     Secondaries Propagate(const ParticleDef&, DynamicData&, double distance = 1e20, double min_energy=0.);
 
+    // ----------------------------------------------------------------------------
+    /// @brief Propagate the given particle, may be called from several threads
+    ///
+    /// Every call borrows a PropagationContext from the pool of the particle
+    /// type, so particles of the same or of different types can be propagated
+    /// at the same time without further locking. All contexts of a particle
+    /// type use the same registered propagator and therefore share its tables.
+    /// The propagators must not be registered while particles are propagated.
+    /// Sectors built without an InterpolationDef work as well, but propagate
+    /// one particle at a time, see Sector::Propagate.
+    ///
+    /// @param ParticleDef
+    /// @param DynamicData initial condition of the particle
+    /// @param RandomStream random numbers are drawn from this stream,
+    ///        it must not be used by another thread during the call
+    ///
+    /// @return vector of secondary data
+    // ----------------------------------------------------------------------------
+    Secondaries Propagate(const ParticleDef&, const DynamicData&, RandomStream&, double distance = 1e20, double min_energy=0.) const;
+
     // ----------------------------------------------------------------------------
     /// @brief Get Propagator for a given particle
     ///
@@ -90,7 +114,30 @@ public:
     Propagator* GetPropagatorToParticleDef(const ParticleDef&);
 
 private:
+    // ----------------------------------------------------------------------------
+    /// @brief Propagation contexts of one particle type which are not in use
+    ///
+    /// The contexts are reused, so the statistics collected during the
+    /// propagation are kept between the calls.
+    // ----------------------------------------------------------------------------
+    class ContextPool
+    {
+    public:
+        ContextPool();
+        ~ContextPool();
+
+        std::unique_ptr<PropagationContext> Acquire();
+        void Release(std::unique_ptr<PropagationContext>);
+
+    private:
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<PropagationContext> > contexts_;
+    };
+
+    typedef std::unordered_map<ParticleDef, std::unique_ptr<ContextPool> > ContextPoolMap;
+
     PropagatorMap propagator_map_;
+    ContextPoolMap context_pool_map_;
 };
 
 } // namespace PROPOSAL
@@ -30,7 +30,9 @@
 
 // #include <string>
 // #include <vector>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <tuple>
 
 #include "PROPOSAL/Secondaries.h"
@@ -43,6 +45,7 @@
 namespace PROPOSAL {
 
 class ContinuousRandomizer;
+class RandomStream;
 // class CrossSection;
 // class Medium;
 // class EnergyCutSettings;
@@ -74,6 +77,15 @@ public:
 
         bool operator==(const Definition&) const;
         bool operator!=(const Definition&) const;
+
+        // ----------------------------------------------------------------------------
+        /// @brief Check if sectors of both definitions use the same physics
+        ///
+        /// This is the case if medium, cuts, utility definition, scattering
+        /// model and the optional utilities agree. Geometry, location and the
+        /// options only used while propagating may differ.
+        // ----------------------------------------------------------------------------
+        bool HasSamePhysics(const Definition&) const;
         /* Definition& operator=(const Definition&); */
         friend std::ostream& operator<<(std::ostream&, Definition const&);
         void swap(Definition&);
@@ -112,10 +124,43 @@ public:
 
 public:
     Sector(const ParticleDef&, const Definition&);
+
+    // ----------------------------------------------------------------------------
+    /// @brief Create a sector using interpolation tables
+    ///
+    /// With InterpolationDef::do_lazy_tables, the cross sections, tables and
+    /// propagation utilities are not built here, but on the first use of the
+    /// sector, see Initialize.
+    // ----------------------------------------------------------------------------
     Sector(const ParticleDef&, const Definition&, const InterpolationDef&);
     Sector(const Sector&);
+
+    // ----------------------------------------------------------------------------
+    /// @brief Create a sector sharing the physics of the given sector
+    ///
+    /// The cross sections, tables and propagation utilities are taken from
+    /// the given sector, so no tables have to be built. The definition has to
+    /// fulfill HasSamePhysics with the definition of the given sector.
+    // ----------------------------------------------------------------------------
+    Sector(const Definition&, const Sector&);
     ~Sector();
 
+    // ----------------------------------------------------------------------------
+    /// @brief Build the physics of a sector with lazy tables
+    ///
+    /// The member functions only build the parts of the physics they use,
+    /// e.g. GetUtility only the cross sections and ContinuousRandomize the
+    /// tables of the continuous randomization, so it is only needed to build
+    /// all of them in advance. Every part is built once for all sectors
+    /// sharing it, even if several threads use them at once. Sectors without
+    /// lazy tables are built in their constructor.
+    // ----------------------------------------------------------------------------
+    void Initialize() const;
+    bool IsInitialized() const { return initialized_parts_ == AllParts; }
+
+    // Sectors are equal if their definitions are, so they are compared
+    // without building lazy tables
+
     bool operator==(const Sector&) const;
     bool operator!=(const Sector&) const;
     friend std::ostream& operator<<(std::ostream&, Sector const&);
@@ -164,9 +209,16 @@ public:
         const DynamicData&, double, double);
     /* std::shared_ptr<DynamicData> DoBorder(const DynamicData& ); */
 
+    // Sectors without interpolation tables keep intermediate results in
+    // their integrals, which may be shared with copies of the sector, so
+    // all of them propagate one particle at a time
     Secondaries Propagate(const DynamicData& particle_condition,
         double max_distance=1e20, double minimal_energy=0.);
 
+    // Same as above, but all random numbers are drawn from the given stream
+    Secondaries Propagate(const DynamicData& particle_condition,
+        double max_distance, double minimal_energy, RandomStream& random_stream);
+
     /**
      *  Makes Stochastic Energyloss
      *
@@ -189,14 +241,51 @@ public:
     // --------------------------------------------------------------------- //
 
     ParticleLocation::Enum GetLocation() const { return sector_def_.location; }
-    std::shared_ptr<Scattering> GetScattering() const { return scattering_; }
+    bool IsInterpolated() const { return interpolated_; }
+    std::shared_ptr<Scattering> GetScattering() const { InitializeParts(ScatteringPart); return scattering_; }
     const ParticleDef GetParticleDef() const { return particle_def_; }
-    const Utility& GetUtility() const { return utility_; }
+    const Utility& GetUtility() const { InitializeParts(UtilityPart); return *utility_; }
     const Definition& GetSectorDef() const { return sector_def_; }
+    const InterpolationDef& GetInterpolationDef() const { return interpolation_def_; }
+    std::shared_ptr<UtilityDecorator> GetDisplacementCalculator() const { InitializeParts(DisplacementPart); return displacement_calculator_; }
+    std::shared_ptr<UtilityDecorator> GetInteractionCalculator() const { InitializeParts(InteractionPart); return interaction_calculator_; }
+    std::shared_ptr<UtilityDecorator> GetDecayCalculator() const { InitializeParts(DecayPart); return decay_calculator_; }
+    std::shared_ptr<UtilityDecorator> GetExactTimeCalculator() const { InitializeParts(ExactTimePart); return exact_time_calculator_; }
+    std::shared_ptr<ContinuousRandomizer> GetContinuousRandomizer() const { InitializeParts(ContRandPart); return cont_rand_; }
 
 protected:
     Sector& operator=(const Sector&); // Undefined & not allowed
 
+    struct LazyPhysics;
+
+    // The parts of the physics, which are built on their first use for lazy
+    // tables. All other parts refer to the utility, so it is built first.
+    enum Parts : unsigned int
+    {
+        UtilityPart = 1,
+        DisplacementPart = 1 << 1,
+        InteractionPart = 1 << 2,
+        DecayPart = 1 << 3,
+        ExactTimePart = 1 << 4,
+        ContRandPart = 1 << 5,
+        ScatteringPart = 1 << 6,
+        AllParts = (1 << 7) - 1
+    };
+
+    // builds the sector with the given parts, the others are built later
+    // by BuildParts
+    Sector(const ParticleDef&, const Definition&, const InterpolationDef&, unsigned int parts);
+
+    // builds the given parts at the same time, the utility has to be built
+    void BuildParts(unsigned int parts, const InterpolationDef&) const;
+
+    // builds the missing of the given parts of a sector with lazy tables
+    void InitializeParts(unsigned int parts) const;
+
+    // copies the given parts of the physics of the given sector, all of them
+    // by the copy constructor
+    void CopyPhysics(const Sector&, unsigned int parts = AllParts) const;
+
     // --------------------------------------------------------------------- //
     // Protected members
     // --------------------------------------------------------------------- //
@@ -205,14 +294,25 @@ protected:
 
     ParticleDef particle_def_;
 
-    Utility utility_;
-    std::shared_ptr<UtilityDecorator> displacement_calculator_;
-    std::shared_ptr<UtilityDecorator> interaction_calculator_;
-    std::shared_ptr<UtilityDecorator> decay_calculator_;
-    std::shared_ptr<UtilityDecorator> exact_time_calculator_;
+    bool interpolated_; //!< built with an InterpolationDef
+    InterpolationDef interpolation_def_; //!< the default without interpolation
+
+    // Shared by the sectors sharing the physics, null without lazy tables.
+    // Declared first, as the physics copied from it refers to its members.
+    std::shared_ptr<LazyPhysics> lazy_physics_;
+
+    // The physics is mutable, as it is built by Initialize for lazy tables
+    mutable std::unique_ptr<Utility> utility_;
+    mutable std::shared_ptr<UtilityDecorator> displacement_calculator_;
+    mutable std::shared_ptr<UtilityDecorator> interaction_calculator_;
+    mutable std::shared_ptr<UtilityDecorator> decay_calculator_;
+    mutable std::shared_ptr<UtilityDecorator> exact_time_calculator_;
+
+    mutable std::shared_ptr<ContinuousRandomizer> cont_rand_;
+    mutable std::shared_ptr<Scattering> scattering_;
 
-    std::shared_ptr<ContinuousRandomizer> cont_rand_;
-    std::shared_ptr<Scattering> scattering_;
+    mutable std::atomic<unsigned int> initialized_parts_;
+    mutable std::mutex initialize_mutex_;
 
     /* std::pair<double, double> produced_particle_moments_{ 100., 10000. }; */
     /* unsigned int n_th_call_{ 1 }; */
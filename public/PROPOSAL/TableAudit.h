@@ -0,0 +1,87 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace PROPOSAL {
+
+class Propagator;
+
+// ----------------------------------------------------------------------------
+/// @brief Accuracy and cost of the tables behind one interpolated quantity
+// ----------------------------------------------------------------------------
+struct TableAudit
+{
+    TableAudit();
+
+    std::string sector;  //!< index and medium of the sector
+    std::string table;   //!< quantity, e.g. "BremsKelnerKokoulinPetrukhin dEdx"
+    double max_error;    //!< maximal deviation from the integral relative to the larger value,
+                         //!< but at least to a thousandth of the largest compared integral
+    double worst_energy; //!< energy of the maximal deviation
+    int points;          //!< number of compared points
+    int nodes;           //!< sampling points of all tables of the quantity
+    size_t bytes;        //!< memory of all tables of the quantity
+    double ns;           //!< time of one interpolated evaluation in ns
+};
+
+// ----------------------------------------------------------------------------
+/// @brief Compares all tables of a propagator with the integrals
+///
+/// For every sector, the interpolated dEdx, dE2dx, dNdx and cumulative dNdx
+/// of the cross sections and the displacement, interaction, decay and time
+/// integrals of the sector are evaluated at random points within the range
+/// of their tables. The results are compared with the same quantities
+/// calculated by integration, as done without an InterpolationDef. Sectors
+/// sharing their tables are audited separately. Quantities which are not
+/// interpolated are not reported.
+///
+/// The integrals are much slower than the tables, so the number of points
+/// should be kept small. The propagator must not be used from other threads
+/// meanwhile.
+///
+/// @param propagator
+/// @param points number of random points per quantity
+/// @param seed seed of the random points
+///
+/// @return one entry per interpolated quantity and sector
+// ----------------------------------------------------------------------------
+std::vector<TableAudit> AuditTables(const Propagator& propagator, int points = 100, uint64_t seed = 0);
+
+// ----------------------------------------------------------------------------
+/// @brief Prints the audit as a table with one line per quantity
+// ----------------------------------------------------------------------------
+void PrintTableAudit(std::ostream&, const std::vector<TableAudit>&);
+
+} // namespace PROPOSAL
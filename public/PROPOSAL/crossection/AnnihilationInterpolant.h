@@ -54,12 +54,15 @@ namespace PROPOSAL {
         double CalculatedE2dx(double energy){ (void)energy; return 0; }
         double CalculateStochasticLoss(double energy, double rnd1, double rnd2);
         std::pair<std::vector<DynamicData>, bool> CalculateProducedParticles(double energy, double energy_loss, const Vector3D& initial_direction);
+        std::pair<std::vector<DynamicData>, bool> CalculateProducedParticles(double energy, double energy_loss, const Vector3D& initial_direction, double rnd1, double rnd2);
 
     protected:
         virtual bool compare(const CrossSection&) const;
 
+        // The sampled component is needed for the produced particles
+        virtual bool HasRatePerComponent() const { return false; }
+
     private:
-        double rndc_;
         ParticleDef const* gamma_def_;
     };
 
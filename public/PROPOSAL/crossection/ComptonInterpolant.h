@@ -49,12 +49,12 @@ namespace PROPOSAL {
         // ----------------------------------------------------------------- //
 
         double CalculatedEdx(double energy);
-        virtual double FunctionToBuildDNdxInterpolant2D(double energy, double v, Integral&, int component);
+        virtual double FunctionToBuildDNdxInterpolant2D(double energy, double v, Parametrization&, Integral&, int component) const;
         virtual double CalculateCumulativeCrossSection(double energy, int component, double v);
         virtual std::pair<double, double> StochasticDeflection(double energy, double energy_loss);
 
     private:
-        virtual double CalculateStochasticLoss(double energy, double rnd1);
+        virtual double CalculateStochasticLossOfComponent(double energy, int component, double rnd, double rate);
         virtual void InitdNdxInterpolation(const InterpolationDef& def);
 
     };
@@ -74,6 +74,15 @@ public:
         (void)energy; (void)energy_loss; (void)initial_direction; return std::make_pair(std::vector<DynamicData>(), false);
     }
 
+    // Same as above for the interaction sampled by CalculateStochasticLoss
+    // with the random numbers rnd1 and rnd2. The interpolated cross sections
+    // sample the interaction again from them, so the cross section does not
+    // keep any state of the last interaction.
+    virtual std::pair<std::vector<DynamicData>, bool> CalculateProducedParticles(
+            double energy, double energy_loss, const Vector3D& initial_direction, double rnd1, double rnd2){
+        (void)rnd1; (void)rnd2; return CalculateProducedParticles(energy, energy_loss, initial_direction);
+    }
+
     virtual std::pair<double, double> StochasticDeflection(double energy, double energy_loss);
 
     virtual double CalculateCumulativeCrossSection(double energy, int component, double v) = 0;
@@ -89,12 +98,6 @@ protected:
 
     virtual bool compare(const CrossSection&) const = 0;
 
-    // ----------------------------------------------------------------- //
-    // Protected methods
-    // ----------------------------------------------------------------- //
-
-    virtual double CalculateStochasticLoss(double energy, double rnd1) = 0;
-
     // ----------------------------------------------------------------- //
     // Protected member
     // ----------------------------------------------------------------- //
@@ -103,14 +106,7 @@ protected:
 
     Parametrization* parametrization_;
 
-    std::vector<double> prob_for_component_; //!< probability for each medium component to
-                                             //!< interact with the particle (formerly h_)
-    double sum_of_rates_;
-
     const std::vector<Components::Component>& components_;
-
-    double rnd_; //!< This random number will be stored in CalculateDNdx to avoid calculate dNdx a second time in
-                 //! ClaculateSochasticLoss when it is already done
 };
 
 std::ostream& operator<<(std::ostream&, PROPOSAL::CrossSection const&);
@@ -62,6 +62,16 @@ protected:
     Integral de2dx_integral_;
     IntegralVec dndx_integral_;
 
+    // The integral cross sections store the rates of the last call of
+    // CalculatedNdx for CalculateStochasticLoss and the produced particles,
+    // so they must not be used by several threads at once, see
+    // Sector::Propagate. The interpolated cross sections keep no such state.
+    std::vector<double> prob_for_component_; //!< probability for each medium component to
+                                             //!< interact with the particle (formerly h_)
+    double sum_of_rates_;
+    double rnd_; //!< This random number will be stored in CalculateDNdx to avoid calculate dNdx a second time in
+                 //! ClaculateSochasticLoss when it is already done
+
     virtual double CalculateStochasticLoss(double energy, double rnd1);
 };
 
@@ -29,7 +29,10 @@
 
 #pragma once
 
+#include <memory>
+
 #include "PROPOSAL/crossection/CrossSection.h"
+#include "PROPOSAL/math/InterpolantBuilder.h"
 #include "PROPOSAL/methods.h"
 
 namespace PROPOSAL {
@@ -54,21 +57,74 @@ public:
 
     // Needed to initialize interpolation
     virtual double FunctionToBuildDNdxInterpolant(double energy, int component);
-    virtual double FunctionToBuildDNdxInterpolant2D(double energy, double v, Integral&, int component);
+    virtual double FunctionToBuildDNdxInterpolant2D(double energy, double v, Parametrization&, Integral&, int component) const;
     virtual double CalculateCumulativeCrossSection(double energy, int component, double v);
 
+    // The total dNdx is the sum of the rates of the cross section, which are
+    // the dNdx of the components, or the whole dNdx if the cross section
+    // samples its components itself. The fused tables of the Utility are
+    // built from them, see Utility::StochasticLoss.
+    int GetNumberOfRates() const;
+    double CalculatedNdxOfRate(double energy, int rate);
+
+    //! Same as CalculateStochasticLoss, but the rate is already chosen
+    double CalculateStochasticLossOfRate(double energy, int rate, double rnd1, double rnd2);
+
+    typedef std::vector<std::shared_ptr<const Interpolant> > InterpolantVec;
+
+    // Tables of the cross section, e.g. to audit them. The dE2dx table is
+    // null if it was not built.
+    std::shared_ptr<const Interpolant> GetdEdxInterpolant() const { return dedx_interpolant_; }
+    std::shared_ptr<const Interpolant> GetdE2dxInterpolant() const { return de2dx_interpolant_; }
+    const InterpolantVec& GetdNdxInterpolants1D() const { return dndx_interpolant_1d_; }
+    const InterpolantVec& GetdNdxInterpolants2D() const { return dndx_interpolant_2d_; }
+
 protected:
     virtual bool compare(const CrossSection&) const;
 
-    typedef std::vector<Interpolant*> InterpolantVec;
+    //! False if the components can not be sampled on their own, e.g. as
+    //! the produced particles depend on the sampled component
+    virtual bool HasRatePerComponent() const { return true; }
 
-    virtual double CalculateStochasticLoss(double energy, double rnd1);
+    //! Sample the energy loss of an interaction with the given component,
+    //! rate is the random number rnd scaled by the dNdx of the component.
+    virtual double CalculateStochasticLossOfComponent(double energy, int component, double rnd, double rate);
     virtual void InitdNdxInterpolation(const InterpolationDef& def);
 
-    Interpolant* dedx_interpolant_;
-    Interpolant* de2dx_interpolant_;
+    //! Initializes the dNdx tables and the dEdx and dE2dx tables of the
+    //! builders at the same time, as they do not depend on each other, and
+    //! the Chebyshev series afterwards. The dEdx and dE2dx builders must
+    //! therefore not share an integral.
+    void InitTables(const InterpolationDef& def,
+                    Helper::InterpolantBuilderContainer& dedx_builders,
+                    Helper::InterpolantBuilderContainer& de2dx_builders);
+
+    //! Builds the inverse dNdx tables if enabled in the InterpolationDef,
+    //! the dNdx tables have to be initialized before.
+    void InitdNdxInverseInterpolation(const InterpolationDef& def, double energy_min);
+
+    //! Replaces the dEdx, dE2dx and dNdx tables by Chebyshev series if
+    //! enabled in the InterpolationDef, the tables have to be initialized before.
+    void InitChebyshevSeries(const InterpolationDef& def);
+
+    //! Finds the x2 value of the dNdx table of the component where the
+    //! cumulative dNdx equals rate, which is rnd scaled by the dNdx of the
+    //! component. The inverse table is used if it was built and rnd is
+    //! neither too small nor too large.
+    double FinddNdxLimit(double energy, int component, double rnd, double rate) const;
+
+    //! Creates instances of FunctionToBuildDNdxInterpolant2D with their own
+    //! copy of the parametrization, so the dNdx tables can be built in parallel.
+    Interpolant2DBuilder::Function2DFactory DNdxInterpolant2DFactory(int component) const;
+
+    // The tables are shared between copies of the cross section
+    std::shared_ptr<const Interpolant> dedx_interpolant_;
+    std::shared_ptr<const Interpolant> de2dx_interpolant_;
     InterpolantVec dndx_interpolant_1d_; // Stochastic dNdx()
     InterpolantVec dndx_interpolant_2d_; // Stochastic dNdx()
+    InterpolantVec dndx_inverse_interpolant_2d_; // x2 of dndx_interpolant_2d_ depending on energy and rnd, empty if not built
+    double dndx_inverse_rnd_min_; // below, the inverse tables are not accurate enough and are not used
+    double dndx_inverse_rnd_max_; // above, the inverse tables are not accurate enough and are not used
 };
 
 } // namespace PROPOSAL
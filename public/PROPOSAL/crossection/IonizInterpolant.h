@@ -51,13 +51,17 @@ public:
     double CalculatedEdx(double energy);
     virtual double CalculatedNdx(double energy);
     virtual double CalculatedNdx(double energy, double rnd);
+    virtual double CalculateStochasticLoss(double energy, double rnd1, double rnd2);
 
     // Needed to initialize interpolation
     double FunctionToBuildDNdxInterpolant(double energy, int component);
-    virtual double FunctionToBuildDNdxInterpolant2D(double energy, double v, Integral&, int component);
+    virtual double FunctionToBuildDNdxInterpolant2D(double energy, double v, Parametrization&, Integral&, int component) const;
+
+protected:
+    // Only one table is used for all components
+    virtual bool HasRatePerComponent() const { return false; }
 
 private:
-    virtual double CalculateStochasticLoss(double energy, double rnd1);
     virtual void InitdNdxInterpolation(const InterpolationDef& def);
 };
 
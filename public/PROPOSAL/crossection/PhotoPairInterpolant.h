@@ -57,6 +57,7 @@ namespace PROPOSAL {
         double CalculatedE2dx(double energy){ (void)energy; return 0; }
 
         std::pair<std::vector<DynamicData>, bool> CalculateProducedParticles(double energy, double energy_loss, const Vector3D&);
+        std::pair<std::vector<DynamicData>, bool> CalculateProducedParticles(double energy, double energy_loss, const Vector3D&, double rnd1, double rnd2);
         double CalculateStochasticLoss(double energy, double rnd1, double rnd2);
 
         PhotoAngleDistribution& GetPhotoAngleDistribution() const { return *photoangle_; }
@@ -65,9 +66,11 @@ namespace PROPOSAL {
         virtual bool compare(const CrossSection&) const;
         void InitdNdxInterpolation(const InterpolationDef& def);
 
+        // The sampled component is needed for the produced particles
+        virtual bool HasRatePerComponent() const { return false; }
+
         PhotoAngleDistribution* photoangle_;
     private:
-        double rndc_;
         ParticleDef const* eminus_def_;
         ParticleDef const* eplus_def_;
     };
@@ -75,6 +75,7 @@ public:
     virtual double CalculateParametrization(double energy, double v) = 0;
 
     virtual IntegralLimits GetIntegralLimits(double energy);
+    virtual IntegralLimits GetIntegralLimits(double energy, int component);
 
     // ----------------------------------------------------------------- //
     // Getter
@@ -143,7 +144,7 @@ private:
     virtual bool compare(const Parametrization&) const;
 
     static const std::string name_;
-    Interpolant* interpolant_;
+    std::shared_ptr<const Interpolant> interpolant_;
 };
 
 #undef BREMSSTRAHLUNG_DEF
@@ -97,6 +97,7 @@ public:
     virtual double DifferentialCrossSection(double energy, double v) = 0;
 
     virtual IntegralLimits GetIntegralLimits(double energy);
+    virtual IntegralLimits GetIntegralLimits(double energy, int component);
 
 
 protected:
@@ -170,7 +171,7 @@ template<class Param = EpairKelnerKokoulinPetrukhin>
 class EpairProductionRhoInterpolant : public Param
 {
 public:
-    typedef std::vector<Interpolant*> InterpolantVec;
+    typedef std::vector<std::shared_ptr<const Interpolant> > InterpolantVec;
 
 public:
     EpairProductionRhoInterpolant(const ParticleDef&,
@@ -197,7 +198,7 @@ public:
 
 protected:
     virtual bool compare(const Parametrization&) const;
-    double FunctionToBuildPhotoInterpolant(double energy, double v, int component);
+    static double FunctionToBuildPhotoInterpolant(Param&, double energy, double v, int component);
 
     InterpolantVec interpolant_;
 };
@@ -210,7 +211,7 @@ EpairProductionRhoInterpolant<Param>::EpairProductionRhoInterpolant(const Partic
                                               bool lpm,
                                               InterpolationDef def)
     : Param(particle_def, medium, cuts, multiplier, lpm)
-    , interpolant_(this->medium_->GetNumComponents(), NULL)
+    , interpolant_(this->medium_->GetNumComponents(), nullptr)
 {
     std::vector<Interpolant2DBuilder> builder2d(this->components_.size());
     Helper::InterpolantBuilderContainer builder_container2d(this->components_.size());
@@ -236,7 +237,13 @@ EpairProductionRhoInterpolant<Param>::EpairProductionRhoInterpolant(const Partic
             .SetRationalY(false)
             .SetRelativeY(false)
             .SetLogSubst(false)
-            .SetFunction2D(std::bind(&EpairProductionRhoInterpolant::FunctionToBuildPhotoInterpolant, this, std::placeholders::_1, std::placeholders::_2, i));
+            .SetFunction2DFactory([this, i]() -> Interpolant2DBuilder::Function2D {
+                // every thread uses its own copy of the parametrization
+                std::shared_ptr<Param> param = std::make_shared<Param>(*this);
+                return [param, i](double energy, double v) {
+                    return EpairProductionRhoInterpolant::FunctionToBuildPhotoInterpolant(*param, energy, v, i);
+                };
+            });
 
         builder_container2d[i].first  = &builder2d[i];
         builder_container2d[i].second = &interpolant_[i];
@@ -248,25 +255,13 @@ EpairProductionRhoInterpolant<Param>::EpairProductionRhoInterpolant(const Partic
 template<class Param>
 EpairProductionRhoInterpolant<Param>::EpairProductionRhoInterpolant(const EpairProductionRhoInterpolant& photo)
     : Param(photo)
-    , interpolant_()
+    , interpolant_(photo.interpolant_)
 {
-    interpolant_.resize(photo.interpolant_.size());
-
-    for (unsigned int i = 0; i < photo.interpolant_.size(); ++i)
-    {
-        interpolant_[i] = new Interpolant(*photo.interpolant_[i]);
-    }
 }
 
 template<class Param>
 EpairProductionRhoInterpolant<Param>::~EpairProductionRhoInterpolant()
 {
-    for (std::vector<Interpolant*>::const_iterator iter = interpolant_.begin(); iter != interpolant_.end(); ++iter)
-    {
-        delete *iter;
-    }
-
-    interpolant_.clear();
 }
 
 template<class Param>
@@ -303,10 +298,10 @@ double EpairProductionRhoInterpolant<Param>::DifferentialCrossSection(double ene
 }
 
 template<class Param>
-double EpairProductionRhoInterpolant<Param>::FunctionToBuildPhotoInterpolant(double energy, double v, int component)
+double EpairProductionRhoInterpolant<Param>::FunctionToBuildPhotoInterpolant(Param& param, double energy, double v, int component)
 {
-    this->component_index_                 = component;
-    Parametrization::IntegralLimits limits = this->GetIntegralLimits(energy);
+    param.SetCurrentComponent(component);
+    Parametrization::IntegralLimits limits = param.GetIntegralLimits(energy);
 
     if (limits.vUp == limits.vMax)
     {
@@ -315,7 +310,7 @@ double EpairProductionRhoInterpolant<Param>::FunctionToBuildPhotoInterpolant(dou
 
     v = limits.vUp * std::exp(v * std::log(limits.vMax / limits.vUp));
 
-    return Param::DifferentialCrossSection(energy, v);
+    return param.DifferentialCrossSection(energy, v);
 }
 
 #undef EPAIR_PARAM_INTEGRAL_DEC
@@ -149,7 +149,7 @@ template<class Param = MupairKelnerKokoulinPetrukhin>
 class MupairProductionRhoInterpolant : public Param
 {
 public:
-    typedef std::vector<Interpolant*> InterpolantVec;
+    typedef std::vector<std::shared_ptr<const Interpolant> > InterpolantVec;
 
 public:
     MupairProductionRhoInterpolant(const ParticleDef&,
@@ -176,7 +176,7 @@ public:
 
 protected:
     virtual bool compare(const Parametrization&) const;
-    double FunctionToBuildPhotoInterpolant(double energy, double v, int component);
+    static double FunctionToBuildPhotoInterpolant(Param&, double energy, double v, int component);
 
     InterpolantVec interpolant_;
 };
@@ -189,7 +189,7 @@ MupairProductionRhoInterpolant<Param>::MupairProductionRhoInterpolant(const Part
                                               bool particle_output,
                                               InterpolationDef def)
     : Param(particle_def, medium, cuts, multiplier, particle_output)
-    , interpolant_(this->medium_->GetNumComponents(), NULL)
+    , interpolant_(this->medium_->GetNumComponents(), nullptr)
 {
     std::vector<Interpolant2DBuilder> builder2d(this->components_.size());
     Helper::InterpolantBuilderContainer builder_container2d(this->components_.size());
@@ -215,7 +215,13 @@ MupairProductionRhoInterpolant<Param>::MupairProductionRhoInterpolant(const Part
             .SetRationalY(false)
             .SetRelativeY(false)
             .SetLogSubst(false)
-            .SetFunction2D(std::bind(&MupairProductionRhoInterpolant::FunctionToBuildPhotoInterpolant, this, std::placeholders::_1, std::placeholders::_2, i));
+            .SetFunction2DFactory([this, i]() -> Interpolant2DBuilder::Function2D {
+                // every thread uses its own copy of the parametrization
+                std::shared_ptr<Param> param = std::make_shared<Param>(*this);
+                return [param, i](double energy, double v) {
+                    return MupairProductionRhoInterpolant::FunctionToBuildPhotoInterpolant(*param, energy, v, i);
+                };
+            });
 
         builder_container2d[i].first  = &builder2d[i];
         builder_container2d[i].second = &interpolant_[i];
@@ -227,25 +233,13 @@ MupairProductionRhoInterpolant<Param>::MupairProductionRhoInterpolant(const Part
 template<class Param>
 MupairProductionRhoInterpolant<Param>::MupairProductionRhoInterpolant(const MupairProductionRhoInterpolant& photo)
     : Param(photo)
-    , interpolant_()
+    , interpolant_(photo.interpolant_)
 {
-    interpolant_.resize(photo.interpolant_.size());
-
-    for (unsigned int i = 0; i < photo.interpolant_.size(); ++i)
-    {
-        interpolant_[i] = new Interpolant(*photo.interpolant_[i]);
-    }
 }
 
 template<class Param>
 MupairProductionRhoInterpolant<Param>::~MupairProductionRhoInterpolant()
 {
-    for (std::vector<Interpolant*>::const_iterator iter = interpolant_.begin(); iter != interpolant_.end(); ++iter)
-    {
-        delete *iter;
-    }
-
-    interpolant_.clear();
 }
 
 template<class Param>
@@ -282,10 +276,10 @@ double MupairProductionRhoInterpolant<Param>::DifferentialCrossSection(double en
 }
 
 template<class Param>
-double MupairProductionRhoInterpolant<Param>::FunctionToBuildPhotoInterpolant(double energy, double v, int component)
+double MupairProductionRhoInterpolant<Param>::FunctionToBuildPhotoInterpolant(Param& param, double energy, double v, int component)
 {
-    this->component_index_                 = component;
-    Parametrization::IntegralLimits limits = this->GetIntegralLimits(energy);
+    param.SetCurrentComponent(component);
+    Parametrization::IntegralLimits limits = param.GetIntegralLimits(energy);
 
     if (limits.vUp == limits.vMax)
     {
@@ -294,7 +288,7 @@ double MupairProductionRhoInterpolant<Param>::FunctionToBuildPhotoInterpolant(do
 
     v = limits.vUp * std::exp(v * std::log(limits.vMax / limits.vUp));
 
-    return Param::DifferentialCrossSection(energy, v);
+    return param.DifferentialCrossSection(energy, v);
 }
 
 #undef MUPAIR_PARAM_INTEGRAL_DEC
@@ -76,6 +76,15 @@ public:
 
     virtual IntegralLimits GetIntegralLimits(double energy) = 0;
 
+    //! Integral limits of the given medium component, independent of the
+    //! current component. Parametrizations whose limits depend on the
+    //! component have to override this.
+    virtual IntegralLimits GetIntegralLimits(double energy, int component)
+    {
+        (void)component;
+        return GetIntegralLimits(energy);
+    }
+
     // ----------------------------------------------------------------- //
     // Getter
     // ----------------------------------------------------------------- //
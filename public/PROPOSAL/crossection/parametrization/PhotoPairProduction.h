@@ -76,7 +76,7 @@ namespace PROPOSAL {
     class PhotoPairTsai : public PhotoPairProduction
     {
     public:
-        typedef std::vector<Interpolant*> InterpolantVec;
+        typedef std::vector<std::shared_ptr<const Interpolant> > InterpolantVec;
 
         PhotoPairTsai(const ParticleDef&, std::shared_ptr<const Medium>, double multiplier);
         PhotoPairTsai(const PhotoPairTsai&);
@@ -129,7 +129,7 @@ template<class Param = PhotoAbramowiczLevinLevyMaor97>
 class PhotoQ2Interpolant : public Param
 {
 public:
-    typedef std::vector<Interpolant*> InterpolantVec;
+    typedef std::vector<std::shared_ptr<const Interpolant> > InterpolantVec;
 
 public:
     PhotoQ2Interpolant(const ParticleDef&,
@@ -156,7 +156,7 @@ public:
 
 protected:
     virtual bool compare(const Parametrization&) const;
-    double FunctionToBuildPhotoInterpolant(double energy, double v, int component);
+    static double FunctionToBuildPhotoInterpolant(Param&, double energy, double v, int component);
 
     InterpolantVec interpolant_;
 };
@@ -169,7 +169,7 @@ PhotoQ2Interpolant<Param>::PhotoQ2Interpolant(const ParticleDef& particle_def,
                                               const ShadowEffect& shadow_effect,
                                               InterpolationDef def)
     : Param(particle_def, medium, cuts, multiplier, shadow_effect)
-    , interpolant_(this->medium_->GetNumComponents(), NULL)
+    , interpolant_(this->medium_->GetNumComponents(), nullptr)
 {
     std::vector<Interpolant2DBuilder> builder2d(this->components_.size());
     Helper::InterpolantBuilderContainer builder_container2d(this->components_.size());
@@ -195,7 +195,13 @@ PhotoQ2Interpolant<Param>::PhotoQ2Interpolant(const ParticleDef& particle_def,
             .SetRationalY(false)
             .SetRelativeY(false)
             .SetLogSubst(false)
-            .SetFunction2D(std::bind(&PhotoQ2Interpolant::FunctionToBuildPhotoInterpolant, this, std::placeholders::_1, std::placeholders::_2, i));
+            .SetFunction2DFactory([this, i]() -> Interpolant2DBuilder::Function2D {
+                // every thread uses its own copy of the parametrization
+                std::shared_ptr<Param> param = std::make_shared<Param>(*this);
+                return [param, i](double energy, double v) {
+                    return PhotoQ2Interpolant::FunctionToBuildPhotoInterpolant(*param, energy, v, i);
+                };
+            });
 
         builder_container2d[i].first  = &builder2d[i];
         builder_container2d[i].second = &interpolant_[i];
@@ -207,25 +213,13 @@ PhotoQ2Interpolant<Param>::PhotoQ2Interpolant(const ParticleDef& particle_def,
 template<class Param>
 PhotoQ2Interpolant<Param>::PhotoQ2Interpolant(const PhotoQ2Interpolant& photo)
     : Param(photo)
-    , interpolant_()
+    , interpolant_(photo.interpolant_)
 {
-    interpolant_.resize(photo.interpolant_.size());
-
-    for (unsigned int i = 0; i < photo.interpolant_.size(); ++i)
-    {
-        interpolant_[i] = new Interpolant(*photo.interpolant_[i]);
-    }
 }
 
 template<class Param>
 PhotoQ2Interpolant<Param>::~PhotoQ2Interpolant()
 {
-    for (std::vector<Interpolant*>::const_iterator iter = interpolant_.begin(); iter != interpolant_.end(); ++iter)
-    {
-        delete *iter;
-    }
-
-    interpolant_.clear();
 }
 
 template<class Param>
@@ -261,10 +255,10 @@ double PhotoQ2Interpolant<Param>::DifferentialCrossSection(double energy, double
 }
 
 template<class Param>
-double PhotoQ2Interpolant<Param>::FunctionToBuildPhotoInterpolant(double energy, double v, int component)
+double PhotoQ2Interpolant<Param>::FunctionToBuildPhotoInterpolant(Param& param, double energy, double v, int component)
 {
-    this->component_index_                 = component;
-    Parametrization::IntegralLimits limits = this->GetIntegralLimits(energy);
+    param.SetCurrentComponent(component);
+    Parametrization::IntegralLimits limits = param.GetIntegralLimits(energy);
 
     if (limits.vUp == limits.vMax)
     {
@@ -273,7 +267,7 @@ double PhotoQ2Interpolant<Param>::FunctionToBuildPhotoInterpolant(double energy,
 
     v = limits.vUp * std::exp(v * std::log(limits.vMax / limits.vUp));
 
-    return Param::DifferentialCrossSection(energy, v);
+    return param.DifferentialCrossSection(energy, v);
 }
 
 #undef Q2_PHOTO_PARAM_INTEGRAL_DEC
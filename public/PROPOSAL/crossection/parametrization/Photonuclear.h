@@ -95,7 +95,7 @@ private:
     virtual bool compare(const RealPhoton&) const;
 
     static std::vector<double> x;
-    std::vector<Interpolant*> interpolant_;
+    std::vector<std::shared_ptr<const Interpolant> > interpolant_;
 
     static const std::string name_;
 };
@@ -204,6 +204,7 @@ public:
     virtual double DifferentialCrossSection(double energy, double v) = 0;
 
     virtual IntegralLimits GetIntegralLimits(double energy);
+    virtual IntegralLimits GetIntegralLimits(double energy, int component);
 
 protected:
     virtual bool compare(const Parametrization&) const;
@@ -75,7 +75,7 @@ namespace PROPOSAL {
 class WeakCooperSarkarMertsch : public WeakInteraction
 {
 public:
-        typedef std::vector<Interpolant*> InterpolantVec;
+        typedef std::vector<std::shared_ptr<const Interpolant> > InterpolantVec;
 
         WeakCooperSarkarMertsch(const ParticleDef&, std::shared_ptr<const Medium>, double multiplier);
         WeakCooperSarkarMertsch(const WeakCooperSarkarMertsch&);
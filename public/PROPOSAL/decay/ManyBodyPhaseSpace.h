@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <unordered_map>
 #include <functional>
 
@@ -202,7 +203,10 @@ private:
 
     static const std::string name_;
 
+    // The parameters are estimated lazily, the same decay table might be
+    // used by several threads at once.
     ParameterMap parameter_map_;
+    std::mutex parameter_map_mutex_;
 };
 
 class ManyBodyPhaseSpace::Builder
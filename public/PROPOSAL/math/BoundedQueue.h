@@ -0,0 +1,163 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace PROPOSAL {
+
+// ----------------------------------------------------------------------------
+/// @brief Lock free queue of fixed capacity for several producers and consumers
+///
+/// Every slot carries a sequence number telling whether it is ready to be
+/// written or read in the current round, so producers and consumers only
+/// synchronize on the slot they use (D. Vyukov's bounded MPMC queue).
+/// TryPush and TryPop never block, they fail if the queue is full or empty.
+/// The capacity is rounded up to a power of two.
+// ----------------------------------------------------------------------------
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity)
+        : mask_(RoundUpToPowerOfTwo(capacity) - 1)
+        , cells_(new Cell[mask_ + 1])
+        , enqueue_pos_(0)
+        , dequeue_pos_(0)
+    {
+        for (size_t i = 0; i <= mask_; ++i)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    size_t GetCapacity() const { return mask_ + 1; }
+
+    // ----------------------------------------------------------------------------
+    /// @brief Append the value if there is a free slot
+    ///
+    /// @return false if the queue is full, the value is not moved then
+    // ----------------------------------------------------------------------------
+    bool TryPush(T& value)
+    {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true)
+        {
+            cell = &cells_[pos & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0)
+            {
+                return false;
+            } else
+            {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ----------------------------------------------------------------------------
+    /// @brief Take the oldest value if there is one
+    ///
+    /// @return false if the queue is empty
+    // ----------------------------------------------------------------------------
+    bool TryPop(T& value)
+    {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true)
+        {
+            cell = &cells_[pos & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+
+            if (diff == 0)
+            {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0)
+            {
+                return false;
+            } else
+            {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->data);
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    BoundedQueue(const BoundedQueue&);            // Undefined & not allowed
+    BoundedQueue& operator=(const BoundedQueue&); // Undefined & not allowed
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t RoundUpToPowerOfTwo(size_t n)
+    {
+        size_t result = 2;
+        while (result < n)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    // producers and consumers work on different cache lines
+    char padding0_[64];
+    std::atomic<size_t> enqueue_pos_;
+    char padding1_[64];
+    std::atomic<size_t> dequeue_pos_;
+};
+
+} // namespace PROPOSAL
@@ -32,7 +32,13 @@
 #include <vector>
 // #include <cmath>
 
+#include <cstddef>
 #include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include "PROPOSAL/math/TableValues.h"
 
 namespace PROPOSAL {
 
@@ -63,14 +69,11 @@ private:
 
     int romberg_, rombergY_;
 
-    std::vector<double> iX_;
-    std::vector<double> iY_;
+    TableValues<double> iX_;
+    TableValues<double> iY_;
 
     std::vector<std::vector<double> > iY2_;
 
-    std::vector<double> c_;
-    std::vector<double> d_;
-
     int max_;
     double xmin_, xmax_, step_;
     bool rational_, relative_;
@@ -79,19 +82,48 @@ private:
     std::function<double(double, double)> function2d_;
     std::vector<Interpolant*> Interpolant_;
 
-    int row_, starti_;
+    int row_;
     bool rationalY_, relativeY_;
 
-    bool reverse_, self_, flag_; // Self is setted to true in constructor
+    bool self_, flag_; // Self is setted to true in constructor
     bool isLog_, logSubst_;
 
-    double precision_, worstX_;
-    double precision2_, worstX2_;
-    double precisionY_, worstY_;
+    // The precision bookkeeping is only done if fast_ is false. It is meant
+    // for debugging the tables and is not thread safe.
+    mutable double precision_, worstX_;
+    mutable double precision2_, worstX2_;
+    mutable double precisionY_, worstY_;
 
     bool fast_; // Is setted to true in constructor
 
-    double x_save_, y_save_; // Is setted to 1 and 0 in constructor
+    // Coefficients of the Newton polynomials through the sampling points of
+    // every window, empty if the Neville scheme is used
+    std::vector<double> polynomials_;
+    std::vector<bool> log_zero_windows_;
+
+    // Function values of all rows of a 2d table in one block, every row
+    // starting at a cache line, see BuildGrid. Empty if the rows are
+    // evaluated by their own Interpolate.
+    TableValues<double> grid_;
+
+    // Single precision copy of grid_, laid out the same way. If it is not
+    // empty, it replaces grid_ and the function values of the rows, see
+    // StoreFloats.
+    std::vector<float> floats_;
+
+    // Coefficients of the Chebyshev series of a 1d table from chebyshev_min_
+    // to xmax_, empty if the table is interpolated, see FitChebyshev
+    std::vector<double> chebyshev_;
+    double chebyshev_min_;
+
+    // Evaluation with the order and the flags of the table fixed at compile
+    // time, see SelectKernels. Null if the general code is used.
+    typedef double (*Kernel)(const Interpolant&, double);
+    typedef double (*NevilleKernel)(const double*, const double*, double, int, int);
+
+    Kernel kernel_;         // Interpolate(x) of a 1d table
+    NevilleKernel neville_; // Neville scheme of Interpolate
+    NevilleKernel inverse_; // Neville scheme of FindLimit
 
     //----------------------------------------------------------------------------//
     // Memberfunctions
@@ -99,11 +131,80 @@ private:
     /*!
      * interpolates f(x) based on the values iY[i]=f(iX[i]) in the romberg-vicinity of x
      *
-     * \param   x        position of the function
-     * \param   start    start position of the sampling points for interpolation
+     * All intermediate results are kept on the stack, so an Interpolant
+     * can be evaluated from several threads at once.
+     *
+     * \param   iX        sampling points
+     * \param   iY        function values at the sampling points
+     * \param   x         position of the function
+     * \param   start     start position of the sampling points for interpolation
+     * \param   starti    sampling point closest to x
+     * \param   romberg   order of interpolation
+     * \param   rational  interpolate with rational function
+     * \param   relative  save error relative to the function value
+     * \param   reverse   iY may hold log substituted values of zero
+     * \param   precision worst precision so far, updated if fast_ is false
+     * \param   worstX    position of the worst precision
      * \return  Interpolation result
      */
-    double Interpolate(double x, int start);
+    double Interpolate(const double* iX,
+                       const double* iY,
+                       double x,
+                       int start,
+                       int starti,
+                       int romberg,
+                       bool rational,
+                       bool relative,
+                       bool reverse,
+                       double& precision,
+                       double& worstX) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Neville scheme of a fast table with the order fixed at compile time.
+     *
+     * Does the same operations in the same order as the general Interpolate,
+     * so the results are identical.
+     *
+     * \tparam  Romberg   order of interpolation
+     * \tparam  Rational  interpolate with rational function
+     * \tparam  LogZero   iY may hold log substituted values of zero
+     * \param   iX        sampling points
+     * \param   iY        function values at the sampling points
+     * \param   x         position of the function
+     * \param   start     start position of the sampling points for interpolation
+     * \param   starti    sampling point closest to x
+     * \return  Interpolation result
+     */
+    template <int Romberg, bool Rational, bool LogZero>
+    static double Neville(const double* iX, const double* iY, double x, int start, int starti);
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Interpolate(x) of a fast 1d table with the order and the flags fixed at compile time.
+     *
+     * \param   interpolant  table, evaluated with the Neville scheme
+     * \param   x            position of the function
+     * \return  Interpolation result
+     */
+    template <int Romberg, bool Rational, bool IsLog, bool LogSubst>
+    static double InterpolateKernel(const Interpolant& interpolant, double x);
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Selects the kernels for the order and the flags of the table.
+     *
+     * Has to be called whenever they change. Tables of higher orders and
+     * tables tracking the precision are evaluated by the general code.
+     */
+
+    void SelectKernels();
+
+    template <int Romberg>
+    void SelectKernelsOfOrder();
 
     //----------------------------------------------------------------------------//
 
@@ -117,7 +218,7 @@ private:
      * \return   exp(x) OR 0;
      */
 
-    double Exp(double x);
+    static double Exp(double x);
 
     //----------------------------------------------------------------------------//
 
@@ -131,22 +232,222 @@ private:
      * \return   log(x) OR bigNumber;
      */
 
-    double Log(double x);
+    static double Log(double x);
+
+    //----------------------------------------------------------------------------//
+
+    double Get2dFunctionFixedY(double x); // TOMSASZ
 
     //----------------------------------------------------------------------------//
 
     /**
-     * Log it again.
+     * Finds the sampling points used to interpolate at x in the equidistant table.
      *
-     * \param    x
-     * \return   log(x) OR y_save;
+     * \param   x        position, already log substituted if isLog_
+     * \param   start    first sampling point used for the interpolation
+     * \param   starti   sampling point closest to x
      */
 
-    double Slog(double x);
+    void LocateEquidistant(double x, int& start, int& starti) const;
 
     //----------------------------------------------------------------------------//
 
-    double Get2dFunctionFixedY(double x); // TOMSASZ
+    /**
+     * Finds the sampling points used to interpolate at x by bisection of iX.
+     *
+     * \param   iX       sampling points, monotonic
+     * \param   x        position
+     * \param   romberg  order of interpolation
+     * \param   start    first sampling point used for the interpolation
+     * \param   starti   sampling point closest to x
+     */
+
+    void LocateArray(const TableValues<double>& iX, double x, int romberg, int& start, int& starti) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Checks if log substituted function values of zero are within the romberg-vicinity.
+     *
+     * \param   iY       function values starting at the first sampling point
+     * \param   romberg  order of interpolation
+     * \return  true if the values have to be interpolated without log substitution
+     */
+
+    bool HasLogZero(const double* iY, int romberg) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Evaluates the precomputed polynomial of a window.
+     *
+     * \param   x        position, already log substituted if isLog_
+     * \param   start    first sampling point of the window
+     * \return  Interpolation result
+     */
+
+    double EvaluatePolynomial(double x, int start) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Evaluates the Chebyshev series with the Clenshaw recurrence.
+     *
+     * \param   x        position in [chebyshev_min_, xmax_], already log substituted if isLog_
+     * \return  logarithm of the interpolation result
+     */
+
+    double EvaluateChebyshev(double x) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Computes the coefficients of the Chebyshev series through the logarithm
+     * of the table at the Chebyshev nodes.
+     *
+     * \param   terms    number of coefficients
+     * \return  coefficients
+     */
+
+    std::vector<double> ChebyshevCoefficients(int terms) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Compares the Chebyshev series with the table between all sampling points.
+     *
+     * \param   tolerance  maximal relative deviation
+     * \return  true if the series agrees with the table everywhere
+     */
+
+    bool ChebyshevAgrees(double tolerance) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Copies the function values of the rows of a 2d table into grid_.
+     *
+     * This is only done if all rows share their sampling points and settings
+     * and are evaluated with the Neville scheme, otherwise grid_ stays empty.
+     */
+
+    void BuildGrid();
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Returns true if the rows can be evaluated in a grid, see BuildGrid.
+     */
+
+    bool HasGridRows() const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Returns the function values of a row in grid_.
+     *
+     * \param   row      index of the row
+     * \return  first function value of the row
+     */
+
+    const double* GridRow(int row) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Returns the function values of a row in floats_.
+     *
+     * \param   row      index of the row
+     * \return  first function value of the row
+     */
+
+    const float* FloatRow(int row) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Lays out floats_ like grid_ with the function values of the rows of a table.
+     *
+     * \param   table    2d table with a grid in single or double precision
+     */
+
+    void BuildFloats(const Interpolant& table);
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Copies the function values of a window of a row in the grid.
+     *
+     * \param   row      index of the row
+     * \param   start    first sampling point of the window
+     * \param   romberg  number of sampling points
+     * \param   values   function values in double precision
+     */
+
+    void GridWindow(int row, int start, int romberg, double* values) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Returns true if the rows are evaluated in grid_ or floats_.
+     */
+
+    bool HasGrid() const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Saves a row of a 2d table, with its function values taken from floats_
+     * if the table is stored in single precision.
+     *
+     * \param   row      index of the row
+     * \param   out      ostream
+     * \param   binary_tables  save in binary format
+     * \return  true if successfull
+     */
+
+    bool SaveRow(int row, std::ostream& out, bool binary_tables) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Finds the sampling points of the rows in grid_ used to interpolate at x1.
+     *
+     * The rows share their sampling points, so this is done once for all rows.
+     * \param   x1       position in the rows
+     * \param   x        position, log substituted if the rows are
+     * \param   start    first sampling point used for the interpolation
+     * \param   starti   sampling point closest to x
+     */
+
+    void LocateGrid(double x1, double& x, int& start, int& starti) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Interpolates a row in grid_, same as Interpolant_[row]->Interpolate(x1).
+     *
+     * \param   row      index of the row
+     * \param   x        position found by LocateGrid
+     * \param   start    first sampling point found by LocateGrid
+     * \param   starti   sampling point found by LocateGrid
+     * \return  Interpolation result
+     */
+
+    double InterpolateGrid(int row, double x, int start, int starti) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Interpolates the rows first to last of a 2d table at x1.
+     *
+     * \param   x1       position in the rows
+     * \param   first    first row
+     * \param   last     last row
+     * \param   iY       interpolated values of the rows
+     */
+
+    void InterpolateRows(double x1, int first, int last, double* iY) const;
 
     //----------------------------------------------------------------------------//
 
@@ -283,6 +584,42 @@ public:
 
     //----------------------------------------------------------------------------//
 
+    /*!
+     * Constructor for the 2-dimensional functions building the rows of the
+     * table on several threads.
+     *
+     * Every thread evaluates its own instance of the function, created by
+     * function2d_factory, so the function itself does not have to be thread
+     * safe. The resulting table does not depend on the number of threads.
+     *
+     * \param   function2d_factory  creates an instance of the function which will be interpolated
+     * \param   n_threads           number of threads, 0 uses all hardware threads
+     *
+     * The other parameters are the same as for the constructor above.
+     */
+    Interpolant(int max1,
+                double x1min,
+                double x1max,
+                int max2,
+                double x2min,
+                double x2max,
+                std::function<std::function<double(double, double)>()> function2d_factory,
+                unsigned int n_threads,
+                int romberg1,
+                bool rational1,
+                bool relative1,
+                bool isLog1,
+                int romberg2,
+                bool rational2,
+                bool relative2,
+                bool isLog2,
+                int rombergY,
+                bool rationalY,
+                bool relativeY,
+                bool logSubst);
+
+    //----------------------------------------------------------------------------//
+
     /*!
      * Constructor for the 1-dimensional functions if the array already exists.
      *
@@ -349,7 +686,7 @@ public:
      * \return   interpolated value f(x)
      */
 
-    double Interpolate(double x);
+    double Interpolate(double x) const;
 
     //----------------------------------------------------------------------------//
 
@@ -361,7 +698,7 @@ public:
      * \return   interpolated value f(x1,x2)
      */
 
-    double Interpolate(double x1, double x2);
+    double Interpolate(double x1, double x2) const;
 
     //----------------------------------------------------------------------------//
 
@@ -372,7 +709,7 @@ public:
      * \return   interpolated value f(x)
      */
 
-    double InterpolateArray(double x);
+    double InterpolateArray(double x) const;
 
     //----------------------------------------------------------------------------//
 
@@ -384,7 +721,7 @@ public:
      * \return   interpolated value f(x1,x2)
      */
 
-    double InterpolateArray(double x1, double x2);
+    double InterpolateArray(double x1, double x2) const;
 
     //----------------------------------------------------------------------------//
 
@@ -397,7 +734,7 @@ public:
      * \return   interpolated value x(y);
      */
 
-    double FindLimit(double y);
+    double FindLimit(double y) const;
 
     //----------------------------------------------------------------------------//
 
@@ -411,7 +748,133 @@ public:
      * \return   interpolated value x(y);
      */
 
-    double FindLimit(double x1, double y);
+    double FindLimit(double x1, double y) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Interpolates f(x) for 1d function at n positions
+     *
+     * The results are the same as calling Interpolate(x) for every position.
+     * Fast tables with polynomial interpolation evaluate the positions in
+     * blocks, so the loops of the Neville scheme can be vectorized.
+     *
+     * \param    x    positions
+     * \param    out  interpolated values f(x)
+     * \param    n    number of positions
+     */
+
+    void Interpolate(const double* x, double* out, size_t n) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Interpolates f(x1,x2) for 2d function at n positions
+     *
+     * The results are the same as calling Interpolate(x1, x2) for every position.
+     *
+     * \param    x1   first coordinates
+     * \param    x2   second coordinates
+     * \param    out  interpolated values f(x1,x2)
+     * \param    n    number of positions
+     */
+
+    void Interpolate(const double* x1, const double* x2, double* out, size_t n) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Finds x: f(x)=y for n values of y, 1d initialization required
+     *
+     * The results are the same as calling FindLimit(y) for every value.
+     *
+     * \param    y    function values
+     * \param    out  interpolated values x(y)
+     * \param    n    number of values
+     */
+
+    void FindLimit(const double* y, double* out, size_t n) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Finds x: f(a,x)=y for n pairs of a and y, 2d initialization required
+     *
+     * The rows are different for every a, so the values are found one by one.
+     *
+     * \param    x1   values of a
+     * \param    y    function values
+     * \param    out  interpolated values x(y)
+     * \param    n    number of values
+     */
+
+    void FindLimit(const double* x1, const double* y, double* out, size_t n) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Precomputes the interpolating polynomials of the table
+     *
+     * For every window of romberg neighbouring sampling points the coefficients
+     * of the polynomial through them are stored. Interpolate then evaluates
+     * this polynomial with a Horner scheme instead of building the Neville
+     * tableau, which needs romberg times the memory of the function values.
+     * The polynomials are only used if they agree with the Neville scheme up
+     * to rounding errors in every window. Rational tables and tables tracking
+     * their precision keep the Neville scheme. The rows of 2d tables are
+     * precomputed, FindLimit is not affected. Tables stored in single
+     * precision keep the Neville scheme.
+     *
+     * \return  true if all windows use the polynomials
+     */
+
+    bool PrecomputePolynomials();
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Stores the function values of a 2d table in single precision
+     *
+     * The rows are still interpolated in double precision, only their
+     * function values are rounded, which halves the memory of the table.
+     * Every row is compared with the double precision table between all of
+     * its sampling points, and the table is only converted if the relative
+     * deviation stays below the tolerance everywhere. The deviation is taken
+     * relative to the largest function value of the window, log substituted
+     * values are compared after the substitution is undone.
+     * Only 2d tables whose rows are evaluated in one grid are converted, so
+     * neither 1d tables nor tables with polynomials are. The table files are
+     * written with the rounded values in double precision.
+     *
+     * \param   tolerance  maximal relative deviation
+     * \return  true if the table is stored in single precision
+     */
+
+    bool StoreFloats(double tolerance);
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Replaces a 1d table by a Chebyshev series
+     *
+     * The series is fitted to the logarithm of the table, in the log
+     * substituted x of the table, with an increasing number of terms until it
+     * agrees with the table at all sampling points and between them up to the
+     * relative tolerance. Interpolate then sums the series instead of
+     * searching the table, which takes a fixed number of multiplications and
+     * additions. Values which are not positive, e.g. below a threshold, are
+     * left to the table, so the series starts above the last of them, or
+     * further up, if the function rises too steeply there to be fitted. Outside
+     * of the range of the series and in FindLimit the table is still used.
+     * 2d tables and tables tracking their precision are not fitted. The
+     * tolerance can not be much smaller than the interpolation error of the
+     * table, which the series does not reproduce.
+     *
+     * \param   tolerance  maximal relative deviation from the table
+     * \return  true if the table is evaluated with the series
+     */
+
+    bool FitChebyshev(double tolerance);
 
     //----------------------------------------------------------------------------//
 
@@ -421,24 +884,56 @@ public:
     /**
      * Saves an interpolation table from file
      *
-     * \param    Path/ofstream
+     * \param    Path/ostream
      * \return   true if successfull
      */
 
-    bool Save(std::string Path, bool binary_tables = false);
-    bool Save(std::ofstream& out, bool binary_tables = false);
+    bool Save(std::string Path, bool binary_tables = false) const;
+    bool Save(std::ostream& out, bool binary_tables = false) const;
 
     //----------------------------------------------------------------------------//
 
     /**
      * Loads an interpolation table from file
      *
-     * \param    Path/ifstream
+     * \param    Path/istream
      * \return   true if successfull
      */
 
     bool Load(std::string Path, bool binary_tables = false);
-    bool Load(std::ifstream& in, bool binary_tables = false);
+    bool Load(std::istream& in, bool binary_tables = false);
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Appends the table to a block in the layout read by LoadMapped.
+     *
+     * The settings of the table are followed by its values, every part
+     * starting at a cache line relative to the beginning of the block. The
+     * function values of the rows of a 2d table are laid out like grid_.
+     *
+     * \param    block  its size has to be a multiple of a cache line
+     * \return   false for tables of rows which are 2d tables themselves
+     */
+
+    bool SaveMapped(std::string& block) const;
+
+    //----------------------------------------------------------------------------//
+
+    /**
+     * Loads a table saved by SaveMapped without copying its values.
+     *
+     * The values of the table and its rows become views into the block,
+     * which is kept alive by owner as long as they exist.
+     *
+     * \param    block  start of the block, aligned to a cache line
+     * \param    size   size of the block
+     * \param    offset position of the table in the block, moved behind it
+     * \param    owner  owner of the memory of the block
+     * \return   false if the table does not fit in the block
+     */
+
+    bool LoadMapped(const char* block, size_t size, size_t& offset, std::shared_ptr<const void> owner);
 
     //----------------------------------------------------------------------------//
     //----------------------------------------------------------------------------//
@@ -447,22 +942,21 @@ public:
     // Getter
     /**
      * Getter for Interpolant object.
+     * The function values of the rows are copied when the table is built or
+     * loaded, so the rows must not be modified afterwards. The rows of a
+     * table stored in single precision have no function values of their own.
      *
      * \return   Interpolant object;
      */
-    std::vector<Interpolant*> GetInterpolant() { return Interpolant_; }
+    std::vector<Interpolant*> GetInterpolant() const { return Interpolant_; }
 
     int GetRombergY() const { return rombergY_; }
 
     int GetRomberg() const { return romberg_; }
 
-    std::vector<double> GetIX() const { return iX_; }
-
-    std::vector<double> GetIY() const { return iY_; }
+    std::vector<double> GetIX() const { return iX_.ToVector(); }
 
-    std::vector<double> GetC() const { return c_; }
-
-    std::vector<double> GetD() const { return d_; }
+    std::vector<double> GetIY() const { return iY_.ToVector(); }
 
     int GetMax() const { return max_; }
 
@@ -478,8 +972,6 @@ public:
 
     int GetRow() const { return row_; }
 
-    int GetStarti() const { return starti_; }
-
     bool GetRationalY() const { return rationalY_; }
 
     bool GetRelativeY() const { return relativeY_; }
@@ -488,8 +980,6 @@ public:
 
     bool GetFlag() const { return flag_; }
 
-    bool GetReverse() const { return reverse_; }
-
     bool GetIsLog() const { return isLog_; }
 
     bool GetLogSubst() const { return logSubst_; }
@@ -506,9 +996,17 @@ public:
 
     bool GetFast() const { return fast_; }
 
-    double GetX_save() const { return x_save_; }
+    bool HasPolynomials() const;
+
+    bool HasFloats() const { return !floats_.empty(); }
+
+    int GetChebyshevTerms() const { return chebyshev_.size(); }
+
+    //! Number of sampling points, of all rows of a 2d table
+    int GetNodes() const;
 
-    double GetY_save() const { return y_save_; }
+    //! Memory of the table including its rows and precomputed coefficients in bytes
+    size_t GetMemorySize() const;
 
     //----------------------------------------------------------------------------//
     // Setter
@@ -517,8 +1015,6 @@ public:
     void SetRomberg(int romberg);
     void SetIX(const std::vector<double>& iX);
     void SetIY(const std::vector<double>& iY);
-    void SetC(const std::vector<double>& c);
-    void SetD(const std::vector<double>& d);
     void SetMax(int max);
     void SetXmin(double xmin);
     void SetXmax(double xmax);
@@ -526,12 +1022,10 @@ public:
     void SetRelative(bool relative);
     void SetRational(bool rational);
     void SetRow(int row);
-    void SetStarti(int starti);
     void SetRationalY(bool rationalY);
     void SetRelativeY(bool relativeY);
     void SetSelf(bool self);
     void SetFlag(bool flag);
-    void SetReverse(bool reverse);
     void SetIsLog(bool isLog);
     void SetLogSubst(bool logSubst);
     void SetPrecision(double precision);
@@ -540,8 +1034,6 @@ public:
     void SetWorstY(double worstY);
     void SetPrecisionY(double precisionY);
     void SetFast(bool fast);
-    void SetX_save(double x_save);
-    void SetY_save(double y_save);
     /*!
      * Destructor
      */
@@ -63,6 +63,38 @@ public:
     virtual ~InterpolantBuilder() {}
 
     virtual Interpolant* build() = 0;
+
+    // ----------------------------------------------------------------------------
+    /// @brief Whether build can run at the same time as other builds
+    ///
+    /// A thread safe builder does not share any state with other builders
+    /// and does not need any other table to be built before.
+    // ----------------------------------------------------------------------------
+    virtual bool IsThreadSafe() const { return false; }
+
+    // ----------------------------------------------------------------------------
+    /// @brief Number of threads build may use, 0 uses all hardware threads
+    ///
+    /// Ignored by builders which can only build their table sequentially.
+    // ----------------------------------------------------------------------------
+    virtual void SetNumberOfThreads(unsigned int) {}
+
+    // ----------------------------------------------------------------------------
+    /// @brief Relative interpolation error the number of nodes is chosen for
+    ///
+    /// If larger than zero, build estimates the error of the table between
+    /// the nodes and uses the smallest number of nodes reaching it. The
+    /// number of nodes set for the table is the upper limit.
+    /// Ignored by builders without a function to estimate the error.
+    // ----------------------------------------------------------------------------
+    virtual void SetTargetError(double) {}
+
+    // ----------------------------------------------------------------------------
+    /// @brief Estimated relative error of the last built table
+    ///
+    /// @return -1 if the error has not been estimated
+    // ----------------------------------------------------------------------------
+    virtual double GetError() const { return -1; }
 };
 
 // ----------------------------------------------------------------------------
@@ -156,8 +188,13 @@ public:
 
     Interpolant* build();
 
+    void SetTargetError(double val) { target_error = val; }
+    double GetError() const { return error; }
+
 private:
     Function1D function1d;
+    double target_error;
+    double error;
 
     int max;
     double xmin, xmax;
@@ -176,6 +213,7 @@ class Interpolant2DBuilder : public InterpolantBuilder
 {
 public:
     typedef std::function<double(double, double)> Function2D;
+    typedef std::function<Function2D()> Function2DFactory;
     static const Function2D default_function2d;
 
     // Constructor
@@ -189,6 +227,19 @@ public:
         return *this;
     }
 
+    // ----------------------------------------------------------------------------
+    /// @brief Set a factory creating independent instances of the function
+    ///
+    /// Used instead of the function set by SetFunction2D. Every thread gets
+    /// its own instance, so the rows of the table can be built in parallel
+    /// and the builder is thread safe.
+    // ----------------------------------------------------------------------------
+    Interpolant2DBuilder& SetFunction2DFactory(Function2DFactory val)
+    {
+        function2d_factory = val;
+        return *this;
+    }
+
     Interpolant2DBuilder& SetMax1(const int val)
     {
         max1 = val;
@@ -298,8 +349,19 @@ public:
 
     Interpolant* build();
 
+    bool IsThreadSafe() const { return function2d_factory != nullptr; }
+    void SetNumberOfThreads(unsigned int val) { n_threads = val; }
+    void SetTargetError(double val) { target_error = val; }
+    double GetError() const { return error; }
+
 private:
+    Interpolant* build(int nodes1, int nodes2);
+
     Function2D function2d;
+    Function2DFactory function2d_factory;
+    unsigned int n_threads;
+    double target_error;
+    double error;
 
     int max1;
     double x1min, x1max;
@@ -0,0 +1,69 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace PROPOSAL {
+
+// ----------------------------------------------------------------------------
+/// @brief Number of worker threads to use for a parallel loop
+///
+/// @param n_threads requested number of threads, 0 uses all hardware threads
+/// @param n_items number of items in the loop
+///
+/// @return number of workers, at least 1 and not more than n_items
+// ----------------------------------------------------------------------------
+unsigned int NumberOfWorkers(unsigned int n_threads, size_t n_items);
+
+// ----------------------------------------------------------------------------
+/// @brief Calls task(worker, item) for every item in [0, n_items)
+///
+/// Every worker starts with a contiguous block of the items. A worker which
+/// has finished its block steals the upper half of the remaining items of
+/// another worker, so items of very different cost are still spread evenly.
+/// The order in which the items are processed is not defined, the tasks have
+/// to write their results into a slot belonging to the item.
+///
+/// The worker index is in [0, n_workers) and can be used to address per
+/// worker state. With a single worker the items are processed in order in
+/// the calling thread. If a task throws, the remaining items are skipped and
+/// the first exception is rethrown in the calling thread.
+///
+/// @param n_items number of items
+/// @param n_workers number of worker threads, see NumberOfWorkers
+/// @param task function called with the worker index and the item index
+// ----------------------------------------------------------------------------
+void ParallelFor(size_t n_items,
+                 unsigned int n_workers,
+                 const std::function<void(unsigned int, size_t)>& task);
+
+} // namespace PROPOSAL
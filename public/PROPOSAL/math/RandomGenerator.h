@@ -33,6 +33,7 @@
 #include <random>
 #include <iostream>
 
+#include "PROPOSAL/math/RandomStream.h"
 
 #ifdef ICECUBE_PROJECT
 #include <phys-services/I3RandomService.h>
@@ -42,10 +43,34 @@ namespace PROPOSAL {
 
 // ----------------------------------------------------------------------------
 /// @brief Random number generator
+///
+/// By default all random numbers are drawn from one global generator.
+/// A RandomStream can be installed for the current thread with a
+/// StreamScope, then RandomDouble draws from this stream instead.
 // ----------------------------------------------------------------------------
 class RandomGenerator
 {
 public:
+    // ----------------------------------------------------------------------------
+    /// @brief Draw from the given stream in the current thread while in scope
+    ///
+    /// Scopes can be nested, the previous stream is restored on destruction.
+    /// If the stream is nullptr, the current one is kept.
+    // ----------------------------------------------------------------------------
+    class StreamScope
+    {
+    public:
+        explicit StreamScope(RandomStream* stream);
+        ~StreamScope();
+
+    private:
+        StreamScope(const StreamScope&);            // Undefined & not allowed
+        StreamScope& operator=(const StreamScope&); // Undefined & not allowed
+
+        RandomStream* previous_;
+    };
+
+
     static RandomGenerator& Get()
     {
         static RandomGenerator instance;
@@ -65,7 +90,8 @@ public:
     /// @brief Serialize the rng to a stream
     ///
     /// Useful for debuging to save a specific state.
-    /// Only supported for internal used rng from the standard libraries.
+    /// Only supported for internal used rng from the standard libraries
+    /// and for a RandomStream installed for the current thread.
     ///
     /// @param std::ostream
     // ----------------------------------------------------------------------------
@@ -75,12 +101,20 @@ public:
     /// @brief Deserialize the rng from a stream
     ///
     /// Useful for debuging to get back a specific state.
-    /// Only supported for internal used rng from the standard libraries.
+    /// Only supported for internal used rng from the standard libraries
+    /// and for a RandomStream installed for the current thread.
     ///
     /// @param std::ostream
     // ----------------------------------------------------------------------------
     void Deserialize(std::istream&);
 
+    // ----------------------------------------------------------------------------
+    /// @brief Stream installed for the current thread
+    ///
+    /// @return the stream or nullptr if the global generator is used
+    // ----------------------------------------------------------------------------
+    RandomStream* GetStream() const;
+
     /** @brief Set a custom random number generator
      *
      * Classes that contain other subclasses of MathModel should
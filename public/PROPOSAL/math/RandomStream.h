@@ -0,0 +1,138 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+
+namespace PROPOSAL {
+
+// ----------------------------------------------------------------------------
+/// @brief Stream of random numbers
+///
+/// Interface for random number streams which can be handed to the
+/// propagation, see PropagationContext. Unlike the global RandomGenerator,
+/// every stream has its own state, so several threads can draw from
+/// different streams without interfering with each other.
+// ----------------------------------------------------------------------------
+class RandomStream
+{
+public:
+    virtual ~RandomStream() {}
+
+    virtual RandomStream* clone() const = 0;
+
+    // ----------------------------------------------------------------------------
+    /// @brief Draw the next random number of the stream
+    ///
+    /// @return random number in (0, 1)
+    // ----------------------------------------------------------------------------
+    virtual double RandomDouble() = 0;
+
+    // ----------------------------------------------------------------------------
+    /// @brief Serialize the state of the stream
+    ///
+    /// @param std::ostream
+    // ----------------------------------------------------------------------------
+    virtual void Serialize(std::ostream&) const = 0;
+
+    // ----------------------------------------------------------------------------
+    /// @brief Restore the state of the stream written by Serialize
+    ///
+    /// @param std::istream
+    // ----------------------------------------------------------------------------
+    virtual void Deserialize(std::istream&) = 0;
+};
+
+// ----------------------------------------------------------------------------
+/// @brief Counter based random number stream
+///
+/// Uses the Philox4x32-10 generator of Salmon et al., "Parallel random
+/// numbers: as easy as 1, 2, 3", SC'11 (2011). The n-th random number of a
+/// stream is a pure function of the seed, the stream number and n.
+/// Therefore skipping ahead is O(1) and e.g. event i of a simulation can
+/// always draw from stream i, no matter which thread propagates it.
+// ----------------------------------------------------------------------------
+class PhiloxStream : public RandomStream
+{
+public:
+    PhiloxStream(uint64_t seed = 0, uint64_t stream = 0);
+    PhiloxStream(const PhiloxStream&);
+    virtual ~PhiloxStream();
+
+    RandomStream* clone() const { return new PhiloxStream(*this); }
+
+    bool operator==(const PhiloxStream&) const;
+    bool operator!=(const PhiloxStream&) const;
+
+    double RandomDouble();
+
+    // ----------------------------------------------------------------------------
+    /// @brief Skip the next n random numbers
+    // ----------------------------------------------------------------------------
+    void SkipAhead(uint64_t n);
+
+    // ----------------------------------------------------------------------------
+    /// @brief Go to the beginning of the given stream
+    // ----------------------------------------------------------------------------
+    void SetStream(uint64_t stream);
+    void SetSeed(uint64_t seed);
+
+    void Serialize(std::ostream&) const;
+    void Deserialize(std::istream&);
+
+    uint64_t GetSeed() const { return seed_; }
+    uint64_t GetStream() const { return stream_; }
+    uint64_t GetPosition() const { return position_; } //!< number of random numbers drawn
+
+    typedef std::array<uint32_t, 4> Counter;
+    typedef std::array<uint32_t, 2> Key;
+
+    // ----------------------------------------------------------------------------
+    /// @brief The Philox4x32-10 bijection
+    // ----------------------------------------------------------------------------
+    static Counter Philox4x32(Counter counter, Key key);
+
+private:
+    void Generate(uint64_t block);
+
+    uint64_t seed_;
+    uint64_t stream_;
+    uint64_t position_;
+
+    // Every block of the generator gives two random numbers.
+    // The last generated block is cached.
+    uint64_t cached_block_;
+    bool cache_valid_;
+    Counter cache_;
+};
+
+} // namespace PROPOSAL
@@ -0,0 +1,227 @@
+
+/******************************************************************************
+ *                                                                            *
+ * This file is part of the simulation tool PROPOSAL.                         *
+ *                                                                            *
+ * Copyright (C) 2017 TU Dortmund University, Department of Physics,          *
+ *                    Chair Experimental Physics 5b                           *
+ *                                                                            *
+ * This software may be modified and distributed under the terms of a         *
+ * modified GNU Lesser General Public Licence version 3 (LGPL),               *
+ * copied verbatim in the file "LICENSE".                                     *
+ *                                                                            *
+ * Modifcations to the LGPL License:                                          *
+ *                                                                            *
+ *      1. The user shall acknowledge the use of PROPOSAL by citing the       *
+ *         following reference:                                               *
+ *                                                                            *
+ *         J.H. Koehne et al.  Comput.Phys.Commun. 184 (2013) 2070-2090 DOI:  *
+ *         10.1016/j.cpc.2013.04.001                                          *
+ *                                                                            *
+ *      2. The user should report any bugs/errors or improvments to the       *
+ *         current maintainer of PROPOSAL or open an issue on the             *
+ *         GitHub webpage                                                     *
+ *                                                                            *
+ *         "https://github.com/tudo-astroparticlephysics/PROPOSAL"            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace PROPOSAL {
+
+// ----------------------------------------------------------------------------
+/// @brief Values of a table, either owned or a view into memory owned by others
+///
+/// Views are used for tables in memory mapped files, see
+/// Interpolant::LoadMapped, and for the rows of a grid, see Share. The owner
+/// keeps the memory alive as long as a view of it exists, copies of a view
+/// are views of the same memory.
+/// The values can only be read through a view. Functions changing them copy
+/// the values of a view first, so they are owned afterwards.
+// ----------------------------------------------------------------------------
+template <typename T>
+class TableValues
+{
+public:
+    TableValues()
+        : data_(nullptr)
+        , size_(0)
+        , shared_capacity_(0)
+    {
+    }
+
+    TableValues(const TableValues& values)
+        : owned_(values.owner_ ? std::vector<T>() : values.owned_)
+        , data_(values.data_)
+        , size_(values.size_)
+        , owner_(values.owner_)
+        , shared_capacity_(0)
+    {
+        Sync();
+    }
+
+    TableValues& operator=(const TableValues& values)
+    {
+        TableValues copy(values);
+        swap(copy);
+        return *this;
+    }
+
+    TableValues& operator=(const std::vector<T>& values)
+    {
+        owner_.reset();
+        shared_capacity_ = 0;
+        owned_ = values;
+        Sync();
+        return *this;
+    }
+
+    //! the values become a view of size values at data, kept alive by owner
+    void View(const T* data, size_t size, std::shared_ptr<const void> owner)
+    {
+        std::vector<T>().swap(owned_);
+        data_            = data;
+        size_            = size;
+        owner_           = owner;
+        shared_capacity_ = 0;
+    }
+
+    //! the values become a view of memory, which can be viewed by others
+    //! with the returned owner as well
+    std::shared_ptr<const void> Share()
+    {
+        if (!owner_)
+        {
+            std::shared_ptr<std::vector<T> > shared = std::make_shared<std::vector<T> >();
+            shared->swap(owned_);
+            data_            = shared->data();
+            owner_           = shared;
+            shared_capacity_ = shared->capacity();
+        }
+
+        return owner_;
+    }
+
+    bool IsView() const { return owner_ != nullptr; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T* data() const { return data_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+    const T& at(size_t i) const
+    {
+        if (i >= size_)
+        {
+            throw std::out_of_range("TableValues::at");
+        }
+        return data_[i];
+    }
+
+    //! allocated memory, views do not allocate any unless created by Share
+    size_t capacity() const { return owned_.capacity() + shared_capacity_; }
+
+    //! writable values, a view is copied first
+    T* Mutable()
+    {
+        MakeOwned();
+        return owned_.data();
+    }
+
+    //! keeps a view if the size does not change
+    void resize(size_t size)
+    {
+        if (size == size_)
+        {
+            return;
+        }
+
+        MakeOwned();
+        owned_.resize(size);
+        Sync();
+    }
+
+    void assign(size_t size, const T& value)
+    {
+        owner_.reset();
+        shared_capacity_ = 0;
+        owned_.assign(size, value);
+        Sync();
+    }
+
+    template <typename Iterator>
+    void assign(Iterator first, Iterator last)
+    {
+        std::vector<T> values(first, last);
+        owner_.reset();
+        shared_capacity_ = 0;
+        owned_.swap(values);
+        Sync();
+    }
+
+    //! releases the memory as well
+    void clear()
+    {
+        owner_.reset();
+        shared_capacity_ = 0;
+        std::vector<T>().swap(owned_);
+        Sync();
+    }
+
+    void swap(TableValues& values)
+    {
+        owned_.swap(values.owned_);
+        std::swap(data_, values.data_);
+        std::swap(size_, values.size_);
+        owner_.swap(values.owner_);
+        std::swap(shared_capacity_, values.shared_capacity_);
+    }
+
+    std::vector<T> ToVector() const { return std::vector<T>(begin(), end()); }
+
+    bool operator==(const TableValues& values) const
+    {
+        return size_ == values.size_ && std::equal(begin(), end(), values.begin());
+    }
+
+    bool operator!=(const TableValues& values) const { return !(*this == values); }
+
+private:
+    void MakeOwned()
+    {
+        if (owner_)
+        {
+            owned_.assign(begin(), end());
+            owner_.reset();
+            shared_capacity_ = 0;
+            Sync();
+        }
+    }
+
+    void Sync()
+    {
+        if (!owner_)
+        {
+            data_ = owned_.data();
+            size_ = owned_.size();
+        }
+    }
+
+    std::vector<T> owned_;
+    const T* data_;
+    size_t size_;
+    std::shared_ptr<const void> owner_;
+    size_t shared_capacity_; //!< memory allocated by Share
+};
+
+} // namespace PROPOSAL
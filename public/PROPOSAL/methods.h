@@ -33,6 +33,7 @@
 #include <vector>
 #include <functional>
 #include <map>
+#include <memory>
 #include "PROPOSAL/json.hpp"
 
 #define PROPOSAL_MAKE_HASHABLE(type, ...) \
@@ -76,12 +77,22 @@ struct InterpolationDef
         : order_of_interpolation(5)
         , path_to_tables(std::string())
         , path_to_tables_readonly(std::string())
+        , path_to_table_bundle(std::string()) // file with the tables of several files, see Helper::PackTables
         , max_node_energy(1e14) // upper energy bound for Interpolation (MeV)
         , nodes_cross_section(100) // number of interpolation in cross section
         , nodes_continous_randomization(200) // number of interpolation in continuous randomization
         , nodes_propagate(1000) // number of interpolation in propagate
         , do_binary_tables(true)
+        , do_mapped_tables(false) // memory map the table files instead of reading them
         , just_use_readonly_path(false)
+        , n_threads(0) // number of threads to build the tables, 0 uses all hardware threads
+        , do_polynomial_tables(false)
+        , do_inverse_tables(false)
+        , do_fused_rate_tables(false) // sample the interacting cross section from one set of cumulative rate tables
+        , do_lazy_tables(false) // build the tables of a sector on its first use instead of in its constructor
+        , target_interpolation_error(0) // relative error the number of nodes is chosen for, 0 uses the nodes_*
+        , float_table_tolerance(0) // relative deviation up to which 2d tables are stored in single precision, 0 never
+        , chebyshev_table_tolerance(0) // relative deviation up to which cross section tables are replaced by series, 0 never
     {
     }
 
@@ -90,14 +101,30 @@ struct InterpolationDef
     int order_of_interpolation;
     std::string path_to_tables;
     std::string path_to_tables_readonly;
+    std::string path_to_table_bundle; //!< read before the table paths, not part of the hash
     double max_node_energy;
     int nodes_cross_section;
     int nodes_continous_randomization;
     int nodes_propagate;
     bool do_binary_tables;
+    bool do_mapped_tables; //!< stored in files of their own suffix, not part of the hash
     bool just_use_readonly_path;
+    unsigned int n_threads; //!< does not change the tables, so it is not part of the hash
+    bool do_polynomial_tables; //!< evaluate with precomputed polynomials, not part of the hash either
+    bool do_inverse_tables;    //!< sample stochastic losses from inverted dNdx tables, not part of the hash either
+    bool do_fused_rate_tables; //!< derived from the dNdx tables in memory, not part of the hash either
+    bool do_lazy_tables;       //!< only changes when the tables are built, not part of the hash either
+    double target_interpolation_error; //!< if larger than zero, the nodes_* are the upper limits
+    double float_table_tolerance;      //!< does not change the table files, not part of the hash
+    double chebyshev_table_tolerance;  //!< neither does this one
 
     size_t GetHash() const;
+
+    //! the tables built with both definitions are the same, i.e. the hash
+    //! and the options changing the tables in memory are equal
+    bool HasSameTables(const InterpolationDef&) const;
+
+    friend std::ostream& operator<<(std::ostream&, InterpolationDef const&);
 };
 
 class Parametrization;
@@ -159,11 +186,192 @@ bool FileExist(const std::string path);
 // ----------------------------------------------------------------------------
 std::string Centered(int width, const std::string& str, char fill = '=');
 
-typedef std::vector<std::pair<InterpolantBuilder*, Interpolant**> > InterpolantBuilderContainer;
+// The tables are immutable once built and shared between all copies of
+// the objects holding them.
+typedef std::vector<std::pair<InterpolantBuilder*, std::shared_ptr<const Interpolant>*> > InterpolantBuilderContainer;
+
+// ----------------------------------------------------------------------------
+/// @brief Build all interpolants of the container
+///
+/// Tables of thread safe builders are built at the same time, the others
+/// are built afterwards in the order of the container, so they can use
+/// the tables built before.
+///
+/// @param InterpolantBuilderContainer:
+///        vector of builder, pointer to Interplant pairs
+/// @param n_threads: number of threads, 0 uses all hardware threads
+// ----------------------------------------------------------------------------
+void BuildInterpolants(InterpolantBuilderContainer&, unsigned int n_threads);
+
+// ----------------------------------------------------------------------------
+/// @brief Save the interpolants of the container to a file
+///
+/// The file starts with a header containing the version of the file format,
+/// the format and architecture of the tables, their hash, length and checksum,
+/// followed by the largest estimated error of the tables if the
+/// number of nodes was chosen adaptively. It is written to a temporary file first, which is then renamed,
+/// so other processes see either the complete file or no file at all.
+/// Mapped tables are stored in the layout used in memory, starting at the
+/// first cache line after the header, see Interpolant::SaveMapped.
+///
+/// @param filename
+/// @param InterpolantBuilderContainer: the interpolants have to be built
+/// @param binary_tables
+/// @param mapped_tables: overrides binary_tables
+/// @param hash: identifies the tables, see LoadOrBuildInterpolants
+///
+/// @return true if the file was written
+// ----------------------------------------------------------------------------
+bool SaveTables(const std::string& filename,
+                const InterpolantBuilderContainer&,
+                bool binary_tables,
+                bool mapped_tables = false,
+                size_t hash = 0);
+
+// ----------------------------------------------------------------------------
+/// @brief Load the interpolants of the container from a file
+///
+/// The header is checked before using the tables, so tables of another
+/// version, format, architecture or hash are rejected without reading them.
+/// The length and the checksum of the tables are checked as well.
+/// The file is mapped into memory, mapped tables use it without copying the
+/// values and keep it mapped as long as they exist. The other formats are
+/// read from the mapping in place.
+///
+/// @param filename
+/// @param InterpolantBuilderContainer
+/// @param binary_tables
+/// @param mapped_tables: overrides binary_tables
+/// @param hash: of the tables written by SaveTables, 0 accepts every hash
+///
+/// @return false if the file does not exist, does not match, is incomplete
+///         or corrupt. The container is not altered in this case.
+// ----------------------------------------------------------------------------
+bool LoadTables(const std::string& filename,
+                InterpolantBuilderContainer&,
+                bool binary_tables,
+                bool mapped_tables = false,
+                size_t hash = 0);
+
+// ----------------------------------------------------------------------------
+/// @brief Pack table files into one bundle
+///
+/// The bundle starts with an index of the file names, offsets and lengths of
+/// the tables, followed by the unchanged table files, each starting at a
+/// cache line. It is mapped into memory the first time one of its tables is
+/// needed and is written like the table files, see SaveTables.
+///
+/// @param bundle: file name of the bundle
+/// @param files: table files written by SaveTables
+///
+/// @return false if one of the files is not a valid table file or the bundle
+///         can not be written
+// ----------------------------------------------------------------------------
+bool PackTables(const std::string& bundle, const std::vector<std::string>& files);
+
+// ----------------------------------------------------------------------------
+/// @brief Load the interpolants of the container from a table file in a bundle
+///
+/// @param bundle: file name of the bundle
+/// @param table: name of the table file in the bundle, without the path
+/// @param InterpolantBuilderContainer
+/// @param binary_tables
+/// @param mapped_tables: overrides binary_tables
+/// @param hash: see LoadTables
+///
+/// @return false if the bundle does not contain the table or either of them
+///         is corrupt. The container is not altered in this case.
+// ----------------------------------------------------------------------------
+bool LoadTablesFromBundle(const std::string& bundle,
+                          const std::string& table,
+                          InterpolantBuilderContainer&,
+                          bool binary_tables,
+                          bool mapped_tables = false,
+                          size_t hash = 0);
+
+//! names of the table files in the bundle, empty if it can not be read
+std::vector<std::string> GetBundledTables(const std::string& bundle);
+
+// ----------------------------------------------------------------------------
+/// @brief Exclusive advisory lock of a file, released on destruction
+///
+/// The constructor blocks until no other process or thread holds the lock.
+/// The lock file is created if it does not exist and is removed again when
+/// the lock is released. The lock is also released if the process crashes,
+/// the file is left behind then and is reused by the next lock.
+// ----------------------------------------------------------------------------
+class FileLock
+{
+public:
+    FileLock(const std::string& path);
+    ~FileLock();
+
+    //! false if the lock file could not be created or locked
+    bool IsLocked() const { return fd_ >= 0; }
+
+private:
+    FileLock(const FileLock&);
+    FileLock& operator=(const FileLock&);
+
+    std::string path_;
+    int fd_;
+};
+
+// ----------------------------------------------------------------------------
+/// @brief Where the tables of one table file came from and what they cost
+///
+/// InitializeInterpolation records every table file it initializes, e.g. to
+/// report the tables built in advance for many jobs, see TakeTableRecords.
+// ----------------------------------------------------------------------------
+struct TableRecord
+{
+    TableRecord()
+        : seconds(0)
+        , file_size(0)
+        , memory_size(0)
+    {
+    }
+
+    std::string name;   //!< subject of the file name
+    std::string file;   //!< table file or bundle:table file, empty if not stored
+    std::string source; //!< bundle, read, built or memory (built and not stored)
+    double seconds;     //!< to read or build the tables and prepare them
+    size_t file_size;   //!< 0 for tables in a bundle or not stored
+    size_t memory_size; //!< see Interpolant::GetMemorySize
+};
+
+//! records of the tables initialized since the last call, in the order
+//! they were completed, at most the last 10000
+std::vector<TableRecord> TakeTableRecords();
+
+// ----------------------------------------------------------------------------
+/// @brief Read the tables from the table paths or build and save them
+///
+/// The file name is built from the name and the hashes of the
+/// parametrizations and the InterpolationDef. If the InterpolationDef has a
+/// table bundle, the file is looked up in the bundle first.
+/// The hash is stored in the header of the file as well, see SaveTables.
+/// Files of the writable path which can not be used are rebuilt.
+///
+/// @param name: subject of resulting file name
+/// @param InterpolantBuilderContainer:
+///        vector of builder, pointer to Interplant pairs
+/// @param std::vector: vector of parametrizations used to create
+///        the interpolation tables with
+///
+/// @return where the tables came from, without the time and memory
+// ----------------------------------------------------------------------------
+TableRecord LoadOrBuildInterpolants(const std::string& name,
+                                    InterpolantBuilderContainer&,
+                                    const std::vector<Parametrization*>&,
+                                    const InterpolationDef&);
 
 // ----------------------------------------------------------------------------
 /// @brief Helper for interpolation initialization
 ///
+/// Loads or builds the tables and prepares them for the evaluation chosen
+/// in the InterpolationDef.
+///
 /// @param name: subject of resulting file name
 /// @param InterpolantBuilderContainer:
 ///        vector of builder, pointer to Interplant pairs
@@ -175,6 +383,24 @@ void InitializeInterpolation(const std::string name,
                              const std::vector<Parametrization*>&,
                              const InterpolationDef);
 
+//! initializes tables with the given InterpolationDef, see InitializeInParallel
+typedef std::function<void(const InterpolationDef&)> TableTask;
+
+// ----------------------------------------------------------------------------
+/// @brief Run tasks initializing independent tables at the same time
+///
+/// The tasks must not use the tables of each other, e.g. the dNdx, dEdx and
+/// dE2dx tables of a cross section or the tables of the cross sections of
+/// a Utility. The threads of the InterpolationDef are shared among the
+/// tasks, every task gets a copy of it with its share, so tasks running
+/// tasks themselves do not use more threads. With a single thread, the
+/// tasks run in their order in the calling thread.
+///
+/// @param tasks
+/// @param InterpolationDef
+// ----------------------------------------------------------------------------
+void InitializeInParallel(const std::vector<TableTask>& tasks, const InterpolationDef&);
+
 // ----------------------------------------------------------------------------
 /// @brief Simple map structure where keys and values can be used for indexing
 // ----------------------------------------------------------------------------
@@ -49,6 +49,7 @@
 namespace PROPOSAL {
 
 class CrossSection;
+class Interpolant;
 
 struct InterpolationDef;
 
@@ -104,9 +105,16 @@ class Utility {
     std::pair<double, int> StochasticLoss(
         double particle_energy, double rnd1, double rnd2, double rnd3);
 
+    bool HasFusedRateTables() const { return !cumulative_rates_.empty(); }
+
    protected:
     Utility& operator=(const Utility&);  // Undefined & not allowed
 
+    // The rates are the dNdx of the components of all cross sections, see
+    // CrossSectionInterpolant::GetNumberOfRates. The k-th table holds the
+    // sum of the first k+1 rates, so the last one is the total dNdx.
+    void InitFusedRateTables(const InterpolationDef&);
+
     // --------------------------------------------------------------------- //
     // Protected members
     // --------------------------------------------------------------------- //
@@ -116,6 +124,9 @@ class Utility {
     EnergyCutSettings cut_settings_;
 
     std::vector<CrossSection*> crosssections_;
+
+    std::vector<std::pair<int, int> > rates_; //!< index of the cross section and of its rate
+    std::vector<std::shared_ptr<const Interpolant> > cumulative_rates_;
 };
 
 class UtilityDecorator {
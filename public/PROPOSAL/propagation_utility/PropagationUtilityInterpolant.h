@@ -78,6 +78,11 @@ public:
     virtual double Calculate(double ei, double ef, double rnd) = 0;
     virtual double GetUpperLimit(double ei, double rnd);
 
+    // Tables of the decorator, e.g. to audit them. The table of the
+    // derivative is null if it is not needed.
+    std::shared_ptr<const Interpolant> GetInterpolant() const { return interpolant_; }
+    std::shared_ptr<const Interpolant> GetInterpolantDiff() const { return interpolant_diff_; }
+
 protected:
     UtilityInterpolant& operator=(const UtilityInterpolant&); // Undefined & not allowed
 
@@ -86,9 +91,9 @@ protected:
     virtual double BuildInterpolant(double, UtilityIntegral&, Integral&)                                = 0;
     virtual void InitInterpolation(const std::string&, UtilityIntegral&, int number_of_sampling_points) = 0;
 
-    double stored_result_;
-    Interpolant* interpolant_;
-    Interpolant* interpolant_diff_;
+    // The tables are shared between copies of the decorator
+    std::shared_ptr<const Interpolant> interpolant_;
+    std::shared_ptr<const Interpolant> interpolant_diff_;
 
     InterpolationDef interpolation_def_;
 };
@@ -152,9 +157,6 @@ private:
     double BuildInterpolant(double, UtilityIntegral&, Integral&);
     void InitInterpolation(const std::string&, UtilityIntegral&, int number_of_sampling_points);
 
-    std::function<double(double)> f;
-    std::function<double(double)> df;
-
     double big_low_;
     double up_;
 };
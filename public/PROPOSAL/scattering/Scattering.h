@@ -36,6 +36,7 @@ namespace PROPOSAL {
 
 struct ParticleDef;
 class Utility;
+class RandomStream;
 
 struct Directions : std::enable_shared_from_this<Directions>
 {
@@ -62,6 +63,12 @@ public:
 
 
     Directions Scatter(double dr, double ei, double ef, const Vector3D& pos, const Vector3D& old_direction);
+    Directions Scatter(double dr,
+                        double ei,
+                        double ef,
+                        const Vector3D& pos,
+                        const Vector3D& old_direction,
+                        RandomStream& random_stream);
     Directions Scatter(double dr,
                         double ei,
                         double ef,
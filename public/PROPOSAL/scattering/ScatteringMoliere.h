@@ -70,26 +70,25 @@ private:
     double weight_ZZ_sum_;          // inverse of sum of mass weights of different components time Z^2
     int max_weight_index_;          // index of the maximium of mass weights of different components
 
-    // scattering parameters
-    double chiCSq_; // characteristic angle² in rad²
-    std::vector<double> B_;
-
     //----------------------------------------------------------------------------//
     //----------------------------------------------------------------------------//
 
-    double f1M(double x);
-    double f2M(double x);
+    double f1M(double x) const;
+    double f2M(double x) const;
 
-    double f(double theta);
+    // chiCSq is the characteristic angle² in rad², B the screening parameters
+    // of the components. Both are computed per call and passed on, so no
+    // state is written to the object.
+    double f(double theta, double chiCSq, const std::vector<double>& B) const;
 
-    double F1M(double x);
-    double F2M(double x);
+    double F1M(double x) const;
+    double F2M(double x) const;
 
-    double F(double theta);
+    double F(double theta, double chiCSq, const std::vector<double>& B) const;
 
     //----------------------------------------------------------------------------//
     //----------------------------------------------------------------------------//
 
-    double GetRandom(double pre_factor, double rnd);
+    double GetRandom(double pre_factor, double chiCSq, const std::vector<double>& B, double rnd) const;
 };
 } // namespace PROPOSAL
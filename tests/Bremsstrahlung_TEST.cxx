@@ -155,6 +155,48 @@ TEST(Assignment, Copyconstructor2)
     EXPECT_TRUE(Interpol_A == Interpol_B);
 }
 
+class BremsInterpolantTables : public BremsInterpolant
+{
+public:
+    BremsInterpolantTables(const Bremsstrahlung& param, InterpolationDef def)
+        : BremsInterpolant(param, def)
+    {
+    }
+
+    const Interpolant* GetdEdxTable() const { return dedx_interpolant_.get(); }
+    const Interpolant* GetdNdxTable(int component) const { return dndx_interpolant_2d_.at(component).get(); }
+};
+
+TEST(Assignment, SharedTables)
+{
+    ParticleDef particle_def = MuMinusDef::Get();
+    auto medium = std::make_shared<const Water>();
+    EnergyCutSettings ecuts;
+    double multiplier = 1.;
+    bool lpm          = true;
+
+    BremsKelnerKokoulinPetrukhin Brems_A(particle_def, medium, ecuts, multiplier, lpm);
+
+    InterpolationDef InterpolDef;
+    BremsInterpolantTables Interpol_A(Brems_A, InterpolDef);
+    BremsInterpolantTables Interpol_B(Interpol_A);
+    EXPECT_TRUE(Interpol_A == Interpol_B);
+    EXPECT_EQ(Interpol_A.GetdEdxTable(), Interpol_B.GetdEdxTable());
+    for (int i = 0; i < medium->GetNumComponents(); ++i)
+    {
+        EXPECT_EQ(Interpol_A.GetdNdxTable(i), Interpol_B.GetdNdxTable(i));
+    }
+
+    BremsInterpolantTables Interpol_C(Brems_A, InterpolDef);
+    EXPECT_TRUE(Interpol_A == Interpol_C);
+    EXPECT_NE(Interpol_A.GetdEdxTable(), Interpol_C.GetdEdxTable());
+
+    BremsElectronScreening Screening_A(EMinusDef::Get(), medium, ecuts, multiplier, lpm);
+    BremsElectronScreening Screening_B(Screening_A);
+    EXPECT_TRUE(Screening_A == Screening_B);
+    EXPECT_TRUE(Screening_A == BremsElectronScreening(EMinusDef::Get(), medium, ecuts, multiplier, lpm));
+}
+
 // in polymorphism an assignmant and swap operator doesn't make sense
 
 TEST(Bremsstrahlung, Test_of_dEdx)
@@ -549,6 +591,45 @@ TEST(Bremsstrahlung, Test_of_e_Interpolant)
     }
 }
 
+TEST(Bremsstrahlung, Test_of_e_Inverse_Tables)
+{
+    ParticleDef particle_def = MuMinusDef::Get();
+    auto medium = std::make_shared<const StandardRock>();
+    EnergyCutSettings ecuts(500, 0.05);
+
+    BremsKelnerKokoulinPetrukhin param(particle_def, medium, ecuts, 1., true);
+
+    InterpolationDef InterpolDef;
+    BremsIntegral Integral(param);
+    BremsInterpolant Interpol_A(param, InterpolDef);
+
+    InterpolDef.do_inverse_tables = true;
+    BremsInterpolant Interpol_B(param, InterpolDef);
+
+    RandomGenerator::Get().SetSeed(0);
+
+    // The inverse tables are as accurate as the dNdx tables they are built
+    // from, so they differ from the search in the dNdx tables less than the
+    // search differs from the integration.
+    double max_rel_diff = 0.;
+    double max_rel_diff_search = 0.;
+    for (int i = 0; i < 1000; ++i)
+    {
+        double energy = std::pow(10., 3. + 8. * RandomGenerator::Get().RandomDouble());
+        double rnd1   = RandomGenerator::Get().RandomDouble();
+        double rnd2   = RandomGenerator::Get().RandomDouble();
+
+        double loss_integral = Integral.CalculateStochasticLoss(energy, rnd1, rnd2);
+        double loss_search   = Interpol_A.CalculateStochasticLoss(energy, rnd1, rnd2);
+        double loss_inverse  = Interpol_B.CalculateStochasticLoss(energy, rnd1, rnd2);
+
+        max_rel_diff        = std::max(max_rel_diff, std::abs(loss_inverse - loss_search) / loss_search);
+        max_rel_diff_search = std::max(max_rel_diff_search, std::abs(loss_search - loss_integral) / loss_integral);
+    }
+    EXPECT_LT(max_rel_diff_search, 5e-3);
+    EXPECT_LT(max_rel_diff, max_rel_diff_search);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
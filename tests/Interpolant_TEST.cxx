@@ -1,7 +1,17 @@
 
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <thread>
 #include "gtest/gtest.h"
 #include "PROPOSAL/math/Interpolant.h"
+#include "PROPOSAL/math/InterpolantBuilder.h"
+#include "PROPOSAL/methods.h"
 
 using namespace PROPOSAL;
 
@@ -159,7 +169,7 @@ TEST(Comparison, Comparison_not_equal)
                                      true);
 
     EXPECT_TRUE(A != *B);
-    EXPECT_TRUE(*B != *C);
+    EXPECT_TRUE(*B == *C); // evaluating does not alter the interpolant
     EXPECT_TRUE(*D != *E);
 }
 
@@ -805,6 +815,910 @@ TEST(_2D_Interpol, All_On)
     delete Pol2;
 }
 
+TEST(Threading, Concurrent_Evaluation)
+{
+    Interpolant Pol1(max, xmin, xmax, X2, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
+    Interpolant Pol2(max,
+                     xmin,
+                     xmax,
+                     max2,
+                     x2min,
+                     x2max,
+                     X_YY,
+                     romberg,
+                     rational,
+                     relative,
+                     isLog,
+                     romberg2,
+                     rational2,
+                     relative2,
+                     isLog2,
+                     rombergY,
+                     rationalY,
+                     relativeY,
+                     true);
+
+    const int n_threads = 4;
+    const int n_points  = 1000;
+
+    std::vector<double> expected(4 * n_points);
+    for (int i = 0; i < n_points; ++i)
+    {
+        double x1 = xmin + (xmax - xmin) * i / n_points;
+        double x2 = x2min + (x2max - x2min) * i / n_points;
+
+        expected[4 * i]     = Pol1.Interpolate(x1);
+        expected[4 * i + 1] = Pol1.FindLimit(X2(x1));
+        expected[4 * i + 2] = Pol2.Interpolate(x1, x2);
+        expected[4 * i + 3] = Pol2.FindLimit(x1, X_YY(x1, x2));
+    }
+
+    std::vector<std::vector<double> > results(n_threads, std::vector<double>(4 * n_points));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            // half of the threads walk through the points backwards
+            for (int k = 0; k < n_points; ++k)
+            {
+                int i     = (t % 2 == 0) ? k : n_points - 1 - k;
+                double x1 = xmin + (xmax - xmin) * i / n_points;
+                double x2 = x2min + (x2max - x2min) * i / n_points;
+
+                results[t][4 * i]     = Pol1.Interpolate(x1);
+                results[t][4 * i + 1] = Pol1.FindLimit(X2(x1));
+                results[t][4 * i + 2] = Pol2.Interpolate(x1, x2);
+                results[t][4 * i + 3] = Pol2.FindLimit(x1, X_YY(x1, x2));
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int t = 0; t < n_threads; ++t)
+    {
+        for (int i = 0; i < 4 * n_points; ++i)
+        {
+            EXPECT_EQ(results[t][i], expected[i]);
+        }
+    }
+}
+
+TEST(Batch, Same_As_Single)
+{
+    // zero below x = 5 to check the log substitution of zeros
+    auto step = [](double x) { return x < 5 ? 0. : X2(x); };
+
+    std::vector<Interpolant> pols1;
+    pols1.emplace_back(max, xmin, xmax, X2, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
+    pols1.emplace_back(max, xmin, xmax, X2, romberg, rational, relative, !isLog, rombergY, rationalY, relativeY, !logSubst);
+    pols1.emplace_back(max, xmin, xmax, X2, romberg, !rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
+    pols1.emplace_back(max, xmin, xmax, step, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, !logSubst);
+
+    // includes the sampling points themselves and positions outside of the table
+    const int n_points = 1001;
+
+    std::vector<double> x(n_points), y(n_points), out(n_points);
+    for (auto& pol : pols1)
+    {
+        for (int i = 0; i < n_points; ++i)
+        {
+            x[i] = xmin - 1 + (xmax - xmin + 2) * i / (n_points - 1);
+            y[i] = X2(x[i]);
+        }
+
+        pol.Interpolate(x.data(), out.data(), n_points);
+        for (int i = 0; i < n_points; ++i)
+        {
+            EXPECT_EQ(out[i], pol.Interpolate(x[i]));
+        }
+
+        pol.FindLimit(y.data(), out.data(), n_points);
+        for (int i = 0; i < n_points; ++i)
+        {
+            EXPECT_EQ(out[i], pol.FindLimit(y[i]));
+        }
+    }
+
+    std::vector<Interpolant> pols2;
+    pols2.emplace_back(max, xmin, xmax, max2, x2min, x2max, X_YY, romberg, rational, relative, isLog, romberg2,
+                       rational2, relative2, isLog2, rombergY, rationalY, relativeY, logSubst);
+    pols2.emplace_back(max, xmin, xmax, max2, x2min, x2max, X_YY, romberg, rational, relative, isLog, romberg2,
+                       rational2, relative2, !isLog2, rombergY, rationalY, relativeY, !logSubst);
+    pols2.emplace_back(max, xmin, xmax, max2, x2min, x2max, X_YY, romberg, rational, relative, isLog, romberg2,
+                       !rational2, relative2, isLog2, rombergY, rationalY, relativeY, logSubst);
+
+    std::vector<double> x2(n_points);
+    for (auto& pol : pols2)
+    {
+        for (int i = 0; i < n_points; ++i)
+        {
+            x[i]  = xmin + (xmax - xmin) * i / (n_points - 1);
+            x2[i] = x2min - 1 + (x2max - x2min + 2) * ((7 * i) % n_points) / (n_points - 1);
+            y[i]  = X_YY(x[i], x2[i]);
+        }
+
+        pol.Interpolate(x.data(), x2.data(), out.data(), n_points);
+        for (int i = 0; i < n_points; ++i)
+        {
+            EXPECT_EQ(out[i], pol.Interpolate(x[i], x2[i]));
+        }
+
+        pol.FindLimit(x.data(), y.data(), out.data(), n_points);
+        for (int i = 0; i < n_points; ++i)
+        {
+            EXPECT_EQ(out[i], pol.FindLimit(x[i], y[i]));
+        }
+    }
+}
+
+TEST(Grid, Same_As_Rows)
+{
+    // zero for x1 < x2 to check the log substitution of zeros
+    auto step = [](double x1, double x2) { return x1 < x2 ? 0. : X_YY(x1, x2); };
+
+    std::vector<Interpolant> pols;
+    pols.emplace_back(max, xmin, xmax, max2, x2min, x2max, X_YY, romberg, rational, relative, isLog, romberg2,
+                      rational2, relative2, isLog2, rombergY, rationalY, relativeY, logSubst);
+    pols.emplace_back(max, xmin, xmax, max2, x2min, x2max, X_YY, romberg, rational, relative, !isLog, romberg2,
+                      rational2, relative2, isLog2, rombergY, rationalY, relativeY, !logSubst);
+    pols.emplace_back(max, xmin, xmax, max2, x2min, x2max, step, romberg, rational, relative, isLog, romberg2,
+                      rational2, relative2, isLog2, rombergY, rationalY, relativeY, !logSubst);
+    pols.emplace_back(max, xmin, xmax, max2, x2min, x2max, X_YY, romberg, !rational, relative, isLog, romberg2,
+                      rational2, relative2, isLog2, rombergY, rationalY, relativeY, logSubst);
+
+    const int n_points = 1001;
+
+    for (auto& pol : pols)
+    {
+        std::vector<Interpolant*> rows = pol.GetInterpolant();
+        std::vector<double> x2 = pol.GetIX();
+        Interpolant copy = pol;
+
+        // the values of the rows are views into the grid, they are only kept once
+        size_t row_bytes = 0;
+        for (auto row : rows)
+        {
+            row_bytes += row->GetMemorySize();
+        }
+        EXPECT_LT(row_bytes, rows.size() * (sizeof(Interpolant) + (max + max / 2) * sizeof(double)));
+
+        // includes the sampling points themselves and positions outside of the table
+        for (int i = 0; i < n_points; ++i)
+        {
+            double x1 = xmin - 1 + (xmax - xmin + 2) * i / (n_points - 1);
+
+            // at the sampling points of x2 the rows are returned as they are
+            for (int j = 0; j < max2; j += 7)
+            {
+                double expected = rows[j]->Interpolate(x1);
+
+                if (pol.GetLogSubst())
+                {
+                    expected = expected > -299 ? std::exp(expected) : 0;
+                }
+
+                EXPECT_EQ(pol.Interpolate(x1, x2[j]), expected);
+            }
+
+            double x2_i = x2min - 1 + (x2max - x2min + 2) * ((7 * i) % n_points) / (n_points - 1);
+
+            EXPECT_EQ(copy.Interpolate(x1, x2_i), pol.Interpolate(x1, x2_i));
+            EXPECT_EQ(copy.FindLimit(x1, X_YY(x1, x2_i)), pol.FindLimit(x1, X_YY(x1, x2_i)));
+        }
+    }
+}
+
+TEST(Floats, Tolerance)
+{
+    // zero for x1 < x2 to check the log substitution of zeros
+    auto step = [](double x1, double x2) { return x1 < x2 ? 0. : X_YY(x1, x2); };
+
+    std::vector<Interpolant> pols;
+    pols.emplace_back(max, xmin, xmax, max2, x2min, x2max, X_YY, romberg, rational, relative, isLog, romberg2,
+                      rational2, relative2, isLog2, rombergY, rationalY, relativeY, !logSubst);
+    pols.emplace_back(max, xmin, xmax, max2, x2min, x2max, X_YY, romberg, rational, relative, !isLog, romberg2,
+                      rational2, relative2, !isLog2, rombergY, rationalY, relativeY, logSubst);
+    pols.emplace_back(max, xmin, xmax, max2, x2min, x2max, step, romberg, rational, relative, isLog, romberg2,
+                      rational2, relative2, isLog2, rombergY, rationalY, relativeY, !logSubst);
+
+    const int n_points = 501;
+    const double tolerance = 1e-5;
+
+    for (size_t p = 0; p < pols.size(); ++p)
+    {
+        Interpolant& pol   = pols[p];
+        Interpolant single = pol;
+
+        // rounding to single precision can not be as precise as this
+        EXPECT_FALSE(single.StoreFloats(1e-12));
+        EXPECT_FALSE(single.HasFloats());
+        EXPECT_TRUE(single == pol);
+
+        ASSERT_TRUE(single.StoreFloats(tolerance));
+        EXPECT_TRUE(single.HasFloats());
+        EXPECT_FALSE(single == pol);
+        EXPECT_FALSE(single.PrecomputePolynomials());
+
+        Interpolant copy = single;
+        EXPECT_TRUE(copy == single);
+
+        std::stringstream file;
+        ASSERT_TRUE(single.Save(file, true));
+
+        Interpolant loaded;
+        ASSERT_TRUE(loaded.Load(file, true));
+        EXPECT_FALSE(loaded.HasFloats());
+
+        for (int i = 0; i < n_points; ++i)
+        {
+            double x1 = xmin + (xmax - xmin) * i / (n_points - 1);
+            double x2 = x2min + (x2max - x2min) * ((7 * i) % n_points) / (n_points - 1);
+            double y  = pol.Interpolate(x1, x2);
+
+            // the deviation of the rows is amplified by the interpolation in x2
+            EXPECT_NEAR(single.Interpolate(x1, x2), y, 10 * tolerance * std::abs(y));
+            // the tables of the step are not invertible for x1 < x2
+            if (p < 2)
+            {
+                double limit = pol.FindLimit(x1, X_YY(x1, x2));
+
+                EXPECT_NEAR(single.FindLimit(x1, X_YY(x1, x2)), limit, 10 * tolerance * limit);
+            }
+
+            // the copy and the saved table hold the same rounded values
+            EXPECT_EQ(copy.Interpolate(x1, x2), single.Interpolate(x1, x2));
+            EXPECT_EQ(loaded.Interpolate(x1, x2), single.Interpolate(x1, x2));
+            EXPECT_EQ(copy.FindLimit(x1, X_YY(x1, x2)), single.FindLimit(x1, X_YY(x1, x2)));
+        }
+    }
+
+    // only the rows of 2d tables are stored in single precision
+    Interpolant pol1D(max, xmin, xmax, X2, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
+    EXPECT_FALSE(pol1D.StoreFloats(tolerance));
+}
+
+TEST(Chebyshev, Tolerance)
+{
+    auto step = [](double x) { return x < 5 ? 0. : X2(x); };
+
+    const int n_points = 1001;
+
+    // Without the log substitution the table itself is not as precise, as
+    // the values grow exponentially. The series does not reproduce the
+    // interpolation error of the table, so it can not be compared as tightly.
+    for (int flags = 0; flags < 3; ++flags)
+    {
+        bool log_on   = flags & 1;
+        bool subst_on = flags < 2;
+
+        Interpolant table(max, xmin, xmax, X2, romberg, rational, relative, log_on, rombergY, rationalY, relativeY, subst_on);
+        Interpolant series = table;
+
+        double tolerance = subst_on ? 1e-6 : 1e-4;
+
+        ASSERT_TRUE(series.FitChebyshev(tolerance));
+        EXPECT_GT(series.GetChebyshevTerms(), 0);
+        EXPECT_LT(series.GetChebyshevTerms(), max);
+
+        Interpolant copy = series;
+
+        // outside of the range the table is extrapolated as before
+        for (int i = 0; i < n_points; ++i)
+        {
+            double x        = xmin - 1 + (xmax - xmin + 2) * i / (n_points - 1);
+            double expected = table.Interpolate(x);
+
+            if (x < xmin || x > xmax)
+            {
+                EXPECT_EQ(series.Interpolate(x), expected);
+            } else
+            {
+                EXPECT_NEAR(series.Interpolate(x), expected, 2 * tolerance * std::abs(expected));
+            }
+
+            EXPECT_EQ(copy.Interpolate(x), series.Interpolate(x));
+        }
+
+        // changing the table discards the series
+        series.SetIY(table.GetIY());
+        EXPECT_EQ(series.GetChebyshevTerms(), 0);
+    }
+
+    const double tolerance = 1e-6;
+
+    // the zeros below the threshold are left to the table
+    Interpolant threshold(max, xmin, xmax, step, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, !logSubst);
+    Interpolant series = threshold;
+
+    ASSERT_TRUE(series.FitChebyshev(tolerance));
+
+    for (int i = 0; i < n_points; ++i)
+    {
+        double x        = xmin + (xmax - xmin) * i / (n_points - 1);
+        double expected = threshold.Interpolate(x);
+
+        if (x < 5)
+        {
+            EXPECT_EQ(series.Interpolate(x), expected);
+        } else if (x > 6)
+        {
+            EXPECT_NEAR(series.Interpolate(x), expected, 2 * tolerance * std::abs(expected));
+        }
+    }
+
+    // unless they leave too few sampling points
+    auto cutoff = [](double x) { return x > xmax - 0.5 ? 0. : X2(x); };
+
+    Interpolant end(max, xmin, xmax, cutoff, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, !logSubst);
+    EXPECT_FALSE(end.FitChebyshev(tolerance));
+    EXPECT_EQ(end.GetChebyshevTerms(), 0);
+
+    // neither a precision the table itself can not reach
+    Interpolant table(max, xmin, xmax, X2, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
+    EXPECT_FALSE(table.FitChebyshev(1e-17));
+
+    Interpolant pol2D(max, xmin, xmax, max2, x2min, x2max, X_YY, romberg, rational, relative, isLog, romberg2,
+                      rational2, relative2, isLog2, rombergY, rationalY, relativeY, logSubst);
+    EXPECT_FALSE(pol2D.FitChebyshev(tolerance));
+}
+
+TEST(Kernels, Same_As_General)
+{
+    auto step = [](double x) { return x < 5 ? 0. : X2(x); };
+
+    // the values of tables which are not self are not log substituted back
+    // and are evaluated by the general code
+    auto exp_cut = [](double y) { return y <= -299 ? 0. : std::exp(y); };
+
+    const int n_points = 501;
+
+    for (int order : {1, 2, 3, 5, 8, 9})
+    {
+        for (int flags = 0; flags < 8; ++flags)
+        {
+            bool rational_on = flags & 1;
+            bool log_on      = flags & 2;
+            bool subst_on    = flags & 4;
+
+            for (auto function : {std::function<double(double)>(X2), std::function<double(double)>(step)})
+            {
+                Interpolant kernel(
+                    max, xmin, xmax, function, order, rational_on, relative, log_on, rombergY, rationalY, relativeY, subst_on);
+                Interpolant general = kernel;
+                general.SetSelf(false);
+
+                for (int i = 0; i < n_points; ++i)
+                {
+                    double x        = xmin - 1 + (xmax - xmin + 2) * i / (n_points - 1);
+                    double expected = general.Interpolate(x);
+
+                    EXPECT_EQ(kernel.Interpolate(x), subst_on ? exp_cut(expected) : expected);
+                }
+            }
+        }
+    }
+}
+
+TEST(Polynomials, Same_As_Neville)
+{
+    auto step = [](double x) { return x < 5 ? 0. : X2(x); };
+
+    std::vector<Interpolant> pols1;
+    pols1.emplace_back(max, xmin, xmax, X2, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
+    pols1.emplace_back(max, xmin, xmax, X2, romberg, rational, relative, !isLog, rombergY, rationalY, relativeY, !logSubst);
+    pols1.emplace_back(max, xmin, xmax, X2, 4, rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
+    pols1.emplace_back(max, xmin, xmax, step, romberg, rational, relative, isLog, rombergY, rationalY, relativeY, !logSubst);
+
+    const int n_points = 1001;
+
+    for (auto& neville : pols1)
+    {
+        Interpolant pol = neville;
+        EXPECT_TRUE(pol.PrecomputePolynomials());
+        EXPECT_TRUE(pol.HasPolynomials());
+        EXPECT_FALSE(neville.HasPolynomials());
+
+        Interpolant copy = pol;
+        EXPECT_TRUE(copy.HasPolynomials());
+
+        // includes the sampling points themselves and positions outside of the table
+        for (int i = 0; i < n_points; ++i)
+        {
+            double x        = xmin - 1 + (xmax - xmin + 2) * i / (n_points - 1);
+            double expected = neville.Interpolate(x);
+
+            EXPECT_NEAR(pol.Interpolate(x), expected, 1e-10 * std::abs(expected));
+            EXPECT_EQ(copy.Interpolate(x), pol.Interpolate(x));
+            EXPECT_EQ(pol.FindLimit(X2(x)), neville.FindLimit(X2(x)));
+        }
+    }
+
+    Interpolant neville2(max, xmin, xmax, max2, x2min, x2max, X_YY, romberg, rational, relative, isLog, romberg2,
+                         rational2, relative2, isLog2, rombergY, rationalY, relativeY, !logSubst);
+    Interpolant pol2 = neville2;
+    EXPECT_TRUE(pol2.PrecomputePolynomials());
+    EXPECT_TRUE(pol2.HasPolynomials());
+
+    for (int i = 0; i < n_points; ++i)
+    {
+        double x1       = xmin + (xmax - xmin) * i / (n_points - 1);
+        double x2       = x2min + (x2max - x2min) * ((7 * i) % n_points) / (n_points - 1);
+        double expected = neville2.Interpolate(x1, x2);
+
+        EXPECT_NEAR(pol2.Interpolate(x1, x2), expected, 1e-10 * std::abs(expected));
+    }
+
+    // rational tables keep the Neville scheme
+    Interpolant rational1(max, xmin, xmax, X2, romberg, !rational, relative, isLog, rombergY, rationalY, relativeY, logSubst);
+    EXPECT_FALSE(rational1.PrecomputePolynomials());
+    EXPECT_FALSE(rational1.HasPolynomials());
+}
+
+TEST(Threading, Parallel_Construction)
+{
+    Interpolant Pol2(max,
+                     xmin,
+                     xmax,
+                     max2,
+                     x2min,
+                     x2max,
+                     X_YY,
+                     romberg,
+                     rational,
+                     relative,
+                     isLog,
+                     romberg2,
+                     rational2,
+                     relative2,
+                     isLog2,
+                     rombergY,
+                     rationalY,
+                     relativeY,
+                     logSubst);
+
+    // every instance of the function may only be called from one thread
+    std::atomic<int> n_instances(0);
+    std::atomic<bool> shared_instance(false);
+    auto factory = [&]() -> std::function<double(double, double)> {
+        ++n_instances;
+        std::shared_ptr<std::thread::id> owner = std::make_shared<std::thread::id>();
+        return [&shared_instance, owner](double x, double y) {
+            if (*owner == std::thread::id())
+                *owner = std::this_thread::get_id();
+            else if (*owner != std::this_thread::get_id())
+                shared_instance = true;
+            return X_YY(x, y);
+        };
+    };
+
+    for (unsigned int n_threads = 1; n_threads <= 4; ++n_threads)
+    {
+        n_instances = 0;
+        Interpolant Parallel(max,
+                             xmin,
+                             xmax,
+                             max2,
+                             x2min,
+                             x2max,
+                             factory,
+                             n_threads,
+                             romberg,
+                             rational,
+                             relative,
+                             isLog,
+                             romberg2,
+                             rational2,
+                             relative2,
+                             isLog2,
+                             rombergY,
+                             rationalY,
+                             relativeY,
+                             logSubst);
+
+        EXPECT_EQ(n_instances, static_cast<int>(n_threads));
+        EXPECT_FALSE(shared_instance);
+        EXPECT_TRUE(Pol2 == Parallel);
+    }
+}
+
+TEST(Adaptive, Target_Error)
+{
+    auto function1d = [](double x) { return std::log(1. + x) * std::sqrt(x); };
+    auto function2d = [](double x, double y) { return std::log(1. + x) * std::sqrt(y); };
+    double target   = 1e-6;
+
+    Interpolant1DBuilder builder1d;
+    builder1d.SetMax(1000).SetXMin(1).SetXMax(1e4).SetRomberg(romberg).SetIsLog(true).SetFunction1D(function1d);
+    EXPECT_EQ(builder1d.GetError(), -1);
+
+    builder1d.SetTargetError(target);
+    std::unique_ptr<Interpolant> table1d(builder1d.build());
+
+    EXPECT_LT(table1d->GetMax(), 1000);
+    EXPECT_GE(builder1d.GetError(), 0);
+    EXPECT_LE(builder1d.GetError(), target);
+
+    Interpolant2DBuilder builder2d;
+    builder2d.SetMax1(1000)
+        .SetX1Min(1)
+        .SetX1Max(1e4)
+        .SetIsLog1(true)
+        .SetMax2(1000)
+        .SetX2Min(0.1)
+        .SetX2Max(10)
+        .SetRomberg1(romberg)
+        .SetRomberg2(romberg2)
+        .SetFunction2DFactory([&function2d]() { return function2d; });
+
+    builder2d.SetTargetError(target);
+    std::unique_ptr<Interpolant> table2d(builder2d.build());
+
+    EXPECT_LT(table2d->GetMax(), 1000);
+    EXPECT_LT(table2d->GetInterpolant().front()->GetMax(), 1000);
+    EXPECT_LE(builder2d.GetError(), target);
+
+    // the estimate only uses the points between the nodes
+    for (double x = 1.3; x < 1e4; x *= 1.7)
+    {
+        EXPECT_NEAR(table1d->Interpolate(x), function1d(x), 10 * target * function1d(x));
+        for (double y = 0.13; y < 10; y += 0.37)
+        {
+            EXPECT_NEAR(table2d->Interpolate(x, y), function2d(x, y), 10 * target * function2d(x, y));
+        }
+    }
+
+    // a target which can not be reached uses all nodes
+    builder1d.SetMax(20).SetTargetError(1e-15);
+    std::unique_ptr<Interpolant> coarse(builder1d.build());
+    EXPECT_EQ(coarse->GetMax(), 20);
+    EXPECT_GT(builder1d.GetError(), 1e-15);
+
+    // the error is stored in the header of the table file
+    std::shared_ptr<const Interpolant> saved1d(table1d.release());
+    std::shared_ptr<const Interpolant> loaded1d;
+    Helper::InterpolantBuilderContainer saved, loaded;
+    saved.push_back(std::make_pair(&builder1d, &saved1d));
+    loaded.push_back(std::make_pair(&builder1d, &loaded1d));
+
+    std::string filename = "TableFile_Adaptive_Test";
+    ASSERT_TRUE(Helper::SaveTables(filename, saved, true));
+
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    std::string word, format, architecture;
+    int version;
+    size_t hash, length;
+    uint64_t checksum;
+    double error = -1;
+    in >> word >> version >> format >> architecture >> hash >> length >> checksum >> error;
+    in.close();
+    EXPECT_NEAR(error, builder1d.GetError(), 1e-5 * builder1d.GetError());
+
+    ASSERT_TRUE(Helper::LoadTables(filename, loaded, true));
+    EXPECT_TRUE(*loaded1d == *saved1d);
+
+    std::remove(filename.c_str());
+}
+
+TEST(TableFile, Save_And_Load)
+{
+    Interpolant1DBuilder builder1d;
+    builder1d.SetMax(max).SetXMin(xmin).SetXMax(xmax).SetRomberg(romberg).SetFunction1D(X2);
+
+    Interpolant2DBuilder builder2d;
+    builder2d.SetMax1(max)
+        .SetX1Min(xmin)
+        .SetX1Max(xmax)
+        .SetMax2(max2)
+        .SetX2Min(x2min)
+        .SetX2Max(x2max)
+        .SetRomberg1(romberg)
+        .SetRomberg2(romberg2)
+        .SetFunction2D(X_YY);
+
+    std::shared_ptr<const Interpolant> built1d(builder1d.build());
+    std::shared_ptr<const Interpolant> built2d(builder2d.build());
+
+    Helper::InterpolantBuilderContainer saved;
+    saved.push_back(std::make_pair(&builder1d, &built1d));
+    saved.push_back(std::make_pair(&builder2d, &built2d));
+
+    for (bool binary_tables : {true, false})
+    {
+        std::string filename = "TableFile_Test";
+        ASSERT_TRUE(Helper::SaveTables(filename, saved, binary_tables));
+
+        std::shared_ptr<const Interpolant> loaded1d;
+        std::shared_ptr<const Interpolant> loaded2d;
+        Helper::InterpolantBuilderContainer loaded;
+        loaded.push_back(std::make_pair(&builder1d, &loaded1d));
+        loaded.push_back(std::make_pair(&builder2d, &loaded2d));
+
+        ASSERT_TRUE(Helper::LoadTables(filename, loaded, binary_tables));
+        ASSERT_TRUE(loaded1d != nullptr);
+        ASSERT_TRUE(loaded2d != nullptr);
+        // text tables are written with 16 digits only
+        double precision = binary_tables ? 0. : 1e-12;
+        EXPECT_NEAR(loaded1d->Interpolate(7.), built1d->Interpolate(7.), precision * built1d->Interpolate(7.));
+        EXPECT_NEAR(loaded2d->Interpolate(7., 11.), built2d->Interpolate(7., 11.), precision * built2d->Interpolate(7., 11.));
+
+        // a truncated file must not be used
+        std::ifstream in(filename.c_str(), std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+
+        std::ofstream truncated(filename.c_str(), std::ios::binary);
+        truncated << content.substr(0, content.size() / 2);
+        truncated.close();
+
+        loaded1d.reset();
+        loaded2d.reset();
+        EXPECT_FALSE(Helper::LoadTables(filename, loaded, binary_tables));
+        EXPECT_TRUE(loaded1d == nullptr);
+        EXPECT_TRUE(loaded2d == nullptr);
+
+        // neither a corrupt one
+        content[content.size() - 10] ^= 1;
+        std::ofstream corrupt(filename.c_str(), std::ios::binary);
+        corrupt << content;
+        corrupt.close();
+
+        EXPECT_FALSE(Helper::LoadTables(filename, loaded, binary_tables));
+        EXPECT_TRUE(loaded1d == nullptr);
+
+        std::remove(filename.c_str());
+    }
+
+    EXPECT_FALSE(Helper::LoadTables("TableFile_Test_does_not_exist", saved, true));
+}
+
+TEST(TableFile, Header)
+{
+    Interpolant1DBuilder builder1d;
+    builder1d.SetMax(max).SetXMin(xmin).SetXMax(xmax).SetRomberg(romberg).SetFunction1D(X2);
+
+    std::shared_ptr<const Interpolant> built1d(builder1d.build());
+    Helper::InterpolantBuilderContainer saved(1, std::make_pair(&builder1d, &built1d));
+
+    std::shared_ptr<const Interpolant> loaded1d;
+    Helper::InterpolantBuilderContainer loaded(1, std::make_pair(&builder1d, &loaded1d));
+
+    std::string filename = "TableFile_Test";
+    size_t hash          = 12345;
+    ASSERT_TRUE(Helper::SaveTables(filename, saved, true, false, hash));
+
+    EXPECT_TRUE(Helper::LoadTables(filename, loaded, true, false, hash));
+    EXPECT_TRUE(Helper::LoadTables(filename, loaded, true, false));
+
+    // tables of other settings or another format are not used
+    loaded1d.reset();
+    EXPECT_FALSE(Helper::LoadTables(filename, loaded, true, false, hash + 1));
+    EXPECT_FALSE(Helper::LoadTables(filename, loaded, false, false, hash));
+    EXPECT_FALSE(Helper::LoadTables(filename, loaded, true, true, hash));
+    EXPECT_TRUE(loaded1d == nullptr);
+
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    // neither tables of another version or architecture
+    std::vector<std::pair<std::string, std::string> > changes = {
+        {"PROPOSAL_TABLES 2 ", "PROPOSAL_TABLES 1 "},
+        {" binary ", " binary x"},
+        {"PROPOSAL_TABLES", "PROPOSAL_TABLEZ"},
+    };
+
+    for (auto& change : changes)
+    {
+        std::string changed = content;
+        size_t position     = changed.find(change.first);
+        ASSERT_NE(position, std::string::npos) << change.first;
+        changed.replace(position, change.first.size(), change.second);
+
+        std::ofstream out(filename.c_str(), std::ios::binary);
+        out << changed;
+        out.close();
+
+        EXPECT_FALSE(Helper::LoadTables(filename, loaded, true, false, hash)) << change.second;
+        EXPECT_TRUE(loaded1d == nullptr);
+    }
+
+    std::remove(filename.c_str());
+
+    // broken settings are detected before the memory for the table is allocated
+    std::stringstream stream;
+    built1d->Save(stream, true);
+
+    std::string broken = stream.str();
+    int nodes          = -1;
+    std::copy(reinterpret_cast<char*>(&nodes), reinterpret_cast<char*>(&nodes) + sizeof nodes, &broken[sizeof(bool)]);
+
+    std::istringstream broken_stream(broken);
+    Interpolant table;
+    EXPECT_FALSE(table.Load(broken_stream, true));
+}
+
+TEST(TableFile, Bundle)
+{
+    Interpolant1DBuilder builder1d;
+    builder1d.SetMax(max).SetXMin(xmin).SetXMax(xmax).SetRomberg(romberg).SetFunction1D(X2);
+
+    Interpolant2DBuilder builder2d;
+    builder2d.SetMax1(max)
+        .SetX1Min(xmin)
+        .SetX1Max(xmax)
+        .SetMax2(max2)
+        .SetX2Min(x2min)
+        .SetX2Max(x2max)
+        .SetRomberg1(romberg)
+        .SetRomberg2(romberg2)
+        .SetFunction2D(X_YY);
+
+    std::shared_ptr<const Interpolant> built1d(builder1d.build());
+    std::shared_ptr<const Interpolant> built2d(builder2d.build());
+
+    Helper::InterpolantBuilderContainer saved1d(1, std::make_pair(&builder1d, &built1d));
+    Helper::InterpolantBuilderContainer saved2d(1, std::make_pair(&builder2d, &built2d));
+
+    ASSERT_TRUE(Helper::SaveTables("TableFile_Test_1", saved1d, true));
+    ASSERT_TRUE(Helper::SaveTables("TableFile_Test_2", saved2d, true));
+
+    std::string bundle = "TableFile_Test.bundle";
+    ASSERT_TRUE(Helper::PackTables(bundle, {"TableFile_Test_1", "TableFile_Test_2"}));
+    std::remove("TableFile_Test_1");
+    std::remove("TableFile_Test_2");
+
+    std::vector<std::string> tables = Helper::GetBundledTables(bundle);
+    ASSERT_EQ(tables.size(), 2u);
+    EXPECT_EQ(tables[0], "TableFile_Test_1");
+    EXPECT_EQ(tables[1], "TableFile_Test_2");
+
+    std::shared_ptr<const Interpolant> loaded1d;
+    std::shared_ptr<const Interpolant> loaded2d;
+    Helper::InterpolantBuilderContainer loaded1d_container(1, std::make_pair(&builder1d, &loaded1d));
+    Helper::InterpolantBuilderContainer loaded2d_container(1, std::make_pair(&builder2d, &loaded2d));
+
+    ASSERT_TRUE(Helper::LoadTablesFromBundle(bundle, "TableFile_Test_2", loaded2d_container, true));
+    ASSERT_TRUE(Helper::LoadTablesFromBundle(bundle, "TableFile_Test_1", loaded1d_container, true));
+    EXPECT_EQ(loaded1d->Interpolate(7.), built1d->Interpolate(7.));
+    EXPECT_EQ(loaded2d->Interpolate(7., 11.), built2d->Interpolate(7., 11.));
+    EXPECT_FALSE(Helper::LoadTablesFromBundle(bundle, "TableFile_Test_3", loaded1d_container, true));
+
+    // a changed bundle is read again and a corrupt table is not used
+    std::ifstream in(bundle.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    content[content.size() - 10] ^= 1;
+    std::ofstream corrupt((bundle + ".tmp").c_str(), std::ios::binary);
+    corrupt << content;
+    corrupt.close();
+    std::rename((bundle + ".tmp").c_str(), bundle.c_str());
+
+    loaded2d.reset();
+    EXPECT_TRUE(Helper::LoadTablesFromBundle(bundle, "TableFile_Test_1", loaded1d_container, true));
+    EXPECT_FALSE(Helper::LoadTablesFromBundle(bundle, "TableFile_Test_2", loaded2d_container, true));
+    EXPECT_TRUE(loaded2d == nullptr);
+
+    // only table files are packed
+    EXPECT_FALSE(Helper::PackTables(bundle + "2", {bundle}));
+    EXPECT_TRUE(Helper::GetBundledTables(bundle + "2").empty());
+
+    std::remove(bundle.c_str());
+}
+
+TEST(TableFile, Mapped)
+{
+    Interpolant1DBuilder builder1d;
+    builder1d.SetMax(max).SetXMin(xmin).SetXMax(xmax).SetRomberg(romberg).SetIsLog(true).SetFunction1D(X2);
+
+    Interpolant2DBuilder builder2d;
+    builder2d.SetMax1(max)
+        .SetX1Min(xmin)
+        .SetX1Max(xmax)
+        .SetMax2(max2)
+        .SetX2Min(x2min)
+        .SetX2Max(x2max)
+        .SetRomberg1(romberg)
+        .SetRomberg2(romberg2)
+        .SetFunction2D(X_YY);
+
+    std::shared_ptr<const Interpolant> built1d(builder1d.build());
+    std::shared_ptr<const Interpolant> built2d(builder2d.build());
+
+    Helper::InterpolantBuilderContainer saved;
+    saved.push_back(std::make_pair(&builder1d, &built1d));
+    saved.push_back(std::make_pair(&builder2d, &built2d));
+
+    std::string filename = "TableFile_Test.map";
+    ASSERT_TRUE(Helper::SaveTables(filename, saved, true, true));
+
+    std::shared_ptr<const Interpolant> loaded1d;
+    std::shared_ptr<const Interpolant> loaded2d;
+    Helper::InterpolantBuilderContainer loaded;
+    loaded.push_back(std::make_pair(&builder1d, &loaded1d));
+    loaded.push_back(std::make_pair(&builder2d, &loaded2d));
+
+    ASSERT_TRUE(Helper::LoadTables(filename, loaded, true, true));
+
+    for (double x = xmin; x < xmax; x += 0.37)
+    {
+        EXPECT_EQ(loaded1d->Interpolate(x), built1d->Interpolate(x));
+        EXPECT_EQ(loaded1d->FindLimit(x * x), built1d->FindLimit(x * x));
+
+        for (double y = x2min; y < x2max; y += 0.53)
+        {
+            EXPECT_EQ(loaded2d->Interpolate(x, y), built2d->Interpolate(x, y));
+        }
+    }
+
+    // the values stay in the file, copies keep it mapped
+    EXPECT_LT(loaded2d->GetMemorySize(), built2d->GetMemorySize() / 2);
+
+    Interpolant copy(*loaded2d);
+    loaded2d.reset();
+    std::remove(filename.c_str());
+    EXPECT_EQ(copy.Interpolate(7., 11.), built2d->Interpolate(7., 11.));
+
+    // mapped tables in a bundle and truncated tables
+    ASSERT_TRUE(Helper::SaveTables(filename, saved, true, true));
+    ASSERT_TRUE(Helper::PackTables("TableFile_Test.bundle", {filename}));
+
+    ASSERT_TRUE(Helper::LoadTablesFromBundle("TableFile_Test.bundle", filename, loaded, true, true));
+    EXPECT_EQ(loaded2d->Interpolate(7., 11.), built2d->Interpolate(7., 11.));
+    std::remove("TableFile_Test.bundle");
+
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    std::ofstream truncated(filename.c_str(), std::ios::binary);
+    truncated << content.substr(0, content.size() - 64);
+    truncated.close();
+
+    loaded2d.reset();
+    EXPECT_FALSE(Helper::LoadTables(filename, loaded, true, true));
+    EXPECT_TRUE(loaded2d == nullptr);
+
+    std::remove(filename.c_str());
+}
+
+TEST(TableFile, Lock)
+{
+    std::string lock_file = "TableFile_Test.lock";
+    std::atomic<int> n_inside(0);
+    std::atomic<bool> overlap(false);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 20; ++i)
+            {
+                Helper::FileLock lock(lock_file);
+                EXPECT_TRUE(lock.IsLocked());
+
+                if (++n_inside > 1)
+                    overlap = true;
+                std::this_thread::yield();
+                --n_inside;
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_FALSE(overlap);
+
+    // the last holder removes the lock file
+    EXPECT_FALSE(Helper::FileExist(lock_file));
+    std::remove(lock_file.c_str());
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
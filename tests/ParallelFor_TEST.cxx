@@ -0,0 +1,102 @@
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "PROPOSAL/PROPOSAL.h"
+
+using namespace PROPOSAL;
+
+TEST(ParallelFor, NumberOfWorkers)
+{
+    EXPECT_EQ(NumberOfWorkers(4, 100), 4u);
+    EXPECT_EQ(NumberOfWorkers(4, 2), 2u);
+    EXPECT_EQ(NumberOfWorkers(4, 0), 1u);
+    EXPECT_GE(NumberOfWorkers(0, 100), 1u);
+}
+
+TEST(ParallelFor, EveryItemOnce)
+{
+    for (unsigned int n_workers = 1; n_workers <= 8; ++n_workers)
+    {
+        const size_t n_items = 1000;
+        std::vector<std::atomic<int>> calls(n_items);
+        for (auto& c : calls)
+            c = 0;
+
+        std::vector<std::atomic<int>> worker_calls(n_workers);
+        for (auto& c : worker_calls)
+            c = 0;
+
+        ParallelFor(n_items, n_workers, [&](unsigned int worker, size_t i) {
+            ASSERT_LT(worker, n_workers);
+            ++calls[i];
+            ++worker_calls[worker];
+        });
+
+        int sum = 0;
+        for (size_t i = 0; i < n_items; ++i)
+        {
+            EXPECT_EQ(calls[i], 1);
+        }
+        for (auto& c : worker_calls)
+        {
+            sum += c;
+        }
+        EXPECT_EQ(sum, static_cast<int>(n_items));
+    }
+}
+
+TEST(ParallelFor, Stealing)
+{
+    // the first worker blocks on its first item until another worker
+    // has stolen an item of its block
+    const size_t n_items = 64;
+    const unsigned int n_workers = 4;
+    std::atomic<bool> stolen(false);
+    std::vector<std::atomic<int>> worker_calls(n_workers);
+    for (auto& c : worker_calls)
+        c = 0;
+
+    ParallelFor(n_items, n_workers, [&](unsigned int worker, size_t i) {
+        ++worker_calls[worker];
+        if (i < n_items / n_workers)
+        {
+            if (worker == 0)
+            {
+                while (!stolen)
+                    std::this_thread::yield();
+            } else
+            {
+                stolen = true;
+            }
+        }
+    });
+
+    int sum = 0;
+    for (auto& c : worker_calls)
+    {
+        sum += c;
+    }
+    EXPECT_EQ(sum, static_cast<int>(n_items));
+    EXPECT_LT(worker_calls[0], static_cast<int>(n_items / n_workers));
+}
+
+TEST(ParallelFor, Exception)
+{
+    EXPECT_THROW(ParallelFor(100, 4,
+                             [](unsigned int, size_t i) {
+                                 if (i == 42)
+                                     throw std::runtime_error("item 42");
+                             }),
+                 std::runtime_error);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
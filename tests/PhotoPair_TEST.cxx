@@ -358,6 +358,45 @@ delete photopair;
 }
 }
 
+TEST(PhotoPair, ProducedParticlesOfLoss)
+{
+    PhotoPairFactory::Definition photopair_def;
+    photopair_def.parametrization = PhotoPairFactory::Tsai;
+    photopair_def.photoangle      = PhotoPairFactory::PhotoAngle::PhotoAngleNoDeflection;
+
+    InterpolationDef InterpolDef;
+    InterpolDef.nodes_cross_section = 20;
+
+    CrossSection* photopair = PhotoPairFactory::Get().CreatePhotoPair(
+        GammaDef::Get(), std::make_shared<StandardRock>(), photopair_def, InterpolDef);
+    CrossSection* copy = photopair->clone();
+
+    // sampling a loss does not change the cross section, the produced
+    // particles only depend on the random numbers of the interaction
+    double energy = 1e5;
+    double loss   = photopair->CalculateStochasticLoss(energy, 0.3, 0.6);
+    EXPECT_EQ(loss, energy);
+    EXPECT_TRUE(*photopair == *copy);
+
+    Vector3D direction(0, 0, -1);
+    auto particles = photopair->CalculateProducedParticles(energy, loss, direction, 0.3, 0.6);
+    photopair->CalculateStochasticLoss(energy, 0.9, 0.1);
+    auto again = photopair->CalculateProducedParticles(energy, loss, direction, 0.3, 0.6);
+    auto other = copy->CalculateProducedParticles(energy, loss, direction, 0.9, 0.1);
+
+    ASSERT_EQ(particles.first.size(), 2u);
+    ASSERT_EQ(again.first.size(), 2u);
+    ASSERT_EQ(other.first.size(), 2u);
+    EXPECT_TRUE(particles.second);
+    EXPECT_EQ(particles.first[0].GetEnergy(), again.first[0].GetEnergy());
+    EXPECT_EQ(particles.first[1].GetEnergy(), again.first[1].GetEnergy());
+    EXPECT_NEAR(particles.first[0].GetEnergy() + particles.first[1].GetEnergy(), energy, 1e-8 * energy);
+    EXPECT_NE(particles.first[0].GetEnergy(), other.first[0].GetEnergy());
+
+    delete photopair;
+    delete copy;
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,288 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "PROPOSAL/PROPOSAL.h"
+
+#include "TestSectors.h"
+
+using namespace PROPOSAL;
+
+const Propagator& GetPropagator()
+{
+    static std::unique_ptr<Propagator> prop;
+
+    if (!prop)
+    {
+        prop.reset(new Propagator(MuMinusDef::Get(),
+                                  std::vector<Sector::Definition>(1, GetWaterSectorDefinition()),
+                                  GetWorldGeometry(),
+                                  GetCoarseInterpolationDef()));
+    }
+
+    return *prop;
+}
+
+void SetPrimary(DynamicData& primary, size_t i)
+{
+    primary.SetEnergy(std::pow(10., 3 + i % 5));
+    primary.SetPosition(Vector3D(0, 0, 0));
+    primary.SetDirection(Vector3D(0, 0, -1));
+}
+
+TEST(BoundedQueue, PushPop)
+{
+    BoundedQueue<int> queue(3);
+    EXPECT_EQ(queue.GetCapacity(), 4u);
+
+    int value;
+    EXPECT_FALSE(queue.TryPop(value));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        value = i;
+        EXPECT_TRUE(queue.TryPush(value));
+    }
+    value = 4;
+    EXPECT_FALSE(queue.TryPush(value));
+    EXPECT_EQ(value, 4);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(queue.TryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST(BoundedQueue, Concurrent)
+{
+    BoundedQueue<int> queue(8);
+    int n_items = 10000;
+    std::atomic<long> sum(0);
+    std::atomic<int> n_popped(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (int i = t; i < n_items; i += 2)
+            {
+                int value = i;
+                while (!queue.TryPush(value))
+                    std::this_thread::yield();
+            }
+        });
+        threads.emplace_back([&]() {
+            int value;
+            while (n_popped < n_items)
+            {
+                if (queue.TryPop(value))
+                {
+                    sum += value;
+                    ++n_popped;
+                } else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(n_popped, n_items);
+    EXPECT_EQ(sum, static_cast<long>(n_items) * (n_items - 1) / 2);
+}
+
+TEST(Pipeline, SameAsBatch)
+{
+    const Propagator& prop = GetPropagator();
+    size_t n_primaries = 20;
+
+    std::vector<DynamicData> primaries(n_primaries, DynamicData(MuMinusDef::Get().particle_type));
+    for (size_t i = 0; i < n_primaries; ++i)
+    {
+        SetPrimary(primaries[i], i);
+    }
+
+    PipelineOptions options;
+    options.seed         = 1234;
+    options.max_distance = 1e5;
+    options.queue_size   = 4;
+
+    std::vector<Secondaries> batch = prop.PropagateBatch(primaries, options);
+
+    for (unsigned int n_threads : {1, 3})
+    {
+        options.n_threads = n_threads;
+        Pipeline pipeline(prop, options);
+
+        size_t n_generated = 0;
+        std::vector<int> n_written(n_primaries, 0);
+        std::vector<Secondaries> secondaries(n_primaries);
+
+        size_t n_propagated = pipeline.Run(
+            [&](DynamicData& primary) {
+                if (n_generated == n_primaries)
+                    return false;
+                EXPECT_EQ(primary.GetType(), MuMinusDef::Get().particle_type);
+                SetPrimary(primary, n_generated++);
+                return true;
+            },
+            [&](size_t index, Secondaries& sec) {
+                ASSERT_LT(index, n_primaries);
+                ++n_written[index];
+                secondaries[index] = std::move(sec);
+            });
+
+        EXPECT_EQ(n_propagated, n_primaries);
+        for (size_t i = 0; i < n_primaries; ++i)
+        {
+            EXPECT_EQ(n_written[i], 1);
+
+            std::vector<DynamicData> sec_a = batch[i].GetSecondaries();
+            std::vector<DynamicData> sec_b = secondaries[i].GetSecondaries();
+            ASSERT_EQ(sec_a.size(), sec_b.size());
+            for (size_t j = 0; j < sec_a.size(); ++j)
+            {
+                EXPECT_EQ(sec_a[j].GetEnergy(), sec_b[j].GetEnergy());
+                EXPECT_EQ(sec_a[j].GetPosition(), sec_b[j].GetPosition());
+            }
+        }
+    }
+}
+
+TEST(Pipeline, Photons)
+{
+    // photo pair production samples the produced particles from its tables
+    const Propagator prop(GammaDef::Get(),
+                          GetElectromagneticSectorDefinitions(GammaDef::Get()),
+                          GetWorldGeometry(),
+                          GetCoarseInterpolationDef());
+
+    size_t n_primaries = 20;
+
+    std::vector<DynamicData> primaries(n_primaries, DynamicData(GammaDef::Get().particle_type));
+    for (size_t i = 0; i < n_primaries; ++i)
+    {
+        SetPrimary(primaries[i], i);
+    }
+
+    PipelineOptions options;
+    options.seed         = 1234;
+    options.max_distance = 1e5;
+    options.queue_size   = 4;
+    options.n_threads    = 3;
+
+    std::vector<Secondaries> batch = prop.PropagateBatch(primaries, options);
+    std::vector<Secondaries> secondaries(n_primaries);
+
+    size_t n_generated = 0;
+    Pipeline pipeline(prop, options);
+    size_t n_propagated = pipeline.Run(
+        [&](DynamicData& primary) {
+            if (n_generated == n_primaries)
+                return false;
+            EXPECT_EQ(primary.GetType(), GammaDef::Get().particle_type);
+            SetPrimary(primary, n_generated++);
+            return true;
+        },
+        [&](size_t index, Secondaries& sec) { secondaries.at(index) = std::move(sec); });
+
+    EXPECT_EQ(n_propagated, n_primaries);
+    for (size_t i = 0; i < n_primaries; ++i)
+    {
+        std::vector<DynamicData> sec_a = batch[i].GetSecondaries();
+        std::vector<DynamicData> sec_b = secondaries[i].GetSecondaries();
+        ASSERT_EQ(sec_a.size(), sec_b.size());
+        ASSERT_FALSE(sec_a.empty());
+        for (size_t j = 0; j < sec_a.size(); ++j)
+        {
+            EXPECT_EQ(sec_a[j].GetType(), sec_b[j].GetType());
+            EXPECT_EQ(sec_a[j].GetEnergy(), sec_b[j].GetEnergy());
+            EXPECT_EQ(sec_a[j].GetPosition(), sec_b[j].GetPosition());
+        }
+    }
+}
+
+TEST(Pipeline, Backpressure)
+{
+    PipelineOptions options;
+    options.n_threads    = 2;
+    options.queue_size   = 2;
+    options.max_distance = 1e3;
+
+    Pipeline pipeline(GetPropagator(), options);
+
+    size_t n_primaries = 40;
+    size_t n_generated = 0;
+    std::atomic<size_t> n_in_flight(0);
+    size_t max_in_flight = 0;
+
+    size_t n_written = pipeline.Run(
+        [&](DynamicData& primary) {
+            if (n_generated == n_primaries)
+                return false;
+            SetPrimary(primary, 0);
+            ++n_generated;
+            ++n_in_flight;
+            return true;
+        },
+        [&](size_t, Secondaries&) {
+            // a slow writer
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            max_in_flight = std::max(max_in_flight, n_in_flight.load());
+            --n_in_flight;
+        });
+
+    EXPECT_EQ(n_written, 40u);
+    // both queues, the primaries of the workers, the generator and the writer
+    EXPECT_LE(max_in_flight, 2 * options.queue_size + options.n_threads + 2);
+}
+
+TEST(Pipeline, Exception)
+{
+    PipelineOptions options;
+    options.n_threads    = 2;
+    options.queue_size   = 4;
+    options.max_distance = 1e3;
+
+    Pipeline pipeline(GetPropagator(), options);
+
+    auto endless = [](DynamicData& primary) {
+        SetPrimary(primary, 0);
+        return true;
+    };
+
+    EXPECT_THROW(pipeline.Run(endless,
+                              [](size_t index, Secondaries&) {
+                                  if (index > 5)
+                                      throw std::runtime_error("writer failed");
+                              }),
+                 std::runtime_error);
+
+    size_t n_generated = 0;
+    EXPECT_THROW(pipeline.Run(
+                     [&](DynamicData& primary) {
+                         if (n_generated++ == 10)
+                             throw std::runtime_error("generator failed");
+                         SetPrimary(primary, 0);
+                         return true;
+                     },
+                     [](size_t, Secondaries&) {}),
+                 std::runtime_error);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,11 +1,14 @@
 
 #include <cmath>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
 
 #include "PROPOSAL/PROPOSAL.h"
 
+#include "TestSectors.h"
+
 using namespace PROPOSAL;
 
 TEST(Comparison, Comparison_equal)
@@ -249,6 +252,367 @@ TEST(Propagation, particle_type)
     in.close();
 }
 
+TEST(Propagation, Context)
+{
+    std::vector<Sector::Definition> sec_defs(1, GetWaterSectorDefinition());
+    InterpolationDef interpolation_def = GetCoarseInterpolationDef();
+
+    Propagator prop(MuMinusDef::Get(), sec_defs, GetWorldGeometry(), interpolation_def);
+    Propagator prop_copy(prop);
+
+    DynamicData mu(MuMinusDef::Get().particle_type);
+    mu.SetEnergy(1e6);
+    mu.SetPosition(Vector3D(0, 0, 0));
+    mu.SetDirection(Vector3D(0, 0, -1));
+
+    RandomGenerator::Get().SetSeed(1234);
+    std::vector<DynamicData> sec_a = prop.Propagate(mu, 1e5).GetSecondaries();
+
+    PropagationContext context;
+    RandomGenerator::Get().SetSeed(1234);
+    std::vector<DynamicData> sec_b = prop.Propagate(context, mu, 1e5).GetSecondaries();
+
+    // the same random numbers have to give the same secondaries
+    ASSERT_EQ(sec_a.size(), sec_b.size());
+    for (unsigned int i = 0; i < sec_a.size(); ++i)
+    {
+        EXPECT_EQ(sec_a[i].GetType(), sec_b[i].GetType());
+        EXPECT_EQ(sec_a[i].GetEnergy(), sec_b[i].GetEnergy());
+        EXPECT_EQ(sec_a[i].GetPropagatedDistance(), sec_b[i].GetPropagatedDistance());
+    }
+
+    EXPECT_TRUE(context.current_sector != nullptr);
+    EXPECT_TRUE(prop == prop_copy); // propagating does not alter the propagator
+}
+
+TEST(Propagation, ContextStreams)
+{
+    std::vector<Sector::Definition> sec_defs(1, GetWaterSectorDefinition());
+    InterpolationDef interpolation_def = GetCoarseInterpolationDef();
+
+    const Propagator prop(MuMinusDef::Get(), sec_defs, GetWorldGeometry(), interpolation_def);
+
+    DynamicData mu(MuMinusDef::Get().particle_type);
+    mu.SetEnergy(1e6);
+    mu.SetPosition(Vector3D(0, 0, 0));
+    mu.SetDirection(Vector3D(0, 0, -1));
+
+    // event i always draws from stream i
+    auto propagate_event = [&](PropagationContext& context, PhiloxStream& stream, int i) {
+        stream.SetStream(i);
+        std::vector<DynamicData> secondaries = prop.Propagate(context, mu, 1e5).GetSecondaries();
+
+        double energy_sum = 0;
+        for (auto& secondary : secondaries)
+        {
+            energy_sum += secondary.GetEnergy();
+        }
+        return energy_sum;
+    };
+
+    const int n_events = 8;
+    std::vector<double> serial(n_events);
+
+    PhiloxStream stream(1234);
+    PropagationContext context(&stream);
+    for (int i = 0; i < n_events; ++i)
+    {
+        serial[i] = propagate_event(context, stream, i);
+    }
+
+    EXPECT_NE(serial[0], serial[1]);
+
+    const int n_threads = 2;
+    std::vector<double> parallel(n_events);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < n_threads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            PhiloxStream thread_stream(1234);
+            PropagationContext thread_context(&thread_stream);
+
+            // the second thread walks backwards through its events
+            for (int k = 0; k < n_events / n_threads; ++k)
+            {
+                int i = (t == 0) ? 2 * k : n_events - 1 - 2 * k;
+                parallel[i] = propagate_event(thread_context, thread_stream, i);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int i = 0; i < n_events; ++i)
+    {
+        EXPECT_EQ(serial[i], parallel[i]);
+    }
+}
+
+TEST(Propagation, ContextIntegral)
+{
+    std::vector<Sector::Definition> sec_defs(1, GetWaterSectorDefinition());
+
+    // without an InterpolationDef, the sectors keep intermediate results of
+    // the integrals, so the threads propagate one particle at a time
+    const Propagator prop(MuMinusDef::Get(), sec_defs, GetWorldGeometry());
+    EXPECT_FALSE(prop.GetSectors()[0]->IsInterpolated());
+
+    DynamicData mu(MuMinusDef::Get().particle_type);
+    mu.SetEnergy(1e4);
+    mu.SetPosition(Vector3D(0, 0, 0));
+    mu.SetDirection(Vector3D(0, 0, -1));
+
+    auto propagate_event = [&](int i) {
+        PhiloxStream stream(1234, i);
+        PropagationContext context(&stream);
+        return prop.Propagate(context, mu, 1e3).GetSecondaries().back().GetEnergy();
+    };
+
+    const int n_events = 4;
+    std::vector<double> serial(n_events);
+    for (int i = 0; i < n_events; ++i)
+    {
+        serial[i] = propagate_event(i);
+    }
+
+    std::vector<double> parallel(n_events);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < n_events; ++i)
+    {
+        threads.emplace_back([&, i]() { parallel[i] = propagate_event(i); });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int i = 0; i < n_events; ++i)
+    {
+        EXPECT_EQ(serial[i], parallel[i]);
+    }
+}
+
+TEST(Propagation, PropagateBatch)
+{
+    std::vector<Sector::Definition> sec_defs(1, GetWaterSectorDefinition());
+    InterpolationDef interpolation_def = GetCoarseInterpolationDef();
+
+    const Propagator prop(MuMinusDef::Get(), sec_defs, GetWorldGeometry(), interpolation_def);
+
+    // energies over several orders of magnitude, so the events differ in cost
+    std::vector<DynamicData> primaries;
+    for (int i = 0; i < 12; ++i)
+    {
+        DynamicData mu(MuMinusDef::Get().particle_type);
+        mu.SetEnergy(std::pow(10., 3 + i % 5));
+        mu.SetPosition(Vector3D(0, 0, 0));
+        mu.SetDirection(Vector3D(0, 0, -1));
+        primaries.push_back(mu);
+    }
+
+    BatchOptions options;
+    options.seed         = 1234;
+    options.max_distance = 1e5;
+
+    options.n_threads = 1;
+    std::vector<Secondaries> serial = prop.PropagateBatch(primaries, options);
+    ASSERT_EQ(serial.size(), primaries.size());
+
+    // the i-th primary uses the i-th stream
+    PhiloxStream stream(1234, 3);
+    PropagationContext context(&stream);
+    std::vector<DynamicData> single = prop.Propagate(context, primaries[3], 1e5).GetSecondaries();
+    ASSERT_EQ(single.size(), serial[3].GetNumberOfParticles());
+    EXPECT_EQ(single.back().GetEnergy(), serial[3].GetSecondaries().back().GetEnergy());
+
+    for (unsigned int n_threads : {2, 3, 5})
+    {
+        options.n_threads = n_threads;
+        std::vector<Secondaries> parallel = prop.PropagateBatch(primaries, options);
+        ASSERT_EQ(parallel.size(), serial.size());
+
+        for (unsigned int i = 0; i < serial.size(); ++i)
+        {
+            std::vector<DynamicData> sec_a = serial[i].GetSecondaries();
+            std::vector<DynamicData> sec_b = parallel[i].GetSecondaries();
+            ASSERT_EQ(sec_a.size(), sec_b.size());
+            for (unsigned int j = 0; j < sec_a.size(); ++j)
+            {
+                EXPECT_EQ(sec_a[j].GetType(), sec_b[j].GetType());
+                EXPECT_EQ(sec_a[j].GetEnergy(), sec_b[j].GetEnergy());
+                EXPECT_EQ(sec_a[j].GetPropagatedDistance(), sec_b[j].GetPropagatedDistance());
+                EXPECT_EQ(sec_a[j].GetPosition(), sec_b[j].GetPosition());
+            }
+        }
+    }
+
+    // a batch can be continued by starting at a later stream
+    options.first_stream = 6;
+    std::vector<DynamicData> tail(primaries.begin() + 6, primaries.end());
+    std::vector<Secondaries> continued = prop.PropagateBatch(tail, options);
+    ASSERT_EQ(continued.size(), tail.size());
+    EXPECT_EQ(continued[0].GetSecondaries().back().GetEnergy(), serial[6].GetSecondaries().back().GetEnergy());
+}
+
+TEST(Propagation, PropagateBatchElectromagnetic)
+{
+    InterpolationDef interpolation_def = GetCoarseInterpolationDef();
+
+    std::vector<ParticleDef> particle_defs = {EPlusDef::Get(), GammaDef::Get()};
+
+    for (const ParticleDef& particle_def : particle_defs)
+    {
+        const Propagator prop(particle_def,
+                              GetElectromagneticSectorDefinitions(particle_def),
+                              GetWorldGeometry(),
+                              interpolation_def);
+
+        std::vector<DynamicData> primaries;
+        for (int i = 0; i < 16; ++i)
+        {
+            DynamicData primary(particle_def.particle_type);
+            primary.SetEnergy(std::pow(10., 2 + i % 5));
+            primary.SetPosition(Vector3D(0, 0, 0));
+            primary.SetDirection(Vector3D(0, 0, -1));
+            primaries.push_back(primary);
+        }
+
+        BatchOptions options;
+        options.seed         = 1234;
+        options.max_distance = 1e5;
+
+        options.n_threads = 1;
+        std::vector<Secondaries> serial = prop.PropagateBatch(primaries, options);
+
+        options.n_threads = 4;
+        std::vector<Secondaries> parallel = prop.PropagateBatch(primaries, options);
+
+        ASSERT_EQ(serial.size(), primaries.size());
+        ASSERT_EQ(parallel.size(), primaries.size());
+
+        // annihilations and pair productions are stored as Particle losses
+        int n_annihilations = 0;
+        for (unsigned int i = 0; i < serial.size(); ++i)
+        {
+            std::vector<DynamicData> sec_a = serial[i].GetSecondaries();
+            std::vector<DynamicData> sec_b = parallel[i].GetSecondaries();
+            ASSERT_EQ(sec_a.size(), sec_b.size());
+            for (unsigned int j = 0; j < sec_a.size(); ++j)
+            {
+                if (sec_a[j].GetType() == static_cast<int>(InteractionType::Particle))
+                    ++n_annihilations;
+                EXPECT_EQ(sec_a[j].GetType(), sec_b[j].GetType());
+                EXPECT_EQ(sec_a[j].GetEnergy(), sec_b[j].GetEnergy());
+                EXPECT_EQ(sec_a[j].GetPosition(), sec_b[j].GetPosition());
+            }
+        }
+
+        EXPECT_GT(n_annihilations, 0);
+    }
+}
+
+// Propagates the particle types in turn, with energies from 10^lowest_exponent
+// MeV on, once serially and once from several threads. Every event uses its
+// own random stream, so both have to give the same secondaries.
+void ExpectConcurrentEqualsSerial(const PropagatorService& service,
+                                  const std::vector<ParticleDef>& particle_defs,
+                                  unsigned int n_events,
+                                  int lowest_exponent,
+                                  unsigned int n_exponents)
+{
+    auto propagate = [&](unsigned int i) {
+        const ParticleDef& particle_def = particle_defs[i % particle_defs.size()];
+        DynamicData primary(particle_def.particle_type);
+        primary.SetEnergy(std::pow(10., lowest_exponent + i % n_exponents));
+        primary.SetPosition(Vector3D(0, 0, 0));
+        primary.SetDirection(Vector3D(0, 0, -1));
+
+        PhiloxStream stream(42, i);
+        return service.Propagate(particle_def, primary, stream, 1e5);
+    };
+
+    std::vector<Secondaries> serial;
+    for (unsigned int i = 0; i < n_events; ++i)
+    {
+        serial.push_back(propagate(i));
+    }
+
+    std::vector<Secondaries> concurrent(n_events);
+    std::vector<std::thread> threads;
+    unsigned int n_threads = 4;
+    for (unsigned int t = 0; t < n_threads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (unsigned int i = t; i < n_events; i += n_threads)
+            {
+                concurrent[i] = propagate(i);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (unsigned int i = 0; i < n_events; ++i)
+    {
+        std::vector<DynamicData> sec_a = serial[i].GetSecondaries();
+        std::vector<DynamicData> sec_b = concurrent[i].GetSecondaries();
+        ASSERT_EQ(sec_a.size(), sec_b.size());
+        for (unsigned int j = 0; j < sec_a.size(); ++j)
+        {
+            EXPECT_EQ(sec_a[j].GetType(), sec_b[j].GetType());
+            EXPECT_EQ(sec_a[j].GetEnergy(), sec_b[j].GetEnergy());
+            EXPECT_EQ(sec_a[j].GetPosition(), sec_b[j].GetPosition());
+        }
+    }
+}
+
+TEST(PropagatorService, Concurrent)
+{
+    std::vector<Sector::Definition> sec_defs(1, GetWaterSectorDefinition());
+    InterpolationDef interpolation_def = GetCoarseInterpolationDef();
+
+    std::vector<ParticleDef> particle_defs = {MuMinusDef::Get(), TauMinusDef::Get(), EMinusDef::Get()};
+
+    PropagatorService service;
+    for (const ParticleDef& particle_def : particle_defs)
+    {
+        service.RegisterPropagator(
+            Propagator(particle_def, sec_defs, GetWorldGeometry(), interpolation_def));
+    }
+
+    // mixed particle types, every event with its own random stream
+    ExpectConcurrentEqualsSerial(service, particle_defs, 24, 3, 4);
+
+    PhiloxStream stream(42, 0);
+    DynamicData primary(MuPlusDef::Get().particle_type);
+    primary.SetEnergy(1e5);
+    EXPECT_EQ(service.Propagate(MuPlusDef::Get(), primary, stream).GetNumberOfParticles(), 0u);
+}
+
+TEST(PropagatorService, ConcurrentElectromagnetic)
+{
+    InterpolationDef interpolation_def = GetCoarseInterpolationDef();
+
+    std::vector<ParticleDef> particle_defs = {EPlusDef::Get(), GammaDef::Get()};
+
+    PropagatorService service;
+    for (const ParticleDef& particle_def : particle_defs)
+    {
+        service.RegisterPropagator(Propagator(particle_def,
+                                              GetElectromagneticSectorDefinitions(particle_def),
+                                              GetWorldGeometry(),
+                                              interpolation_def));
+    }
+
+    // positrons and photons alternate, so both propagators are used at once
+    ExpectConcurrentEqualsSerial(service, particle_defs, 32, 2, 5);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
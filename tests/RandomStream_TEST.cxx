@@ -0,0 +1,145 @@
+
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "PROPOSAL/PROPOSAL.h"
+
+using namespace PROPOSAL;
+
+TEST(Philox, KnownAnswer)
+{
+    // Known answer tests of the Random123 library
+    PhiloxStream::Counter zero_ctr = {{ 0, 0, 0, 0 }};
+    PhiloxStream::Key zero_key     = {{ 0, 0 }};
+    PhiloxStream::Counter result   = PhiloxStream::Philox4x32(zero_ctr, zero_key);
+
+    EXPECT_EQ(result[0], 0x6627e8d5u);
+    EXPECT_EQ(result[1], 0xe169c58du);
+    EXPECT_EQ(result[2], 0xbc57ac4cu);
+    EXPECT_EQ(result[3], 0x9b00dbd8u);
+
+    PhiloxStream::Counter pi_ctr = {{ 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }};
+    PhiloxStream::Key pi_key     = {{ 0xa4093822, 0x299f31d0 }};
+    result                       = PhiloxStream::Philox4x32(pi_ctr, pi_key);
+
+    EXPECT_EQ(result[0], 0xd16cfe09u);
+    EXPECT_EQ(result[1], 0x94fdccebu);
+    EXPECT_EQ(result[2], 0x5001e420u);
+    EXPECT_EQ(result[3], 0x24126ea1u);
+}
+
+TEST(Philox, Range)
+{
+    PhiloxStream stream(1234);
+
+    double sum = 0;
+    int statistic = 100000;
+    for (int i = 0; i < statistic; ++i)
+    {
+        double rnd = stream.RandomDouble();
+        ASSERT_GT(rnd, 0.);
+        ASSERT_LT(rnd, 1.);
+        sum += rnd;
+    }
+
+    EXPECT_NEAR(sum / statistic, 0.5, 0.005);
+}
+
+TEST(Philox, SkipAhead)
+{
+    PhiloxStream stream_a(42, 7);
+    PhiloxStream stream_b(42, 7);
+
+    for (int i = 0; i < 13; ++i)
+    {
+        stream_a.RandomDouble();
+    }
+    stream_b.SkipAhead(13);
+
+    EXPECT_TRUE(stream_a == stream_b);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(stream_a.RandomDouble(), stream_b.RandomDouble());
+    }
+}
+
+TEST(Philox, Streams)
+{
+    PhiloxStream stream(42);
+
+    std::vector<double> first;
+    for (int i = 0; i < 5; ++i)
+    {
+        stream.SetStream(i);
+        first.push_back(stream.RandomDouble());
+    }
+
+    // the streams do not depend on the order they are used in
+    for (int i = 4; i >= 0; --i)
+    {
+        stream.SetStream(i);
+        EXPECT_EQ(stream.RandomDouble(), first[i]);
+    }
+
+    for (int i = 1; i < 5; ++i)
+    {
+        EXPECT_NE(first[i], first[i - 1]);
+    }
+
+    PhiloxStream other_seed(43);
+    EXPECT_NE(other_seed.RandomDouble(), first[0]);
+}
+
+TEST(Philox, Serialization)
+{
+    PhiloxStream stream(42, 3);
+    stream.SkipAhead(5);
+    stream.RandomDouble();
+
+    std::stringstream ss;
+    stream.Serialize(ss);
+
+    PhiloxStream restored;
+    restored.Deserialize(ss);
+
+    EXPECT_TRUE(stream == restored);
+    EXPECT_EQ(stream.RandomDouble(), restored.RandomDouble());
+}
+
+TEST(RandomGenerator, StreamScope)
+{
+    PhiloxStream stream(42);
+    PhiloxStream reference(42);
+
+    EXPECT_TRUE(RandomGenerator::Get().GetStream() == nullptr);
+
+    {
+        RandomGenerator::StreamScope scope(&stream);
+        EXPECT_TRUE(RandomGenerator::Get().GetStream() == &stream);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            EXPECT_EQ(RandomGenerator::Get().RandomDouble(), reference.RandomDouble());
+        }
+
+        std::stringstream ss;
+        RandomGenerator::Get().Serialize(ss);
+        RandomGenerator::Get().RandomDouble();
+        RandomGenerator::Get().Deserialize(ss);
+        EXPECT_TRUE(stream == reference);
+
+        RandomGenerator::StreamScope no_stream(nullptr);
+        EXPECT_TRUE(RandomGenerator::Get().GetStream() == &stream);
+    }
+
+    EXPECT_TRUE(RandomGenerator::Get().GetStream() == nullptr);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
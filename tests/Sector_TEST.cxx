@@ -1,6 +1,8 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <sstream>
+#include <thread>
 
 #include "PROPOSAL/PROPOSAL.h"
 #include <string>
@@ -146,6 +148,113 @@ TEST(Assignment, Copyconstructor2)
     EXPECT_TRUE(sector_1 == sector_2);
 }
 
+TEST(Assignment, SharedPhysics)
+{
+    ParticleDef mu = MuMinusDef::Get();
+    EnergyCutSettings ecuts(500, 0.05);
+
+    Sector::Definition sector_def_1;
+    sector_def_1.location = Sector::ParticleLocation::InsideDetector;
+    sector_def_1.SetMedium(std::make_shared<Water>());
+    sector_def_1.SetGeometry(Sphere(Vector3D(), 1000, 0).create());
+    sector_def_1.scattering_model = ScatteringFactory::Moliere;
+    sector_def_1.cut_settings = ecuts;
+
+    // same physics in a different place and with an equal, but not
+    // identical medium
+    Sector::Definition sector_def_2 = sector_def_1;
+    sector_def_2.location = Sector::ParticleLocation::BehindDetector;
+    sector_def_2.SetMedium(std::make_shared<Water>());
+    sector_def_2.SetGeometry(Sphere(Vector3D(), 2000, 1000).create());
+    sector_def_2.stochastic_loss_weighting = 1.;
+
+    Sector::Definition sector_def_3 = sector_def_1;
+    sector_def_3.cut_settings = EnergyCutSettings(400, 0.05);
+
+    Sector::Definition sector_def_4 = sector_def_1;
+    sector_def_4.SetMedium(std::make_shared<Water>(2.));
+
+    EXPECT_TRUE(sector_def_1.HasSamePhysics(sector_def_2));
+    EXPECT_FALSE(sector_def_1.HasSamePhysics(sector_def_3));
+    EXPECT_FALSE(sector_def_1.HasSamePhysics(sector_def_4));
+
+    sector_def_1.do_continuous_randomization = true;
+    sector_def_2.do_continuous_randomization = true;
+    sector_def_3.do_continuous_randomization = true;
+
+    InterpolationDef inter_def;
+    inter_def.nodes_cross_section = 20;
+    inter_def.nodes_propagate = 200;
+
+    Sector sector_1(mu, sector_def_1, inter_def);
+    Sector sector_2(sector_def_2, sector_1);
+    EXPECT_TRUE(sector_2 == Sector(mu, sector_def_2, inter_def));
+    EXPECT_TRUE(sector_2.GetSectorDef() == sector_def_2);
+
+    // the sectors use the same tables, not equal copies of them
+    auto expect_shared_tables = [](const Sector& sector, const Sector& shared) {
+        const std::vector<CrossSection*>& crosssections = sector.GetUtility().GetCrosssections();
+        const std::vector<CrossSection*>& shared_crosssections = shared.GetUtility().GetCrosssections();
+        ASSERT_EQ(shared_crosssections.size(), crosssections.size());
+        ASSERT_FALSE(crosssections.empty());
+
+        for (size_t i = 0; i < crosssections.size(); ++i) {
+            auto crosssection = dynamic_cast<const CrossSectionInterpolant*>(crosssections[i]);
+            auto shared_crosssection = dynamic_cast<const CrossSectionInterpolant*>(shared_crosssections[i]);
+            ASSERT_NE(crosssection, nullptr);
+            ASSERT_NE(shared_crosssection, nullptr);
+            EXPECT_NE(shared_crosssection, crosssection);
+
+            ASSERT_NE(crosssection->GetdEdxInterpolant(), nullptr);
+            EXPECT_EQ(shared_crosssection->GetdEdxInterpolant(), crosssection->GetdEdxInterpolant());
+            EXPECT_EQ(shared_crosssection->GetdE2dxInterpolant(), crosssection->GetdE2dxInterpolant());
+            ASSERT_EQ(shared_crosssection->GetdNdxInterpolants2D().size(), crosssection->GetdNdxInterpolants2D().size());
+            for (size_t j = 0; j < crosssection->GetdNdxInterpolants2D().size(); ++j) {
+                EXPECT_EQ(shared_crosssection->GetdNdxInterpolants1D()[j], crosssection->GetdNdxInterpolants1D()[j]);
+                EXPECT_EQ(shared_crosssection->GetdNdxInterpolants2D()[j], crosssection->GetdNdxInterpolants2D()[j]);
+            }
+        }
+
+        std::vector<std::pair<std::shared_ptr<UtilityDecorator>, std::shared_ptr<UtilityDecorator> > > calculators{
+            { sector.GetDisplacementCalculator(), shared.GetDisplacementCalculator() },
+            { sector.GetInteractionCalculator(), shared.GetInteractionCalculator() },
+            { sector.GetDecayCalculator(), shared.GetDecayCalculator() }
+        };
+        for (const auto& calculator : calculators) {
+            auto interpolant = std::dynamic_pointer_cast<const UtilityInterpolant>(calculator.first);
+            auto shared_interpolant = std::dynamic_pointer_cast<const UtilityInterpolant>(calculator.second);
+            ASSERT_NE(interpolant, nullptr);
+            ASSERT_NE(shared_interpolant, nullptr);
+            EXPECT_NE(shared_interpolant, interpolant);
+            ASSERT_NE(interpolant->GetInterpolant(), nullptr);
+            EXPECT_EQ(shared_interpolant->GetInterpolant(), interpolant->GetInterpolant());
+            EXPECT_EQ(shared_interpolant->GetInterpolantDiff(), interpolant->GetInterpolantDiff());
+        }
+
+        ASSERT_NE(sector.GetScattering(), nullptr);
+        EXPECT_EQ(shared.GetScattering(), sector.GetScattering());
+        ASSERT_NE(sector.GetContinuousRandomizer(), nullptr);
+        EXPECT_EQ(shared.GetContinuousRandomizer(), sector.GetContinuousRandomizer());
+    };
+    expect_shared_tables(sector_1, sector_2);
+
+    // the propagator builds the physics of equal sectors only once
+    std::vector<Sector::Definition> sector_defs{ sector_def_1, sector_def_3, sector_def_2 };
+    Propagator prop(mu, sector_defs, Sphere(Vector3D(), 1000, 0).create(), inter_def);
+    EXPECT_TRUE(*prop.GetSectors()[0] == sector_1);
+    EXPECT_TRUE(*prop.GetSectors()[1] == Sector(mu, sector_def_3, inter_def));
+    EXPECT_TRUE(*prop.GetSectors()[2] == sector_2);
+    expect_shared_tables(*prop.GetSectors()[0], *prop.GetSectors()[2]);
+
+    // the sector with other cuts has tables of its own
+    EXPECT_NE(prop.GetSectors()[1]->GetDisplacementCalculator(), prop.GetSectors()[0]->GetDisplacementCalculator());
+    auto own = std::dynamic_pointer_cast<const UtilityInterpolant>(prop.GetSectors()[1]->GetDisplacementCalculator());
+    auto shared = std::dynamic_pointer_cast<const UtilityInterpolant>(prop.GetSectors()[0]->GetDisplacementCalculator());
+    ASSERT_NE(own, nullptr);
+    ASSERT_NE(shared, nullptr);
+    EXPECT_NE(own->GetInterpolant(), shared->GetInterpolant());
+}
+
 TEST(Sector, Continuous)
 {
     std::string filename = "bin/TestFiles/Sector_ContinousLoss.txt";
@@ -367,6 +476,148 @@ TEST(Sector, Propagate)
     }
 }
 
+TEST(Sector, LazyTables)
+{
+    ParticleDef mu = MuMinusDef::Get();
+
+    Sector::Definition sector_def_1;
+    sector_def_1.SetMedium(std::make_shared<Ice>());
+    sector_def_1.scattering_model = ScatteringFactory::Highland;
+    sector_def_1.do_continuous_randomization = true;
+
+    Sector::Definition sector_def_2 = sector_def_1;
+    sector_def_2.location = Sector::ParticleLocation::BehindDetector;
+
+    InterpolationDef inter_def;
+    Helper::TakeTableRecords();
+    Sector sector(mu, sector_def_1, inter_def);
+    size_t n_tables = Helper::TakeTableRecords().size();
+    EXPECT_GT(n_tables, 0u);
+    EXPECT_TRUE(sector.IsInitialized());
+
+    // nothing is built before the first use
+    inter_def.do_lazy_tables = true;
+    Sector lazy_sector_1(mu, sector_def_1, inter_def);
+    Sector lazy_sector_2(sector_def_2, lazy_sector_1);
+    EXPECT_FALSE(lazy_sector_1.IsInitialized());
+    EXPECT_FALSE(lazy_sector_2.IsInitialized());
+    EXPECT_TRUE(Helper::TakeTableRecords().empty());
+
+    // neither comparing nor printing builds the tables
+    EXPECT_TRUE(sector == lazy_sector_1);
+    EXPECT_TRUE(Sector(lazy_sector_1) == lazy_sector_1);
+    EXPECT_FALSE(lazy_sector_1 == lazy_sector_2);
+    std::stringstream printed;
+    printed << lazy_sector_1;
+    EXPECT_FALSE(lazy_sector_1.IsInitialized());
+    EXPECT_TRUE(Helper::TakeTableRecords().empty());
+
+    // only the parts used are built, the cross sections first
+    lazy_sector_1.GetUtility();
+    size_t n_cross_section_tables = Helper::TakeTableRecords().size();
+    EXPECT_GT(n_cross_section_tables, 0u);
+    EXPECT_LT(n_cross_section_tables, n_tables);
+    EXPECT_FALSE(lazy_sector_1.IsInitialized());
+
+    lazy_sector_1.GetContinuousRandomizer();
+    std::vector<Helper::TableRecord> records = Helper::TakeTableRecords();
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].name, "contrand");
+    EXPECT_FALSE(lazy_sector_1.IsInitialized());
+
+    // the sectors sharing the physics build it once, even in several threads
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        const Sector* lazy_sector = (i % 2 == 0) ? &lazy_sector_1 : &lazy_sector_2;
+        threads.emplace_back([lazy_sector]() { lazy_sector->Initialize(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(lazy_sector_1.IsInitialized());
+    EXPECT_TRUE(lazy_sector_2.IsInitialized());
+    EXPECT_EQ(Helper::TakeTableRecords().size() + n_cross_section_tables + 1, n_tables);
+
+    // a copy is built from the shared physics on its first use as well
+    Sector lazy_sector_3(lazy_sector_2);
+    EXPECT_FALSE(lazy_sector_3.IsInitialized());
+    EXPECT_TRUE(lazy_sector_3 == lazy_sector_2);
+    lazy_sector_3.Initialize();
+    EXPECT_TRUE(lazy_sector_3.IsInitialized());
+    EXPECT_TRUE(Helper::TakeTableRecords().empty());
+
+    DynamicData p_condition;
+    p_condition.SetDirection(Vector3D(0, 0, -1));
+    p_condition.SetEnergy(1e6);
+
+    RandomGenerator::Get().SetSeed(1234);
+    DynamicData last = sector.Propagate(p_condition, 1e5, 0).GetSecondaries().back();
+    RandomGenerator::Get().SetSeed(1234);
+    DynamicData lazy_last = lazy_sector_1.Propagate(p_condition, 1e5, 0).GetSecondaries().back();
+
+    EXPECT_EQ(last.GetEnergy(), lazy_last.GetEnergy());
+    EXPECT_EQ(last.GetPropagatedDistance(), lazy_last.GetPropagatedDistance());
+}
+
+TEST(Sector, ParallelTables)
+{
+    ParticleDef mu = MuMinusDef::Get();
+
+    Sector::Definition sector_def;
+    sector_def.SetMedium(std::make_shared<Ice>());
+    sector_def.scattering_model = ScatteringFactory::Highland;
+    sector_def.do_continuous_randomization = true;
+    sector_def.do_exact_time_calculation = true;
+
+    InterpolationDef inter_def;
+    Helper::TakeTableRecords();
+    Sector sector(mu, sector_def, inter_def);
+    std::vector<Helper::TableRecord> records = Helper::TakeTableRecords();
+
+    // the tables of the cross sections and of the calculators are built at
+    // the same time, but are the same as the ones built one after another
+    inter_def.n_threads = 4;
+    Sector parallel_sector(mu, sector_def, inter_def);
+    std::vector<Helper::TableRecord> parallel_records = Helper::TakeTableRecords();
+
+    ASSERT_EQ(parallel_records.size(), records.size());
+    auto by_name = [](const Helper::TableRecord& a, const Helper::TableRecord& b) {
+        return a.name < b.name || (a.name == b.name && a.memory_size < b.memory_size);
+    };
+    std::sort(records.begin(), records.end(), by_name);
+    std::sort(parallel_records.begin(), parallel_records.end(), by_name);
+    for (size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(parallel_records[i].name, records[i].name);
+        EXPECT_EQ(parallel_records[i].memory_size, records[i].memory_size);
+    }
+
+    const std::vector<CrossSection*>& crosssections = sector.GetUtility().GetCrosssections();
+    const std::vector<CrossSection*>& parallel_crosssections = parallel_sector.GetUtility().GetCrosssections();
+    ASSERT_EQ(parallel_crosssections.size(), crosssections.size());
+
+    for (double energy = 1e3; energy < 1e10; energy *= 10) {
+        for (size_t i = 0; i < crosssections.size(); ++i) {
+            EXPECT_EQ(parallel_crosssections[i]->GetTypeId(), crosssections[i]->GetTypeId());
+            EXPECT_EQ(parallel_crosssections[i]->CalculatedEdx(energy), crosssections[i]->CalculatedEdx(energy));
+            EXPECT_EQ(parallel_crosssections[i]->CalculatedE2dx(energy), crosssections[i]->CalculatedE2dx(energy));
+            EXPECT_EQ(parallel_crosssections[i]->CalculatedNdx(energy), crosssections[i]->CalculatedNdx(energy));
+        }
+    }
+
+    DynamicData p_condition;
+    p_condition.SetDirection(Vector3D(0, 0, -1));
+    p_condition.SetEnergy(1e6);
+
+    RandomGenerator::Get().SetSeed(1234);
+    DynamicData last = sector.Propagate(p_condition, 1e5, 0).GetSecondaries().back();
+    RandomGenerator::Get().SetSeed(1234);
+    DynamicData parallel_last = parallel_sector.Propagate(p_condition, 1e5, 0).GetSecondaries().back();
+
+    EXPECT_EQ(last.GetEnergy(), parallel_last.GetEnergy());
+    EXPECT_EQ(last.GetPropagatedDistance(), parallel_last.GetPropagatedDistance());
+    EXPECT_EQ(last.GetTime(), parallel_last.GetTime());
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,116 @@
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "PROPOSAL/PROPOSAL.h"
+
+#include "TestSectors.h"
+
+using namespace PROPOSAL;
+
+std::vector<Sector::Definition> GetSectorDefinitions(
+    WeakInteractionFactory::Enum weak = WeakInteractionFactory::None)
+{
+    Sector::Definition sector_def        = GetWaterSectorDefinition();
+    sector_def.scattering_model          = ScatteringFactory::NoScattering;
+    sector_def.do_exact_time_calculation = true;
+    sector_def.utility_def.weak_def.parametrization = weak;
+
+    return std::vector<Sector::Definition>(1, sector_def);
+}
+
+// The default number of nodes, the tables are accurate at the percent level
+InterpolationDef GetInterpolationDef()
+{
+    InterpolationDef interpolation_def;
+    interpolation_def.max_node_energy = 1e10;
+
+    return interpolation_def;
+}
+
+TEST(TableAudit, Tables)
+{
+    Propagator prop(MuMinusDef::Get(),
+                    GetSectorDefinitions(),
+                    GetWorldGeometry(),
+                    GetInterpolationDef());
+
+    std::vector<TableAudit> audits = AuditTables(prop, 5);
+
+    // dEdx, dE2dx, dNdx and cumulative dNdx of every cross section,
+    // displacement, interaction, decay and time of the sector
+    size_t crosssections = prop.GetSectors().front()->GetUtility().GetCrosssections().size();
+    ASSERT_EQ(audits.size(), 4 * crosssections + 4);
+
+    for (size_t i = 0; i < audits.size(); ++i)
+    {
+        EXPECT_EQ(audits[i].sector, "0 water");
+        // points without an allowed energy loss are left out of the cumulative dNdx
+        EXPECT_GT(audits[i].points, 0);
+        EXPECT_LE(audits[i].points, 5);
+        EXPECT_GT(audits[i].nodes, 0);
+        EXPECT_GT(audits[i].bytes, 0u);
+        EXPECT_GT(audits[i].ns, 0);
+        EXPECT_GE(audits[i].max_error, 0);
+        EXPECT_LT(audits[i].max_error, 5e-2) << audits[i].table;
+    }
+
+    EXPECT_EQ(audits.back().table, "time");
+    EXPECT_EQ(audits[crosssections * 4].table, "displacement");
+
+    // the random points only depend on the seed
+    std::vector<TableAudit> again = AuditTables(prop, 5);
+
+    for (size_t i = 0; i < audits.size(); ++i)
+    {
+        EXPECT_EQ(audits[i].table, again[i].table);
+        EXPECT_EQ(audits[i].max_error, again[i].max_error);
+        EXPECT_EQ(audits[i].worst_energy, again[i].worst_energy);
+    }
+}
+
+TEST(TableAudit, WeakInteraction)
+{
+    // The weak interaction has no continuous losses and therefore neither
+    // dEdx nor dE2dx tables
+    Propagator prop(MuMinusDef::Get(),
+                    GetSectorDefinitions(WeakInteractionFactory::CooperSarkarMertsch),
+                    GetWorldGeometry(),
+                    GetInterpolationDef());
+
+    std::vector<TableAudit> audits = AuditTables(prop, 5);
+
+    size_t crosssections = prop.GetSectors().front()->GetUtility().GetCrosssections().size();
+    ASSERT_EQ(audits.size(), 4 * (crosssections - 1) + 2 + 4);
+
+    int weak = 0;
+
+    for (size_t i = 0; i < audits.size(); ++i)
+    {
+        if (audits[i].table.find("Weak") == 0)
+        {
+            ++weak;
+            EXPECT_EQ(audits[i].table.find(" dE"), std::string::npos) << audits[i].table;
+        }
+
+        EXPECT_GT(audits[i].points, 0);
+        EXPECT_LT(audits[i].max_error, 5e-2) << audits[i].table;
+    }
+
+    EXPECT_EQ(weak, 2);
+}
+
+TEST(TableAudit, Integrals)
+{
+    // Without an InterpolationDef there are no tables to audit
+    Propagator prop(MuMinusDef::Get(), GetSectorDefinitions(), GetWorldGeometry());
+
+    EXPECT_TRUE(AuditTables(prop, 5).empty());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+// Sectors and tables shared by the tests propagating particles
+
+#include <memory>
+#include <vector>
+
+#include "PROPOSAL/PROPOSAL.h"
+
+// Sphere around the whole world, used as detector and as sector geometry
+inline std::shared_ptr<const PROPOSAL::Geometry> GetWorldGeometry()
+{
+    return std::make_shared<const PROPOSAL::Sphere>(PROPOSAL::Vector3D(), 1e20, 0);
+}
+
+// Water with the default interactions of muons, taus and electrons
+inline PROPOSAL::Sector::Definition GetWaterSectorDefinition()
+{
+    PROPOSAL::Sector::Definition sector_def;
+    sector_def.location = PROPOSAL::Sector::ParticleLocation::InsideDetector;
+    sector_def.SetMedium(std::make_shared<PROPOSAL::Medium>(PROPOSAL::Water()));
+    sector_def.SetGeometry(GetWorldGeometry());
+    sector_def.scattering_model            = PROPOSAL::ScatteringFactory::Moliere;
+    sector_def.cut_settings                = PROPOSAL::EnergyCutSettings(500, 0.05);
+    sector_def.do_continuous_randomization = true;
+
+    return sector_def;
+}
+
+// Few nodes up to 10 TeV, so the tables are built quickly
+inline PROPOSAL::InterpolationDef GetCoarseInterpolationDef()
+{
+    PROPOSAL::InterpolationDef interpolation_def;
+    interpolation_def.nodes_cross_section = 20;
+    interpolation_def.nodes_propagate     = 200;
+    interpolation_def.max_node_energy     = 1e10;
+
+    return interpolation_def;
+}
+
+// Water with the interactions of positrons or photons, which sample the
+// produced particles from their tables
+inline std::vector<PROPOSAL::Sector::Definition> GetElectromagneticSectorDefinitions(
+    const PROPOSAL::ParticleDef& particle_def)
+{
+    using namespace PROPOSAL;
+
+    Sector::Definition sector_def = GetWaterSectorDefinition();
+    sector_def.scattering_model   = ScatteringFactory::NoScattering;
+
+    if (particle_def == GammaDef::Get())
+    {
+        sector_def.utility_def.brems_def.parametrization     = BremsstrahlungFactory::None;
+        sector_def.utility_def.photo_def.parametrization     = PhotonuclearFactory::None;
+        sector_def.utility_def.epair_def.parametrization     = EpairProductionFactory::None;
+        sector_def.utility_def.ioniz_def.parametrization     = IonizationFactory::None;
+        sector_def.utility_def.compton_def.parametrization   = ComptonFactory::KleinNishina;
+        sector_def.utility_def.photopair_def.parametrization = PhotoPairFactory::Tsai;
+    } else
+    {
+        sector_def.utility_def.ioniz_def.parametrization        = IonizationFactory::IonizBergerSeltzerBhabha;
+        sector_def.utility_def.annihilation_def.parametrization = AnnihilationFactory::Heitler;
+    }
+
+    return std::vector<Sector::Definition>(1, sector_def);
+}
@@ -1,7 +1,11 @@
 
+#include <map>
+#include <random>
+
 #include "gtest/gtest.h"
 
 #include "PROPOSAL/medium/Medium.h"
+#include "PROPOSAL/methods.h"
 #include "PROPOSAL/propagation_utility/PropagationUtility.h"
 
 using namespace PROPOSAL;
@@ -68,6 +72,72 @@ TEST(Copyconstructor, Copyconstructor2) {
     EXPECT_TRUE(C == D);
 }
 
+TEST(FusedRateTables, AgreeWithSum) {
+    InterpolationDef inter_def;
+    Utility A(MuMinusDef::Get(), std::make_shared<Ice>(), EnergyCutSettings(),
+              Utility::Definition(), inter_def);
+
+    inter_def.do_fused_rate_tables = true;
+    Utility B(MuMinusDef::Get(), std::make_shared<Ice>(), EnergyCutSettings(),
+              Utility::Definition(), inter_def);
+    Utility C(B);
+
+    EXPECT_FALSE(A.HasFusedRateTables());
+    EXPECT_TRUE(B.HasFusedRateTables());
+    EXPECT_TRUE(C.HasFusedRateTables());
+    EXPECT_TRUE(B == C);
+
+    // the random numbers are mapped differently, so only the distributions
+    // of the interaction types and the mean losses are compared
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    int statistics = 100000;
+
+    for (double energy : {1e3, 1e5, 1e8}) {
+        std::map<int, double> types_sum, types_fused;
+        double loss_sum = 0, loss_fused = 0;
+
+        for (int i = 0; i < statistics; ++i) {
+            double rnd1 = uniform(gen), rnd2 = uniform(gen), rnd3 = uniform(gen);
+            auto loss = A.StochasticLoss(energy, rnd1, rnd2, rnd3);
+            types_sum[loss.second] += 1. / statistics;
+            loss_sum += loss.first / statistics;
+
+            rnd1 = uniform(gen), rnd2 = uniform(gen), rnd3 = uniform(gen);
+            loss = C.StochasticLoss(energy, rnd1, rnd2, rnd3);
+            types_fused[loss.second] += 1. / statistics;
+            loss_fused += loss.first / statistics;
+        }
+
+        for (auto& type : types_sum) {
+            double sigma = std::sqrt(type.second * (1 - type.second) / statistics);
+            EXPECT_NEAR(types_fused[type.first], type.second, 5 * sigma + 1e-3);
+        }
+        EXPECT_EQ(types_sum.size(), types_fused.size());
+        EXPECT_NEAR(loss_fused, loss_sum, 0.1 * loss_sum);
+    }
+}
+
+TEST(TableRecords, Taken) {
+    Helper::TakeTableRecords();
+
+    Utility A(MuMinusDef::Get(), std::make_shared<Ice>(), EnergyCutSettings(),
+              Utility::Definition(), InterpolationDef());
+
+    std::vector<Helper::TableRecord> records = Helper::TakeTableRecords();
+    ASSERT_FALSE(records.empty());
+    for (auto& record : records) {
+        EXPECT_FALSE(record.name.empty());
+        EXPECT_EQ(record.source, "memory");
+        EXPECT_TRUE(record.file.empty());
+        EXPECT_EQ(record.file_size, 0u);
+        EXPECT_GT(record.memory_size, 0u);
+        EXPECT_GE(record.seconds, 0.);
+    }
+
+    EXPECT_TRUE(Helper::TakeTableRecords().empty());
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();